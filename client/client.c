@@ -6,6 +6,60 @@
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
+#include <zlib.h>
+
+/**
+ * @brief Parse "CODE MESSAGE\n" into response
+ */
+static void parse_simple_response(const char *line, Response *response)
+{
+    char temp[256];
+    strncpy(temp, line, sizeof(temp) - 1);
+    temp[sizeof(temp) - 1] = '\0';
+    char *nl = strchr(temp, '\n');
+    if (nl)
+        *nl = '\0';
+
+    // Parse code
+    char *space = strchr(temp, ' ');
+    if (space)
+    {
+        *space = '\0';
+        response->code = atoi(temp);
+        strncpy(response->message, space + 1, sizeof(response->message) - 1);
+    }
+    else
+    {
+        response->code = atoi(temp);
+        response->message[0] = '\0';
+    }
+
+    response->data = NULL;
+    response->data_length = 0;
+}
+
+/**
+ * @brief Inflate a ZDATA payload into response->data (NUL-terminated like DATA)
+ */
+static int inflate_payload(const char *z, size_t z_len, size_t raw_len, Response *response)
+{
+    if (raw_len > MAX_DATA_SIZE)
+        return -1;
+    response->data = malloc(raw_len + 1);
+    if (!response->data)
+        return -1;
+
+    uLongf out_len = raw_len;
+    if (uncompress((Bytef *)response->data, &out_len, (const Bytef *)z, z_len) != Z_OK || out_len != raw_len)
+    {
+        free(response->data);
+        response->data = NULL;
+        return -1;
+    }
+    response->data[raw_len] = '\0';
+    response->data_length = raw_len;
+    return 0;
+}
 
 /**
  * @brief Connect to server
@@ -57,6 +111,7 @@ void client_disconnect(Client *client)
         close(client->socket_fd);
         client->socket_fd = -1;
     }
+    client_clear_exam(client);
     client->state = CLIENT_DISCONNECTED;
 }
 
@@ -77,6 +132,23 @@ int client_create_send_command(Client *client, const char *command, const char *
     return send_full(client->socket_fd, buffer, len);
 }
 
+/**
+ * @brief Ask the server to compress large DATA: COMPRESS deflate -> 202 COMPRESS_OK deflate
+ */
+int client_enable_compression(Client *client)
+{
+    const char *params[] = {COMPRESS_DEFLATE};
+    if (client_create_send_command(client, MSG_COMPRESS, params, 1) < 0)
+        return -1;
+
+    Response response;
+    if (client_receive_response(client, &response) < 0)
+        return -1;
+    client->compress = response.code == CODE_COMPRESS_OK;
+    free_response(&response);
+    return client->compress ? 0 : -1;
+}
+
 /**
  * @brief Receive response from server
  * ví dụ: "110 LOGIN_OK sess_12345\n" hoặc "140 DATA 1234\n<1234 bytes>" sau đó lưu vào struct Response
@@ -92,6 +164,8 @@ int client_create_send_command(Client *client, const char *command, const char *
  *  response->message = ""
  *  response->data = <data>
  *  response->data_length = <length>
+ * 3. Compressed data message (after COMPRESS): CODE ZDATA <length> <raw_length>\n<zlib data>
+ * Response str: như DATA, data đã giải nén (data_length = raw_length)
  */
 int client_receive_response(Client *client, Response *response)
 {
@@ -106,6 +180,22 @@ int client_receive_response(Client *client, Response *response)
         return -1;
     }
 
+    int code;
+    size_t z_len, raw_len;
+    if (sscanf(buffer, "%d ZDATA %zu %zu", &code, &z_len, &raw_len) == 3)
+    {
+        char *z = z_len <= MAX_DATA_SIZE ? malloc(z_len + 1) : NULL;
+        if (!z || recv_full(client->socket_fd, z, z_len) < 0 || inflate_payload(z, z_len, raw_len, response) < 0)
+        {
+            fprintf(stderr, "Invalid compressed data\n");
+            free(z);
+            return -1;
+        }
+        free(z);
+        response->code = code;
+        return 0;
+    }
+
     // check if data message
     if (strstr(buffer, " DATA ") != NULL)
     {
@@ -144,30 +234,92 @@ int client_receive_response(Client *client, Response *response)
     }
     else
     {
-        // Simple response: CODE MESSAGE\n
-        char temp[256];
-        strncpy(temp, buffer, sizeof(temp) - 1);
-        char *nl = strchr(temp, '\n');
-        if (nl)
-            *nl = '\0';
+        parse_simple_response(buffer, response);
+    }
 
-        // Parse code
-        char *space = strchr(temp, ' ');
-        if (space)
-        {
-            *space = '\0';
-            response->code = atoi(temp);
-            strncpy(response->message, space + 1, sizeof(response->message) - 1);
-        }
-        else
-        {
-            response->code = atoi(temp);
-            response->message[0] = '\0';
-        }
+    return 0;
+}
 
-        response->data = NULL;
-        response->data_length = 0;
+/**
+ * @brief Parse one response from a receive buffer (for non-blocking sockets)
+ * Giống client_receive_response nhưng không đọc socket: caller tự recv() vào buffer.
+ */
+int client_parse_response(const char *buffer, size_t len, Response *response)
+{
+    memset(response, 0, sizeof(Response));
+
+    const char *nl = memchr(buffer, '\n', len);
+    if (!nl)
+        return len >= BUFFER_SIZE ? -1 : 0; // header line not complete yet
+
+    size_t header_len = (size_t)(nl - buffer) + 1;
+    char header[BUFFER_SIZE];
+    size_t copy = header_len < sizeof(header) ? header_len : sizeof(header) - 1;
+    memcpy(header, buffer, copy);
+    header[copy] = '\0';
+
+    int code;
+    size_t z_len, raw_len;
+    if (sscanf(header, "%d ZDATA %zu %zu", &code, &z_len, &raw_len) == 3)
+    {
+        if (z_len > MAX_DATA_SIZE)
+            return -1;
+        if (len - header_len < z_len)
+            return 0; // payload not complete yet
+        if (inflate_payload(buffer + header_len, z_len, raw_len, response) < 0)
+            return -1;
+        response->code = code;
+        return (int)(header_len + z_len);
     }
 
-    return 0;
+    if (strstr(header, " DATA ") == NULL)
+    {
+        parse_simple_response(header, response);
+        return (int)header_len;
+    }
+
+    size_t data_len;
+    if (sscanf(header, "%d DATA %zu", &code, &data_len) != 2 || data_len > MAX_DATA_SIZE)
+        return -1;
+    if (len - header_len < data_len)
+        return 0; // payload not complete yet
+
+    response->data = malloc(data_len + 1);
+    if (!response->data)
+        return -1;
+    memcpy(response->data, buffer + header_len, data_len);
+    response->data[data_len] = '\0';
+    response->data_length = data_len;
+    response->code = code;
+    return (int)(header_len + data_len);
+}
+
+/**
+ * @brief Receive the exam pushed after START_OK
+ * "125 START_OK room_id|start|deadline|EXAM" -> next message is "150 DATA <length>\n<JSON>"
+ */
+int client_receive_pushed_exam(Client *client, const Response *start)
+{
+    const char *flag = strrchr(start->message, '|');
+    if (!flag || strcmp(flag + 1, START_OK_EXAM_PUSHED) != 0)
+        return 0;
+
+    Response exam;
+    if (client_receive_response(client, &exam) < 0)
+        return -1;
+    if (exam.code != CODE_EXAM_DATA || !exam.data)
+    {
+        free_response(&exam);
+        return -1;
+    }
+
+    client_clear_exam(client);
+    client->pushed_exam = exam.data; // keep the payload, no copy
+    return 1;
+}
+
+void client_clear_exam(Client *client)
+{
+    free(client->pushed_exam);
+    client->pushed_exam = NULL;
 }
@@ -30,6 +30,8 @@ typedef struct
     char session_id[MAX_SESSION_ID_LEN];
     char current_room[MAX_ROOM_ID_LEN];
     int is_creator; // 1 if user is room creator, 0 otherwise
+    char *pushed_exam; // exam JSON received with START_OK (--push-exam), NULL otherwise
+    int compress;      // server accepted COMPRESS deflate: large DATA arrive as ZDATA
 } Client;
 
 /**
@@ -57,6 +59,13 @@ void client_disconnect(Client *client);
  */
 int client_create_send_command(Client *client, const char *command, const char **params, int param_count);
 
+/**
+ * @brief Ask the server to send large DATA compressed (COMPRESS deflate)
+ * @param client Client structure (client->compress set on success)
+ * @return 0 if accepted, -1 otherwise (the connection stays uncompressed)
+ */
+int client_enable_compression(Client *client);
+
 /**
  * @brief Receive response from server
  * @param client Client structure
@@ -65,4 +74,27 @@ int client_create_send_command(Client *client, const char *command, const char *
  */
 int client_receive_response(Client *client, Response *response);
 
+/**
+ * @brief Parse one response already read into a buffer (non-blocking sockets)
+ * @param buffer Received bytes (not NUL-terminated)
+ * @param len Number of bytes in buffer
+ * @param response Response structure to fill (free data with free_response)
+ * @return Bytes consumed, 0 if more bytes are needed, -1 on error
+ */
+int client_parse_response(const char *buffer, size_t len, Response *response);
+
+/**
+ * @brief Receive the exam that follows 125 START_OK when the server pushes it (--push-exam)
+ * @param client Client structure (exam stored in client->pushed_exam)
+ * @param start The START_OK response
+ * @return 1 if received, 0 if START_OK did not announce an exam, -1 on error
+ */
+int client_receive_pushed_exam(Client *client, const Response *start);
+
+/**
+ * @brief Forget the pushed exam (leaving the exam)
+ * @param client Client structure
+ */
+void client_clear_exam(Client *client);
+
 #endif // CLIENT_H
\ No newline at end of file
@@ -510,6 +510,8 @@ void handle_start_exam(Client *client)
         ui_show_success("Exam started!");
         printf("Start time: %s\n", resp.message);
         ui_show_info("All participants have been notified");
+        if (client_receive_pushed_exam(client, &resp) > 0)
+            ui_show_info("Exam questions received with the start message");
     }
     else
     {
@@ -519,6 +521,20 @@ void handle_start_exam(Client *client)
     }
 }
 
+/**
+ * @brief Print exam questions (JSON from 150 DATA)
+ */
+static void show_exam(const char *exam_json)
+{
+    ui_show_success("Exam questions received!");
+    printf("\n========================================\n");
+    printf("EXAM QUESTIONS\n");
+    printf("========================================\n");
+    printf("%s\n", exam_json);
+    printf("========================================\n");
+    printf("\nYou can now answer the questions. Choose your answers and submit in the next step.\n");
+}
+
 /**
  * @brief Handle GET_EXAM - fetch exam questions
  */
@@ -532,6 +548,13 @@ void handle_get_exam(Client *client)
         return;
     }
 
+    // Exam already pushed with START_OK (--push-exam): no request needed
+    if (client->pushed_exam)
+    {
+        show_exam(client->pushed_exam);
+        return;
+    }
+
     ui_show_info("Fetching exam questions...");
 
     // Send GET_EXAM command
@@ -552,13 +575,7 @@ void handle_get_exam(Client *client)
 
     if (resp.code == 150) // CODE_EXAM_DATA
     {
-        ui_show_success("Exam questions received!");
-        printf("\n========================================\n");
-        printf("EXAM QUESTIONS\n");
-        printf("========================================\n");
-        printf("%s\n", resp.data);
-        printf("========================================\n");
-        printf("\nYou can now answer the questions. Choose your answers and submit in the next step.\n");
+        show_exam(resp.data);
     }
     else
     {
@@ -569,19 +586,11 @@ void handle_get_exam(Client *client)
 }
 
 /**
- * @brief Handle submit exam
+ * @brief Read answers from stdin as "A,B,C" (accepts "A B C" / lowercase)
+ * @return Number of answers, -1 on invalid input (error already shown)
  */
-void handle_submit_exam(Client *client)
+static int read_answers(char *answers, size_t size)
 {
-    printf("\n=== SUBMIT EXAM ===\n");
-
-    if (strlen(client->current_room) == 0)
-    {
-        ui_show_error("You are not in any room");
-        return;
-    }
-
-    // Get answers from user
     char input[512];
     printf("Enter your answers (e.g., A,B,C,D,A or A B C D A):\n");
     printf("Answers: ");
@@ -589,7 +598,7 @@ void handle_submit_exam(Client *client)
     if (fgets(input, sizeof(input), stdin) == NULL)
     {
         ui_show_error("Failed to read answers");
-        return;
+        return -1;
     }
 
     // Remove newline
@@ -603,11 +612,11 @@ void handle_submit_exam(Client *client)
     if (strlen(input) == 0)
     {
         ui_show_error("Answers cannot be empty");
-        return;
+        return -1;
     }
 
     // Process input: remove spaces and convert to comma-separated format
-    char answers[512] = "";
+    answers[0] = '\0';
     int answer_count = 0;
     char *token = strtok(input, " ,"); // Split by space or comma
 
@@ -622,6 +631,11 @@ void handle_submit_exam(Client *client)
             // Convert to uppercase
             char upper = (token[0] >= 'a' && token[0] <= 'z') ? token[0] - 32 : token[0];
 
+            if (strlen(answers) + 3 > size)
+            {
+                ui_show_error("Too many answers");
+                return -1;
+            }
             if (answer_count > 0)
             {
                 strcat(answers, ","); // server expects comma-separated answers
@@ -634,7 +648,7 @@ void handle_submit_exam(Client *client)
             char error[512];
             snprintf(error, sizeof(error), "Invalid answer '%s'. Use A, B, C, or D only.", token);
             ui_show_error(error);
-            return;
+            return -1;
         }
 
         token = strtok(NULL, " ,"); // Get next token
@@ -643,9 +657,29 @@ void handle_submit_exam(Client *client)
     if (answer_count == 0)
     {
         ui_show_error("No valid answers found");
+        return -1;
+    }
+    return answer_count;
+}
+
+/**
+ * @brief Handle submit exam
+ */
+void handle_submit_exam(Client *client)
+{
+    printf("\n=== SUBMIT EXAM ===\n");
+
+    if (strlen(client->current_room) == 0)
+    {
+        ui_show_error("You are not in any room");
         return;
     }
 
+    // Get answers from user
+    char answers[512];
+    if (read_answers(answers, sizeof(answers)) < 0)
+        return;
+
     ui_show_info("Submitting exam...");
 
     // Send SUBMIT_EXAM command: room_id|answers
@@ -710,6 +744,7 @@ void handle_submit_exam(Client *client)
         // Update client state - exit exam
         client->state = CLIENT_AUTHENTICATED;
         memset(client->current_room, 0, sizeof(client->current_room));
+        client_clear_exam(client);
 
         printf("\nYou have been returned to the main menu.\n");
     }
@@ -746,3 +781,176 @@ void handle_submit_exam(Client *client)
         ui_show_error(error);
     }
 }
+
+/**
+ * @brief Handle PRACTICE - practice questions, graded right away
+ */
+void handle_practice(Client *client)
+{
+    char count[16];
+
+    printf("\n=== PRACTICE ===\n");
+    ui_get_input("Number of questions (1-50, Enter = 10): ", count, sizeof(count));
+
+    const char *params[] = {count};
+    if (client_create_send_command(client, "PRACTICE", params, strlen(count) > 0 ? 1 : 0) < 0)
+    {
+        ui_show_error("Failed to send command");
+        return;
+    }
+
+    Response resp;
+    if (client_receive_response(client, &resp) < 0)
+    {
+        ui_show_error("Failed to receive response");
+        return;
+    }
+    if (resp.code != CODE_DATA || !resp.data)
+    {
+        char error[512];
+        snprintf(error, sizeof(error), "[%d] %s", resp.code, resp.message);
+        ui_show_error(error);
+        free(resp.data);
+        return;
+    }
+
+    // "practice_id": "<id>"
+    char practice_id[64] = "";
+    const char *id = strstr(resp.data, "\"practice_id\": \"");
+    if (id)
+        sscanf(id + strlen("\"practice_id\": \""), "%63[^\"]", practice_id);
+
+    printf("\n========================================\n");
+    printf("PRACTICE QUESTIONS\n");
+    printf("========================================\n");
+    printf("%s\n", resp.data);
+    printf("========================================\n");
+    free(resp.data);
+
+    if (strlen(practice_id) == 0)
+    {
+        ui_show_error("Invalid practice data");
+        return;
+    }
+
+    char answers[512];
+    if (read_answers(answers, sizeof(answers)) < 0)
+        return;
+
+    const char *submit_params[] = {practice_id, answers};
+    if (client_create_send_command(client, "SUBMIT_PRACTICE", submit_params, 2) < 0)
+    {
+        ui_show_error("Failed to send command");
+        return;
+    }
+    if (client_receive_response(client, &resp) < 0)
+    {
+        ui_show_error("Failed to receive response");
+        return;
+    }
+
+    if (resp.code == CODE_PRACTICE_RESULT)
+    {
+        // score|total|correct answers
+        char *score_str = strtok(resp.message, "|");
+        char *total_str = strtok(NULL, "|");
+        char *correct = strtok(NULL, "|");
+        printf("\nScore: %s/%s\n", score_str ? score_str : "?", total_str ? total_str : "?");
+        if (correct)
+            printf("Correct answers: %s\n", correct);
+    }
+    else
+    {
+        char error[512];
+        snprintf(error, sizeof(error), "[%d] %s", resp.code, resp.message);
+        ui_show_error(error);
+    }
+}
+
+void handle_adaptive_practice(Client *client)
+{
+    char category[64];
+
+    printf("\n=== ADAPTIVE PRACTICE ===\n");
+    ui_get_input("Category (Enter = continue last one): ", category, sizeof(category));
+
+    while (1)
+    {
+        const char *params[] = {category};
+        if (client_create_send_command(client, "PRACTICE_NEXT", params, strlen(category) > 0 ? 1 : 0) < 0)
+        {
+            ui_show_error("Failed to send command");
+            return;
+        }
+        category[0] = '\0'; // next questions continue the session
+
+        Response resp;
+        if (client_receive_response(client, &resp) < 0)
+        {
+            ui_show_error("Failed to receive response");
+            return;
+        }
+        if (resp.code != CODE_DATA || !resp.data)
+        {
+            char error[512];
+            snprintf(error, sizeof(error), "[%d] %s", resp.code, resp.message);
+            ui_show_error(error);
+            free(resp.data);
+            return;
+        }
+
+        // "practice_id": "<id>"
+        char practice_id[64] = "";
+        const char *id = strstr(resp.data, "\"practice_id\": \"");
+        if (id)
+            sscanf(id + strlen("\"practice_id\": \""), "%63[^\"]", practice_id);
+
+        printf("\n========================================\n");
+        printf("%s\n", resp.data);
+        printf("========================================\n");
+        free(resp.data);
+
+        if (strlen(practice_id) == 0)
+        {
+            ui_show_error("Invalid practice data");
+            return;
+        }
+
+        char answer[16];
+        ui_get_input("Your answer (A-D, Enter = stop): ", answer, sizeof(answer));
+        if (strlen(answer) == 0)
+            return;
+
+        const char *answer_params[] = {practice_id, answer};
+        if (client_create_send_command(client, "PRACTICE_ANSWER", answer_params, 2) < 0)
+        {
+            ui_show_error("Failed to send command");
+            return;
+        }
+        if (client_receive_response(client, &resp) < 0)
+        {
+            ui_show_error("Failed to receive response");
+            return;
+        }
+
+        if (resp.code == CODE_PRACTICE_RESULT)
+        {
+            // correct|1|correct answer|rating
+            char *correct = strtok(resp.message, "|");
+            strtok(NULL, "|");
+            char *correct_answer = strtok(NULL, "|");
+            char *rating = strtok(NULL, "|");
+            if (correct && strcmp(correct, "1") == 0)
+                printf("\nCorrect!");
+            else
+                printf("\nWrong, the answer is %s.", correct_answer ? correct_answer : "?");
+            printf(" Your rating: %s\n", rating ? rating : "?");
+        }
+        else
+        {
+            char error[512];
+            snprintf(error, sizeof(error), "[%d] %s", resp.code, resp.message);
+            ui_show_error(error);
+        }
+    }
+}
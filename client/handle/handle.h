@@ -126,4 +126,28 @@ void handle_get_exam(Client *client);
  */
 void handle_submit_exam(Client *client);
 
+/**
+ * @brief Handle PRACTICE - practice with random questions
+ * @param client Client instance
+ *
+ * Flow:
+ * 1. Get number of questions from user
+ * 2. Send PRACTICE num_questions, receive 140 DATA with JSON (practice_id + questions)
+ * 3. Get answers from user, send SUBMIT_PRACTICE practice_id|answers
+ * 4. Display 141 score|total and the correct answers
+ */
+void handle_practice(Client *client);
+
+/**
+ * @brief Handle PRACTICE_NEXT / PRACTICE_ANSWER - adaptive practice, one question at a time
+ * @param client Client instance
+ *
+ * Flow:
+ * 1. Get category from user (empty: continue the last adaptive session)
+ * 2. Send PRACTICE_NEXT [category], receive 140 DATA with one question and the current rating
+ * 3. Send PRACTICE_ANSWER practice_id|answer, display 141 correct|1|answer|new rating
+ * 4. Repeat until the user stops
+ */
+void handle_adaptive_practice(Client *client);
+
 #endif // HANDLE_H
\ No newline at end of file
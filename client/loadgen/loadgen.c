@@ -0,0 +1,1009 @@
+#include "../client.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+// ===============================================
+// LOADGEN - headless load generator
+// ===============================================
+//
+// Simulates virtual examinees (VU) following the exam journey:
+//   REGISTER -> LOGIN -> CREATE_ROOM (creator) / JOIN_ROOM (members)
+//   -> wait 125 START_OK -> GET_EXAM (or the exam pushed with START_OK) -> think
+//   -> SUBMIT_EXAM -> VIEW_RESULT
+//
+// VUs are grouped by room (1 creator + N-1 members); a room lives on one
+// worker thread. Each worker runs its own epoll loop over non-blocking
+// sockets, so thousands of VUs need only a few threads.
+//
+// --lobby N adds N lobby watchers (REGISTER -> LOGIN -> SUBSCRIBE_LOBBY) that
+// receive the room changes caused by the examinees until they are done.
+// LOBBY_PUSH is the delay from the oldest event of a batch to its arrival;
+// run the server on one core (taskset -c 0) to find how many subscribers a
+// core serves before that delay grows.
+//
+// --rejoin makes members send JOIN_ROOM twice. The second join must not count
+// as another participant: if it did, rooms never finish early and every
+// journey fails at VIEW_RESULT (still IN_PROGRESS after the retries).
+//
+// Usage: loadgen [--host IP] [--port N] [--users N] [--room-size N] [--threads N]
+//                [--questions N] [--think-ms N] [--ramp-ms N] [--duration S]
+//                [--prefix STR] [--no-register] [--lobby N] [--rejoin]
+
+#define LG_PASSWORD "Password123"
+#define LG_RECV_INITIAL (16 * 1024)               // receive buffer grows on demand
+#define LG_RECV_MAX (MAX_DATA_SIZE + BUFFER_SIZE)
+#define LG_VIEW_RETRY_MS 100
+#define LG_VIEW_MAX_RETRIES 100
+
+// Latency histogram: same log-linear layout as the server metrics (8 sub-buckets per power of two)
+#define LG_SUB_BITS 3
+#define LG_SUB_COUNT (1 << LG_SUB_BITS)
+#define LG_MAX_EXP 40
+#define LG_BUCKETS ((LG_MAX_EXP - LG_SUB_BITS + 1) * LG_SUB_COUNT)
+
+typedef enum
+{
+    LG_REGISTER,
+    LG_LOGIN,
+    LG_CREATE_ROOM,
+    LG_JOIN_ROOM,
+    LG_START_EXAM, // creator: START_EXAM -> own 125 START_OK
+    LG_START_PUSH, // members: creator's START_EXAM -> 125 START_OK received
+    LG_GET_EXAM,
+    LG_SUBMIT_EXAM,
+    LG_VIEW_RESULT,
+    LG_SUBSCRIBE_LOBBY,
+    LG_LOBBY_PUSH, // watchers: event queued on the server -> batch received
+    LG_COMMAND_COUNT
+} LgCommand;
+
+static const char *command_names[LG_COMMAND_COUNT] = {
+    "REGISTER", "LOGIN", "CREATE_ROOM", "JOIN_ROOM", "START_EXAM", "START_PUSH", "GET_EXAM", "SUBMIT_EXAM", "VIEW_RESULT",
+    "SUB_LOBBY", "LOBBY_PUSH"};
+
+typedef enum
+{
+    VU_PENDING,     // chờ tới lượt connect (ramp)
+    VU_CONNECTING,
+    VU_REGISTER,
+    VU_LOGIN,
+    VU_CREATE_ROOM,
+    VU_WAIT_ROOM,   // member: chờ creator tạo phòng / creator: chờ member join
+    VU_JOIN_ROOM,
+    VU_WAIT_START,
+    VU_GET_EXAM,
+    VU_THINK,
+    VU_SUBMIT,
+    VU_WAIT_FINISH, // chờ cả phòng nộp bài
+    VU_VIEW_RESULT,
+    VU_SUBSCRIBE,   // watcher: chờ 129 SUBSCRIBED
+    VU_WATCH,       // watcher: nhận lobby push tới khi các VU thi xong
+    VU_DONE,
+    VU_FAILED
+} VuState;
+
+typedef struct
+{
+    uint64_t count;
+    uint64_t errors;
+    uint64_t max_ns;
+    uint64_t buckets[LG_BUCKETS];
+} LgHistogram;
+
+typedef struct RoomGroup RoomGroup;
+
+typedef struct
+{
+    int fd;
+    int index;
+    VuState state;
+    int is_creator;
+    int is_watcher; // lobby watcher (--lobby), group = NULL
+    RoomGroup *group;
+    char username[MAX_USERNAME_LEN + 1];
+    uint64_t sent_ns;     // time of the outstanding request
+    uint64_t timer_ns;    // wake-up time (0 = none)
+    int questions;
+    int view_retries;
+    int rejoined;         // --rejoin: second JOIN_ROOM sent
+    char *in;             // receive buffer
+    size_t in_len;
+    size_t in_cap;
+    char out[BUFFER_SIZE]; // pending bytes to send
+    size_t out_len;
+    size_t out_off;
+    int epoll_out;         // EPOLLOUT currently registered
+} VirtualUser;
+
+struct RoomGroup
+{
+    char room_id[MAX_ROOM_ID_LEN];
+    int size;
+    int joined;
+    int submitted;
+    int failed;
+    uint64_t start_sent_ns;
+    VirtualUser **members; // members[0] = creator
+};
+
+typedef struct
+{
+    int id;
+    int epoll_fd;
+    VirtualUser *vus;
+    int vu_count;
+    int finished; // VUs in DONE or FAILED
+    unsigned int seed;
+    LgHistogram hist[LG_COMMAND_COUNT];
+    uint64_t journeys_done;
+    uint64_t journeys_failed;
+    uint64_t lobby_batches;
+    uint64_t lobby_events;
+    pthread_t thread;
+} Worker;
+
+typedef struct
+{
+    const char *host;
+    int port;
+    int users;
+    int room_size;
+    int threads;
+    int questions;
+    int time_limit;
+    int think_ms;
+    int ramp_ms;
+    int duration_s;
+    int do_register;
+    const char *prefix;
+    int lobby;
+    int rejoin;
+} LgOptions;
+
+static LgOptions opts = {SERVER_IP, SERVER_PORT, 100, 10, 4, 10, 30, 2000, 1000, 600, 1, "lg", 0, 0};
+static struct sockaddr_in server_addr;
+static uint64_t run_start_ns;
+static atomic_int examinees_left; // watchers stop when it reaches 0
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// ============================== Histogram ===================================
+
+static size_t bucket_index(uint64_t value)
+{
+    if (value < LG_SUB_COUNT)
+        return (size_t)value;
+    if (value >= (1ULL << LG_MAX_EXP))
+        value = (1ULL << LG_MAX_EXP) - 1;
+    int exp = 63 - __builtin_clzll(value);
+    int shift = exp - LG_SUB_BITS;
+    return (size_t)(exp - LG_SUB_BITS + 1) * LG_SUB_COUNT + ((value >> shift) & (LG_SUB_COUNT - 1));
+}
+
+static uint64_t bucket_upper(size_t index)
+{
+    if (index < LG_SUB_COUNT)
+        return index + 1;
+    size_t group = index / LG_SUB_COUNT;
+    int shift = (int)group - 1;
+    return ((uint64_t)(LG_SUB_COUNT + index % LG_SUB_COUNT) << shift) + (1ULL << shift);
+}
+
+static uint64_t percentile(const LgHistogram *h, double p)
+{
+    if (h->count == 0)
+        return 0;
+    uint64_t target = (uint64_t)((double)h->count * p / 100.0 + 0.5);
+    if (target == 0)
+        target = 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < LG_BUCKETS; i++)
+    {
+        seen += h->buckets[i];
+        if (seen >= target)
+            return bucket_upper(i) < h->max_ns ? bucket_upper(i) : h->max_ns;
+    }
+    return h->max_ns;
+}
+
+static void record(Worker *w, LgCommand cmd, uint64_t elapsed_ns)
+{
+    LgHistogram *h = &w->hist[cmd];
+    h->count++;
+    h->buckets[bucket_index(elapsed_ns)]++;
+    if (elapsed_ns > h->max_ns)
+        h->max_ns = elapsed_ns;
+}
+
+// ============================== VU helpers ==================================
+
+static void vu_fail(Worker *w, VirtualUser *vu, LgCommand cmd, const char *reason);
+
+static void vu_finish(Worker *w, VirtualUser *vu, VuState state)
+{
+    if (vu->state == VU_DONE || vu->state == VU_FAILED)
+        return;
+    vu->state = state;
+    vu->timer_ns = 0;
+    w->finished++;
+    if (!vu->is_watcher)
+    {
+        atomic_fetch_sub(&examinees_left, 1);
+        if (state == VU_DONE)
+            w->journeys_done++;
+        else
+            w->journeys_failed++;
+    }
+    if (vu->fd >= 0)
+    {
+        epoll_ctl(w->epoll_fd, EPOLL_CTL_DEL, vu->fd, NULL);
+        close(vu->fd);
+        vu->fd = -1;
+    }
+}
+
+// Only touch epoll when EPOLLOUT interest actually changes
+static void update_events(Worker *w, VirtualUser *vu)
+{
+    int want_out = vu->out_off < vu->out_len || vu->state == VU_CONNECTING;
+    if (want_out == vu->epoll_out)
+        return;
+
+    struct epoll_event ev;
+    ev.events = EPOLLIN | (want_out ? EPOLLOUT : 0);
+    ev.data.ptr = vu;
+    epoll_ctl(w->epoll_fd, EPOLL_CTL_MOD, vu->fd, &ev);
+    vu->epoll_out = want_out;
+}
+
+static int flush_out(Worker *w, VirtualUser *vu)
+{
+    while (vu->out_off < vu->out_len)
+    {
+        ssize_t n = send(vu->fd, vu->out + vu->out_off, vu->out_len - vu->out_off, MSG_NOSIGNAL);
+        if (n < 0)
+        {
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                update_events(w, vu);
+                return 0;
+            }
+            return -1;
+        }
+        vu->out_off += (size_t)n;
+    }
+    vu->out_len = vu->out_off = 0;
+    update_events(w, vu);
+    return 0;
+}
+
+// Queue a command built with the client protocol module and try to send it now
+static void vu_send(Worker *w, VirtualUser *vu, VuState next, LgCommand cmd, const char *command,
+                    const char **params, int param_count)
+{
+    int len = create_control_message(command, params, param_count, vu->out + vu->out_len,
+                                     sizeof(vu->out) - vu->out_len);
+    if (len <= 0)
+    {
+        vu_fail(w, vu, cmd, "message too large");
+        return;
+    }
+    vu->out_len += (size_t)len;
+    vu->state = next;
+    vu->sent_ns = now_ns();
+    if (flush_out(w, vu) < 0)
+        vu_fail(w, vu, cmd, "send failed");
+}
+
+static void group_fail(Worker *w, RoomGroup *group)
+{
+    if (!group || group->failed)
+        return;
+    group->failed = 1;
+    // Members waiting on the room would never be woken: end them too
+    for (int i = 0; i < group->size; i++)
+    {
+        VirtualUser *m = group->members[i];
+        if (m->state == VU_WAIT_ROOM || m->state == VU_WAIT_START || m->state == VU_WAIT_FINISH ||
+            m->state == VU_PENDING)
+            vu_finish(w, m, VU_FAILED);
+    }
+}
+
+static void vu_fail(Worker *w, VirtualUser *vu, LgCommand cmd, const char *reason)
+{
+    if (cmd < LG_COMMAND_COUNT)
+        w->hist[cmd].errors++;
+    if (w->journeys_failed < 10)
+        fprintf(stderr, "[loadgen] %s failed at %s: %s\n", vu->username,
+                cmd < LG_COMMAND_COUNT ? command_names[cmd] : "CONNECT", reason);
+    vu_finish(w, vu, VU_FAILED);
+    group_fail(w, vu->group);
+}
+
+static void send_login(Worker *w, VirtualUser *vu)
+{
+    const char *params[] = {vu->username, LG_PASSWORD};
+    vu_send(w, vu, VU_LOGIN, LG_LOGIN, "LOGIN", params, 2);
+}
+
+static void send_join(Worker *w, VirtualUser *vu)
+{
+    const char *params[] = {vu->group->room_id};
+    vu_send(w, vu, VU_JOIN_ROOM, LG_JOIN_ROOM, "JOIN_ROOM", params, 1);
+}
+
+static void send_start(Worker *w, VirtualUser *creator)
+{
+    const char *params[] = {creator->group->room_id};
+    vu_send(w, creator, VU_WAIT_START, LG_START_EXAM, "START_EXAM", params, 1);
+    creator->group->start_sent_ns = creator->sent_ns;
+}
+
+static void send_view(Worker *w, VirtualUser *vu)
+{
+    const char *params[] = {vu->group->room_id};
+    vu_send(w, vu, VU_VIEW_RESULT, LG_VIEW_RESULT, "VIEW_RESULT", params, 1);
+}
+
+static void send_submit(Worker *w, VirtualUser *vu)
+{
+    char answers[BUFFER_SIZE / 2];
+    size_t pos = 0;
+    for (int i = 0; i < vu->questions && pos + 3 < sizeof(answers); i++)
+    {
+        answers[pos++] = (char)('A' + rand_r(&w->seed) % 4);
+        if (i + 1 < vu->questions)
+            answers[pos++] = ',';
+    }
+    answers[pos] = '\0';
+
+    const char *params[] = {vu->group->room_id, answers};
+    vu_send(w, vu, VU_SUBMIT, LG_SUBMIT_EXAM, "SUBMIT_EXAM", params, 2);
+}
+
+static void start_vu(Worker *w, VirtualUser *vu)
+{
+    vu->fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    if (vu->fd < 0)
+    {
+        vu_fail(w, vu, LG_COMMAND_COUNT, strerror(errno));
+        return;
+    }
+    int one = 1;
+    setsockopt(vu->fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    vu->state = VU_CONNECTING;
+    vu->sent_ns = now_ns();
+    if (connect(vu->fd, (struct sockaddr *)&server_addr, sizeof(server_addr)) < 0 && errno != EINPROGRESS)
+    {
+        vu_fail(w, vu, LG_COMMAND_COUNT, strerror(errno));
+        return;
+    }
+
+    struct epoll_event ev;
+    ev.events = EPOLLIN | EPOLLOUT;
+    ev.data.ptr = vu;
+    epoll_ctl(w->epoll_fd, EPOLL_CTL_ADD, vu->fd, &ev);
+    vu->epoll_out = 1;
+}
+
+static void on_connected(Worker *w, VirtualUser *vu)
+{
+    int err = 0;
+    socklen_t len = sizeof(err);
+    getsockopt(vu->fd, SOL_SOCKET, SO_ERROR, &err, &len);
+    if (err != 0)
+    {
+        vu_fail(w, vu, LG_COMMAND_COUNT, strerror(err));
+        return;
+    }
+
+    if (opts.do_register)
+    {
+        const char *params[] = {vu->username, LG_PASSWORD};
+        vu_send(w, vu, VU_REGISTER, LG_REGISTER, "REGISTER", params, 2);
+    }
+    else
+    {
+        send_login(w, vu);
+    }
+}
+
+static int count_questions(const char *json)
+{
+    int count = 0;
+    for (const char *p = json; (p = strstr(p, "\"question_id\"")) != NULL; p++)
+        count++;
+    return count;
+}
+
+// ============================ Journey logic =================================
+
+static void on_response(Worker *w, VirtualUser *vu, Response *resp)
+{
+    uint64_t now = now_ns();
+    uint64_t elapsed = now - vu->sent_ns;
+    RoomGroup *group = vu->group;
+
+    switch (vu->state)
+    {
+    case VU_REGISTER:
+        // 401 = account left over from a previous run: fine
+        if (resp->code != CODE_CREATED && resp->code != CODE_USERNAME_EXISTS)
+            {
+                vu_fail(w, vu, LG_REGISTER, resp->message);
+                return;
+            }
+        record(w, LG_REGISTER, elapsed);
+        send_login(w, vu);
+        break;
+
+    case VU_LOGIN:
+        if (resp->code != CODE_LOGIN_OK)
+            {
+                vu_fail(w, vu, LG_LOGIN, resp->message);
+                return;
+            }
+        record(w, LG_LOGIN, elapsed);
+        if (vu->is_watcher)
+        {
+            vu_send(w, vu, VU_SUBSCRIBE, LG_SUBSCRIBE_LOBBY, MSG_SUBSCRIBE_LOBBY, NULL, 0);
+        }
+        else if (vu->is_creator)
+        {
+            char name[64], questions[16], time_limit[16];
+            snprintf(name, sizeof(name), "%s_room", vu->username);
+            snprintf(questions, sizeof(questions), "%d", opts.questions);
+            snprintf(time_limit, sizeof(time_limit), "%d", opts.time_limit);
+            const char *params[] = {name, questions, time_limit};
+            vu_send(w, vu, VU_CREATE_ROOM, LG_CREATE_ROOM, "CREATE_ROOM", params, 3);
+        }
+        else if (group->room_id[0])
+        {
+            send_join(w, vu);
+        }
+        else
+        {
+            vu->state = VU_WAIT_ROOM;
+        }
+        break;
+
+    case VU_CREATE_ROOM:
+        if (resp->code != CODE_ROOM_CREATED)
+            {
+                vu_fail(w, vu, LG_CREATE_ROOM, resp->message);
+                return;
+            }
+        record(w, LG_CREATE_ROOM, elapsed);
+        snprintf(group->room_id, sizeof(group->room_id), "%s", resp->message);
+        vu->state = VU_WAIT_ROOM;
+        for (int i = 1; i < group->size; i++)
+        {
+            if (group->members[i]->state == VU_WAIT_ROOM)
+                send_join(w, group->members[i]);
+        }
+        if (group->size == 1)
+            send_start(w, vu);
+        break;
+
+    case VU_JOIN_ROOM:
+        if (resp->code != CODE_ROOM_JOIN_OK)
+            {
+                vu_fail(w, vu, LG_JOIN_ROOM, resp->message);
+                return;
+            }
+        record(w, LG_JOIN_ROOM, elapsed);
+        if (opts.rejoin && !vu->rejoined)
+        {
+            vu->rejoined = 1;
+            send_join(w, vu);
+            break;
+        }
+        vu->state = VU_WAIT_START;
+        if (++group->joined == group->size - 1 && group->members[0]->state == VU_WAIT_ROOM)
+            send_start(w, group->members[0]);
+        break;
+
+    case VU_WAIT_START:
+        if (resp->code != CODE_START_OK)
+            {
+                vu_fail(w, vu, vu->is_creator ? LG_START_EXAM : LG_START_PUSH, resp->message);
+                return;
+            }
+        if (vu->is_creator)
+            record(w, LG_START_EXAM, elapsed);
+        else
+            record(w, LG_START_PUSH, now - group->start_sent_ns);
+        {
+            // --push-exam: 150 DATA follows START_OK (GET_EXAM measures the wait for it)
+            const char *flag = strrchr(resp->message, '|');
+            if (flag && strcmp(flag + 1, START_OK_EXAM_PUSHED) == 0)
+            {
+                vu->state = VU_GET_EXAM;
+                vu->sent_ns = now;
+                break;
+            }
+            const char *params[] = {group->room_id};
+            vu_send(w, vu, VU_GET_EXAM, LG_GET_EXAM, "GET_EXAM", params, 1);
+        }
+        break;
+
+    case VU_GET_EXAM:
+        if (resp->code != CODE_EXAM_DATA || !resp->data)
+            {
+                vu_fail(w, vu, LG_GET_EXAM, resp->message);
+                return;
+            }
+        record(w, LG_GET_EXAM, elapsed);
+        vu->questions = count_questions(resp->data);
+        {
+            // think time: think_ms +/- 50%
+            uint64_t think_ms = opts.think_ms > 0 ? opts.think_ms / 2 + rand_r(&w->seed) % (opts.think_ms + 1) : 0;
+            vu->state = VU_THINK;
+            vu->timer_ns = now + think_ms * 1000000ULL;
+        }
+        break;
+
+    case VU_SUBMIT:
+        // 225: room already auto-finished (creator submitting last) - still a completed journey
+        if (resp->code != CODE_SUBMIT_OK && resp->code != CODE_ALREADY_SUBMITTED && resp->code != CODE_ROOM_FINISHED)
+            {
+                vu_fail(w, vu, LG_SUBMIT_EXAM, resp->message);
+                return;
+            }
+        record(w, LG_SUBMIT_EXAM, elapsed);
+        vu->state = VU_WAIT_FINISH;
+        if (++group->submitted == group->size)
+        {
+            for (int i = 0; i < group->size; i++)
+            {
+                if (group->members[i]->state == VU_WAIT_FINISH)
+                    send_view(w, group->members[i]);
+            }
+        }
+        break;
+
+    case VU_VIEW_RESULT:
+        if (resp->code == CODE_ROOM_IN_PROGRESS && vu->view_retries++ < LG_VIEW_MAX_RETRIES)
+        {
+            vu->state = VU_WAIT_FINISH;
+            vu->timer_ns = now + LG_VIEW_RETRY_MS * 1000000ULL;
+            break;
+        }
+        if (resp->code != CODE_RESULT_DATA)
+            {
+                vu_fail(w, vu, LG_VIEW_RESULT, resp->message);
+                return;
+            }
+        record(w, LG_VIEW_RESULT, elapsed);
+        vu_finish(w, vu, VU_DONE);
+        break;
+
+    case VU_SUBSCRIBE:
+        if (resp->code != CODE_LOBBY_PUSH)
+            {
+                vu_fail(w, vu, LG_SUBSCRIBE_LOBBY, resp->message);
+                return;
+            }
+        record(w, LG_SUBSCRIBE_LOBBY, elapsed);
+        vu->state = VU_WATCH;
+        break;
+
+    case VU_WATCH:
+        if (resp->code == CODE_LOBBY_PUSH && resp->data)
+        {
+            // queued_at_ms is wall-clock time on the server (same host, or synced clocks)
+            const char *queued = strstr(resp->data, "\"queued_at_ms\":");
+            if (queued)
+            {
+                struct timespec ts;
+                clock_gettime(CLOCK_REALTIME, &ts);
+                long long delay_ms = (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000 - atoll(queued + 15);
+                record(w, LG_LOBBY_PUSH, delay_ms > 0 ? (uint64_t)delay_ms * 1000000ULL : 0);
+            }
+            w->lobby_batches++;
+            for (const char *p = resp->data; (p = strstr(p, "\"type\"")) != NULL; p++)
+                w->lobby_events++;
+        }
+        break;
+
+    default:
+        // Unexpected push (e.g. START_OK after a failure): ignore
+        break;
+    }
+}
+
+static void on_timer(Worker *w, VirtualUser *vu)
+{
+    vu->timer_ns = 0;
+    switch (vu->state)
+    {
+    case VU_PENDING:
+        start_vu(w, vu);
+        break;
+    case VU_THINK:
+        send_submit(w, vu);
+        break;
+    case VU_WAIT_FINISH:
+        send_view(w, vu); // VIEW_RESULT retry
+        break;
+    default:
+        break;
+    }
+}
+
+static void on_readable(Worker *w, VirtualUser *vu)
+{
+    for (;;)
+    {
+        if (vu->in_len == vu->in_cap)
+        {
+            size_t cap = vu->in_cap ? vu->in_cap * 2 : LG_RECV_INITIAL;
+            char *in = cap <= LG_RECV_MAX ? realloc(vu->in, cap) : NULL;
+            if (!in)
+            {
+                vu_fail(w, vu, LG_COMMAND_COUNT, "response too large");
+                return;
+            }
+            vu->in = in;
+            vu->in_cap = cap;
+        }
+
+        ssize_t n = recv(vu->fd, vu->in + vu->in_len, vu->in_cap - vu->in_len, 0);
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+        if (n <= 0)
+        {
+            vu_fail(w, vu, LG_COMMAND_COUNT, "connection closed by server");
+            return;
+        }
+        vu->in_len += (size_t)n;
+
+        // Several responses may arrive in one read (e.g. JOIN_OK followed by START_OK)
+        size_t off = 0;
+        while (off < vu->in_len)
+        {
+            Response resp;
+            int used = client_parse_response(vu->in + off, vu->in_len - off, &resp);
+            if (used < 0)
+            {
+                vu_fail(w, vu, LG_COMMAND_COUNT, "malformed response");
+                return;
+            }
+            if (used == 0)
+                break;
+            off += (size_t)used;
+            on_response(w, vu, &resp);
+            free_response(&resp);
+            if (vu->fd < 0)
+                return;
+        }
+        memmove(vu->in, vu->in + off, vu->in_len - off);
+        vu->in_len -= off;
+    }
+}
+
+// ============================== Worker loop =================================
+
+static void *worker_main(void *arg)
+{
+    Worker *w = (Worker *)arg;
+    struct epoll_event events[256];
+    uint64_t deadline = run_start_ns + (uint64_t)opts.duration_s * 1000000000ULL;
+
+    while (w->finished < w->vu_count)
+    {
+        // Examinees of every worker are done: nothing left to watch
+        if (atomic_load(&examinees_left) == 0)
+        {
+            for (int i = 0; i < w->vu_count; i++)
+                if (w->vus[i].is_watcher)
+                    vu_finish(w, &w->vus[i], w->vus[i].state == VU_WATCH ? VU_DONE : VU_FAILED);
+            continue;
+        }
+
+        uint64_t now = now_ns();
+        if (now >= deadline)
+        {
+            for (int i = 0; i < w->vu_count; i++)
+                if (w->vus[i].state != VU_DONE && w->vus[i].state != VU_FAILED)
+                    vu_fail(w, &w->vus[i], LG_COMMAND_COUNT, "duration exceeded");
+            break;
+        }
+
+        // Fire due timers and find the next one (linear scan: cheap next to a syscall)
+        uint64_t next = deadline;
+        for (int i = 0; i < w->vu_count; i++)
+        {
+            VirtualUser *vu = &w->vus[i];
+            if (vu->timer_ns == 0)
+                continue;
+            if (vu->timer_ns <= now)
+                on_timer(w, vu);
+            else if (vu->timer_ns < next)
+                next = vu->timer_ns;
+        }
+
+        int timeout_ms = (int)((next - now) / 1000000ULL);
+        if (timeout_ms > 100)
+            timeout_ms = 100;
+
+        int n = epoll_wait(w->epoll_fd, events, 256, timeout_ms);
+        for (int i = 0; i < n; i++)
+        {
+            VirtualUser *vu = (VirtualUser *)events[i].data.ptr;
+            if (vu->fd < 0)
+                continue;
+            if (vu->state == VU_CONNECTING)
+            {
+                if (events[i].events & (EPOLLOUT | EPOLLERR | EPOLLHUP))
+                    on_connected(w, vu);
+                continue;
+            }
+            if (events[i].events & EPOLLOUT)
+            {
+                if (flush_out(w, vu) < 0)
+                {
+                    vu_fail(w, vu, LG_COMMAND_COUNT, "send failed");
+                    continue;
+                }
+            }
+            if (events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP))
+                on_readable(w, vu);
+        }
+    }
+    return NULL;
+}
+
+// ================================ Report ====================================
+
+static void print_report(Worker *workers, int count, double seconds)
+{
+    LgHistogram total[LG_COMMAND_COUNT];
+    memset(total, 0, sizeof(total));
+    uint64_t done = 0, failed = 0, lobby_batches = 0, lobby_events = 0;
+
+    for (int t = 0; t < count; t++)
+    {
+        done += workers[t].journeys_done;
+        failed += workers[t].journeys_failed;
+        lobby_batches += workers[t].lobby_batches;
+        lobby_events += workers[t].lobby_events;
+        for (int c = 0; c < LG_COMMAND_COUNT; c++)
+        {
+            LgHistogram *h = &workers[t].hist[c];
+            total[c].count += h->count;
+            total[c].errors += h->errors;
+            if (h->max_ns > total[c].max_ns)
+                total[c].max_ns = h->max_ns;
+            for (size_t b = 0; b < LG_BUCKETS; b++)
+                total[c].buckets[b] += h->buckets[b];
+        }
+    }
+
+    printf("\n=== LOADGEN REPORT ===\n");
+    printf("Duration: %.2f s, users: %d, rooms of %d, threads: %d\n", seconds, opts.users, opts.room_size, count);
+    printf("Journeys: %llu completed, %llu failed\n", (unsigned long long)done, (unsigned long long)failed);
+    if (opts.lobby > 0)
+        printf("Lobby: %d watchers, %llu batches (%.1f/s), %llu events (%.1f/s) received\n", opts.lobby,
+               (unsigned long long)lobby_batches, lobby_batches / seconds, (unsigned long long)lobby_events,
+               lobby_events / seconds);
+    printf("\n");
+    printf("%-12s %8s %7s %9s %9s %9s %9s %9s %9s\n", "command", "count", "errors", "req/s", "p50 ms", "p90 ms",
+           "p99 ms", "p99.9 ms", "max ms");
+    for (int c = 0; c < LG_COMMAND_COUNT; c++)
+    {
+        LgHistogram *h = &total[c];
+        if (h->count == 0 && h->errors == 0)
+            continue;
+        printf("%-12s %8llu %7llu %9.1f %9.2f %9.2f %9.2f %9.2f %9.2f\n", command_names[c],
+               (unsigned long long)h->count, (unsigned long long)h->errors, h->count / seconds,
+               percentile(h, 50) / 1e6, percentile(h, 90) / 1e6, percentile(h, 99) / 1e6,
+               percentile(h, 99.9) / 1e6, h->max_ns / 1e6);
+    }
+}
+
+static void print_usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --host IP        server address (default %s)\n"
+            "  --port N         server port (default %d)\n"
+            "  --users N        virtual examinees (default %d)\n"
+            "  --room-size N    users per room including the creator (default %d)\n"
+            "  --threads N      worker threads (default %d)\n"
+            "  --questions N    questions per room (default %d)\n"
+            "  --think-ms N     mean think time before SUBMIT_EXAM (default %d)\n"
+            "  --ramp-ms N      spread connections over N ms (default %d)\n"
+            "  --duration S     stop after S seconds (default %d)\n"
+            "  --prefix STR     username prefix (default %s)\n"
+            "  --no-register    accounts already exist, skip REGISTER\n"
+            "  --lobby N        lobby watchers (SUBSCRIBE_LOBBY) during the run (default %d)\n"
+            "  --rejoin         members send JOIN_ROOM twice (must still count once)\n",
+            prog, opts.host, opts.port, opts.users, opts.room_size, opts.threads, opts.questions, opts.think_ms,
+            opts.ramp_ms, opts.duration_s, opts.prefix, opts.lobby);
+}
+
+int main(int argc, char **argv)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(arg, "--no-register") == 0)
+        {
+            opts.do_register = 0;
+            continue;
+        }
+        if (strcmp(arg, "--rejoin") == 0)
+        {
+            opts.rejoin = 1;
+            continue;
+        }
+        if (!value)
+        {
+            print_usage(argv[0]);
+            return 1;
+        }
+        i++;
+        if (strcmp(arg, "--host") == 0)
+            opts.host = value;
+        else if (strcmp(arg, "--port") == 0)
+            opts.port = atoi(value);
+        else if (strcmp(arg, "--users") == 0)
+            opts.users = atoi(value);
+        else if (strcmp(arg, "--room-size") == 0)
+            opts.room_size = atoi(value);
+        else if (strcmp(arg, "--threads") == 0)
+            opts.threads = atoi(value);
+        else if (strcmp(arg, "--questions") == 0)
+            opts.questions = atoi(value);
+        else if (strcmp(arg, "--think-ms") == 0)
+            opts.think_ms = atoi(value);
+        else if (strcmp(arg, "--ramp-ms") == 0)
+            opts.ramp_ms = atoi(value);
+        else if (strcmp(arg, "--duration") == 0)
+            opts.duration_s = atoi(value);
+        else if (strcmp(arg, "--prefix") == 0)
+            opts.prefix = value;
+        else if (strcmp(arg, "--lobby") == 0)
+            opts.lobby = atoi(value);
+        else
+        {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (opts.users <= 0 || opts.room_size <= 0 || opts.threads <= 0 || opts.lobby < 0 || strlen(opts.prefix) > 10)
+    {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;
+    server_addr.sin_port = htons(opts.port);
+    if (inet_pton(AF_INET, opts.host, &server_addr.sin_addr) <= 0)
+    {
+        fprintf(stderr, "Invalid address: %s\n", opts.host);
+        return 1;
+    }
+
+    // Rooms are never split across threads: distribute whole rooms round-robin
+    int room_count = (opts.users + opts.room_size - 1) / opts.room_size;
+    if (opts.threads > room_count)
+        opts.threads = room_count;
+
+    Worker *workers = calloc(opts.threads, sizeof(Worker));
+    int vu_total = opts.users + opts.lobby;
+    VirtualUser *vus = calloc(vu_total, sizeof(VirtualUser));
+    RoomGroup *groups = calloc(room_count, sizeof(RoomGroup));
+    VirtualUser **members = calloc(opts.users, sizeof(VirtualUser *));
+    if (!workers || !vus || !groups || !members)
+    {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+
+    // Lay out VUs so each worker owns a contiguous slice of whole rooms
+    // (+ its share of the lobby watchers at the end of the slice)
+    int vu_index = 0, member_index = 0;
+    for (int t = 0; t < opts.threads; t++)
+    {
+        Worker *w = &workers[t];
+        w->id = t;
+        w->seed = (unsigned int)(time(NULL) ^ (t * 2654435761u));
+        w->epoll_fd = epoll_create1(0);
+        w->vus = &vus[vu_index];
+
+        for (int g = t; g < room_count; g += opts.threads)
+        {
+            RoomGroup *group = &groups[g];
+            int first = g * opts.room_size;
+            group->size = opts.users - first < opts.room_size ? opts.users - first : opts.room_size;
+            group->members = &members[member_index];
+
+            for (int m = 0; m < group->size; m++)
+            {
+                VirtualUser *vu = &vus[vu_index];
+                vu->fd = -1;
+                vu->index = first + m;
+                vu->is_creator = (m == 0);
+                vu->group = group;
+                snprintf(vu->username, sizeof(vu->username), "%s_%d", opts.prefix, vu->index);
+                group->members[m] = vu;
+                vu_index++;
+                member_index++;
+                w->vu_count++;
+            }
+        }
+
+        for (int j = t; j < opts.lobby; j += opts.threads)
+        {
+            VirtualUser *vu = &vus[vu_index];
+            vu->fd = -1;
+            vu->index = j;
+            vu->is_watcher = 1;
+            snprintf(vu->username, sizeof(vu->username), "%s_w%d", opts.prefix, j);
+            vu_index++;
+            w->vu_count++;
+        }
+    }
+    atomic_store(&examinees_left, opts.users);
+
+    // Ramp-up: each VU connects at its own offset
+    run_start_ns = now_ns();
+    for (int i = 0; i < vu_total; i++)
+    {
+        // Watchers subscribe before the examinees start
+        uint64_t offset = opts.users > 1 && !vus[i].is_watcher
+                              ? (uint64_t)opts.ramp_ms * 1000000ULL * vus[i].index / opts.users
+                              : 0;
+        vus[i].state = VU_PENDING;
+        vus[i].timer_ns = run_start_ns + offset + 1;
+    }
+
+    printf("loadgen: %d users in %d rooms (+%d lobby watchers) on %d threads -> %s:%d\n", opts.users, room_count,
+           opts.lobby, opts.threads, opts.host, opts.port);
+
+    for (int t = 0; t < opts.threads; t++)
+        pthread_create(&workers[t].thread, NULL, worker_main, &workers[t]);
+    for (int t = 0; t < opts.threads; t++)
+        pthread_join(workers[t].thread, NULL);
+
+    double seconds = (now_ns() - run_start_ns) / 1e9;
+    print_report(workers, opts.threads, seconds);
+
+    uint64_t failed = 0;
+    for (int t = 0; t < opts.threads; t++)
+    {
+        failed += workers[t].journeys_failed;
+        close(workers[t].epoll_fd);
+    }
+    for (int i = 0; i < vu_total; i++)
+        free(vus[i].in);
+    free(members);
+    free(groups);
+    free(vus);
+    free(workers);
+    return failed ? 2 : 0;
+}
@@ -22,6 +22,7 @@ int main()
         fprintf(stderr, "Failed to connect to server\n");
         return 1;
     }
+    client_enable_compression(&client); // older servers answer 300: DATA stays uncompressed
 
     while (running)
     {
@@ -71,6 +72,12 @@ int main()
             case 5:
                 handle_logout(&client);
                 break;
+            case 6:
+                handle_practice(&client);
+                break;
+            case 7:
+                handle_adaptive_practice(&client);
+                break;
             case 0:
                 running = 0;
                 break;
@@ -82,7 +89,6 @@ int main()
         {
             fd_set readfds; // select descriptor set
             int maxfd;
-            char buffer[BUFFER_SIZE];
 
             // PARTICIPANT (NOT CREATOR)
             if (!client.is_creator)
@@ -108,24 +114,27 @@ int main()
                     // ===== EVENT: SERVER MESSAGE =====
                     if (FD_ISSET(client.socket_fd, &readfds))
                     {
-                        int bytes = recv(client.socket_fd, buffer, sizeof(buffer) - 1, 0);
-                        if (bytes <= 0)
+                        // One message at a time: START_OK may be followed by the exam (--push-exam)
+                        Response push;
+                        if (client_receive_response(&client, &push) < 0)
                         {
                             ui_show_error("Server disconnected");
                             client.state = CLIENT_DISCONNECTED;
                             break;
                         }
 
-                        buffer[bytes] = '\0';
-
-                        if (strstr(buffer, "125 START_OK") != NULL)
+                        if (push.code == CODE_START_OK)
                         {
                             printf("\nCreator has started the exam!\n");
                             printf("Loading exam questions...\n");
 
+                            if (client_receive_pushed_exam(&client, &push) > 0)
+                                ui_show_info("Exam questions received - choose 'Get Exam Questions' to view them");
+
                             client.state = CLIENT_IN_EXAM;
                             break;
                         }
+                        free_response(&push);
                     }
 
                     // ===== EVENT: USER INPUT =====
@@ -184,6 +193,7 @@ int main()
             case 0:
                 client.state = CLIENT_AUTHENTICATED;
                 memset(client.current_room, 0, sizeof(client.current_room));
+                client_clear_exam(&client);
                 client.is_creator = 0;
                 break;
             default:
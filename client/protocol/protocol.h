@@ -22,6 +22,10 @@
 #define CODE_ROOM_LEAVE_OK 123 // Rời phòng thành công
 #define CODE_START_OK 125      // Bắt đầu thi
 #define CODE_RESULT_DATA 127   // Dữ liệu kết quả
+#define CODE_LOBBY_PUSH 129    // Thay đổi danh sách phòng (SUBSCRIBE_LOBBY)
+
+// 125 START_OK room_id|start|deadline[|EXAM]: "EXAM" = đề thi (150 DATA) gửi ngay sau (--push-exam)
+#define START_OK_EXAM_PUSHED "EXAM"
 
 // Exam & Submit Codes
 #define CODE_SUBMIT_OK 130         // Nộp bài lần đầu
@@ -35,6 +39,7 @@
 // Ping/Pong
 #define CODE_PONG 200   // Response to PING
 #define CODE_WHOAMI 201 // Trả thông tin user
+#define CODE_COMPRESS_OK 202 // Bật nén DATA cho kết nối (COMPRESS)
 
 // Authentication Errors
 #define CODE_ACCOUNT_LOCKED 211    // Tài khoản bị khóa
@@ -87,6 +92,8 @@
 #define MSG_VIEW_RESULT "VIEW_RESULT"
 #define MSG_PING "PING"
 #define MSG_WHOAMI "WHOAMI"
+#define MSG_COMPRESS "COMPRESS"
+#define MSG_SUBSCRIBE_LOBBY "SUBSCRIBE_LOBBY"
 
 // ==========================================
 // PROTOCOL CONSTANTS
@@ -102,6 +109,9 @@
 #define MAX_PARAMS 10
 #define DELIMITER '\n'
 
+// COMPRESS deflate: DATA lớn được nhận nén (zlib) dạng "CODE ZDATA <length> <raw_length>\n<data>"
+#define COMPRESS_DEFLATE "deflate"
+
 // ==========================================
 // STRUCTURES - Cấu trúc dữ liệu giao thức
 // ==========================================
@@ -45,6 +45,8 @@ void ui_print_menu_authenticated()
     printf("3. List Rooms\n");
     printf("4. View Result\n");
     printf("5. Logout\n");
+    printf("6. Practice\n");
+    printf("7. Adaptive Practice\n");
     printf("0. Exit\n");
     printf("Choice: ");
 }
@@ -169,6 +169,36 @@ CREATE TABLE activity_logs (
     INDEX idx_level (level)
 ) ENGINE=InnoDB;
 
+-- ==========================================
+-- 11. BẢNG PRACTICE_ABILITIES - Năng lực luyện tập theo chủ đề (Elo)
+-- ==========================================
+CREATE TABLE practice_abilities (
+    username VARCHAR(20) NOT NULL,
+    category VARCHAR(50) NOT NULL,
+    rating INT NOT NULL DEFAULT 1500,
+    answers INT NOT NULL DEFAULT 0,
+    updated_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP ON UPDATE CURRENT_TIMESTAMP,
+    PRIMARY KEY (username, category),
+    FOREIGN KEY (username) REFERENCES users(username) ON DELETE CASCADE
+) ENGINE=InnoDB;
+
+-- ==========================================
+-- 12. BẢNG QUESTION_STATS - Thống kê câu trả lời theo câu hỏi
+-- ==========================================
+CREATE TABLE question_stats (
+    question_id INT PRIMARY KEY,
+    attempts BIGINT NOT NULL DEFAULT 0,
+    correct_count BIGINT NOT NULL DEFAULT 0,
+    option_a BIGINT NOT NULL DEFAULT 0,
+    option_b BIGINT NOT NULL DEFAULT 0,
+    option_c BIGINT NOT NULL DEFAULT 0,
+    option_d BIGINT NOT NULL DEFAULT 0,
+    unanswered BIGINT NOT NULL DEFAULT 0,
+    time_ms_total BIGINT NOT NULL DEFAULT 0,
+    updated_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP ON UPDATE CURRENT_TIMESTAMP,
+    FOREIGN KEY (question_id) REFERENCES questions(id) ON DELETE CASCADE
+) ENGINE=InnoDB;
+
 -- ==========================================
 -- DỮ LIỆU MẪU
 -- ==========================================
@@ -315,6 +345,7 @@ DELIMITER ;
 
 -- Tạo indexes cho performance
 CREATE INDEX idx_room_status_created ON rooms(status, created_at);
+CREATE INDEX idx_room_created ON rooms(created_at, room_id);
 CREATE INDEX idx_results_room_score ON exam_results(room_id, score DESC, submit_time ASC);
 CREATE INDEX idx_sessions_active ON sessions(is_active, last_activity);
 
@@ -0,0 +1,522 @@
+#include "answers.h"
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+// File: ANSWERS_JOURNAL_MAGIC, then records
+//   AnswerRecord | room_id | username      (crc32 covers everything after crc)
+// Native byte order, like the results journal.
+#define ANSWERS_JOURNAL_MAGIC "EXAMAJ1\n"
+#define ANSWERS_JOURNAL_MAGIC_LEN 8
+
+typedef struct
+{
+    uint32_t crc;
+    uint8_t room_len;
+    uint8_t user_len;
+    uint8_t qidx;
+    uint8_t choice; // 'A'..'D'
+} AnswerRecord;
+
+typedef struct AnswerSheet
+{
+    char username[MAX_USERNAME_LEN + 1];
+    struct AnswerSheet *next;                       // room->sheets chain
+    uint64_t answered;                              // bit i = question i answered
+    uint8_t choices[ANSWERS_MAX_QUESTIONS / 4];     // 2 bits per question, A = 0 .. D = 3
+} AnswerSheet;
+
+typedef struct AnswerRoom
+{
+    char room_id[MAX_ROOM_ID_LEN];
+    struct AnswerRoom *next; // hash chain
+    pthread_mutex_t mutex;
+    int question_count; // 0 = unknown (restored from the journal)
+    int sheet_count;
+    AnswerSheet *sheets[ANSWERS_USER_BUCKETS];
+} AnswerRoom;
+
+// Lock order: rooms_lock -> room->mutex -> journal_mutex.
+// remove_room takes rooms_lock for writing, so a room in use is never freed.
+static pthread_rwlock_t rooms_lock = PTHREAD_RWLOCK_INITIALIZER;
+static AnswerRoom *rooms[ANSWERS_BUCKETS];
+
+static pthread_mutex_t journal_mutex = PTHREAD_MUTEX_INITIALIZER;
+static int journal_fd = -1;
+static off_t journal_size;
+static int sheet_total; // sheets in every room (journal truncated at 0)
+
+static unsigned int hash_string(const char *s)
+{
+    unsigned int h = 2166136261u; // FNV-1a
+    while (*s)
+    {
+        h ^= (unsigned char)*s++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// Caller holds rooms_lock
+static AnswerRoom **find_room_slot(const char *room_id)
+{
+    AnswerRoom **slot = &rooms[hash_string(room_id) % ANSWERS_BUCKETS];
+    while (*slot && strcmp((*slot)->room_id, room_id) != 0)
+        slot = &(*slot)->next;
+    return slot;
+}
+
+// Caller holds room->mutex
+static AnswerSheet **find_sheet_slot(AnswerRoom *room, const char *username)
+{
+    AnswerSheet **slot = &room->sheets[hash_string(username) % ANSWERS_USER_BUCKETS];
+    while (*slot && strcmp((*slot)->username, username) != 0)
+        slot = &(*slot)->next;
+    return slot;
+}
+
+static int sheet_choice(const AnswerSheet *sheet, int qidx)
+{
+    return (sheet->choices[qidx / 4] >> ((qidx % 4) * 2)) & 3;
+}
+
+static void sheet_set(AnswerSheet *sheet, int qidx, int choice)
+{
+    int shift = (qidx % 4) * 2;
+    sheet->choices[qidx / 4] = (uint8_t)((sheet->choices[qidx / 4] & ~(3 << shift)) | (choice << shift));
+    sheet->answered |= 1ULL << qidx;
+}
+
+// "A,-,C": total choices, ANSWERS_UNANSWERED for blanks; returns answered count
+static int sheet_format(const AnswerSheet *sheet, int total, char *out, size_t out_size)
+{
+    if (total > ANSWERS_MAX_QUESTIONS)
+        total = ANSWERS_MAX_QUESTIONS;
+    size_t pos = 0;
+    int answered = 0;
+    for (int i = 0; i < total && pos + 2 < out_size; i++)
+    {
+        if (i > 0)
+            out[pos++] = ',';
+        if (sheet->answered & (1ULL << i))
+        {
+            out[pos++] = (char)('A' + sheet_choice(sheet, i));
+            answered++;
+        }
+        else
+        {
+            out[pos++] = ANSWERS_UNANSWERED;
+        }
+    }
+    if (out_size > 0)
+        out[pos] = '\0';
+    return answered;
+}
+
+static void room_free(AnswerRoom *room)
+{
+    for (int i = 0; i < ANSWERS_USER_BUCKETS; i++)
+    {
+        while (room->sheets[i])
+        {
+            AnswerSheet *next = room->sheets[i]->next;
+            free(room->sheets[i]);
+            room->sheets[i] = next;
+        }
+    }
+    pthread_mutex_destroy(&room->mutex);
+    free(room);
+}
+
+// ===============================================
+// Journal
+// ===============================================
+
+static int write_all(int fd, const char *buf, size_t len)
+{
+    while (len > 0)
+    {
+        ssize_t written = write(fd, buf, len);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        buf += written;
+        len -= (size_t)written;
+    }
+    return 0;
+}
+
+// Caller holds journal_mutex
+static int journal_append(const char *room_id, const char *username, int qidx, char choice)
+{
+    if (journal_fd < 0)
+        return 0;
+
+    char buf[sizeof(AnswerRecord) + MAX_ROOM_ID_LEN + MAX_USERNAME_LEN + 1];
+    AnswerRecord record;
+    record.crc = 0;
+    record.room_len = (uint8_t)strlen(room_id);
+    record.user_len = (uint8_t)strlen(username);
+    record.qidx = (uint8_t)qidx;
+    record.choice = (uint8_t)choice;
+    memcpy(buf + sizeof(record), room_id, record.room_len);
+    memcpy(buf + sizeof(record) + record.room_len, username, record.user_len);
+
+    size_t len = sizeof(record) + record.room_len + record.user_len;
+    memcpy(buf, &record, sizeof(record));
+    record.crc = (uint32_t)crc32(0L, (const Bytef *)buf + sizeof(record.crc), (uInt)(len - sizeof(record.crc)));
+    memcpy(buf, &record, sizeof(record));
+
+    if (write_all(journal_fd, buf, len) < 0)
+    {
+        fprintf(stderr, "[ANSWERS] Journal write failed: %s\n", strerror(errno));
+        // Cut the partial record so later records stay readable
+        if (ftruncate(journal_fd, journal_size) < 0)
+            fprintf(stderr, "[ANSWERS] Journal truncate failed: %s\n", strerror(errno));
+        return -1;
+    }
+    journal_size += (off_t)len;
+    return 0;
+}
+
+// Caller holds journal_mutex
+static void sheets_removed(int count)
+{
+    sheet_total -= count;
+    // Nothing left to restore: start over
+    if (sheet_total == 0 && journal_fd >= 0 && journal_size > ANSWERS_JOURNAL_MAGIC_LEN &&
+        ftruncate(journal_fd, ANSWERS_JOURNAL_MAGIC_LEN) == 0)
+        journal_size = ANSWERS_JOURNAL_MAGIC_LEN;
+}
+
+// ===============================================
+// Sheets
+// ===============================================
+
+/**
+ * @brief Update (or create) a sheet; journal = 0 while replaying
+ */
+static int save_answer(const char *room_id, const char *username, int qidx, char choice, int create, int journal, int *answered_out)
+{
+    choice = (char)toupper((unsigned char)choice);
+    if (qidx < 0 || qidx >= ANSWERS_MAX_QUESTIONS || choice < 'A' || choice > 'D')
+        return ANSWERS_BAD_INDEX;
+    if (strlen(room_id) >= MAX_ROOM_ID_LEN || strlen(username) > MAX_USERNAME_LEN)
+        return ANSWERS_BAD_INDEX;
+
+    pthread_rwlock_rdlock(&rooms_lock);
+    AnswerRoom *room = *find_room_slot(room_id);
+    if (!room)
+    {
+        pthread_rwlock_unlock(&rooms_lock);
+        return ANSWERS_UNKNOWN;
+    }
+
+    pthread_mutex_lock(&room->mutex);
+    int rc = ANSWERS_OK;
+    AnswerSheet **slot = find_sheet_slot(room, username);
+    AnswerSheet *sheet = *slot;
+    if (room->question_count > 0 && qidx >= room->question_count)
+    {
+        rc = ANSWERS_BAD_INDEX;
+    }
+    else if (!sheet && !create)
+    {
+        rc = ANSWERS_UNKNOWN;
+    }
+    else if (!sheet && !(sheet = calloc(1, sizeof(AnswerSheet))))
+    {
+        rc = ANSWERS_ERROR;
+    }
+    else
+    {
+        int created = !*slot;
+        pthread_mutex_lock(&journal_mutex);
+        if (journal && journal_append(room_id, username, qidx, choice) < 0)
+        {
+            rc = ANSWERS_ERROR;
+        }
+        else
+        {
+            if (created)
+            {
+                snprintf(sheet->username, sizeof(sheet->username), "%s", username);
+                *slot = sheet;
+                room->sheet_count++;
+                sheet_total++;
+            }
+            sheet_set(sheet, qidx, choice - 'A');
+            if (answered_out)
+                *answered_out = __builtin_popcountll(sheet->answered);
+        }
+        pthread_mutex_unlock(&journal_mutex);
+        if (rc != ANSWERS_OK && created)
+            free(sheet);
+    }
+    pthread_mutex_unlock(&room->mutex);
+    pthread_rwlock_unlock(&rooms_lock);
+    return rc;
+}
+
+int answers_track_room(const char *room_id, int question_count)
+{
+    if (strlen(room_id) >= MAX_ROOM_ID_LEN || question_count > ANSWERS_MAX_QUESTIONS)
+        return -1;
+
+    pthread_rwlock_wrlock(&rooms_lock);
+    AnswerRoom **slot = find_room_slot(room_id);
+    AnswerRoom *room = *slot;
+    if (!room)
+    {
+        room = calloc(1, sizeof(AnswerRoom));
+        if (!room)
+        {
+            pthread_rwlock_unlock(&rooms_lock);
+            return -1;
+        }
+        snprintf(room->room_id, sizeof(room->room_id), "%s", room_id);
+        pthread_mutex_init(&room->mutex, NULL);
+        *slot = room;
+    }
+    if (question_count > 0)
+        room->question_count = question_count;
+    pthread_rwlock_unlock(&rooms_lock);
+    return 0;
+}
+
+int answers_save(const char *room_id, const char *username, int qidx, char choice, int create, int *answered_out)
+{
+    return save_answer(room_id, username, qidx, choice, create, 1, answered_out);
+}
+
+int answers_question_count(const char *room_id)
+{
+    pthread_rwlock_rdlock(&rooms_lock);
+    AnswerRoom *room = *find_room_slot(room_id);
+    int count = 0;
+    if (room)
+    {
+        pthread_mutex_lock(&room->mutex);
+        count = room->question_count;
+        pthread_mutex_unlock(&room->mutex);
+    }
+    pthread_rwlock_unlock(&rooms_lock);
+    return count;
+}
+
+int answers_sheet_csv(const char *room_id, const char *username, int total, char *out, size_t out_size)
+{
+    int answered = -1;
+    pthread_rwlock_rdlock(&rooms_lock);
+    AnswerRoom *room = *find_room_slot(room_id);
+    if (room)
+    {
+        pthread_mutex_lock(&room->mutex);
+        AnswerSheet *sheet = *find_sheet_slot(room, username);
+        if (sheet)
+            answered = sheet_format(sheet, total, out, out_size);
+        pthread_mutex_unlock(&room->mutex);
+    }
+    pthread_rwlock_unlock(&rooms_lock);
+    return answered;
+}
+
+AnswerSheetCopy *answers_room_sheets(const char *room_id, int total, int *count_out)
+{
+    AnswerSheetCopy *copies = NULL;
+    int count = 0;
+
+    pthread_rwlock_rdlock(&rooms_lock);
+    AnswerRoom *room = *find_room_slot(room_id);
+    if (room)
+    {
+        pthread_mutex_lock(&room->mutex);
+        if (room->sheet_count > 0 && (copies = malloc(sizeof(AnswerSheetCopy) * (size_t)room->sheet_count)))
+        {
+            for (int i = 0; i < ANSWERS_USER_BUCKETS; i++)
+            {
+                for (AnswerSheet *sheet = room->sheets[i]; sheet; sheet = sheet->next)
+                {
+                    memcpy(copies[count].username, sheet->username, sizeof(copies[count].username));
+                    sheet_format(sheet, total, copies[count].answers, sizeof(copies[count].answers));
+                    count++;
+                }
+            }
+        }
+        pthread_mutex_unlock(&room->mutex);
+    }
+    pthread_rwlock_unlock(&rooms_lock);
+
+    *count_out = count;
+    return copies;
+}
+
+void answers_discard(const char *room_id, const char *username)
+{
+    pthread_rwlock_rdlock(&rooms_lock);
+    AnswerRoom *room = *find_room_slot(room_id);
+    if (room)
+    {
+        pthread_mutex_lock(&room->mutex);
+        AnswerSheet **slot = find_sheet_slot(room, username);
+        AnswerSheet *sheet = *slot;
+        if (sheet)
+        {
+            *slot = sheet->next;
+            room->sheet_count--;
+            free(sheet);
+            pthread_mutex_lock(&journal_mutex);
+            sheets_removed(1);
+            pthread_mutex_unlock(&journal_mutex);
+        }
+        pthread_mutex_unlock(&room->mutex);
+    }
+    pthread_rwlock_unlock(&rooms_lock);
+}
+
+void answers_remove_room(const char *room_id)
+{
+    pthread_rwlock_wrlock(&rooms_lock);
+    AnswerRoom **slot = find_room_slot(room_id);
+    AnswerRoom *room = *slot;
+    if (room)
+        *slot = room->next;
+    pthread_rwlock_unlock(&rooms_lock);
+
+    if (room)
+    {
+        pthread_mutex_lock(&journal_mutex);
+        sheets_removed(room->sheet_count);
+        pthread_mutex_unlock(&journal_mutex);
+        room_free(room);
+    }
+}
+
+// ===============================================
+// Open / close
+// ===============================================
+
+/**
+ * @brief Replay the records of a previous run, drop a torn tail
+ */
+static int journal_recover(const char *path)
+{
+    struct stat st;
+    if (fstat(journal_fd, &st) < 0)
+        return -1;
+
+    if (st.st_size == 0)
+    {
+        if (write_all(journal_fd, ANSWERS_JOURNAL_MAGIC, ANSWERS_JOURNAL_MAGIC_LEN) < 0)
+            return -1;
+        journal_size = ANSWERS_JOURNAL_MAGIC_LEN;
+        return 0;
+    }
+
+    char *buf = malloc((size_t)st.st_size);
+    if (!buf)
+        return -1;
+    ssize_t got = pread(journal_fd, buf, (size_t)st.st_size, 0);
+    if (got != st.st_size || st.st_size < ANSWERS_JOURNAL_MAGIC_LEN || memcmp(buf, ANSWERS_JOURNAL_MAGIC, ANSWERS_JOURNAL_MAGIC_LEN) != 0)
+    {
+        fprintf(stderr, "[ANSWERS] %s is not an answers journal\n", path);
+        free(buf);
+        return -1;
+    }
+
+    size_t offset = ANSWERS_JOURNAL_MAGIC_LEN;
+    int replayed = 0;
+    while (offset + sizeof(AnswerRecord) <= (size_t)st.st_size)
+    {
+        AnswerRecord record;
+        memcpy(&record, buf + offset, sizeof(record));
+        size_t len = sizeof(record) + record.room_len + record.user_len;
+        if (offset + len > (size_t)st.st_size || record.room_len >= MAX_ROOM_ID_LEN || record.user_len > MAX_USERNAME_LEN ||
+            (uint32_t)crc32(0L, (const Bytef *)buf + offset + sizeof(record.crc), (uInt)(len - sizeof(record.crc))) != record.crc)
+            break;
+
+        char room_id[MAX_ROOM_ID_LEN], username[MAX_USERNAME_LEN + 1];
+        memcpy(room_id, buf + offset + sizeof(record), record.room_len);
+        room_id[record.room_len] = '\0';
+        memcpy(username, buf + offset + sizeof(record) + record.room_len, record.user_len);
+        username[record.user_len] = '\0';
+
+        // Question count unknown until the room is used again (answers_track_room)
+        answers_track_room(room_id, 0);
+        save_answer(room_id, username, record.qidx, (char)record.choice, 1, 0, NULL);
+        offset += len;
+        replayed++;
+    }
+    free(buf);
+
+    if (offset < (size_t)st.st_size)
+    {
+        fprintf(stderr, "[ANSWERS] Dropping %lld bytes of torn record at the end of %s\n",
+                (long long)(st.st_size - (off_t)offset), path);
+        if (ftruncate(journal_fd, (off_t)offset) < 0)
+            return -1;
+    }
+    journal_size = (off_t)offset;
+
+    if (replayed > 0)
+        printf("[ANSWERS] Restored %d saved answer(s) (%d sheet(s)) from %s\n", replayed, sheet_total, path);
+    return 0;
+}
+
+int answers_open_journal(const char *path)
+{
+    if (journal_fd >= 0)
+        return -1;
+    int fd = open(path, O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0600);
+    if (fd < 0)
+    {
+        fprintf(stderr, "[ANSWERS] Cannot open %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    // Called at startup before any client thread; replayed saves are not re-journaled
+    journal_fd = fd;
+    if (journal_recover(path) < 0)
+    {
+        close(fd);
+        journal_fd = -1;
+        return -1;
+    }
+    return 0;
+}
+
+void answers_close(void)
+{
+    pthread_rwlock_wrlock(&rooms_lock);
+    for (int i = 0; i < ANSWERS_BUCKETS; i++)
+    {
+        while (rooms[i])
+        {
+            AnswerRoom *next = rooms[i]->next;
+            room_free(rooms[i]);
+            rooms[i] = next;
+        }
+    }
+    pthread_rwlock_unlock(&rooms_lock);
+
+    // Sheets still in the file are restored on the next start
+    pthread_mutex_lock(&journal_mutex);
+    sheet_total = 0;
+    if (journal_fd >= 0)
+    {
+        close(journal_fd);
+        journal_fd = -1;
+    }
+    pthread_mutex_unlock(&journal_mutex);
+}
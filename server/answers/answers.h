@@ -0,0 +1,99 @@
+#ifndef ANSWERS_H
+#define ANSWERS_H
+
+#include "../protocol/protocol.h"
+#include <stddef.h>
+
+// ===============================================
+// ANSWER SHEETS - incremental autosave (SAVE_ANSWER)
+// ===============================================
+//
+// Each participant of a running exam has a packed answer sheet in memory:
+// 2 bits per choice (A..D) plus a bitmap of answered questions (24 bytes);
+// with the username and chain pointer an AnswerSheet is 56 bytes, ~64 per
+// examinee with malloc overhead. SAVE_ANSWER room|qidx|choice only touches
+// the sheet (and appends a 16-byte + strings record to the optional
+// journal), so answers reach the server during the whole exam instead of
+// all at the deadline.
+// SUBMIT_EXAM without answers and the deadline grade from the sheet.
+//
+// Journal (--answers-journal FILE): CRC-framed records replayed on startup,
+// written without fdatasync - a crash may lose the last saves, never a
+// submitted result (SUBMIT_EXAM keeps its own durability). The file is
+// truncated whenever no sheet is left.
+
+#define ANSWERS_MAX_QUESTIONS 64 // answered bitmap is a uint64_t (rooms have at most 50)
+#define ANSWERS_BUCKETS 1024     // room hash table
+#define ANSWERS_USER_BUCKETS 64  // sheets per room hash table
+#define ANSWERS_UNANSWERED '-'   // placeholder in answers_sheet_csv (graded as wrong)
+
+#define ANSWERS_OK 0
+#define ANSWERS_ERROR -1     // out of memory / journal write failed
+#define ANSWERS_UNKNOWN -2   // room or sheet not tracked (create = 0)
+#define ANSWERS_BAD_INDEX -3 // qidx outside the exam or choice not A..D
+
+/**
+ * @brief A sheet copied out of the table (deadline grading)
+ */
+typedef struct
+{
+    char username[MAX_USERNAME_LEN + 1];
+    char answers[ANSWERS_MAX_QUESTIONS * 2]; // "A,-,C,..." (answers_sheet_csv format)
+} AnswerSheetCopy;
+
+/**
+ * @brief Open (or create) the autosave journal and restore the sheets it holds
+ * @return 0 on success, -1 on error
+ */
+int answers_open_journal(const char *path);
+
+/**
+ * @brief Close the journal and drop every sheet
+ */
+void answers_close(void);
+
+/**
+ * @brief Start tracking a running room (idempotent)
+ * @param question_count Questions in the exam (bounds qidx)
+ * @return 0 on success, -1 on error
+ */
+int answers_track_room(const char *room_id, int question_count);
+
+/**
+ * @brief Record one answer
+ * @param qidx 0-based position in the GET_EXAM question list
+ * @param choice 'A'..'D'
+ * @param create 1 = create the user's sheet if missing (room must be tracked)
+ * @param answered_out Optional: questions answered so far
+ * @return ANSWERS_OK, ANSWERS_UNKNOWN, ANSWERS_BAD_INDEX or ANSWERS_ERROR
+ */
+int answers_save(const char *room_id, const char *username, int qidx, char choice, int create, int *answered_out);
+
+/**
+ * @brief Question count of a tracked room (0 = unknown, restored from the journal)
+ */
+int answers_question_count(const char *room_id);
+
+/**
+ * @brief Sheet as SUBMIT_EXAM answers: total comma-separated choices, '-' if unanswered
+ * @return Number of answered questions, -1 if the user has no sheet
+ */
+int answers_sheet_csv(const char *room_id, const char *username, int total, char *out, size_t out_size);
+
+/**
+ * @brief Copy every sheet of a room (answers_sheet_csv format)
+ * @return malloc'd array (free()), NULL if none
+ */
+AnswerSheetCopy *answers_room_sheets(const char *room_id, int total, int *count_out);
+
+/**
+ * @brief Drop a user's sheet (submitted)
+ */
+void answers_discard(const char *room_id, const char *username);
+
+/**
+ * @brief Drop every sheet of a room (finished / deleted)
+ */
+void answers_remove_room(const char *room_id);
+
+#endif // ANSWERS_H
@@ -1,5 +1,6 @@
 #include "auth.h"
 #include "../server.h"
+#include "../practice/practice.h"
 #include <openssl/sha.h>
 #include <string.h>
 #include <stdlib.h>
@@ -160,9 +161,13 @@ void handle_logout(Server *server, ClientSession *client) {
     
     printf("[LOGOUT] User '%s' logged out\n", client->username);
     
+    practice_discard(client->username);
+
     // Clear client session
     memset(client->session_id, 0, sizeof(client->session_id));
     memset(client->username, 0, sizeof(client->username));
+    memset(client->subscribed_room, 0, sizeof(client->subscribed_room));
+    client->lobby = 0;
     client->state = STATE_CONNECTED;
     
     // Send response
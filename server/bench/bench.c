@@ -0,0 +1,555 @@
+// ===============================================
+// MICROBENCHMARKS - protocol, grading and JSON builders
+// ===============================================
+//
+// Build & run: make bench            (or: bin/bench [filter] [--reps N] [--min-ms M])
+//
+// Each benchmark is calibrated (iterations doubled until one repetition takes
+// at least --min-ms), warmed up once, then run --reps times. ns/op is the
+// median repetition; min is reported to show noise.
+//
+// allocs/op, alloc B/op and copied B/op come from link-time wrappers
+// (-Wl,--wrap=..., see Makefile) around malloc/calloc/realloc/strdup and the
+// copy functions used on these paths (memcpy, strcpy, strncpy, strcat,
+// snprintf, vsnprintf, recv). "copied" counts bytes written by those calls,
+// e.g. strncpy counts its zero padding and recv counts kernel -> user bytes.
+
+#include "../protocol/protocol.h"
+#include "../database/db_json.h"
+#include "../exam/exam.h"
+#include "../room/room_id.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#define BENCH_DEFAULT_REPS 7
+#define BENCH_DEFAULT_MIN_MS 50
+#define BENCH_MAX_REPS 64
+
+// ===============================================
+// Allocation / copy accounting (link-time wrappers)
+// ===============================================
+
+static unsigned long long count_allocs = 0;
+static unsigned long long count_alloc_bytes = 0;
+static unsigned long long count_copied = 0;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+char *__real_strdup(const char *s);
+void *__real_memcpy(void *dst, const void *src, size_t n);
+char *__real_strcpy(char *dst, const char *src);
+char *__real_strncpy(char *dst, const char *src, size_t n);
+char *__real_strcat(char *dst, const char *src);
+int __real_vsnprintf(char *buf, size_t size, const char *format, va_list args);
+ssize_t __real_recv(int fd, void *buf, size_t len, int flags);
+
+void *__wrap_malloc(size_t size)
+{
+    count_allocs++;
+    count_alloc_bytes += size;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t n, size_t size)
+{
+    count_allocs++;
+    count_alloc_bytes += n * size;
+    return __real_calloc(n, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+    count_allocs++;
+    count_alloc_bytes += size;
+    return __real_realloc(ptr, size);
+}
+
+char *__wrap_strdup(const char *s)
+{
+    size_t len = strlen(s) + 1;
+    count_allocs++;
+    count_alloc_bytes += len;
+    count_copied += len;
+    return __real_strdup(s);
+}
+
+void *__wrap_memcpy(void *dst, const void *src, size_t n)
+{
+    count_copied += n;
+    return __real_memcpy(dst, src, n);
+}
+
+char *__wrap_strcpy(char *dst, const char *src)
+{
+    count_copied += strlen(src) + 1;
+    return __real_strcpy(dst, src);
+}
+
+char *__wrap_strncpy(char *dst, const char *src, size_t n)
+{
+    count_copied += n; // strncpy always writes n bytes (zero padded)
+    return __real_strncpy(dst, src, n);
+}
+
+char *__wrap_strcat(char *dst, const char *src)
+{
+    count_copied += strlen(src) + 1;
+    return __real_strcat(dst, src);
+}
+
+int __wrap_vsnprintf(char *buf, size_t size, const char *format, va_list args)
+{
+    int n = __real_vsnprintf(buf, size, format, args);
+    if (n > 0 && size > 0)
+        count_copied += (size_t)n < size ? (size_t)n + 1 : size;
+    return n;
+}
+
+int __wrap_snprintf(char *buf, size_t size, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    int n = __wrap_vsnprintf(buf, size, format, args);
+    va_end(args);
+    return n;
+}
+
+ssize_t __wrap_recv(int fd, void *buf, size_t len, int flags)
+{
+    ssize_t n = __real_recv(fd, buf, len, flags);
+    if (n > 0)
+        count_copied += (size_t)n;
+    return n;
+}
+
+// ===============================================
+// Benchmark registry
+// ===============================================
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Keeps results alive so the loops are not optimized away
+static volatile long sink;
+
+/**
+ * @brief One benchmark: run(iters) executes the operation iters times and
+ * returns the measured time in ns (so untimed setup can be excluded)
+ */
+typedef struct
+{
+    const char *name;
+    int (*setup)(void); // optional, 0 on success
+    uint64_t (*run)(long iters);
+    void (*teardown)(void); // optional
+} Bench;
+
+// ----- protocol -----
+
+static const char CONTROL_LINE[] = "SUBMIT_EXAM 1712345678|A,B,C,D,A,B,C,D,A,B,C,D,A,B,C,D,A,B,C,D\n";
+
+static uint64_t run_parse_control(long iters)
+{
+    Message msg;
+    uint64_t start = now_ns();
+    for (long i = 0; i < iters; i++)
+    {
+        parse_message(CONTROL_LINE, &msg);
+        sink += msg.param_count;
+        free_message(&msg);
+    }
+    return now_ns() - start;
+}
+
+static char data_line[64 + 1024];
+
+static int setup_parse_data(void)
+{
+    int header = snprintf(data_line, sizeof(data_line), "150 DATA %d\n", 1024);
+    memset(data_line + header, 'x', 1024);
+    data_line[header + 1024] = '\0';
+
+    Message msg;
+    if (parse_message(data_line, &msg) != 0)
+        fprintf(stderr, "note: parse_message rejects data messages, timing its error path\n");
+    free_message(&msg);
+    return 0;
+}
+
+static uint64_t run_parse_data(long iters)
+{
+    Message msg;
+    uint64_t start = now_ns();
+    for (long i = 0; i < iters; i++)
+    {
+        parse_message(data_line, &msg);
+        sink += (long)msg.data_length;
+        free_message(&msg);
+    }
+    return now_ns() - start;
+}
+
+static uint64_t run_create_control(long iters)
+{
+    const char *params[] = {"john123", "Password123"};
+    char buffer[MAX_MESSAGE_LEN];
+    uint64_t start = now_ns();
+    for (long i = 0; i < iters; i++)
+        sink += create_control_message("LOGIN", params, 2, buffer, sizeof(buffer));
+    return now_ns() - start;
+}
+
+static char data_payload[4096];
+
+static int setup_create_data(void)
+{
+    memset(data_payload, '{', sizeof(data_payload));
+    return 0;
+}
+
+static uint64_t run_create_data(long iters)
+{
+    char buffer[MAX_MESSAGE_LEN];
+    uint64_t start = now_ns();
+    for (long i = 0; i < iters; i++)
+        sink += create_data_message(CODE_EXAM_DATA, data_payload, sizeof(data_payload), buffer, sizeof(buffer));
+    return now_ns() - start;
+}
+
+// ----- recv_line over a socketpair -----
+
+#define RECV_BATCH 256 // lines queued per refill, well below the socket buffer
+
+static int pair[2] = {-1, -1};
+static char recv_batch[RECV_BATCH * sizeof(CONTROL_LINE)];
+static size_t recv_batch_len = 0;
+
+static int setup_recv_line(void)
+{
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) < 0)
+    {
+        perror("socketpair");
+        return -1;
+    }
+    recv_batch_len = 0;
+    for (int i = 0; i < RECV_BATCH; i++)
+    {
+        memcpy(recv_batch + recv_batch_len, CONTROL_LINE, sizeof(CONTROL_LINE) - 1);
+        recv_batch_len += sizeof(CONTROL_LINE) - 1;
+    }
+    return 0;
+}
+
+static uint64_t run_recv_line(long iters)
+{
+    char buffer[MAX_MESSAGE_LEN];
+    uint64_t timed = 0;
+    long done = 0;
+    while (done < iters)
+    {
+        long batch = iters - done < RECV_BATCH ? iters - done : RECV_BATCH;
+        size_t bytes = (size_t)batch * (sizeof(CONTROL_LINE) - 1);
+        if (send_full(pair[1], recv_batch, bytes) < 0) // untimed refill
+            return 0;
+
+        uint64_t start = now_ns();
+        for (long i = 0; i < batch; i++)
+            sink += recv_line(pair[0], buffer, sizeof(buffer));
+        timed += now_ns() - start;
+        done += batch;
+    }
+    return timed;
+}
+
+static void teardown_recv_line(void)
+{
+    close(pair[0]);
+    close(pair[1]);
+    pair[0] = pair[1] = -1;
+}
+
+// ----- grading (handle_submit_exam) -----
+
+static char grade_submitted[50 * 2 + 1];
+static char grade_correct[51];
+
+static int setup_grade(void)
+{
+    static const char letters[] = "ABCD";
+    size_t len = 0;
+    for (int i = 0; i < 50; i++)
+    {
+        grade_correct[i] = letters[(i * 7) % 4];
+        len += snprintf(grade_submitted + len, sizeof(grade_submitted) - len, "%s%c", i ? "," : "", letters[i % 4]);
+    }
+    grade_correct[50] = '\0';
+    return 0;
+}
+
+static uint64_t run_grade(long iters)
+{
+    int answered = 0;
+    uint64_t start = now_ns();
+    for (long i = 0; i < iters; i++)
+        sink += grade_answers(grade_submitted, grade_correct, 50, &answered);
+    return now_ns() - start;
+}
+
+// ----- JSON builders (database.c) -----
+
+#define JSON_ROOMS 50
+#define JSON_LEADERBOARD 50
+#define JSON_QUESTIONS 20
+
+static char room_cells[JSON_ROOMS][9][32];
+static char *room_rows[JSON_ROOMS][9];
+static char board_cells[JSON_LEADERBOARD][5][32];
+static char *board_rows[JSON_LEADERBOARD][5];
+static char question_cells[JSON_QUESTIONS][6][128];
+static char *question_rows[JSON_QUESTIONS][6];
+
+static int setup_json(void)
+{
+    for (int i = 0; i < JSON_ROOMS; i++)
+    {
+        snprintf(room_cells[i][0], 32, "%d", 1712345678 + i);
+        snprintf(room_cells[i][1], 32, "Room number %d", i);
+        snprintf(room_cells[i][2], 32, "user%d", i);
+        snprintf(room_cells[i][3], 32, "%s", "NOT_STARTED");
+        snprintf(room_cells[i][4], 32, "%d", i % 10);
+        snprintf(room_cells[i][5], 32, "%d", 50);
+        snprintf(room_cells[i][6], 32, "%d", 10);
+        snprintf(room_cells[i][7], 32, "%d", 30);
+        snprintf(room_cells[i][8], 32, "%s", "2024-10-01 12:34:56");
+        for (int c = 0; c < 9; c++)
+            room_rows[i][c] = room_cells[i][c];
+    }
+    for (int i = 0; i < JSON_LEADERBOARD; i++)
+    {
+        snprintf(board_cells[i][0], 32, "user%d", i);
+        snprintf(board_cells[i][1], 32, "%d", 10 - i % 10);
+        snprintf(board_cells[i][2], 32, "%d", 10);
+        snprintf(board_cells[i][3], 32, "%s", "2024-10-01 12:00:00");
+        snprintf(board_cells[i][4], 32, "%d", 60 + i);
+        for (int c = 0; c < 5; c++)
+            board_rows[i][c] = board_cells[i][c];
+    }
+    for (int i = 0; i < JSON_QUESTIONS; i++)
+    {
+        snprintf(question_cells[i][0], 128, "%d", i + 1);
+        snprintf(question_cells[i][1], 128, "What does the TCP three-way handshake establish (question %d)?", i + 1);
+        snprintf(question_cells[i][2], 128, "%s", "A reliable connection");
+        snprintf(question_cells[i][3], 128, "%s", "A routing table");
+        snprintf(question_cells[i][4], 128, "%s", "An encryption key");
+        snprintf(question_cells[i][5], 128, "%s", "A MAC address");
+        for (int c = 0; c < 6; c++)
+            question_rows[i][c] = question_cells[i][c];
+    }
+    return 0;
+}
+
+static uint64_t run_json_rooms(long iters)
+{
+    uint64_t start = now_ns();
+    for (long i = 0; i < iters; i++)
+    {
+        char *json = db_json_rooms_open();
+        for (int r = 0; r < JSON_ROOMS; r++)
+            db_json_rooms_add(json, room_rows[r]);
+        db_json_rooms_close(json);
+        sink += json[0];
+        free(json);
+    }
+    return now_ns() - start;
+}
+
+static uint64_t run_json_leaderboard(long iters)
+{
+    uint64_t start = now_ns();
+    for (long i = 0; i < iters; i++)
+    {
+        char *json = db_json_leaderboard_open();
+        for (int r = 0; r < JSON_LEADERBOARD; r++)
+            db_json_leaderboard_add(json, r + 1, board_rows[r]);
+        db_json_leaderboard_close(json);
+        sink += json[0];
+        free(json);
+    }
+    return now_ns() - start;
+}
+
+static uint64_t run_json_questions(long iters)
+{
+    uint64_t start = now_ns();
+    for (long i = 0; i < iters; i++)
+    {
+        char *json = db_json_questions_open();
+        for (int r = 0; r < JSON_QUESTIONS; r++)
+            db_json_questions_add(json, question_rows[r], r == 0);
+        db_json_questions_close(json);
+        sink += json[0];
+        free(json);
+    }
+    return now_ns() - start;
+}
+
+// ----- COMPRESS: the exam JSON above as 150 ZDATA -----
+
+static char *zdata_exam;
+static size_t zdata_exam_len;
+static char zdata_buffer[MAX_MESSAGE_LEN];
+
+static int setup_zdata(void)
+{
+    setup_json();
+    zdata_exam = db_json_questions_open();
+    for (int r = 0; r < JSON_QUESTIONS; r++)
+        db_json_questions_add(zdata_exam, question_rows[r], r == 0);
+    db_json_questions_close(zdata_exam);
+    zdata_exam_len = strlen(zdata_exam);
+    fprintf(stderr, "note: exam JSON %zu bytes -> %d bytes as ZDATA\n", zdata_exam_len,
+            create_zdata_message(CODE_EXAM_DATA, zdata_exam, zdata_exam_len, zdata_buffer, sizeof(zdata_buffer)));
+    return 0;
+}
+
+static uint64_t run_zdata(long iters)
+{
+    uint64_t start = now_ns();
+    for (long i = 0; i < iters; i++)
+        sink += create_zdata_message(CODE_EXAM_DATA, zdata_exam, zdata_exam_len, zdata_buffer, sizeof(zdata_buffer));
+    return now_ns() - start;
+}
+
+static void teardown_zdata(void)
+{
+    free(zdata_exam);
+    zdata_exam = NULL;
+}
+
+// ----- CREATE_ROOM id: room_id_next + base32 text -----
+
+static uint64_t run_room_id(long iters)
+{
+    char room_id[MAX_ROOM_ID_LEN];
+    uint64_t start = now_ns();
+    for (long i = 0; i < iters; i++)
+    {
+        room_id_format(room_id_next(), room_id);
+        sink += room_id[ROOM_ID_TEXT_LEN - 1];
+    }
+    return now_ns() - start;
+}
+
+static const Bench benches[] = {
+    {"parse_message/control", NULL, run_parse_control, NULL},
+    {"parse_message/data_1KB", setup_parse_data, run_parse_data, NULL},
+    {"create_control_message", NULL, run_create_control, NULL},
+    {"create_data_message/4KB", setup_create_data, run_create_data, NULL},
+    {"recv_line/socketpair", setup_recv_line, run_recv_line, teardown_recv_line},
+    {"grade_answers/50", setup_grade, run_grade, NULL},
+    {"json/list_rooms/50", setup_json, run_json_rooms, NULL},
+    {"json/leaderboard/50", setup_json, run_json_leaderboard, NULL},
+    {"json/exam_questions/20", setup_json, run_json_questions, NULL},
+    {"zdata_message/exam_20", setup_zdata, run_zdata, teardown_zdata},
+    {"room_id/next+format", NULL, run_room_id, NULL},
+};
+
+// ===============================================
+// Driver
+// ===============================================
+
+static int compare_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static void run_bench(const Bench *b, int reps, int min_ms)
+{
+    if (b->setup && b->setup() != 0)
+    {
+        printf("%-26s setup failed\n", b->name);
+        return;
+    }
+
+    // Calibrate: double iterations until one repetition is long enough (doubles as warmup)
+    long iters = 1;
+    uint64_t target = (uint64_t)min_ms * 1000000ULL;
+    while (b->run(iters) < target && iters < (1L << 30))
+        iters *= 2;
+    b->run(iters); // warmup at final size
+
+    uint64_t samples[BENCH_MAX_REPS];
+    unsigned long long allocs = count_allocs, alloc_bytes = count_alloc_bytes, copied = count_copied;
+    for (int r = 0; r < reps; r++)
+        samples[r] = b->run(iters);
+    allocs = count_allocs - allocs;
+    alloc_bytes = count_alloc_bytes - alloc_bytes;
+    copied = count_copied - copied;
+
+    qsort(samples, reps, sizeof(samples[0]), compare_u64);
+    double total_ops = (double)iters * reps;
+    printf("%-26s %10ld %12.1f %12.1f %10.2f %12.1f %12.1f\n",
+           b->name, iters,
+           (double)samples[reps / 2] / iters, (double)samples[0] / iters,
+           allocs / total_ops, alloc_bytes / total_ops, copied / total_ops);
+
+    if (b->teardown)
+        b->teardown();
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "Usage: %s [filter] [--reps N] [--min-ms M]\n", prog);
+    fprintf(stderr, "  filter     run only benchmarks whose name contains this string\n");
+    fprintf(stderr, "  --reps N   measured repetitions, median reported (default %d)\n", BENCH_DEFAULT_REPS);
+    fprintf(stderr, "  --min-ms M minimum duration of one repetition (default %d)\n", BENCH_DEFAULT_MIN_MS);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *filter = NULL;
+    int reps = BENCH_DEFAULT_REPS;
+    int min_ms = BENCH_DEFAULT_MIN_MS;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--reps") == 0 && i + 1 < argc)
+            reps = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--min-ms") == 0 && i + 1 < argc)
+            min_ms = atoi(argv[++i]);
+        else if (argv[i][0] == '-')
+        {
+            usage(argv[0]);
+            return 1;
+        }
+        else
+            filter = argv[i];
+    }
+    if (reps < 1 || reps > BENCH_MAX_REPS || min_ms < 1)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    printf("%-26s %10s %12s %12s %10s %12s %12s\n",
+           "benchmark", "iters", "ns/op", "min ns/op", "allocs/op", "alloc B/op", "copied B/op");
+    for (size_t i = 0; i < sizeof(benches) / sizeof(benches[0]); i++)
+    {
+        if (filter && !strstr(benches[i].name, filter))
+            continue;
+        run_bench(&benches[i], reps, min_ms);
+    }
+    return 0;
+}
@@ -0,0 +1,171 @@
+#include "capture.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+// Capture is opt-in and each record is a few bytes: one mutex around a
+// buffered FILE keeps records in global time order. A flush thread writes
+// the buffer out every CAPTURE_FLUSH_INTERVAL_MS, even when no traffic comes.
+static pthread_mutex_t capture_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t flush_cond = PTHREAD_COND_INITIALIZER;
+static pthread_t flush_thread;
+static int flush_running = 0;
+static FILE *capture_file = NULL;
+static volatile int capture_on = 0;
+static uint64_t last_us = 0; // timestamp of the previous record
+
+static uint64_t monotonic_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000;
+}
+
+static void put_varint(uint64_t value)
+{
+    unsigned char buf[10];
+    int n = 0;
+    do
+    {
+        unsigned char byte = value & 0x7f;
+        value >>= 7;
+        buf[n++] = byte | (value ? 0x80 : 0);
+    } while (value);
+    fwrite(buf, 1, n, capture_file);
+}
+
+// Caller holds capture_mutex
+static void put_header(char type, uint32_t conn_id)
+{
+    uint64_t now = monotonic_us();
+    fputc(type, capture_file);
+    put_varint(now - last_us);
+    put_varint(conn_id);
+    last_us = now;
+}
+
+static void *flush_loop(void *arg)
+{
+    (void)arg;
+    pthread_mutex_lock(&capture_mutex);
+    while (flush_running)
+    {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += (long)CAPTURE_FLUSH_INTERVAL_MS * 1000000L;
+        deadline.tv_sec += deadline.tv_nsec / 1000000000L;
+        deadline.tv_nsec %= 1000000000L;
+        pthread_cond_timedwait(&flush_cond, &capture_mutex, &deadline);
+        if (capture_file)
+            fflush(capture_file);
+    }
+    pthread_mutex_unlock(&capture_mutex);
+    return NULL;
+}
+
+int capture_open(const char *path)
+{
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0600); // contains passwords
+    if (fd < 0)
+        return -1;
+    FILE *f = fdopen(fd, "wb");
+    if (!f)
+    {
+        close(fd);
+        return -1;
+    }
+    setvbuf(f, NULL, _IOFBF, 64 * 1024);
+
+    struct timespec wall;
+    clock_gettime(CLOCK_REALTIME, &wall);
+    uint64_t start_ms = (uint64_t)wall.tv_sec * 1000ULL + (uint64_t)wall.tv_nsec / 1000000;
+    unsigned char le[8];
+    for (int i = 0; i < 8; i++)
+        le[i] = (unsigned char)(start_ms >> (8 * i));
+
+    pthread_mutex_lock(&capture_mutex);
+    capture_file = f;
+    fwrite(CAPTURE_MAGIC, 1, CAPTURE_MAGIC_LEN, f);
+    fwrite(le, 1, sizeof(le), f);
+    last_us = monotonic_us();
+    capture_on = 1;
+    flush_running = 1;
+    if (pthread_create(&flush_thread, NULL, flush_loop, NULL) != 0)
+    {
+        flush_running = 0;
+        capture_on = 0;
+        capture_file = NULL;
+        pthread_mutex_unlock(&capture_mutex);
+        fclose(f);
+        return -1;
+    }
+    pthread_mutex_unlock(&capture_mutex);
+
+    atexit(capture_close); // also runs on SIGINT/SIGTERM (main.c)
+    return 0;
+}
+
+void capture_close(void)
+{
+    pthread_mutex_lock(&capture_mutex);
+    capture_on = 0;
+    if (flush_running)
+    {
+        flush_running = 0;
+        pthread_cond_signal(&flush_cond);
+        pthread_mutex_unlock(&capture_mutex);
+        pthread_join(flush_thread, NULL);
+        pthread_mutex_lock(&capture_mutex);
+    }
+    if (capture_file)
+    {
+        fclose(capture_file);
+        capture_file = NULL;
+    }
+    pthread_mutex_unlock(&capture_mutex);
+}
+
+int capture_enabled(void)
+{
+    return capture_on;
+}
+
+void capture_connection(uint32_t conn_id, char type)
+{
+    if (!capture_on)
+        return;
+    pthread_mutex_lock(&capture_mutex);
+    if (capture_file)
+    {
+        put_header(type, conn_id);
+    }
+    pthread_mutex_unlock(&capture_mutex);
+}
+
+static void put_bytes_record(char type, uint32_t conn_id, const char *data, size_t len)
+{
+    if (!capture_on)
+        return;
+    pthread_mutex_lock(&capture_mutex);
+    if (capture_file)
+    {
+        put_header(type, conn_id);
+        put_varint(len);
+        fwrite(data, 1, len, capture_file);
+    }
+    pthread_mutex_unlock(&capture_mutex);
+}
+
+void capture_data(uint32_t conn_id, const char *data, size_t len)
+{
+    put_bytes_record(CAPTURE_DATA, conn_id, data, len);
+}
+
+void capture_room_created(uint32_t conn_id, const char *room_id)
+{
+    put_bytes_record(CAPTURE_ROOM, conn_id, room_id, strlen(room_id));
+}
@@ -0,0 +1,67 @@
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ===============================================
+// TRAFFIC CAPTURE - shared by server and tools/replay.c
+// ===============================================
+//
+// File layout:
+//   header : "EXCAPT01" (8 bytes) + u64 wall-clock start (unix ms, little endian)
+//   records: u8 type, varint delta_us (since previous record), varint conn_id
+//            'D' records add: varint len, <len bytes> (raw command line incl. '\n')
+//            'R' records add: varint len, <len bytes> (room id CREATE_ROOM returned)
+//
+// Varints are LEB128 (7 bits per byte, low bits first). Records are written
+// in time order, so replay just walks the file. Room ids are assigned by the
+// server, so replay maps the ids of 'R' records to the ones the target
+// server returns before sending commands that use them.
+//
+// NOTE: LOGIN/REGISTER lines contain plaintext passwords; capture files are
+// created with mode 0600 and should be handled like credentials.
+
+#define CAPTURE_MAGIC "EXCAPT01"
+#define CAPTURE_MAGIC_LEN 8
+
+#define CAPTURE_OPEN 'O'  // connection accepted
+#define CAPTURE_DATA 'D'  // command line received
+#define CAPTURE_CLOSE 'C' // connection closed
+#define CAPTURE_ROOM 'R'  // CREATE_ROOM answered with this room id
+
+#define CAPTURE_FLUSH_INTERVAL_MS 1000 // flush buffered records at least this often
+
+/**
+ * @brief Start capturing inbound traffic to a file
+ * @param path Capture file (truncated)
+ * @return 0 on success, -1 on error
+ */
+int capture_open(const char *path);
+
+/**
+ * @brief Flush and close the capture file
+ */
+void capture_close(void);
+
+/**
+ * @brief 1 if capture is on (cheap check before building a record)
+ */
+int capture_enabled(void);
+
+/**
+ * @brief Record a connection event (CAPTURE_OPEN / CAPTURE_CLOSE)
+ */
+void capture_connection(uint32_t conn_id, char type);
+
+/**
+ * @brief Record one inbound command line
+ */
+void capture_data(uint32_t conn_id, const char *data, size_t len);
+
+/**
+ * @brief Record the room id a CREATE_ROOM of this connection got
+ */
+void capture_room_created(uint32_t conn_id, const char *room_id);
+
+#endif // CAPTURE_H
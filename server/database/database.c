@@ -1,8 +1,16 @@
 #include "database.h"
+#include "db_backend.h"
+#include "db_journal.h"
+#include "../metrics/metrics.h"
 #include <stdio.h>
 #include <stdlib.h>
-#include <string.h>
-#include <time.h>
+
+// ===============================================
+// db_* API - dispatch to the selected backend (db_backend.h)
+// ===============================================
+//
+// Latency metrics are recorded here so all backends report the same
+// db_* histograms.
 
 int db_connect(Database *db, const char *host, const char *user, const char *password, const char *dbname)
 {
@@ -11,1033 +19,307 @@ int db_connect(Database *db, const char *host, const char *user, const char *pas
 
 int db_connect_with_port(Database *db, const char *host, const char *user, const char *password, const char *dbname, unsigned int port)
 {
-    db->conn = mysql_init(NULL);
-    if (db->conn == NULL)
-    {
-        fprintf(stderr, "mysql_init() failed\n");
-        return -1;
-    }
+    db->journal = NULL;
+#if WITH_MYSQL
+    return db_mysql_open(db, host, user, password, dbname, port);
+#else
+    (void)db;
+    (void)host;
+    (void)user;
+    (void)password;
+    (void)dbname;
+    (void)port;
+    fprintf(stderr, "MySQL backend not built (WITH_MYSQL=0), use --db %s\n", DB_BACKEND_MEMORY);
+    return -1;
+#endif
+}
 
-    // Kết nối với port cụ thể
-    if (mysql_real_connect(db->conn, host, user, password, dbname, port, NULL, 0) == NULL)
-    {
-        fprintf(stderr, "mysql_real_connect() failed: %s\n", mysql_error(db->conn));
-        mysql_close(db->conn);
-        return -1;
-    }
+int db_open_memory(Database *db, const char *seed_file)
+{
+    db->journal = NULL;
+    return db_memory_open(db, seed_file ? seed_file : DB_MEMORY_SEED_FILE);
+}
 
-    if (pthread_mutex_init(&db->mutex, NULL) != 0)
-    {
-        fprintf(stderr, "Mutex init failed\n");
-        mysql_close(db->conn);
-        return -1;
-    }
+int db_open_sqlite(Database *db, const char *path, const char *seed_file)
+{
+    db->journal = NULL;
+#if WITH_SQLITE
+    return db_sqlite_open(db, path ? path : DB_SQLITE_FILE, seed_file ? seed_file : DB_MEMORY_SEED_FILE);
+#else
+    (void)db;
+    (void)path;
+    (void)seed_file;
+    fprintf(stderr, "SQLite backend not built (WITH_SQLITE=0), use --db %s\n", DB_BACKEND_MEMORY);
+    return -1;
+#endif
+}
 
-    return 0;
+int db_enable_results_journal(Database *db, const char *path)
+{
+    db->journal = db_journal_open(db, path);
+    return db->journal ? 0 : -1;
+}
+
+const char *db_backend_name(Database *db)
+{
+    return db->backend->name;
 }
 
 void db_disconnect(Database *db)
 {
-    pthread_mutex_destroy(&db->mutex);
-    mysql_close(db->conn);
+    if (db->journal)
+    {
+        db_journal_close(db->journal);
+        db->journal = NULL;
+    }
+    db->backend->close(db->impl);
+    db->backend = NULL;
+    db->impl = NULL;
 }
 
-// ============================= User operations ===============================
+// ============================== User operations ==============================
 int db_create_user(Database *db, const char *username, const char *password_hash)
 {
-    pthread_mutex_lock(&db->mutex);
-
-    char query[512];
-    snprintf(query, sizeof(query), "INSERT INTO users (username, password_hash) VALUES ('%s', '%s')", username, password_hash);
-
-    int result = mysql_query(db->conn, query);
-    pthread_mutex_unlock(&db->mutex);
-    return result == 0 ? 0 : -1;
+    METRICS_DB_SCOPE(create_user);
+    return db->backend->create_user(db->impl, username, password_hash);
 }
 
 int db_check_username_exists(Database *db, const char *username)
 {
-    pthread_mutex_lock(&db->mutex);
-
-    char query[256];
-    snprintf(query, sizeof(query), "SELECT COUNT(*) FROM users WHERE username='%s'", username);
-
-    // conn dùng để thực hiện truy vấn MySQL
-    if (mysql_query(db->conn, query) != 0)
-    {
-        pthread_mutex_unlock(&db->mutex);
-        return -1;
-    }
-    MYSQL_RES *result = mysql_store_result(db->conn); // Lấy kết quả truy vấn
-    MYSQL_ROW row = mysql_fetch_row(result);          // Lấy dòng đầu tiên
-    int exists = atoi(row[0]) > 0;                    // Nếu > 0 thì tồn tại
-    mysql_free_result(result);
-    pthread_mutex_unlock(&db->mutex);
-    return exists;
+    METRICS_DB_SCOPE(check_username_exists);
+    return db->backend->check_username_exists(db->impl, username);
 }
 
 int db_verify_login(Database *db, const char *username, const char *password_hash)
 {
-    pthread_mutex_lock(&db->mutex);
-
-    char query[512];
-    snprintf(query, sizeof(query), "SELECT COUNT(*) FROM users WHERE username='%s' AND password_hash='%s'", username, password_hash);
-    if (mysql_query(db->conn, query) != 0)
-    {
-        pthread_mutex_unlock(&db->mutex);
-        return -1;
-    }
-    MYSQL_RES *result = mysql_store_result(db->conn);
-    MYSQL_ROW row = mysql_fetch_row(result);
-    int valid = atoi(row[0]) > 0;
-
-    mysql_free_result(result);
-    pthread_mutex_unlock(&db->mutex);
-
-    return valid;
+    METRICS_DB_SCOPE(verify_login);
+    return db->backend->verify_login(db->impl, username, password_hash);
 }
 
 int db_is_account_locked(Database *db, const char *username)
 {
-    pthread_mutex_lock(&db->mutex);
-
-    char query[256];
-    snprintf(query, sizeof(query), "SELECT is_locked FROM users WHERE username='%s'", username);
-    if (mysql_query(db->conn, query) != 0)
-    {
-        pthread_mutex_unlock(&db->mutex);
-        return -1;
-    }
-
-    MYSQL_RES *result = mysql_store_result(db->conn);
-    MYSQL_ROW row = mysql_fetch_row(result);
-    int is_locked = 0;
-    if (row != NULL)
-    {
-        is_locked = atoi(row[0]);
-    }
-
-    mysql_free_result(result);
-    pthread_mutex_unlock(&db->mutex);
-
-    return is_locked;
+    METRICS_DB_SCOPE(is_account_locked);
+    return db->backend->is_account_locked(db->impl, username);
 }
 
 // ============================ Session operations =============================
 int db_create_session(Database *db, const char *session_id, const char *username)
 {
-    pthread_mutex_lock(&db->mutex);
-
-    // Deactivate existing sessions
-    char query1[512];
-    snprintf(query1, sizeof(query1), "UPDATE sessions SET is_active = 0 WHERE username='%s'", username);
-    mysql_query(db->conn, query1);
-
-    // Create new session
-    char query2[512];
-    snprintf(query2, sizeof(query2), "INSERT INTO sessions (session_id, username) VALUES ('%s', '%s')", session_id, username);
-    int result = mysql_query(db->conn, query2);
-
-    pthread_mutex_unlock(&db->mutex);
-    return result == 0 ? 0 : -1;
+    METRICS_DB_SCOPE(create_session);
+    return db->backend->create_session(db->impl, session_id, username);
 }
 
 int db_destroy_session(Database *db, const char *session_id)
 {
-    pthread_mutex_lock(&db->mutex);
-
-    char query[512];
-    snprintf(query, sizeof(query), "UPDATE sessions SET is_active = 0 WHERE session_id='%s'", session_id);
-    int result = mysql_query(db->conn, query);
-
-    pthread_mutex_unlock(&db->mutex);
-    return result == 0 ? 0 : -1;
+    METRICS_DB_SCOPE(destroy_session);
+    return db->backend->destroy_session(db->impl, session_id);
 }
 
 int db_check_user_logged_in(Database *db, const char *username)
 {
-    pthread_mutex_lock(&db->mutex);
-
-    char query[512];
-    snprintf(query, sizeof(query), "SELECT COUNT(*) FROM sessions WHERE username='%s' AND is_active = 1", username);
-    if (mysql_query(db->conn, query) != 0)
-    {
-        pthread_mutex_unlock(&db->mutex);
-        return -1;
-    }
-
-    MYSQL_RES *result = mysql_store_result(db->conn);
-    MYSQL_ROW row = mysql_fetch_row(result);
-    int logged_in = atoi(row[0]) > 0;
-
-    mysql_free_result(result);
-    pthread_mutex_unlock(&db->mutex);
-
-    return logged_in;
+    METRICS_DB_SCOPE(check_user_logged_in);
+    return db->backend->check_user_logged_in(db->impl, username);
 }
 
-// =============================== Logging =====================================
+// ================================== Logging ==================================
 void db_log_activity(Database *db, const char *level, const char *username, const char *action, const char *details)
 {
-    pthread_mutex_lock(&db->mutex);
-
-    char query[2048];
-    char safe_details[1024] = {0};
-
-    if (details)
-    {
-        mysql_real_escape_string(db->conn, safe_details, details, strlen(details));
-    }
-
-    snprintf(query, sizeof(query),
-             "INSERT INTO activity_logs (level, username, action, details) "
-             "VALUES ('%s', '%s', '%s', '%s')",
-             level, username ? username : "SYSTEM", action, safe_details);
-
-    if (mysql_query(db->conn, query) != 0)
-    {
-        fprintf(stderr, "Failed to log activity: %s\n", mysql_error(db->conn));
-    }
-    pthread_mutex_unlock(&db->mutex);
+    METRICS_DB_SCOPE(log_activity);
+    db->backend->log_activity(db->impl, level, username, action, details);
 }
 
-// ============================= Room operations ===============================
+// ============================== Room operations ==============================
 int db_create_room(Database *db, const char *room_id, const char *room_name, const char *creator, int num_questions, int time_limit)
 {
-    pthread_mutex_lock(&db->mutex);
-
-    // Start transaction
-    if (mysql_query(db->conn, "START TRANSACTION"))
-    {
-        fprintf(stderr, "[DB ERROR] Failed to start transaction: %s\n", mysql_error(db->conn));
-        pthread_mutex_unlock(&db->mutex);
-        return -1;
-    }
-
-    // Insert room (max_participants will use default value from schema)
-    char query1[512];
-    snprintf(query1, sizeof(query1),
-             "INSERT INTO rooms (room_id, room_name, creator, num_questions, time_limit_minutes) "
-             "VALUES ('%s', '%s', '%s', %d, %d)",
-             room_id, room_name, creator, num_questions, time_limit);
-
-    if (mysql_query(db->conn, query1))
-    {
-        fprintf(stderr, "[DB ERROR] Failed to create room: %s\n", mysql_error(db->conn));
-        mysql_query(db->conn, "ROLLBACK");
-        pthread_mutex_unlock(&db->mutex);
-        return -1;
-    }
-
-    // Select random questions and insert into room_questions
-    char query2[1024];
-    snprintf(query2, sizeof(query2),
-             "INSERT INTO room_questions (room_id, question_id, question_order) "
-             "SELECT '%s', id, (@row_number := @row_number + 1) "
-             "FROM questions, (SELECT @row_number := 0) AS t "
-             "ORDER BY RAND() LIMIT %d",
-             room_id, num_questions);
-
-    if (mysql_query(db->conn, query2))
-    {
-        fprintf(stderr, "[DB ERROR] Failed to assign questions: %s\n", mysql_error(db->conn));
-        mysql_query(db->conn, "ROLLBACK");
-        pthread_mutex_unlock(&db->mutex);
-        return -1;
-    }
-
-    // Creator auto joins, add user to participants table
-    char query3[512];
-    snprintf(query3, sizeof(query3),
-             "INSERT INTO participants (room_id, username) VALUES ('%s', '%s')",
-             room_id, creator);
-
-    if (mysql_query(db->conn, query3))
-    {
-        fprintf(stderr, "[DB ERROR] Failed to add creator as participant: %s\n", mysql_error(db->conn));
-        mysql_query(db->conn, "ROLLBACK");
-        pthread_mutex_unlock(&db->mutex);
-        return -1;
-    }
-
-    // Commit transaction
-    if (mysql_query(db->conn, "COMMIT"))
-    {
-        fprintf(stderr, "[DB ERROR] Failed to commit transaction: %s\n", mysql_error(db->conn));
-        mysql_query(db->conn, "ROLLBACK");
-        pthread_mutex_unlock(&db->mutex);
-        return -1;
-    }
-
-    pthread_mutex_unlock(&db->mutex);
-
-    printf("[DB] Room '%s' created with %d random questions assigned\n", room_id, num_questions);
-    return 0;
+    METRICS_DB_SCOPE(create_room);
+    return db->backend->create_room(db->impl, room_id, room_name, creator, num_questions, time_limit);
 }
 
 char *db_list_rooms(Database *db, const char *status_filter)
 {
-    pthread_mutex_lock(&db->mutex);
-
-    char query[1024];
-    if (strcmp(status_filter, "ALL") == 0)
-    {
-        snprintf(query, sizeof(query),
-                 "SELECT r.room_id, r.room_name, r.creator, r.status, "
-                 "COALESCE(COUNT(p.username), 0) as participant_count, "
-                 "r.max_participants, r.num_questions, r.time_limit_minutes, r.created_at "
-                 "FROM rooms r LEFT JOIN participants p ON r.room_id = p.room_id "
-                 "GROUP BY r.room_id ORDER BY r.created_at DESC");
-    }
-    else
-    {
-        snprintf(query, sizeof(query),
-                 "SELECT r.room_id, r.room_name, r.creator, r.status, "
-                 "COALESCE(COUNT(p.username), 0) as participant_count, "
-                 "r.max_participants, r.num_questions, r.time_limit_minutes, r.created_at "
-                 "FROM rooms r LEFT JOIN participants p ON r.room_id = p.room_id "
-                 "WHERE r.status='%s' "
-                 "GROUP BY r.room_id ORDER BY r.created_at DESC",
-                 status_filter);
-    }
-
-    if (mysql_query(db->conn, query)) // Execute query, if error(mysql_query return non-zero), return NULL
-    {
-        pthread_mutex_unlock(&db->mutex);
-        return NULL;
-    }
-
-    // Retrieve results, mysql_store_result fetches the result set from the last query
-    MYSQL_RES *result = mysql_store_result(db->conn);
-    if (!result)
-    {
-        pthread_mutex_unlock(&db->mutex);
-        return NULL;
-    }
-
-    // Build JSON
-    char *json = malloc(16384);
-    strcpy(json, "{\n  \"rooms\": [\n");
-
-    MYSQL_ROW row; // Fetch each row from the result set
-    while ((row = mysql_fetch_row(result)))
-    {
-        char room_entry[512]; // Temporary buffer for each room entry
-        // row[0]=room_id, row[1]=room_name, row[2]=creator, row[3]=status,
-        // row[4]=participant_count, row[5]=max_participants, row[6]=num_questions,
-        // row[7]=time_limit_minutes, row[8]=created_at
-        snprintf(room_entry, sizeof(room_entry),
-                 "{\"room_id\":\"%s\",\"room_name\":\"%s\",\"creator\":\"%s\","
-                 "\"status\":\"%s\",\"participant_count\":%s,\"max_participants\":%s,"
-                 "\"num_questions\":%s,\"time_limit_minutes\":%s,\"created_at\":\"%s\"},",
-                 row[0], row[1], row[2], row[3], row[4], row[5], row[6], row[7], row[8]);
-        strcat(json, room_entry); // Append room entry to JSON
-        strcat(json, "\n");
-    }
-
-    strcat(json, "  ]\n}");
-    // json:
-    // {
-    //   "rooms": [
-    //     {
-    //       "room_id": "1234567890",
-    //       "room_name": "Sample Room",
-    //       "creator": "user1",
-    //       "status": "NOT_STARTED",
-    //       "participant_count": 5,
-    //       "max_participants": 10,
-    //       "num_questions": 20,
-    //       "time_limit_minutes": 15,
-    //       "created_at": "2024-10-01 12:34:56"
-    //     },
-    //     ...
-    //   ]
-    // }
+    METRICS_DB_SCOPE(list_rooms);
+    return db->backend->list_rooms(db->impl, status_filter);
+}
 
-    mysql_free_result(result); // Free the result set to avoid memory leaks
-    pthread_mutex_unlock(&db->mutex);
+int db_get_rooms(Database *db, const char *const *room_ids, int count, DbRoomRowFn fn, void *ctx)
+{
+    METRICS_DB_SCOPE(get_rooms);
+    return db->backend->get_rooms(db->impl, room_ids, count, fn, ctx);
+}
 
-    return json;
+int db_list_rooms_page(Database *db, const DbRoomPage *page, DbRoomRowFn fn, void *ctx)
+{
+    METRICS_DB_SCOPE(list_rooms_page);
+    return db->backend->list_rooms_page(db->impl, page, fn, ctx);
 }
 
-/**
- * @brief Add user to room participants
- * @param db Pointer to Database
- * @param room_id Room ID
- * @param username Username to add
- * @return 0 on success, -1 on failure
- */
 int db_join_room(Database *db, const char *room_id, const char *username)
 {
-    pthread_mutex_lock(&db->mutex);
-
-    char query[512];
-    snprintf(query, sizeof(query),
-             "INSERT IGNORE INTO participants (room_id, username) VALUES ('%s', '%s')", room_id, username);
-    // Use INSERT IGNORE to avoid duplicate entries
-
-    int result = mysql_query(db->conn, query);
-
-    pthread_mutex_unlock(&db->mutex);
-    return result == 0 ? 0 : -1; // Return 0 on success, -1 on failure
+    METRICS_DB_SCOPE(join_room);
+    return db->backend->join_room(db->impl, room_id, username);
 }
 
-/**
- * @brief Get room status
- * @param db Pointer to Database
- * @param room_id Room ID
- * @return Room status as integer (0=NOT_STARTED, 1=IN_PROGRESS, 2=FINISHED), -1 on error
- */
 int db_get_room_status(Database *db, const char *room_id)
 {
-    pthread_mutex_lock(&db->mutex);
-
-    char query[256];
-    snprintf(query, sizeof(query), "SELECT status FROM rooms WHERE room_id='%s'", room_id);
-
-    if (mysql_query(db->conn, query))
-    {
-        pthread_mutex_unlock(&db->mutex);
-        return -1;
-    }
-
-    MYSQL_RES *result = mysql_store_result(db->conn);
-    if (!result)
-    {
-        pthread_mutex_unlock(&db->mutex);
-        return -1;
-    }
-
-    MYSQL_ROW row = mysql_fetch_row(result);
-    int status = -1;
-
-    if (row)
-    {
-        if (strcmp(row[0], "NOT_STARTED") == 0)
-            status = 0;
-        else if (strcmp(row[0], "IN_PROGRESS") == 0)
-            status = 1;
-        else if (strcmp(row[0], "FINISHED") == 0)
-            status = 2;
-    }
-
-    mysql_free_result(result);
-    pthread_mutex_unlock(&db->mutex);
-
-    return status;
+    METRICS_DB_SCOPE(get_room_status);
+    return db->backend->get_room_status(db->impl, room_id);
 }
 
-/**
- * @brief Get number of participants in a room
- * @param db Pointer to Database
- * @param room_id Room ID
- * @return Number of participants, -1 on error
- */
 int db_get_room_participant_count(Database *db, const char *room_id)
 {
-    pthread_mutex_lock(&db->mutex);
-
-    char query[256];
-    snprintf(query, sizeof(query),
-             "SELECT COUNT(*) FROM participants WHERE room_id='%s'", room_id);
-
-    if (mysql_query(db->conn, query))
-    {
-        pthread_mutex_unlock(&db->mutex);
-        return -1;
-    }
-
-    MYSQL_RES *result = mysql_store_result(db->conn);
-    if (!result)
-    {
-        pthread_mutex_unlock(&db->mutex);
-        return -1;
-    }
-
-    MYSQL_ROW row = mysql_fetch_row(result);
-
-    // If row is NULL, return 0 participants
-    int count = row ? atoi(row[0]) : 0;
-
-    mysql_free_result(result);
-    pthread_mutex_unlock(&db->mutex);
+    METRICS_DB_SCOPE(get_room_participant_count);
+    return db->backend->get_room_participant_count(db->impl, room_id);
+}
 
-    return count;
+int db_get_room_time_limit(Database *db, const char *room_id)
+{
+    METRICS_DB_SCOPE(get_room_time_limit);
+    return db->backend->get_room_time_limit(db->impl, room_id);
 }
 
-/**
- * @brief Get leaderboard for room
- * @param db Database structure
- * @param room_id Room ID
- * @return JSON string with leaderboard (must be freed), NULL on error
- */
+// ============================== Exam operations ==============================
 char *db_get_room_leaderboard(Database *db, const char *room_id)
 {
-    pthread_mutex_lock(&db->mutex);
-
-    char query[1024];
-    snprintf(query, sizeof(query),
-             "SELECT username, score, total_questions, submit_time, time_taken_seconds "
-             "FROM exam_results WHERE room_id='%s' "
-             "ORDER BY score DESC, submit_time ASC",
-             room_id);
-
-    if (mysql_query(db->conn, query))
-    {
-        pthread_mutex_unlock(&db->mutex);
-        return NULL;
-    }
-
-    MYSQL_RES *result = mysql_store_result(db->conn);
-    if (!result)
-    {
-        pthread_mutex_unlock(&db->mutex);
-        return NULL;
-    }
-
-    // Build JSON
-    // json: {"leaderboard":[{"rank":1,"username":"user1","score":8,"total":10,"submit_time":"2024-10-01 12:00:00", "time_taken":120},...]}
-    char *json = malloc(16384);
-    strcpy(json, "{\n  \"leaderboard\":[\n");
-
-    MYSQL_ROW row;
-    int rank = 1;
-    while ((row = mysql_fetch_row(result)))
-    {
-        char entry[512];
-        snprintf(entry, sizeof(entry),
-                 "{\"rank\":%d,\"username\":\"%s\",\"score\":%s,"
-                 "\"total\":%s,\"submit_time\":\"%s\",\"time_taken\":%s},",
-                 rank++, row[0], row[1], row[2], row[3], row[4]);
-        strcat(json, "    ");
-        strcat(json, entry);
-        strcat(json, "\n");
-    }
-
-    strcat(json, "]}");
-
-    mysql_free_result(result);
-    pthread_mutex_unlock(&db->mutex);
-
-    return json;
+    METRICS_DB_SCOPE(get_room_leaderboard);
+    if (db->journal)
+        db_journal_sync_room(db->journal, room_id);
+    return db->backend->get_room_leaderboard(db->impl, room_id);
 }
 
-/**
- * @brief Get exam questions for a room (without correct answers for security)
- * @param db Pointer to Database
- * @param room_id Room ID
- * @return JSON string with questions array, NULL on error
- *
- * Format: {"questions":[{"question_id":1,"content":"...","options":["A","B","C","D"]},...]}}
- * IMPORTANT: NEVER include "correct_answer" field!
- */
 char *db_get_exam_questions(Database *db, const char *room_id)
 {
-    pthread_mutex_lock(&db->mutex);
-
-    // Query to get questions for this room
-    // Join room_questions with questions table to get full question data
-    char query[2048];
-    snprintf(query, sizeof(query),
-             "SELECT q.id, q.question_text, q.option_a, q.option_b, q.option_c, q.option_d "
-             "FROM room_questions rq "
-             "JOIN questions q ON rq.question_id = q.id "
-             "WHERE rq.room_id='%s' "
-             "ORDER BY rq.question_order ASC",
-             room_id);
-
-    if (mysql_query(db->conn, query))
-    {
-        fprintf(stderr, "db_get_exam_questions query failed: %s\n", mysql_error(db->conn));
-        pthread_mutex_unlock(&db->mutex);
-        return NULL;
-    }
-
-    MYSQL_RES *result = mysql_store_result(db->conn);
-    if (!result)
-    {
-        fprintf(stderr, "db_get_exam_questions mysql_store_result failed\n");
-        pthread_mutex_unlock(&db->mutex);
-        return NULL;
-    }
-
-    // Build JSON response with questions
-    char *json = malloc(1024 * 1024); // 1MB buffer for exam data
-    if (!json)
-    {
-        mysql_free_result(result);
-        pthread_mutex_unlock(&db->mutex);
-        return NULL;
-    }
-
-    strcpy(json, "{\n  \"questions\": [\n");
-
-    MYSQL_ROW row;
-    int first = 1;
-    while ((row = mysql_fetch_row(result)))
-    {
-        if (!first)
-            strcat(json, ",\n");
-        first = 0;
-
-        // Escape special characters in options for JSON
-        char opt_a[256], opt_b[256], opt_c[256], opt_d[256];
-        snprintf(opt_a, sizeof(opt_a), "A. %s", row[2]);
-        snprintf(opt_b, sizeof(opt_b), "B. %s", row[3]);
-        snprintf(opt_c, sizeof(opt_c), "C. %s", row[4]);
-        snprintf(opt_d, sizeof(opt_d), "D. %s", row[5]);
-
-        // Build question entry with proper formatting
-        char entry[4096];
-        snprintf(entry, sizeof(entry),
-                 "    {\n"
-                 "      \"question_id\": %s,\n"
-                 "      \"content\": \"%s\",\n"
-                 "      \"options\": [\n"
-                 "        \"%s\",\n"
-                 "        \"%s\",\n"
-                 "        \"%s\",\n"
-                 "        \"%s\"\n"
-                 "      ]\n"
-                 "    }",
-                 row[0], // question_id
-                 row[1], // question_text (content)
-                 opt_a, opt_b, opt_c, opt_d);
-
-        strcat(json, entry);
-    }
-
-    strcat(json, "\n  ]\n}");
-
-    mysql_free_result(result);
-    pthread_mutex_unlock(&db->mutex);
-
-    return json;
+    METRICS_DB_SCOPE(get_exam_questions);
+    return db->backend->get_exam_questions(db->impl, room_id);
 }
 
-/**
- * @brief Remove user from room participants
- * @param db Pointer to Database
- * @param room_id Room ID
- * @param username Username to remove
- * @return 0 on success, -1 on failure
- */
 int db_leave_room(Database *db, const char *room_id, const char *username)
 {
-    pthread_mutex_lock(&db->mutex);
-
-    char query[512];
-    snprintf(query, sizeof(query), "DELETE FROM participants WHERE room_id='%s' AND username='%s'", room_id, username);
-
-    int result = mysql_query(db->conn, query);
-
-    pthread_mutex_unlock(&db->mutex);
-    return result == 0 ? 0 : -1;
+    METRICS_DB_SCOPE(leave_room);
+    return db->backend->leave_room(db->impl, room_id, username);
 }
 
-/**
- * @brief Start a room exam (change status from NOT_STARTED to IN_PROGRESS)
- * @param db Pointer to Database
- * @param room_id Room ID
- * @return 0 on success, -1 on failure
- */
 int db_start_room(Database *db, const char *room_id)
 {
-    pthread_mutex_lock(&db->mutex);
-
-    char query[512];
-
-    // Update room status to IN_PROGRESS and set start_time to NOW()
-    snprintf(query, sizeof(query), "UPDATE rooms SET status='IN_PROGRESS', start_time=NOW() WHERE room_id='%s'", room_id);
-
-    int result = mysql_query(db->conn, query);
-
-    pthread_mutex_unlock(&db->mutex);
-    return result == 0 ? 0 : -1;
+    METRICS_DB_SCOPE(start_room);
+    return db->backend->start_room(db->impl, room_id);
 }
 
-/**
- * @brief Finish a room exam (change status to FINISHED)
- * @param db Pointer to Database
- * @param room_id Room ID
- * @return 0 on success, -1 on failure
- */
 int db_finish_room(Database *db, const char *room_id)
 {
-    pthread_mutex_lock(&db->mutex);
-
-    char query[512];
-    snprintf(query, sizeof(query),
-             "UPDATE rooms SET status='FINISHED', finish_time=NOW() WHERE room_id='%s'",
-             room_id);
-
-    int result = mysql_query(db->conn, query);
-
-    pthread_mutex_unlock(&db->mutex);
-
-    if (result == 0)
-    {
-        printf("[DB] Room '%s' marked as FINISHED\n", room_id);
-    }
-
-    return result == 0 ? 0 : -1;
+    METRICS_DB_SCOPE(finish_room);
+    return db->backend->finish_room(db->impl, room_id);
 }
 
-/**
- * @brief Check if user is the creator of a room
- * @param db Pointer to Database
- * @param room_id Room ID
- * @param username Username to check
- * @return 1 if user is creator, 0 otherwise
- */
 int db_is_room_creator(Database *db, const char *room_id, const char *username)
 {
-    pthread_mutex_lock(&db->mutex);
-
-    char query[256];
-    snprintf(query, sizeof(query), "SELECT COUNT(*) FROM rooms WHERE room_id='%s' AND creator='%s'", room_id, username);
-
-    if (mysql_query(db->conn, query))
-    {
-        pthread_mutex_unlock(&db->mutex);
-        return 0;
-    }
-
-    MYSQL_RES *result = mysql_store_result(db->conn);
-    if (!result)
-    {
-        pthread_mutex_unlock(&db->mutex);
-        return 0;
-    }
-
-    MYSQL_ROW row = mysql_fetch_row(result);
-    int is_creator = row ? (atoi(row[0]) > 0) : 0; // If count > 0, user is creator
-
-    mysql_free_result(result);
-    pthread_mutex_unlock(&db->mutex);
-
-    return is_creator;
+    METRICS_DB_SCOPE(is_room_creator);
+    return db->backend->is_room_creator(db->impl, room_id, username);
 }
 
-/**
- * @brief Check if user is a participant in room
- * @param db Pointer to Database
- * @param room_id Room ID
- * @param username Username to check
- * @return 1 if user is participant, 0 otherwise
- */
 int db_is_participant(Database *db, const char *room_id, const char *username)
 {
-    pthread_mutex_lock(&db->mutex);
-
-    char query[256];
-    snprintf(query, sizeof(query), "SELECT COUNT(*) FROM participants WHERE room_id='%s' AND username='%s'", room_id, username);
-
-    if (mysql_query(db->conn, query))
-    {
-        pthread_mutex_unlock(&db->mutex);
-        return 0;
-    }
-
-    MYSQL_RES *result = mysql_store_result(db->conn);
-    if (!result)
-    {
-        pthread_mutex_unlock(&db->mutex);
-        return 0;
-    }
-
-    MYSQL_ROW row = mysql_fetch_row(result);    // Fetch the first row from result, which contains the count
-    int in_room = row ? (atoi(row[0]) > 0) : 0; // If count > 0, user is in room
-
-    mysql_free_result(result);
-    pthread_mutex_unlock(&db->mutex);
-
-    return in_room;
+    METRICS_DB_SCOPE(is_participant);
+    return db->backend->is_participant(db->impl, room_id, username);
 }
 
-/**
- * @brief Delete a room and all its related data
- * @param db Pointer to Database
- * @param room_id Room ID to delete
- * @return 0 on success, -1 on error
- *
- * NOTE: This will cascade delete:
- * - All participants in room_participants (ON DELETE CASCADE)
- * - All room_questions (ON DELETE CASCADE)
- * - All exam_results (ON DELETE CASCADE)
- */
 int db_delete_room(Database *db, const char *room_id)
 {
-    pthread_mutex_lock(&db->mutex);
-
-    char query[256];
-    snprintf(query, sizeof(query), "DELETE FROM rooms WHERE room_id='%s'", room_id);
-
-    if (mysql_query(db->conn, query))
-    {
-        fprintf(stderr, "[DB ERROR] Failed to delete room '%s': %s\n", room_id, mysql_error(db->conn));
-        pthread_mutex_unlock(&db->mutex);
-        return -1;
-    }
-
-    int affected = mysql_affected_rows(db->conn); // Check if any row was deleted
-    pthread_mutex_unlock(&db->mutex);
-
-    if (affected == 0) // No room found with given ID
-    {
-        fprintf(stderr, "[DB WARNING] Room '%s' not found for deletion\n", room_id);
-        return -1;
-    }
-
-    printf("[DB] Room '%s' deleted successfully (cascaded to participants, questions, results)\n", room_id);
-    return 0;
+    METRICS_DB_SCOPE(delete_room);
+    return db->backend->delete_room(db->impl, room_id);
 }
 
-// ==========================================
-// SUBMIT EXAM OPERATIONS
-// ==========================================
-
-/**
- * @brief Get correct answers for a room
- * @param db Database pointer
- * @param room_id Room ID
- * @param answers_out Buffer to store answers (e.g., "ABCDABCD...")
- * @param total_out Pointer to store total number of questions
- * @return 0 on success, -1 on error
- * Flow:
- * 1. Query room_questions joined with questions to get correct answers
- * 2. Store answers in answers_out as a string of characters
- * 3. Set total_out to number of questions
- */
-int db_get_correct_answers(Database *db, const char *room_id, char *answers_out, int *total_out)
-{
-    pthread_mutex_lock(&db->mutex);
-
-    char query[1024];
-    snprintf(query, sizeof(query),
-             "SELECT q.correct_answer FROM room_questions rq "
-             "JOIN questions q ON rq.question_id = q.id "
-             "WHERE rq.room_id = '%s' ORDER BY rq.question_order",
-             room_id);
-
-    if (mysql_query(db->conn, query))
-    {
-        fprintf(stderr, "[DB ERROR] Failed to get correct answers: %s\n", mysql_error(db->conn));
-        pthread_mutex_unlock(&db->mutex);
-        return -1;
-    }
-
-    MYSQL_RES *result = mysql_store_result(db->conn);
-    if (!result)
-    {
-        fprintf(stderr, "[DB ERROR] Failed to store result: %s\n", mysql_error(db->conn));
-        pthread_mutex_unlock(&db->mutex);
-        return -1;
-    }
-
-    MYSQL_ROW row;
-    int count = 0;
-    while ((row = mysql_fetch_row(result)))
-    {
-        answers_out[count++] = row[0][0]; // Get first character (A, B, C, or D)
-    }
-    answers_out[count] = '\0'; // Null-terminate the string
-
-    *total_out = count; // Set total number of questions
-
-    mysql_free_result(result);
-    pthread_mutex_unlock(&db->mutex);
-
-    return 0;
-}
-
-/**
- * @brief Submit exam answers and calculate score
- * @param db Database pointer
- * @param room_id Room ID
- * @param username Username
- * @param score Score achieved
- * @param total Total questions
- * @param answers User's answers (comma-separated: A,B,C,D...)
- * @param time_taken Time taken in seconds
- * @return 0 on success, -1 on error
- */
+// ========================== Submit exam operations ===========================
 int db_submit_exam(Database *db, const char *room_id, const char *username, int score, int total, const char *answers, int time_taken)
 {
-    pthread_mutex_lock(&db->mutex);
-
-    // Escape the answers string to prevent SQL injection
-    char escaped_answers[4096];
-    mysql_real_escape_string(db->conn, escaped_answers, answers, strlen(answers));
-
-    char query[8192];
-    snprintf(query, sizeof(query),
-             "INSERT INTO exam_results (room_id, username, score, total_questions, "
-             "answers, time_taken_seconds) VALUES ('%s', '%s', %d, %d, '%s', %d)",
-             room_id, username, score, total, escaped_answers, time_taken);
-
-    if (mysql_query(db->conn, query))
-    {
-        fprintf(stderr, "[DB ERROR] Failed to submit exam: %s\n", mysql_error(db->conn));
-        pthread_mutex_unlock(&db->mutex);
-        return -1;
-    }
-
-    pthread_mutex_unlock(&db->mutex);
-    printf("[DB] Exam submitted for user '%s' in room '%s': %d/%d\n", username, room_id, score, total);
-
-    return 0;
+    METRICS_DB_SCOPE(submit_exam);
+    if (db->journal) // acknowledged once journaled, committed by the flusher
+        return db_journal_append(db->journal, room_id, username, score, total, answers, time_taken);
+    return db->backend->submit_exam(db->impl, room_id, username, score, total, answers, time_taken);
 }
 
-/**
- * @brief Check if user already submitted exam for this room
- * @param db Database pointer
- * @param room_id Room ID
- * @param username Username
- * @return 1 if submitted, 0 if not
- */
 int db_check_already_submitted(Database *db, const char *room_id, const char *username)
 {
-    pthread_mutex_lock(&db->mutex);
-
-    char query[512];
-    snprintf(query, sizeof(query),
-             "SELECT COUNT(*) FROM exam_results WHERE room_id='%s' AND username='%s'",
-             room_id, username);
-
-    if (mysql_query(db->conn, query))
-    {
-        fprintf(stderr, "[DB ERROR] Failed to check submission: %s\n", mysql_error(db->conn));
-        pthread_mutex_unlock(&db->mutex);
-        return 0;
-    }
-
-    MYSQL_RES *result = mysql_store_result(db->conn);
-    if (!result)
-    {
-        pthread_mutex_unlock(&db->mutex);
-        return 0;
-    }
-
-    MYSQL_ROW row = mysql_fetch_row(result);
-    int submitted = row ? (atoi(row[0]) > 0) : 0;
-
-    mysql_free_result(result);
-    pthread_mutex_unlock(&db->mutex);
-
-    return submitted;
+    METRICS_DB_SCOPE(check_already_submitted);
+    if (db->journal && db_journal_find(db->journal, room_id, username, NULL, NULL))
+        return 1;
+    return db->backend->check_already_submitted(db->impl, room_id, username);
 }
 
-/**
- * @brief Get exam result for user
- * @param db Database pointer
- * @param room_id Room ID
- * @param username Username
- * @return String with score (e.g., "18|20"), must be freed, NULL on error
- */
 char *db_get_exam_result(Database *db, const char *room_id, const char *username)
 {
-    pthread_mutex_lock(&db->mutex);
-
-    char query[512];
-    snprintf(query, sizeof(query),
-             "SELECT score, total_questions FROM exam_results "
-             "WHERE room_id='%s' AND username='%s'",
-             room_id, username);
-
-    if (mysql_query(db->conn, query))
-    {
-        fprintf(stderr, "[DB ERROR] Failed to get result: %s\n", mysql_error(db->conn));
-        pthread_mutex_unlock(&db->mutex);
-        return NULL;
-    }
-
-    MYSQL_RES *result = mysql_store_result(db->conn);
-    if (!result)
+    METRICS_DB_SCOPE(get_exam_result);
+    int score, total;
+    if (db->journal && db_journal_find(db->journal, room_id, username, &score, &total))
     {
-        pthread_mutex_unlock(&db->mutex);
-        return NULL;
+        char *result_str = malloc(64); // Format: "score|total"
+        if (result_str)
+            snprintf(result_str, 64, "%d|%d", score, total);
+        return result_str;
     }
+    return db->backend->get_exam_result(db->impl, room_id, username);
+}
 
-    MYSQL_ROW row = mysql_fetch_row(result);
-    char *result_str = NULL; // Format: "score|total"
-
-    if (row)
-    {
-        result_str = malloc(64);
-        snprintf(result_str, 64, "%s|%s", row[0], row[1]);
-    }
-
-    mysql_free_result(result);
-    pthread_mutex_unlock(&db->mutex);
-
-    return result_str;
+int db_get_correct_answers(Database *db, const char *room_id, char *answers_out, int *total_out)
+{
+    METRICS_DB_SCOPE(get_correct_answers);
+    return db->backend->get_correct_answers(db->impl, room_id, answers_out, total_out);
 }
 
-/**
- * @brief Check if all participants in a room have submitted their exams
- * @param db Database pointer
- * @param room_id Room ID
- * @return 1 if all submitted, 0 otherwise
- */
 int db_check_all_submitted(Database *db, const char *room_id)
 {
-    pthread_mutex_lock(&db->mutex);
-
-    // Get total participants count
-    char query1[512];
-    snprintf(query1, sizeof(query1),
-             "SELECT COUNT(*) FROM participants WHERE room_id='%s'",
-             room_id);
-
-    if (mysql_query(db->conn, query1))
-    {
-        pthread_mutex_unlock(&db->mutex);
-        return 0;
-    }
-
-    MYSQL_RES *result1 = mysql_store_result(db->conn);
-    if (!result1)
-    {
-        pthread_mutex_unlock(&db->mutex);
-        return 0;
-    }
+    METRICS_DB_SCOPE(check_all_submitted);
+    if (db->journal && db_journal_sync_room(db->journal, room_id) < 0)
+        return 0; // results not committed yet, count again on the next submit
+    return db->backend->check_all_submitted(db->impl, room_id);
+}
 
-    MYSQL_ROW row1 = mysql_fetch_row(result1);
-    int total_participants = row1 ? atoi(row1[0]) : 0;
-    mysql_free_result(result1);
+int db_get_room_question_ids(Database *db, const char *room_id, int *ids_out, int max)
+{
+    METRICS_DB_SCOPE(get_room_question_ids);
+    return db->backend->get_room_question_ids(db->impl, room_id, ids_out, max);
+}
 
-    if (total_participants == 0)
-    {
-        pthread_mutex_unlock(&db->mutex);
-        return 0;
-    }
+// ============================= Practice operations ===========================
+int db_load_questions(Database *db, DbQuestionFn fn, void *ctx)
+{
+    METRICS_DB_SCOPE(load_questions);
+    return db->backend->load_questions(db->impl, fn, ctx);
+}
 
-    // Get total submissions count
-    char query2[512];
-    snprintf(query2, sizeof(query2),
-             "SELECT COUNT(*) FROM exam_results WHERE room_id='%s'",
-             room_id);
+int db_save_practice_results(Database *db, const DbPracticeResult *results, int count)
+{
+    METRICS_DB_SCOPE(save_practice_results);
+    return db->backend->save_practice_results(db->impl, results, count);
+}
 
-    if (mysql_query(db->conn, query2))
-    {
-        pthread_mutex_unlock(&db->mutex);
-        return 0;
-    }
+int db_load_abilities(Database *db, DbAbilityFn fn, void *ctx)
+{
+    METRICS_DB_SCOPE(load_abilities);
+    return db->backend->load_abilities(db->impl, fn, ctx);
+}
 
-    MYSQL_RES *result2 = mysql_store_result(db->conn);
-    if (!result2)
-    {
-        pthread_mutex_unlock(&db->mutex);
-        return 0;
-    }
+int db_save_abilities(Database *db, const DbAbility *abilities, int count)
+{
+    METRICS_DB_SCOPE(save_abilities);
+    return db->backend->save_abilities(db->impl, abilities, count);
+}
 
-    MYSQL_ROW row2 = mysql_fetch_row(result2);
-    int total_submissions = row2 ? atoi(row2[0]) : 0; // Get submission count, if NULL return 0
-    mysql_free_result(result2);
+// ============================== Item statistics ==============================
+int db_load_question_stats(Database *db, DbQuestionStatsFn fn, void *ctx)
+{
+    METRICS_DB_SCOPE(load_question_stats);
+    return db->backend->load_question_stats(db->impl, fn, ctx);
+}
 
-    pthread_mutex_unlock(&db->mutex);
+int db_save_question_stats(Database *db, const DbQuestionStats *stats, int count)
+{
+    METRICS_DB_SCOPE(save_question_stats);
+    return db->backend->save_question_stats(db->impl, stats, count);
+}
 
-    // All submitted if counts match
-    return (total_submissions >= total_participants); // creator is not in participants
+// =================================== Stats ===================================
+int db_count_rooms_by_status(Database *db, int *not_started, int *in_progress, int *finished)
+{
+    METRICS_DB_SCOPE(count_rooms_by_status);
+    return db->backend->count_rooms_by_status(db->impl, not_started, in_progress, finished);
 }
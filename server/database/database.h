@@ -1,19 +1,134 @@
 #ifndef DATABASE_H
 #define DATABASE_H
 
-#include <mysql/mysql.h>
-#include <pthread.h>
+// Build without libmysqlclient: make WITH_MYSQL=0 (only the memory backend)
+#ifndef WITH_MYSQL
+#define WITH_MYSQL 1
+#endif
+// Build without libsqlite3: make WITH_SQLITE=0
+#ifndef WITH_SQLITE
+#define WITH_SQLITE 1
+#endif
 
+#define DB_BACKEND_MYSQL "mysql"
+#define DB_BACKEND_MEMORY "memory"
+#define DB_BACKEND_SQLITE "sqlite"
+#define DB_MEMORY_SEED_FILE "../database/schema.sql" // relative to server/
+#define DB_SQLITE_FILE "exam_system.db"
+
+typedef struct DbBackend DbBackend; // see db_backend.h
+typedef struct DbJournal DbJournal; // see db_journal.h
+
+/**
+ * @brief One row of the questions table (db_load_questions)
+ */
+typedef struct
+{
+    int id;
+    const char *text;
+    const char *options[4]; // option_a .. option_d
+    char correct_answer;    // 'A'..'D'
+    const char *difficulty; // "easy" / "medium" / "hard"
+    const char *category;   // NULL if not set
+} DbQuestion;
+
+/**
+ * @brief Called for each question; strings are only valid during the call
+ * @return 0 to continue, -1 to stop
+ */
+typedef int (*DbQuestionFn)(void *ctx, const DbQuestion *question);
+
+/**
+ * @brief A finished practice session (practice_sessions row with is_completed = 1)
+ */
+typedef struct
+{
+    const char *practice_id;
+    const char *username;
+    int num_questions;
+    int time_limit;
+    int score;
+    long long start_time; // unix time
+} DbPracticeResult;
+
+/**
+ * @brief Ability estimate of a user in one question category (practice_abilities row)
+ */
+typedef struct
+{
+    const char *username;
+    const char *category;
+    int rating;  // Elo scale: 1500 = a medium question answered half the time
+    int answers; // answers graded so far
+} DbAbility;
+
+/**
+ * @brief Called for each ability row; strings are only valid during the call
+ * @return 0 to continue, -1 to stop
+ */
+typedef int (*DbAbilityFn)(void *ctx, const DbAbility *ability);
+
+/**
+ * @brief Answer statistics of one question (question_stats row), cumulative
+ */
+typedef struct
+{
+    int question_id;
+    long long attempts;
+    long long correct;
+    long long choices[5]; // A, B, C, D, unanswered
+    long long time_ms;    // summed share of the exam time (time_taken / questions)
+} DbQuestionStats;
+
+/**
+ * @brief Called for each question_stats row
+ * @return 0 to continue, -1 to stop
+ */
+typedef int (*DbQuestionStatsFn)(void *ctx, const DbQuestionStats *stats);
+
+/**
+ * @brief Called for each room of db_get_rooms; row has the db_json_rooms_add layout
+ * (room_id, room_name, creator, status, participant_count, max_participants,
+ * num_questions, time_limit_minutes, created_at) and is only valid during the call
+ * @return 0 to continue, -1 to stop
+ */
+typedef int (*DbRoomRowFn)(void *ctx, char **row);
+
+/**
+ * @brief One page of the room list, newest first: (created_at DESC, room_id DESC)
+ */
 typedef struct
 {
-    MYSQL *conn;
-    pthread_mutex_t mutex;
+    const char *status;        // "ALL" or NOT_STARTED / IN_PROGRESS / FINISHED
+    const char *creator;       // NULL = any creator
+    const char *name_prefix;   // NULL = any name (case-sensitive prefix)
+    const char *after_created; // keyset cursor "YYYY-MM-DD HH:MM:SS": rooms after
+    const char *after_room_id; // (after_created, after_room_id) in that order; NULL = first page
+    int limit;
+} DbRoomPage;
+
+/**
+ * @brief Database handle: a backend (MySQL, in-memory or SQLite) and its state
+ */
+typedef struct
+{
+    const DbBackend *backend;
+    void *impl;
+    DbJournal *journal; // write-behind exam results (NULL = synchronous db_submit_exam)
 } Database;
 
-// connect to the database
+// connect to the database (MySQL backend)
 int db_connect(Database *db, const char *host, const char *user, const char *password, const char *dbname);
-// connect to the database with specific port
+// connect to the database with specific port (MySQL backend)
 int db_connect_with_port(Database *db, const char *host, const char *user, const char *password, const char *dbname, unsigned int port);
+// open the in-memory backend, seeded with the sample data of schema.sql (NULL = DB_MEMORY_SEED_FILE)
+int db_open_memory(Database *db, const char *seed_file);
+// open (or create) a SQLite database file (NULL = DB_SQLITE_FILE); a new file is seeded like the memory backend
+int db_open_sqlite(Database *db, const char *path, const char *seed_file);
+// write exam results through a local journal, committed to the backend in batches (db_journal.h)
+int db_enable_results_journal(Database *db, const char *path);
+// backend name ("mysql" / "memory" / "sqlite")
+const char *db_backend_name(Database *db);
 // disconnect from the database
 void db_disconnect(Database *db);
 
@@ -36,9 +151,15 @@ void db_log_activity(Database *db, const char *level, const char *username, cons
 // Room operations
 int db_create_room(Database *db, const char *room_id, const char *room_name, const char *creator, int num_questions, int time_limit);
 char *db_list_rooms(Database *db, const char *status_filter);
+// rows of the given rooms (any status, unknown ids skipped); returns rows found, -1 on error
+int db_get_rooms(Database *db, const char *const *room_ids, int count, DbRoomRowFn fn, void *ctx);
+// rows of one page of the room list (keyset on created_at, room_id); returns rows, -1 on error
+int db_list_rooms_page(Database *db, const DbRoomPage *page, DbRoomRowFn fn, void *ctx);
+// 1 if the user was added, 0 if already a participant (or unknown room/user: ignored), -1 on error
 int db_join_room(Database *db, const char *room_id, const char *username);
 int db_get_room_status(Database *db, const char *room_id);
 int db_get_room_participant_count(Database *db, const char *room_id);
+int db_get_room_time_limit(Database *db, const char *room_id);
 
 // Exam operations
 char *db_get_room_leaderboard(Database *db, const char *room_id);
@@ -56,5 +177,19 @@ int db_check_already_submitted(Database *db, const char *room_id, const char *us
 char *db_get_exam_result(Database *db, const char *room_id, const char *username);
 int db_get_correct_answers(Database *db, const char *room_id, char *answers_out, int *total_out);
 int db_check_all_submitted(Database *db, const char *room_id);
+int db_get_room_question_ids(Database *db, const char *room_id, int *ids_out, int max);
+
+// Practice operations (question bank loaded once, scores written in batches)
+int db_load_questions(Database *db, DbQuestionFn fn, void *ctx);
+int db_save_practice_results(Database *db, const DbPracticeResult *results, int count);
+int db_load_abilities(Database *db, DbAbilityFn fn, void *ctx);
+int db_save_abilities(Database *db, const DbAbility *abilities, int count);
+
+// Item statistics (aggregated in memory, written periodically)
+int db_load_question_stats(Database *db, DbQuestionStatsFn fn, void *ctx);
+int db_save_question_stats(Database *db, const DbQuestionStats *stats, int count);
+
+// Stats (admin STATS command)
+int db_count_rooms_by_status(Database *db, int *not_started, int *in_progress, int *finished);
 
 #endif // DATABASE_H
\ No newline at end of file
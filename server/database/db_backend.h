@@ -0,0 +1,126 @@
+#ifndef DB_BACKEND_H
+#define DB_BACKEND_H
+
+#include "database.h"
+
+// ===============================================
+// DATABASE BACKENDS - implemented by db_mysql.c, db_memory.c, db_sqlite.c
+// ===============================================
+//
+// database.c dispatches every db_* call through db->backend with db->impl as
+// the first argument (and records the db_* latency metrics there). Each
+// backend owns its locking and must keep the semantics of the MySQL schema
+// in database/schema.sql: same return codes, same JSON, same constraints.
+
+/**
+ * @brief One exam result of a batch (results journal)
+ */
+typedef struct
+{
+    const char *room_id;
+    const char *username;
+    int score;
+    int total;
+    const char *answers;
+    int time_taken;
+    long long submit_time; // unix time the result was acknowledged
+} DbExamResult;
+
+struct DbBackend
+{
+    const char *name;
+    void (*close)(void *impl);
+
+    // User operations
+    int (*create_user)(void *impl, const char *username, const char *password_hash);
+    int (*check_username_exists)(void *impl, const char *username);
+    int (*verify_login)(void *impl, const char *username, const char *password_hash);
+    int (*is_account_locked)(void *impl, const char *username);
+
+    // Session operations
+    int (*create_session)(void *impl, const char *session_id, const char *username);
+    int (*destroy_session)(void *impl, const char *session_id);
+    int (*check_user_logged_in)(void *impl, const char *username);
+
+    // Logging
+    void (*log_activity)(void *impl, const char *level, const char *username, const char *action, const char *details);
+
+    // Room operations
+    int (*create_room)(void *impl, const char *room_id, const char *room_name, const char *creator, int num_questions, int time_limit);
+    char *(*list_rooms)(void *impl, const char *status_filter);
+    int (*get_rooms)(void *impl, const char *const *room_ids, int count, DbRoomRowFn fn, void *ctx);
+    int (*list_rooms_page)(void *impl, const DbRoomPage *page, DbRoomRowFn fn, void *ctx);
+    int (*join_room)(void *impl, const char *room_id, const char *username);
+    int (*get_room_status)(void *impl, const char *room_id);
+    int (*get_room_participant_count)(void *impl, const char *room_id);
+    int (*get_room_time_limit)(void *impl, const char *room_id);
+
+    // Exam operations
+    char *(*get_room_leaderboard)(void *impl, const char *room_id);
+    char *(*get_exam_questions)(void *impl, const char *room_id);
+    int (*leave_room)(void *impl, const char *room_id, const char *username);
+    int (*start_room)(void *impl, const char *room_id);
+    int (*finish_room)(void *impl, const char *room_id);
+    int (*is_room_creator)(void *impl, const char *room_id, const char *username);
+    int (*is_participant)(void *impl, const char *room_id, const char *username);
+    int (*delete_room)(void *impl, const char *room_id);
+
+    // Submit exam operations
+    int (*submit_exam)(void *impl, const char *room_id, const char *username, int score, int total, const char *answers, int time_taken);
+    int (*check_already_submitted)(void *impl, const char *room_id, const char *username);
+    char *(*get_exam_result)(void *impl, const char *room_id, const char *username);
+    int (*get_correct_answers)(void *impl, const char *room_id, char *answers_out, int *total_out);
+    int (*check_all_submitted)(void *impl, const char *room_id);
+    // Insert results in one transaction. Rows that violate a constraint
+    // (already submitted, room deleted) are skipped like INSERT IGNORE.
+    // Returns 0 when committed, -1 on error (nothing committed).
+    int (*submit_exam_batch)(void *impl, const DbExamResult *results, int count);
+    // Question ids of a room in question_order (at most max); returns the count, -1 on error.
+    int (*get_room_question_ids)(void *impl, const char *room_id, int *ids_out, int max);
+
+    // Practice operations
+    // Calls fn for every question in id order; returns the number of rows, -1 on error.
+    int (*load_questions)(void *impl, DbQuestionFn fn, void *ctx);
+    // Insert finished practice sessions in one transaction (duplicate
+    // practice_id / unknown user skipped). Returns 0 when committed, -1 on error.
+    int (*save_practice_results)(void *impl, const DbPracticeResult *results, int count);
+    // Calls fn for every practice_abilities row; returns the number of rows, -1 on error.
+    int (*load_abilities)(void *impl, DbAbilityFn fn, void *ctx);
+    // Upsert ability rows in one transaction (unknown user skipped).
+    // Returns 0 when committed, -1 on error.
+    int (*save_abilities)(void *impl, const DbAbility *abilities, int count);
+
+    // Item statistics
+    // Calls fn for every question_stats row; returns the number of rows, -1 on error.
+    int (*load_question_stats)(void *impl, DbQuestionStatsFn fn, void *ctx);
+    // Upsert rows with their cumulative values in one transaction (unknown
+    // question skipped). Returns 0 when committed, -1 on error.
+    int (*save_question_stats)(void *impl, const DbQuestionStats *stats, int count);
+
+    // Stats
+    int (*count_rooms_by_status)(void *impl, int *not_started, int *in_progress, int *finished);
+};
+
+#if WITH_MYSQL
+/**
+ * @brief Open the MySQL backend (db_mysql.c)
+ * @return 0 on success, -1 on error
+ */
+int db_mysql_open(Database *db, const char *host, const char *user, const char *password, const char *dbname, unsigned int port);
+#endif
+
+/**
+ * @brief Open the in-memory backend (db_memory.c), seeded from schema.sql
+ * @return 0 on success, -1 on error
+ */
+int db_memory_open(Database *db, const char *seed_file);
+
+#if WITH_SQLITE
+/**
+ * @brief Open the SQLite backend (db_sqlite.c); an empty database is seeded from schema.sql
+ * @return 0 on success, -1 on error
+ */
+int db_sqlite_open(Database *db, const char *path, const char *seed_file);
+#endif
+
+#endif // DB_BACKEND_H
@@ -0,0 +1,597 @@
+#include "db_journal.h"
+#include "db_backend.h"
+#include "../metrics/metrics.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include <zlib.h>
+
+// File: DB_JOURNAL_MAGIC, then records
+//   JournalRecordHeader | JournalRecordFixed | room_id | username | answers
+// Native byte order: the journal is only read back by the server that wrote it.
+#define DB_JOURNAL_MAGIC "EXAMRJ1\n"
+#define DB_JOURNAL_MAGIC_LEN 8
+
+typedef struct
+{
+    uint32_t length; // payload bytes (fixed part + strings)
+    uint32_t crc;    // crc32 of the payload
+} JournalRecordHeader;
+
+typedef struct
+{
+    int64_t submit_time;
+    int32_t score;
+    int32_t total;
+    int32_t time_taken;
+    uint16_t room_len;
+    uint16_t user_len;
+    uint32_t answers_len;
+} JournalRecordFixed;
+
+typedef struct JournalEntry
+{
+    struct JournalEntry *next;
+    uint64_t seq;
+    DbExamResult result; // strings point into data
+    char data[];
+} JournalEntry;
+
+struct DbJournal
+{
+    Database *db;
+    char *path;
+    int fd;
+    off_t file_size; // end of the last complete record
+
+    pthread_mutex_t mutex;
+    pthread_cond_t synced_cond;    // a journal fdatasync finished
+    pthread_cond_t flush_cond;     // wakes the flusher
+    pthread_cond_t committed_cond; // a batch was committed
+
+    // Group fsync: byte counters since open (not file offsets, the file is truncated)
+    uint64_t written_lsn;
+    uint64_t synced_lsn;
+    int syncing;
+
+    // Pending results, oldest first. Appenders add at the tail, only the
+    // flusher removes from the head.
+    JournalEntry *head;
+    JournalEntry *tail;
+    uint64_t next_seq;
+    uint64_t committed_seq; // every entry with seq < committed_seq is committed
+    int flush_now;
+
+    int stop;
+    pthread_t flusher;
+    DbJournalStats stats;
+};
+
+static void deadline_after_ms(struct timespec *ts, int ms)
+{
+    clock_gettime(CLOCK_MONOTONIC, ts);
+    ts->tv_sec += ms / 1000;
+    ts->tv_nsec += (long)(ms % 1000) * 1000000L;
+    if (ts->tv_nsec >= 1000000000L)
+    {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000L;
+    }
+}
+
+static JournalEntry *entry_create(const char *room_id, const char *username, int score, int total, const char *answers, int time_taken, int64_t submit_time)
+{
+    size_t room_len = strlen(room_id), user_len = strlen(username), answers_len = strlen(answers);
+    JournalEntry *entry = malloc(sizeof(JournalEntry) + room_len + user_len + answers_len + 3);
+    if (!entry)
+        return NULL;
+
+    char *p = entry->data;
+    memcpy(p, room_id, room_len + 1);
+    entry->result.room_id = p;
+    p += room_len + 1;
+    memcpy(p, username, user_len + 1);
+    entry->result.username = p;
+    p += user_len + 1;
+    memcpy(p, answers, answers_len + 1);
+    entry->result.answers = p;
+
+    entry->result.score = score;
+    entry->result.total = total;
+    entry->result.time_taken = time_taken;
+    entry->result.submit_time = submit_time;
+    entry->next = NULL;
+    return entry;
+}
+
+// Caller holds mutex
+static void entry_link(DbJournal *journal, JournalEntry *entry)
+{
+    entry->seq = journal->next_seq++;
+    if (journal->tail)
+        journal->tail->next = entry;
+    else
+        journal->head = entry;
+    journal->tail = entry;
+    journal->stats.pending++;
+}
+
+// Caller holds mutex
+static JournalEntry *find_pending(DbJournal *journal, const char *room_id, const char *username)
+{
+    for (JournalEntry *entry = journal->head; entry; entry = entry->next)
+    {
+        if (strcmp(entry->result.room_id, room_id) == 0 && strcmp(entry->result.username, username) == 0)
+            return entry;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Serialize a record (header + payload), malloc'd
+ */
+static char *record_encode(const DbExamResult *result, size_t *len_out)
+{
+    JournalRecordFixed fixed;
+    memset(&fixed, 0, sizeof(fixed));
+    fixed.submit_time = result->submit_time;
+    fixed.score = result->score;
+    fixed.total = result->total;
+    fixed.time_taken = result->time_taken;
+    fixed.room_len = (uint16_t)strlen(result->room_id);
+    fixed.user_len = (uint16_t)strlen(result->username);
+    fixed.answers_len = (uint32_t)strlen(result->answers);
+
+    size_t payload_len = sizeof(fixed) + fixed.room_len + fixed.user_len + fixed.answers_len;
+    char *record = malloc(sizeof(JournalRecordHeader) + payload_len);
+    if (!record)
+        return NULL;
+
+    char *payload = record + sizeof(JournalRecordHeader);
+    char *p = payload;
+    memcpy(p, &fixed, sizeof(fixed));
+    p += sizeof(fixed);
+    memcpy(p, result->room_id, fixed.room_len);
+    p += fixed.room_len;
+    memcpy(p, result->username, fixed.user_len);
+    p += fixed.user_len;
+    memcpy(p, result->answers, fixed.answers_len);
+
+    JournalRecordHeader header;
+    header.length = (uint32_t)payload_len;
+    header.crc = (uint32_t)crc32(0L, (const Bytef *)payload, (uInt)payload_len);
+    memcpy(record, &header, sizeof(header));
+
+    *len_out = sizeof(header) + payload_len;
+    return record;
+}
+
+/**
+ * @brief Parse one record at buf; NULL if truncated or corrupt (torn tail)
+ */
+static JournalEntry *record_decode(const char *buf, size_t available, size_t *consumed)
+{
+    JournalRecordHeader header;
+    JournalRecordFixed fixed;
+    if (available < sizeof(header))
+        return NULL;
+    memcpy(&header, buf, sizeof(header));
+    if (header.length < sizeof(fixed) || header.length > available - sizeof(header))
+        return NULL;
+
+    const char *payload = buf + sizeof(header);
+    if ((uint32_t)crc32(0L, (const Bytef *)payload, (uInt)header.length) != header.crc)
+        return NULL;
+    memcpy(&fixed, payload, sizeof(fixed));
+    if (sizeof(fixed) + (size_t)fixed.room_len + fixed.user_len + fixed.answers_len != header.length)
+        return NULL;
+
+    // Strings are not NUL terminated on disk
+    const char *p = payload + sizeof(fixed);
+    char *room_id = strndup(p, fixed.room_len);
+    char *username = strndup(p + fixed.room_len, fixed.user_len);
+    char *answers = strndup(p + fixed.room_len + fixed.user_len, fixed.answers_len);
+    JournalEntry *entry = NULL;
+    if (room_id && username && answers)
+        entry = entry_create(room_id, username, fixed.score, fixed.total, answers, fixed.time_taken, fixed.submit_time);
+    free(room_id);
+    free(username);
+    free(answers);
+
+    *consumed = sizeof(header) + header.length;
+    return entry;
+}
+
+static int write_all(int fd, const char *buf, size_t len)
+{
+    while (len > 0)
+    {
+        ssize_t written = write(fd, buf, len);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        buf += written;
+        len -= (size_t)written;
+    }
+    return 0;
+}
+
+/**
+ * @brief Load the records left by a previous run into the pending list,
+ * drop a torn tail, write the magic into a new file
+ */
+static int journal_recover(DbJournal *journal)
+{
+    struct stat st;
+    if (fstat(journal->fd, &st) < 0)
+        return -1;
+
+    if (st.st_size == 0)
+    {
+        if (write_all(journal->fd, DB_JOURNAL_MAGIC, DB_JOURNAL_MAGIC_LEN) < 0 || fdatasync(journal->fd) < 0)
+            return -1;
+        journal->file_size = DB_JOURNAL_MAGIC_LEN;
+        return 0;
+    }
+
+    char *buf = malloc((size_t)st.st_size);
+    if (!buf)
+        return -1;
+    ssize_t got = pread(journal->fd, buf, (size_t)st.st_size, 0);
+    if (got != st.st_size || memcmp(buf, DB_JOURNAL_MAGIC, DB_JOURNAL_MAGIC_LEN) != 0)
+    {
+        fprintf(stderr, "[JOURNAL] %s is not a results journal\n", journal->path);
+        free(buf);
+        return -1;
+    }
+
+    size_t offset = DB_JOURNAL_MAGIC_LEN;
+    int replayed = 0;
+    while (offset < (size_t)st.st_size)
+    {
+        size_t consumed = 0;
+        JournalEntry *entry = record_decode(buf + offset, (size_t)st.st_size - offset, &consumed);
+        if (!entry)
+            break;
+        entry_link(journal, entry);
+        offset += consumed;
+        replayed++;
+    }
+    free(buf);
+
+    if (offset < (size_t)st.st_size)
+    {
+        fprintf(stderr, "[JOURNAL] Dropping %lld bytes of torn record at the end of %s\n",
+                (long long)(st.st_size - (off_t)offset), journal->path);
+        if (ftruncate(journal->fd, (off_t)offset) < 0)
+            return -1;
+    }
+    journal->file_size = (off_t)offset;
+
+    if (replayed > 0)
+    {
+        printf("[JOURNAL] Replaying %d result(s) from %s\n", replayed, journal->path);
+        journal->flush_now = 1;
+    }
+    return 0;
+}
+
+// ===============================================
+// Flusher thread: group commit to the backend
+// ===============================================
+
+static void *flusher_thread(void *arg)
+{
+    DbJournal *journal = arg;
+    DbExamResult *batch = malloc(sizeof(DbExamResult) * DB_JOURNAL_BATCH_MAX);
+    if (!batch)
+        return NULL;
+
+    pthread_mutex_lock(&journal->mutex);
+    while (1)
+    {
+        // Wait for a full batch, an explicit flush or the flush interval
+        struct timespec deadline;
+        deadline_after_ms(&deadline, DB_JOURNAL_FLUSH_MS);
+        while (!journal->stop && !journal->flush_now && journal->stats.pending < DB_JOURNAL_BATCH_MIN)
+        {
+            if (pthread_cond_timedwait(&journal->flush_cond, &journal->mutex, &deadline) == ETIMEDOUT)
+            {
+                if (journal->head)
+                    break;
+                deadline_after_ms(&deadline, DB_JOURNAL_FLUSH_MS);
+            }
+        }
+        if (!journal->head)
+        {
+            journal->flush_now = 0;
+            if (journal->stop)
+                break;
+            continue;
+        }
+
+        // Entries stay linked (visible to db_journal_find) until committed.
+        // Only this thread unlinks them, so they can be read without the lock.
+        int count = 0;
+        JournalEntry *last = NULL;
+        for (JournalEntry *entry = journal->head; entry && count < DB_JOURNAL_BATCH_MAX; entry = entry->next)
+        {
+            batch[count++] = entry->result;
+            last = entry;
+        }
+        pthread_mutex_unlock(&journal->mutex);
+
+        int rc;
+        {
+            METRICS_DB_SCOPE(submit_exam_batch);
+            rc = journal->db->backend->submit_exam_batch(journal->db->impl, batch, count);
+        }
+
+        pthread_mutex_lock(&journal->mutex);
+        if (rc < 0)
+        {
+            journal->stats.failures++;
+            fprintf(stderr, "[JOURNAL] Commit of %d result(s) failed, retrying in %d ms\n", count, DB_JOURNAL_RETRY_MS);
+            if (journal->stop)
+                break; // keep them in the journal for the next start
+            deadline_after_ms(&deadline, DB_JOURNAL_RETRY_MS);
+            while (!journal->stop && pthread_cond_timedwait(&journal->flush_cond, &journal->mutex, &deadline) != ETIMEDOUT)
+                ;
+            continue;
+        }
+
+        JournalEntry *entry = journal->head;
+        JournalEntry *end = last->next;
+        journal->head = end;
+        if (!journal->head)
+            journal->tail = NULL;
+        journal->committed_seq = last->seq + 1;
+        journal->stats.pending -= count;
+        journal->stats.committed += (unsigned long long)count;
+        journal->stats.batches++;
+        if (!journal->head)
+        {
+            journal->flush_now = 0;
+            // Everything in the file is in the database: start over
+            if (ftruncate(journal->fd, DB_JOURNAL_MAGIC_LEN) == 0)
+                journal->file_size = DB_JOURNAL_MAGIC_LEN;
+        }
+        pthread_cond_broadcast(&journal->committed_cond);
+        pthread_mutex_unlock(&journal->mutex);
+
+        while (entry != end)
+        {
+            JournalEntry *next = entry->next;
+            free(entry);
+            entry = next;
+        }
+
+        pthread_mutex_lock(&journal->mutex);
+    }
+    pthread_mutex_unlock(&journal->mutex);
+
+    free(batch);
+    return NULL;
+}
+
+// ===============================================
+// Public API
+// ===============================================
+
+DbJournal *db_journal_open(Database *db, const char *path)
+{
+    DbJournal *journal = calloc(1, sizeof(DbJournal));
+    if (!journal)
+        return NULL;
+    journal->db = db;
+    journal->path = strdup(path);
+    journal->fd = open(path, O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0600);
+    if (journal->fd < 0 || !journal->path)
+    {
+        fprintf(stderr, "[JOURNAL] Cannot open %s: %s\n", path, strerror(errno));
+        if (journal->fd >= 0)
+            close(journal->fd);
+        free(journal->path);
+        free(journal);
+        return NULL;
+    }
+
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_mutex_init(&journal->mutex, NULL);
+    pthread_cond_init(&journal->synced_cond, NULL);
+    pthread_cond_init(&journal->flush_cond, &attr);
+    pthread_cond_init(&journal->committed_cond, &attr);
+    pthread_condattr_destroy(&attr);
+
+    if (journal_recover(journal) < 0 || pthread_create(&journal->flusher, NULL, flusher_thread, journal) != 0)
+    {
+        fprintf(stderr, "[JOURNAL] Failed to initialize %s\n", path);
+        while (journal->head)
+        {
+            JournalEntry *next = journal->head->next;
+            free(journal->head);
+            journal->head = next;
+        }
+        close(journal->fd);
+        free(journal->path);
+        free(journal);
+        return NULL;
+    }
+    return journal;
+}
+
+int db_journal_append(DbJournal *journal, const char *room_id, const char *username, int score, int total, const char *answers, int time_taken)
+{
+    JournalEntry *entry = entry_create(room_id, username, score, total, answers, time_taken, (int64_t)time(NULL));
+    if (!entry)
+        return -1;
+    size_t record_len;
+    char *record = record_encode(&entry->result, &record_len);
+    if (!record)
+    {
+        free(entry);
+        return -1;
+    }
+
+    pthread_mutex_lock(&journal->mutex);
+
+    // Same as the UNIQUE (room_id, username) of exam_results
+    if (find_pending(journal, room_id, username))
+    {
+        pthread_mutex_unlock(&journal->mutex);
+        free(record);
+        free(entry);
+        return -1;
+    }
+
+    if (write_all(journal->fd, record, record_len) < 0)
+    {
+        fprintf(stderr, "[JOURNAL] Write failed: %s\n", strerror(errno));
+        // Cut the partial record so later records stay readable
+        if (ftruncate(journal->fd, journal->file_size) < 0)
+            fprintf(stderr, "[JOURNAL] Truncate failed: %s\n", strerror(errno));
+        pthread_mutex_unlock(&journal->mutex);
+        free(record);
+        free(entry);
+        return -1;
+    }
+    free(record);
+    journal->file_size += (off_t)record_len;
+    journal->written_lsn += record_len;
+    uint64_t my_lsn = journal->written_lsn;
+    entry_link(journal, entry);
+    journal->stats.appended++;
+    if (journal->stats.pending >= DB_JOURNAL_BATCH_MIN)
+        pthread_cond_signal(&journal->flush_cond);
+
+    // Group fsync: the first waiter syncs everything written so far, the
+    // others wait for it (or for the next round)
+    int rc = 0;
+    while (journal->synced_lsn < my_lsn)
+    {
+        if (journal->syncing)
+        {
+            pthread_cond_wait(&journal->synced_cond, &journal->mutex);
+            continue;
+        }
+        journal->syncing = 1;
+        uint64_t target = journal->written_lsn;
+        pthread_mutex_unlock(&journal->mutex);
+        int sync_rc = fdatasync(journal->fd);
+        pthread_mutex_lock(&journal->mutex);
+        journal->syncing = 0;
+        journal->stats.fsyncs++;
+        pthread_cond_broadcast(&journal->synced_cond);
+        if (sync_rc < 0)
+        {
+            // The result is queued and will still reach the database, but it
+            // is not known to be durable: report the failure
+            fprintf(stderr, "[JOURNAL] fdatasync failed: %s\n", strerror(errno));
+            rc = -1;
+            break;
+        }
+        if (target > journal->synced_lsn)
+            journal->synced_lsn = target;
+    }
+
+    pthread_mutex_unlock(&journal->mutex);
+    return rc;
+}
+
+int db_journal_find(DbJournal *journal, const char *room_id, const char *username, int *score_out, int *total_out)
+{
+    pthread_mutex_lock(&journal->mutex);
+    JournalEntry *entry = find_pending(journal, room_id, username);
+    if (entry)
+    {
+        if (score_out)
+            *score_out = entry->result.score;
+        if (total_out)
+            *total_out = entry->result.total;
+    }
+    pthread_mutex_unlock(&journal->mutex);
+    return entry != NULL;
+}
+
+int db_journal_sync_room(DbJournal *journal, const char *room_id)
+{
+    pthread_mutex_lock(&journal->mutex);
+
+    // Newest pending entry of the room: committed once committed_seq passes it
+    uint64_t wait_seq = 0;
+    int found = 0;
+    for (JournalEntry *entry = journal->head; entry; entry = entry->next)
+    {
+        if (strcmp(entry->result.room_id, room_id) == 0)
+        {
+            wait_seq = entry->seq;
+            found = 1;
+        }
+    }
+
+    int rc = 0;
+    if (found)
+    {
+        journal->flush_now = 1;
+        pthread_cond_signal(&journal->flush_cond);
+
+        struct timespec deadline;
+        deadline_after_ms(&deadline, DB_JOURNAL_SYNC_TIMEOUT_MS);
+        while (journal->committed_seq <= wait_seq && !journal->stop)
+        {
+            if (pthread_cond_timedwait(&journal->committed_cond, &journal->mutex, &deadline) == ETIMEDOUT)
+                break;
+        }
+        rc = journal->committed_seq > wait_seq ? 0 : -1;
+    }
+
+    pthread_mutex_unlock(&journal->mutex);
+    return rc;
+}
+
+void db_journal_stats(DbJournal *journal, DbJournalStats *out)
+{
+    pthread_mutex_lock(&journal->mutex);
+    *out = journal->stats;
+    pthread_mutex_unlock(&journal->mutex);
+}
+
+void db_journal_close(DbJournal *journal)
+{
+    pthread_mutex_lock(&journal->mutex);
+    journal->stop = 1;
+    pthread_cond_broadcast(&journal->flush_cond);
+    pthread_cond_broadcast(&journal->committed_cond);
+    pthread_mutex_unlock(&journal->mutex);
+    pthread_join(journal->flusher, NULL);
+
+    if (journal->head)
+        fprintf(stderr, "[JOURNAL] %d result(s) left in %s, replayed on next start\n", journal->stats.pending, journal->path);
+    while (journal->head)
+    {
+        JournalEntry *next = journal->head->next;
+        free(journal->head);
+        journal->head = next;
+    }
+
+    fdatasync(journal->fd);
+    close(journal->fd);
+    pthread_mutex_destroy(&journal->mutex);
+    pthread_cond_destroy(&journal->synced_cond);
+    pthread_cond_destroy(&journal->flush_cond);
+    pthread_cond_destroy(&journal->committed_cond);
+    free(journal->path);
+    free(journal);
+}
@@ -0,0 +1,85 @@
+#ifndef DB_JOURNAL_H
+#define DB_JOURNAL_H
+
+#include "database.h"
+
+// ===============================================
+// RESULTS JOURNAL - write-behind persistence of exam results
+// ===============================================
+//
+// db_submit_exam() appends the result to a local journal file and returns
+// once the record is on disk (fdatasync); the client is acknowledged without
+// waiting for the database. A flusher thread then commits pending results to
+// the backend in multi-row transactions (submit_exam_batch).
+//
+// Group commit on both sides:
+//  - journal: concurrent submitters share one fdatasync (leader/follower)
+//  - backend: up to DB_JOURNAL_BATCH_MAX results per transaction, flushed
+//             every DB_JOURNAL_FLUSH_MS or as soon as DB_JOURNAL_BATCH_MIN
+//             results are pending
+//
+// The journal is truncated whenever every record has been committed. On
+// startup the records still in the file are replayed (the insert ignores
+// results that are already stored), so an acknowledged submission survives
+// a crash. Records are framed with length + CRC32; a torn tail is dropped.
+//
+// Results stay visible while pending: check_already_submitted and
+// get_exam_result look them up here; check_all_submitted and the leaderboard
+// wait until the room's pending results are committed.
+
+#define DB_JOURNAL_BATCH_MIN 64       // wake the flusher early
+#define DB_JOURNAL_BATCH_MAX 512      // results per transaction
+#define DB_JOURNAL_FLUSH_MS 20        // max time a result stays pending (DB healthy)
+#define DB_JOURNAL_RETRY_MS 1000      // backoff after a failed commit
+#define DB_JOURNAL_SYNC_TIMEOUT_MS 5000
+
+/**
+ * @brief Journal counters (STATS)
+ */
+typedef struct
+{
+    unsigned long long appended;  // results acknowledged through the journal
+    unsigned long long committed; // results committed to the backend
+    unsigned long long batches;   // backend transactions
+    unsigned long long fsyncs;    // journal fdatasync calls
+    unsigned long long failures;  // failed backend commits (retried)
+    int pending;                  // results not yet committed
+} DbJournalStats;
+
+/**
+ * @brief Open (or create) the journal, queue records left by a previous run and start the flusher
+ * @return Journal, NULL on error
+ */
+DbJournal *db_journal_open(Database *db, const char *path);
+
+/**
+ * @brief Append a result; returns once it is durable in the journal
+ * @return 0 on success, -1 on I/O error or if a pending result exists for (room, user)
+ */
+int db_journal_append(DbJournal *journal, const char *room_id, const char *username, int score, int total, const char *answers, int time_taken);
+
+/**
+ * @brief Look up a pending (not yet committed) result
+ * @param score_out, total_out Optional outputs
+ * @return 1 if pending, 0 otherwise
+ */
+int db_journal_find(DbJournal *journal, const char *room_id, const char *username, int *score_out, int *total_out);
+
+/**
+ * @brief Wait until every pending result of a room is committed
+ * @return 0 on success, -1 on timeout (backend down)
+ */
+int db_journal_sync_room(DbJournal *journal, const char *room_id);
+
+/**
+ * @brief Snapshot of the counters
+ */
+void db_journal_stats(DbJournal *journal, DbJournalStats *out);
+
+/**
+ * @brief Commit what is pending (best effort), stop the flusher and close the file
+ * Results that could not be committed stay in the journal for the next start.
+ */
+void db_journal_close(DbJournal *journal);
+
+#endif // DB_JOURNAL_H
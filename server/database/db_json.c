@@ -0,0 +1,126 @@
+#include "db_json.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+char *db_json_rooms_open(void)
+{
+    char *json = malloc(DB_JSON_ROOMS_BUFFER);
+    if (json)
+        strcpy(json, "{\n  \"rooms\": [\n");
+    return json;
+}
+
+int db_json_rooms_add(char *json, char **row)
+{
+    char room_entry[512]; // Temporary buffer for each room entry
+    snprintf(room_entry, sizeof(room_entry),
+             "{\"room_id\":\"%s\",\"room_name\":\"%s\",\"creator\":\"%s\","
+             "\"status\":\"%s\",\"participant_count\":%s,\"max_participants\":%s,"
+             "\"num_questions\":%s,\"time_limit_minutes\":%s,\"created_at\":\"%s\"},",
+             row[0], row[1], row[2], row[3], row[4], row[5], row[6], row[7], row[8]);
+    if (strlen(json) + strlen(room_entry) + 1 + DB_JSON_TAIL_RESERVE > DB_JSON_ROOMS_BUFFER)
+        return -1;
+    strcat(json, room_entry); // Append room entry to JSON
+    strcat(json, "\n");
+    return 0;
+}
+
+void db_json_rooms_close(char *json)
+{
+    strcat(json, "  ]\n}");
+    // json:
+    // {
+    //   "rooms": [
+    //     {
+    //       "room_id": "1234567890",
+    //       "room_name": "Sample Room",
+    //       "creator": "user1",
+    //       "status": "NOT_STARTED",
+    //       "participant_count": 5,
+    //       "max_participants": 10,
+    //       "num_questions": 20,
+    //       "time_limit_minutes": 15,
+    //       "created_at": "2024-10-01 12:34:56"
+    //     },
+    //     ...
+    //   ]
+    // }
+}
+
+// json: {"leaderboard":[{"rank":1,"username":"user1","score":8,"total":10,"submit_time":"2024-10-01 12:00:00", "time_taken":120},...]}
+char *db_json_leaderboard_open(void)
+{
+    char *json = malloc(DB_JSON_LEADERBOARD_BUFFER);
+    if (json)
+        strcpy(json, "{\n  \"leaderboard\":[\n");
+    return json;
+}
+
+int db_json_leaderboard_add(char *json, int rank, char **row)
+{
+    char entry[512];
+    snprintf(entry, sizeof(entry),
+             "{\"rank\":%d,\"username\":\"%s\",\"score\":%s,"
+             "\"total\":%s,\"submit_time\":\"%s\",\"time_taken\":%s},",
+             rank, row[0], row[1], row[2], row[3], row[4]);
+    if (strlen(json) + strlen(entry) + 5 + DB_JSON_TAIL_RESERVE > DB_JSON_LEADERBOARD_BUFFER)
+        return -1;
+    strcat(json, "    ");
+    strcat(json, entry);
+    strcat(json, "\n");
+    return 0;
+}
+
+void db_json_leaderboard_close(char *json)
+{
+    strcat(json, "]}");
+}
+
+// Format: {"questions":[{"question_id":1,"content":"...","options":["A","B","C","D"]},...]}}
+char *db_json_questions_open(void)
+{
+    char *json = malloc(DB_JSON_QUESTIONS_BUFFER);
+    if (json)
+        strcpy(json, "{\n  \"questions\": [\n");
+    return json;
+}
+
+int db_json_questions_add(char *json, char **row, int first)
+{
+    // Escape special characters in options for JSON
+    char opt_a[256], opt_b[256], opt_c[256], opt_d[256];
+    snprintf(opt_a, sizeof(opt_a), "A. %s", row[2]);
+    snprintf(opt_b, sizeof(opt_b), "B. %s", row[3]);
+    snprintf(opt_c, sizeof(opt_c), "C. %s", row[4]);
+    snprintf(opt_d, sizeof(opt_d), "D. %s", row[5]);
+
+    // Build question entry with proper formatting
+    char entry[4096];
+    snprintf(entry, sizeof(entry),
+             "    {\n"
+             "      \"question_id\": %s,\n"
+             "      \"content\": \"%s\",\n"
+             "      \"options\": [\n"
+             "        \"%s\",\n"
+             "        \"%s\",\n"
+             "        \"%s\",\n"
+             "        \"%s\"\n"
+             "      ]\n"
+             "    }",
+             row[0], // question_id
+             row[1], // question_text (content)
+             opt_a, opt_b, opt_c, opt_d);
+
+    if (strlen(json) + strlen(entry) + 2 + DB_JSON_TAIL_RESERVE > DB_JSON_QUESTIONS_BUFFER)
+        return -1;
+    if (!first)
+        strcat(json, ",\n");
+    strcat(json, entry);
+    return 0;
+}
+
+void db_json_questions_close(char *json)
+{
+    strcat(json, "\n  ]\n}");
+}
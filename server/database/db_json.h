@@ -0,0 +1,50 @@
+#ifndef DB_JSON_H
+#define DB_JSON_H
+
+// ===============================================
+// JSON builders for db_* result sets
+// ===============================================
+//
+// Each builder works on one row as an array of strings (same layout as
+// MYSQL_ROW), so it can be driven by any result source and benchmarked
+// without a database. Usage: open -> add per row -> close.
+
+#define DB_JSON_ROOMS_BUFFER 16384
+#define DB_JSON_LEADERBOARD_BUFFER 16384
+#define DB_JSON_QUESTIONS_BUFFER (1024 * 1024) // 1MB buffer for exam data
+#define DB_JSON_TAIL_RESERVE 16 // room for the closing brackets
+
+// *_add return 0, or -1 when the entry no longer fits the buffer (the row is
+// dropped and the document stays valid; callers stop adding)
+
+/**
+ * @brief Room list: {"rooms":[...]}
+ *
+ * row[0]=room_id, row[1]=room_name, row[2]=creator, row[3]=status,
+ * row[4]=participant_count, row[5]=max_participants, row[6]=num_questions,
+ * row[7]=time_limit_minutes, row[8]=created_at
+ */
+char *db_json_rooms_open(void);
+int db_json_rooms_add(char *json, char **row);
+void db_json_rooms_close(char *json);
+
+/**
+ * @brief Leaderboard: {"leaderboard":[...]}
+ *
+ * row[0]=username, row[1]=score, row[2]=total_questions,
+ * row[3]=submit_time, row[4]=time_taken_seconds
+ */
+char *db_json_leaderboard_open(void);
+int db_json_leaderboard_add(char *json, int rank, char **row);
+void db_json_leaderboard_close(char *json);
+
+/**
+ * @brief Exam questions: {"questions":[...]} (NEVER includes correct_answer)
+ *
+ * row[0]=id, row[1]=question_text, row[2..5]=option_a..option_d
+ */
+char *db_json_questions_open(void);
+int db_json_questions_add(char *json, char **row, int first);
+void db_json_questions_close(char *json);
+
+#endif // DB_JSON_H
@@ -0,0 +1,1274 @@
+#include "db_backend.h"
+#include "db_json.h"
+#include "db_seed.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <unistd.h>
+
+// ===============================================
+// MEMORY BACKEND - in-process stand-in for the MySQL schema
+// ===============================================
+//
+// Tables: users, sessions, questions, rooms, room_questions, participants,
+// exam_results. room_questions / participants / exam_results live inside
+// their room, so deleting a room cascades like the foreign keys do.
+// users and questions are seeded from the INSERT statements in schema.sql.
+//
+// Constraints mirrored from schema.sql: UNIQUE keys, foreign keys to users
+// and rooms, VARCHAR lengths (strict mode) and the CHECKs on num_questions /
+// time_limit_minutes. activity_logs is never read back by the server, so
+// db_log_activity drops the row (server.log has the same events).
+//
+// One rwlock: lookups run in parallel, writes are serialized.
+
+#define MEM_HASH_BUCKETS 4096 // power of 2
+#define MEM_USERNAME_MAX 20   // users.username VARCHAR(20)
+#define MEM_HASH_MAX 65       // users.password_hash VARCHAR(65)
+#define MEM_SESSION_ID_MAX 64 // sessions.session_id VARCHAR(64)
+#define MEM_ROOM_ID_MAX 32    // rooms.room_id VARCHAR(32)
+#define MEM_ROOM_NAME_MAX 100 // rooms.room_name VARCHAR(100)
+#define MEM_PRACTICE_ID_MAX 32 // practice_sessions.practice_id VARCHAR(32)
+#define MEM_CATEGORY_MAX 50    // practice_abilities.category VARCHAR(50)
+#define MEM_DEFAULT_MAX_PARTICIPANTS 50
+
+static const char *ROOM_STATUS_NAMES[] = {"NOT_STARTED", "IN_PROGRESS", "FINISHED"};
+
+typedef struct MemUser
+{
+    char username[MEM_USERNAME_MAX + 1];
+    char password_hash[MEM_HASH_MAX + 1];
+    int is_locked;
+    struct MemSession *active_session; // db_create_session keeps at most one active
+    struct MemUser *next;              // hash chain
+} MemUser;
+
+typedef struct MemSession
+{
+    char session_id[MEM_SESSION_ID_MAX + 1];
+    MemUser *user;
+    struct MemSession *next; // hash chain
+} MemSession;
+
+typedef struct
+{
+    int id;
+    char *text;
+    char *options[4]; // option_a .. option_d
+    char correct_answer;
+    char *difficulty; // easy / medium / hard
+    char *category;   // NULL if not set
+    int has_stats;    // question_stats row exists
+    DbQuestionStats stats;
+} MemQuestion;
+
+typedef struct MemPractice
+{
+    char practice_id[MEM_PRACTICE_ID_MAX + 1];
+    char username[MEM_USERNAME_MAX + 1];
+    int num_questions;
+    int time_limit_minutes;
+    time_t start_time;
+    int score;
+    struct MemPractice *next; // hash chain
+} MemPractice;
+
+typedef struct MemAbility
+{
+    char username[MEM_USERNAME_MAX + 1];
+    char category[MEM_CATEGORY_MAX + 1];
+    int rating;
+    int answers;
+    struct MemAbility *next; // hash chain (by username)
+} MemAbility;
+
+typedef struct
+{
+    char username[MEM_USERNAME_MAX + 1];
+    int score;
+    int total_questions;
+    time_t submit_time;
+    int time_taken_seconds;
+    char *answers;
+    unsigned long seq; // insertion order, tie-break after submit_time
+} MemResult;
+
+typedef struct MemRoom
+{
+    char room_id[MEM_ROOM_ID_MAX + 1];
+    char room_name[MEM_ROOM_NAME_MAX + 1];
+    char creator[MEM_USERNAME_MAX + 1];
+    int num_questions;
+    int time_limit_minutes;
+    int max_participants;
+    int status; // 0=NOT_STARTED, 1=IN_PROGRESS, 2=FINISHED
+    time_t created_at;
+    time_t start_time;
+    time_t finish_time;
+
+    int *question_ids; // room_questions ordered by question_order
+    int question_count;
+
+    char (*participants)[MEM_USERNAME_MAX + 1];
+    int participant_count;
+    int participant_capacity;
+
+    MemResult *results;
+    int result_count;
+    int result_capacity;
+
+    struct MemRoom *next; // hash chain
+} MemRoom;
+
+typedef struct
+{
+    pthread_rwlock_t lock;
+
+    MemUser *users[MEM_HASH_BUCKETS];
+    MemSession *sessions[MEM_HASH_BUCKETS];
+    MemRoom *rooms[MEM_HASH_BUCKETS];
+    MemPractice *practices[MEM_HASH_BUCKETS]; // completed practice sessions only
+    MemAbility *abilities[MEM_HASH_BUCKETS];
+
+    MemRoom **room_order; // creation order (list_rooms is created_at DESC)
+    int room_count;
+    int room_capacity;
+
+    MemQuestion *questions; // id = index + 1 (AUTO_INCREMENT)
+    int question_count;
+    int question_capacity;
+
+    unsigned int rand_seed; // ORDER BY RAND(), guarded by the write lock
+    unsigned long result_seq;
+} MemoryDb;
+
+extern const DbBackend db_memory_backend;
+
+// ===============================================
+// Helpers
+// ===============================================
+
+static unsigned int mem_hash(const char *key)
+{
+    unsigned int h = 2166136261u; // FNV-1a
+    for (; *key; key++)
+        h = (h ^ (unsigned char)*key) * 16777619u;
+    return h & (MEM_HASH_BUCKETS - 1);
+}
+
+static MemUser *find_user(MemoryDb *db, const char *username)
+{
+    for (MemUser *u = db->users[mem_hash(username)]; u; u = u->next)
+    {
+        if (strcmp(u->username, username) == 0)
+            return u;
+    }
+    return NULL;
+}
+
+static MemSession *find_session(MemoryDb *db, const char *session_id)
+{
+    for (MemSession *s = db->sessions[mem_hash(session_id)]; s; s = s->next)
+    {
+        if (strcmp(s->session_id, session_id) == 0)
+            return s;
+    }
+    return NULL;
+}
+
+static MemRoom *find_room(MemoryDb *db, const char *room_id)
+{
+    for (MemRoom *r = db->rooms[mem_hash(room_id)]; r; r = r->next)
+    {
+        if (strcmp(r->room_id, room_id) == 0)
+            return r;
+    }
+    return NULL;
+}
+
+static int find_participant(const MemRoom *room, const char *username)
+{
+    for (int i = 0; i < room->participant_count; i++)
+    {
+        if (strcmp(room->participants[i], username) == 0)
+            return i;
+    }
+    return -1;
+}
+
+static MemResult *find_result(MemRoom *room, const char *username)
+{
+    for (int i = 0; i < room->result_count; i++)
+    {
+        if (strcmp(room->results[i].username, username) == 0)
+            return &room->results[i];
+    }
+    return NULL;
+}
+
+// Grow an array to hold at least `needed` elements
+static int ensure_capacity(void **items, int *capacity, int needed, size_t item_size)
+{
+    if (needed <= *capacity)
+        return 0;
+    int new_capacity = *capacity ? *capacity * 2 : 8;
+    while (new_capacity < needed)
+        new_capacity *= 2;
+    void *grown = realloc(*items, (size_t)new_capacity * item_size);
+    if (!grown)
+        return -1;
+    *items = grown;
+    *capacity = new_capacity;
+    return 0;
+}
+
+// TIMESTAMP columns as MySQL returns them: "YYYY-MM-DD HH:MM:SS" (local time)
+static void format_timestamp(time_t t, char out[20])
+{
+    struct tm tm_info;
+    localtime_r(&t, &tm_info);
+    strftime(out, 20, "%Y-%m-%d %H:%M:%S", &tm_info);
+}
+
+static void session_unlink(MemoryDb *db, MemSession *session)
+{
+    MemSession **link = &db->sessions[mem_hash(session->session_id)];
+    while (*link && *link != session)
+        link = &(*link)->next;
+    if (*link)
+        *link = session->next;
+    if (session->user && session->user->active_session == session)
+        session->user->active_session = NULL;
+    free(session);
+}
+
+static void room_free(MemRoom *room)
+{
+    for (int i = 0; i < room->result_count; i++)
+        free(room->results[i].answers);
+    free(room->results);
+    free(room->participants);
+    free(room->question_ids);
+    free(room);
+}
+
+// ============================= User operations ===============================
+static int memdb_insert_user(MemoryDb *db, const char *username, const char *password_hash, int is_locked)
+{
+    if (strlen(username) > MEM_USERNAME_MAX || strlen(password_hash) > MEM_HASH_MAX)
+        return -1;
+    if (find_user(db, username)) // UNIQUE(username)
+        return -1;
+
+    MemUser *user = calloc(1, sizeof(MemUser));
+    if (!user)
+        return -1;
+    strcpy(user->username, username);
+    strcpy(user->password_hash, password_hash);
+    user->is_locked = is_locked;
+
+    unsigned int bucket = mem_hash(username);
+    user->next = db->users[bucket];
+    db->users[bucket] = user;
+    return 0;
+}
+
+static int memdb_create_user(void *impl, const char *username, const char *password_hash)
+{
+    MemoryDb *db = impl;
+    pthread_rwlock_wrlock(&db->lock);
+    int result = memdb_insert_user(db, username, password_hash, 0);
+    pthread_rwlock_unlock(&db->lock);
+    return result;
+}
+
+static int memdb_check_username_exists(void *impl, const char *username)
+{
+    MemoryDb *db = impl;
+    pthread_rwlock_rdlock(&db->lock);
+    int exists = find_user(db, username) != NULL;
+    pthread_rwlock_unlock(&db->lock);
+    return exists;
+}
+
+static int memdb_verify_login(void *impl, const char *username, const char *password_hash)
+{
+    MemoryDb *db = impl;
+    pthread_rwlock_rdlock(&db->lock);
+    MemUser *user = find_user(db, username);
+    int valid = user && strcmp(user->password_hash, password_hash) == 0;
+    pthread_rwlock_unlock(&db->lock);
+    return valid;
+}
+
+static int memdb_is_account_locked(void *impl, const char *username)
+{
+    MemoryDb *db = impl;
+    pthread_rwlock_rdlock(&db->lock);
+    MemUser *user = find_user(db, username);
+    int is_locked = user ? user->is_locked : 0;
+    pthread_rwlock_unlock(&db->lock);
+    return is_locked;
+}
+
+// ============================ Session operations =============================
+// Only active sessions are kept: inactive rows are never read by the server
+static int memdb_create_session(void *impl, const char *session_id, const char *username)
+{
+    MemoryDb *db = impl;
+    pthread_rwlock_wrlock(&db->lock);
+
+    MemUser *user = find_user(db, username); // FK sessions.username -> users
+    if (!user || strlen(session_id) > MEM_SESSION_ID_MAX || find_session(db, session_id))
+    {
+        pthread_rwlock_unlock(&db->lock);
+        return -1;
+    }
+
+    // Deactivate existing sessions
+    if (user->active_session)
+        session_unlink(db, user->active_session);
+
+    MemSession *session = calloc(1, sizeof(MemSession));
+    if (!session)
+    {
+        pthread_rwlock_unlock(&db->lock);
+        return -1;
+    }
+    strcpy(session->session_id, session_id);
+    session->user = user;
+    unsigned int bucket = mem_hash(session_id);
+    session->next = db->sessions[bucket];
+    db->sessions[bucket] = session;
+    user->active_session = session;
+
+    pthread_rwlock_unlock(&db->lock);
+    return 0;
+}
+
+static int memdb_destroy_session(void *impl, const char *session_id)
+{
+    MemoryDb *db = impl;
+    pthread_rwlock_wrlock(&db->lock);
+    MemSession *session = find_session(db, session_id);
+    if (session)
+        session_unlink(db, session);
+    pthread_rwlock_unlock(&db->lock);
+    return 0; // UPDATE matching no row still succeeds
+}
+
+static int memdb_check_user_logged_in(void *impl, const char *username)
+{
+    MemoryDb *db = impl;
+    pthread_rwlock_rdlock(&db->lock);
+    MemUser *user = find_user(db, username);
+    int logged_in = user && user->active_session;
+    pthread_rwlock_unlock(&db->lock);
+    return logged_in;
+}
+
+// =============================== Logging =====================================
+static void memdb_log_activity(void *impl, const char *level, const char *username, const char *action, const char *details)
+{
+    (void)impl;
+    (void)level;
+    (void)username;
+    (void)action;
+    (void)details;
+}
+
+// ============================= Room operations ===============================
+static int memdb_create_room(void *impl, const char *room_id, const char *room_name, const char *creator, int num_questions, int time_limit)
+{
+    MemoryDb *db = impl;
+    pthread_rwlock_wrlock(&db->lock);
+
+    if (strlen(room_id) > MEM_ROOM_ID_MAX || strlen(room_name) > MEM_ROOM_NAME_MAX ||
+        find_room(db, room_id) || !find_user(db, creator) ||
+        num_questions < 5 || num_questions > 50 || time_limit < 5 || time_limit > 120)
+    {
+        fprintf(stderr, "[DB ERROR] Failed to create room: constraint violation\n");
+        pthread_rwlock_unlock(&db->lock);
+        return -1;
+    }
+
+    MemRoom *room = calloc(1, sizeof(MemRoom));
+    int assigned = num_questions < db->question_count ? num_questions : db->question_count;
+    int *pool = malloc(sizeof(int) * (db->question_count ? db->question_count : 1));
+    if (!room || !pool || ensure_capacity((void **)&db->room_order, &db->room_capacity, db->room_count + 1, sizeof(MemRoom *)) < 0)
+    {
+        free(room);
+        free(pool);
+        pthread_rwlock_unlock(&db->lock);
+        return -1;
+    }
+
+    strcpy(room->room_id, room_id);
+    strcpy(room->room_name, room_name);
+    strcpy(room->creator, creator);
+    room->num_questions = num_questions;
+    room->time_limit_minutes = time_limit;
+    room->max_participants = MEM_DEFAULT_MAX_PARTICIPANTS;
+    room->status = 0;
+    room->created_at = time(NULL);
+
+    // Select random questions (partial Fisher-Yates = ORDER BY RAND() LIMIT n)
+    for (int i = 0; i < db->question_count; i++)
+        pool[i] = db->questions[i].id;
+    for (int i = 0; i < assigned; i++)
+    {
+        int j = i + rand_r(&db->rand_seed) % (db->question_count - i);
+        int tmp = pool[i];
+        pool[i] = pool[j];
+        pool[j] = tmp;
+    }
+    room->question_ids = pool;
+    room->question_count = assigned;
+
+    // Creator auto joins
+    if (ensure_capacity((void **)&room->participants, &room->participant_capacity, 1, sizeof(room->participants[0])) < 0)
+    {
+        room_free(room);
+        pthread_rwlock_unlock(&db->lock);
+        return -1;
+    }
+    strcpy(room->participants[room->participant_count++], creator);
+
+    unsigned int bucket = mem_hash(room_id);
+    room->next = db->rooms[bucket];
+    db->rooms[bucket] = room;
+    db->room_order[db->room_count++] = room;
+
+    pthread_rwlock_unlock(&db->lock);
+
+    printf("[DB] Room '%s' created with %d random questions assigned\n", room_id, num_questions);
+    return 0;
+}
+
+// A room as the 9 strings of db_json_rooms_add (list_rooms / get_rooms)
+typedef struct
+{
+    char participant_count[16], max_participants[16], num_questions[16], time_limit[16], created_at[20];
+    char *row[9];
+} MemRoomRow;
+
+// Caller holds db->lock
+static char **room_row(MemRoom *room, MemRoomRow *out)
+{
+    snprintf(out->participant_count, sizeof(out->participant_count), "%d", room->participant_count);
+    snprintf(out->max_participants, sizeof(out->max_participants), "%d", room->max_participants);
+    snprintf(out->num_questions, sizeof(out->num_questions), "%d", room->num_questions);
+    snprintf(out->time_limit, sizeof(out->time_limit), "%d", room->time_limit_minutes);
+    format_timestamp(room->created_at, out->created_at);
+
+    char *row[9] = {room->room_id, room->room_name, room->creator, (char *)ROOM_STATUS_NAMES[room->status],
+                    out->participant_count, out->max_participants, out->num_questions, out->time_limit, out->created_at};
+    memcpy(out->row, row, sizeof(row));
+    return out->row;
+}
+
+static char *memdb_list_rooms(void *impl, const char *status_filter)
+{
+    MemoryDb *db = impl;
+    pthread_rwlock_rdlock(&db->lock);
+
+    char *json = db_json_rooms_open();
+    if (!json)
+    {
+        pthread_rwlock_unlock(&db->lock);
+        return NULL;
+    }
+
+    int all = strcmp(status_filter, "ALL") == 0;
+    for (int i = db->room_count - 1; i >= 0; i--)
+    {
+        MemRoom *room = db->room_order[i];
+        if (!all && strcasecmp(ROOM_STATUS_NAMES[room->status], status_filter) != 0)
+            continue;
+
+        MemRoomRow row;
+        if (db_json_rooms_add(json, room_row(room, &row)) < 0)
+            break; // buffer full
+    }
+
+    db_json_rooms_close(json);
+    pthread_rwlock_unlock(&db->lock);
+    return json;
+}
+
+static int memdb_get_rooms(void *impl, const char *const *room_ids, int count, DbRoomRowFn fn, void *ctx)
+{
+    MemoryDb *db = impl;
+    pthread_rwlock_rdlock(&db->lock);
+
+    int found = 0;
+    for (int i = 0; i < count; i++)
+    {
+        MemRoom *room = find_room(db, room_ids[i]);
+        if (!room)
+            continue; // deleted
+        MemRoomRow row;
+        found++;
+        if (fn(ctx, room_row(room, &row)) < 0)
+            break;
+    }
+
+    pthread_rwlock_unlock(&db->lock);
+    return found;
+}
+
+// room_order is in creation order, i.e. sorted by created_at (and by room_id
+// within a second, ids being increasing): a page is a backwards walk from the
+// cursor, found by binary search.
+static int memdb_list_rooms_page(void *impl, const DbRoomPage *page, DbRoomRowFn fn, void *ctx)
+{
+    MemoryDb *db = impl;
+
+    time_t after = 0;
+    if (page->after_room_id)
+    {
+        struct tm tm_info = {0};
+        if (sscanf(page->after_created, "%d-%d-%d %d:%d:%d", &tm_info.tm_year, &tm_info.tm_mon, &tm_info.tm_mday,
+                   &tm_info.tm_hour, &tm_info.tm_min, &tm_info.tm_sec) != 6)
+            return -1;
+        tm_info.tm_year -= 1900;
+        tm_info.tm_mon -= 1;
+        tm_info.tm_isdst = -1;
+        after = mktime(&tm_info);
+    }
+
+    pthread_rwlock_rdlock(&db->lock);
+
+    // Rooms [0, end) are older than or in the same second as the cursor
+    int end = db->room_count;
+    if (page->after_room_id)
+    {
+        int lo = 0, hi = db->room_count;
+        while (lo < hi)
+        {
+            int mid = lo + (hi - lo) / 2;
+            if (db->room_order[mid]->created_at <= after)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        end = lo;
+    }
+
+    int all = strcmp(page->status, "ALL") == 0;
+    size_t prefix_len = page->name_prefix ? strlen(page->name_prefix) : 0;
+    int rows = 0;
+    for (int i = end - 1; i >= 0 && rows < page->limit; i--)
+    {
+        MemRoom *room = db->room_order[i];
+        if (page->after_room_id && room->created_at == after && strcmp(room->room_id, page->after_room_id) >= 0)
+            continue; // same second, not after the cursor
+        if (!all && strcasecmp(ROOM_STATUS_NAMES[room->status], page->status) != 0)
+            continue;
+        if (page->creator && strcmp(room->creator, page->creator) != 0)
+            continue;
+        if (prefix_len && strncmp(room->room_name, page->name_prefix, prefix_len) != 0)
+            continue;
+
+        MemRoomRow row;
+        rows++;
+        if (fn(ctx, room_row(room, &row)) < 0)
+            break;
+    }
+
+    pthread_rwlock_unlock(&db->lock);
+    return rows;
+}
+
+static int memdb_join_room(void *impl, const char *room_id, const char *username)
+{
+    MemoryDb *db = impl;
+    pthread_rwlock_wrlock(&db->lock);
+
+    // INSERT IGNORE: duplicates and foreign key failures are ignored, not errors
+    MemRoom *room = find_room(db, room_id);
+    int joined = 0;
+    if (room && find_user(db, username) && find_participant(room, username) < 0 &&
+        ensure_capacity((void **)&room->participants, &room->participant_capacity,
+                        room->participant_count + 1, sizeof(room->participants[0])) == 0)
+    {
+        strcpy(room->participants[room->participant_count++], username);
+        joined = 1;
+    }
+
+    pthread_rwlock_unlock(&db->lock);
+    return joined;
+}
+
+static int memdb_get_room_status(void *impl, const char *room_id)
+{
+    MemoryDb *db = impl;
+    pthread_rwlock_rdlock(&db->lock);
+    MemRoom *room = find_room(db, room_id);
+    int status = room ? room->status : -1;
+    pthread_rwlock_unlock(&db->lock);
+    return status;
+}
+
+static int memdb_get_room_participant_count(void *impl, const char *room_id)
+{
+    MemoryDb *db = impl;
+    pthread_rwlock_rdlock(&db->lock);
+    MemRoom *room = find_room(db, room_id);
+    int count = room ? room->participant_count : 0;
+    pthread_rwlock_unlock(&db->lock);
+    return count;
+}
+
+static int memdb_get_room_time_limit(void *impl, const char *room_id)
+{
+    MemoryDb *db = impl;
+    pthread_rwlock_rdlock(&db->lock);
+    MemRoom *room = find_room(db, room_id);
+    int minutes = room ? room->time_limit_minutes : -1;
+    pthread_rwlock_unlock(&db->lock);
+    return minutes;
+}
+
+// ============================= Exam operations ===============================
+// ORDER BY score DESC, submit_time ASC
+static int compare_results(const void *a, const void *b)
+{
+    const MemResult *x = *(const MemResult *const *)a;
+    const MemResult *y = *(const MemResult *const *)b;
+    if (x->score != y->score)
+        return y->score - x->score;
+    if (x->submit_time != y->submit_time)
+        return x->submit_time < y->submit_time ? -1 : 1;
+    return x->seq < y->seq ? -1 : (x->seq > y->seq);
+}
+
+static char *memdb_get_room_leaderboard(void *impl, const char *room_id)
+{
+    MemoryDb *db = impl;
+    pthread_rwlock_rdlock(&db->lock);
+
+    MemRoom *room = find_room(db, room_id);
+    int count = room ? room->result_count : 0;
+    MemResult **sorted = malloc(sizeof(MemResult *) * (count ? count : 1));
+    char *json = db_json_leaderboard_open();
+    if (!sorted || !json)
+    {
+        free(sorted);
+        free(json);
+        pthread_rwlock_unlock(&db->lock);
+        return NULL;
+    }
+
+    for (int i = 0; i < count; i++)
+        sorted[i] = &room->results[i];
+    qsort(sorted, count, sizeof(MemResult *), compare_results);
+
+    for (int i = 0; i < count; i++)
+    {
+        char score[16], total[16], submit_time[20], time_taken[16];
+        snprintf(score, sizeof(score), "%d", sorted[i]->score);
+        snprintf(total, sizeof(total), "%d", sorted[i]->total_questions);
+        format_timestamp(sorted[i]->submit_time, submit_time);
+        snprintf(time_taken, sizeof(time_taken), "%d", sorted[i]->time_taken_seconds);
+
+        char *row[5] = {sorted[i]->username, score, total, submit_time, time_taken};
+        if (db_json_leaderboard_add(json, i + 1, row) < 0)
+            break; // buffer full
+    }
+
+    db_json_leaderboard_close(json);
+    pthread_rwlock_unlock(&db->lock);
+    free(sorted);
+    return json;
+}
+
+static char *memdb_get_exam_questions(void *impl, const char *room_id)
+{
+    MemoryDb *db = impl;
+    pthread_rwlock_rdlock(&db->lock);
+
+    char *json = db_json_questions_open();
+    if (!json)
+    {
+        pthread_rwlock_unlock(&db->lock);
+        return NULL;
+    }
+
+    MemRoom *room = find_room(db, room_id);
+    for (int i = 0; room && i < room->question_count; i++)
+    {
+        MemQuestion *q = &db->questions[room->question_ids[i] - 1];
+        char id[16];
+        snprintf(id, sizeof(id), "%d", q->id);
+        char *row[6] = {id, q->text, q->options[0], q->options[1], q->options[2], q->options[3]};
+        db_json_questions_add(json, row, i == 0);
+    }
+
+    db_json_questions_close(json);
+    pthread_rwlock_unlock(&db->lock);
+    return json;
+}
+
+static int memdb_leave_room(void *impl, const char *room_id, const char *username)
+{
+    MemoryDb *db = impl;
+    pthread_rwlock_wrlock(&db->lock);
+    MemRoom *room = find_room(db, room_id);
+    int idx = room ? find_participant(room, username) : -1;
+    if (idx >= 0)
+    {
+        memmove(room->participants[idx], room->participants[idx + 1],
+                sizeof(room->participants[0]) * (room->participant_count - idx - 1));
+        room->participant_count--;
+    }
+    pthread_rwlock_unlock(&db->lock);
+    return 0;
+}
+
+static int memdb_start_room(void *impl, const char *room_id)
+{
+    MemoryDb *db = impl;
+    pthread_rwlock_wrlock(&db->lock);
+    MemRoom *room = find_room(db, room_id);
+    if (room)
+    {
+        room->status = 1;
+        room->start_time = time(NULL);
+    }
+    pthread_rwlock_unlock(&db->lock);
+    return 0;
+}
+
+static int memdb_finish_room(void *impl, const char *room_id)
+{
+    MemoryDb *db = impl;
+    pthread_rwlock_wrlock(&db->lock);
+    MemRoom *room = find_room(db, room_id);
+    if (room)
+    {
+        room->status = 2;
+        room->finish_time = time(NULL);
+    }
+    pthread_rwlock_unlock(&db->lock);
+
+    printf("[DB] Room '%s' marked as FINISHED\n", room_id);
+    return 0;
+}
+
+static int memdb_is_room_creator(void *impl, const char *room_id, const char *username)
+{
+    MemoryDb *db = impl;
+    pthread_rwlock_rdlock(&db->lock);
+    MemRoom *room = find_room(db, room_id);
+    int is_creator = room && strcmp(room->creator, username) == 0;
+    pthread_rwlock_unlock(&db->lock);
+    return is_creator;
+}
+
+static int memdb_is_participant(void *impl, const char *room_id, const char *username)
+{
+    MemoryDb *db = impl;
+    pthread_rwlock_rdlock(&db->lock);
+    MemRoom *room = find_room(db, room_id);
+    int in_room = room && find_participant(room, username) >= 0;
+    pthread_rwlock_unlock(&db->lock);
+    return in_room;
+}
+
+static int memdb_delete_room(void *impl, const char *room_id)
+{
+    MemoryDb *db = impl;
+    pthread_rwlock_wrlock(&db->lock);
+
+    MemRoom **link = &db->rooms[mem_hash(room_id)];
+    while (*link && strcmp((*link)->room_id, room_id) != 0)
+        link = &(*link)->next;
+    MemRoom *room = *link;
+    if (!room)
+    {
+        pthread_rwlock_unlock(&db->lock);
+        fprintf(stderr, "[DB WARNING] Room '%s' not found for deletion\n", room_id);
+        return -1;
+    }
+    *link = room->next;
+
+    for (int i = 0; i < db->room_count; i++)
+    {
+        if (db->room_order[i] == room)
+        {
+            memmove(&db->room_order[i], &db->room_order[i + 1], sizeof(MemRoom *) * (db->room_count - i - 1));
+            db->room_count--;
+            break;
+        }
+    }
+    room_free(room); // cascades participants, room_questions, exam_results
+
+    pthread_rwlock_unlock(&db->lock);
+    printf("[DB] Room '%s' deleted successfully (cascaded to participants, questions, results)\n", room_id);
+    return 0;
+}
+
+// ========================== Submit exam operations ===========================
+static int memdb_get_correct_answers(void *impl, const char *room_id, char *answers_out, int *total_out)
+{
+    MemoryDb *db = impl;
+    pthread_rwlock_rdlock(&db->lock);
+
+    MemRoom *room = find_room(db, room_id);
+    int count = 0;
+    for (int i = 0; room && i < room->question_count; i++)
+        answers_out[count++] = db->questions[room->question_ids[i] - 1].correct_answer;
+    answers_out[count] = '\0';
+    *total_out = count;
+
+    pthread_rwlock_unlock(&db->lock);
+    return 0;
+}
+
+// Caller holds the write lock. -1 on constraint violation (exam_results keys)
+static int insert_result(MemoryDb *db, const char *room_id, const char *username, int score, int total, const char *answers, int time_taken, time_t submit_time)
+{
+    MemRoom *room = find_room(db, room_id);
+    if (!room || !find_user(db, username) || find_result(room, username) ||
+        ensure_capacity((void **)&room->results, &room->result_capacity, room->result_count + 1, sizeof(MemResult)) < 0)
+        return -1;
+
+    MemResult *result = &room->results[room->result_count];
+    memset(result, 0, sizeof(*result));
+    strcpy(result->username, username);
+    result->score = score;
+    result->total_questions = total;
+    result->submit_time = submit_time;
+    result->time_taken_seconds = time_taken;
+    result->answers = strdup(answers);
+    result->seq = db->result_seq++;
+    room->result_count++;
+    return 0;
+}
+
+static int memdb_submit_exam(void *impl, const char *room_id, const char *username, int score, int total, const char *answers, int time_taken)
+{
+    MemoryDb *db = impl;
+    pthread_rwlock_wrlock(&db->lock);
+    int rc = insert_result(db, room_id, username, score, total, answers, time_taken, time(NULL));
+    pthread_rwlock_unlock(&db->lock);
+
+    if (rc < 0)
+    {
+        fprintf(stderr, "[DB ERROR] Failed to submit exam: constraint violation\n");
+        return -1;
+    }
+    printf("[DB] Exam submitted for user '%s' in room '%s': %d/%d\n", username, room_id, score, total);
+    return 0;
+}
+
+static int memdb_submit_exam_batch(void *impl, const DbExamResult *results, int count)
+{
+    MemoryDb *db = impl;
+    int stored = 0;
+    pthread_rwlock_wrlock(&db->lock);
+    for (int i = 0; i < count; i++)
+    {
+        const DbExamResult *r = &results[i];
+        if (insert_result(db, r->room_id, r->username, r->score, r->total, r->answers, r->time_taken, (time_t)r->submit_time) == 0)
+            stored++;
+    }
+    pthread_rwlock_unlock(&db->lock);
+
+    printf("[DB] Committed %d/%d journaled exam result(s)\n", stored, count);
+    return 0;
+}
+
+static int memdb_check_already_submitted(void *impl, const char *room_id, const char *username)
+{
+    MemoryDb *db = impl;
+    pthread_rwlock_rdlock(&db->lock);
+    MemRoom *room = find_room(db, room_id);
+    int submitted = room && find_result(room, username);
+    pthread_rwlock_unlock(&db->lock);
+    return submitted;
+}
+
+static char *memdb_get_exam_result(void *impl, const char *room_id, const char *username)
+{
+    MemoryDb *db = impl;
+    pthread_rwlock_rdlock(&db->lock);
+
+    MemRoom *room = find_room(db, room_id);
+    MemResult *result = room ? find_result(room, username) : NULL;
+    char *result_str = NULL; // Format: "score|total"
+    if (result)
+    {
+        result_str = malloc(64);
+        if (result_str)
+            snprintf(result_str, 64, "%d|%d", result->score, result->total_questions);
+    }
+
+    pthread_rwlock_unlock(&db->lock);
+    return result_str;
+}
+
+static int memdb_check_all_submitted(void *impl, const char *room_id)
+{
+    MemoryDb *db = impl;
+    pthread_rwlock_rdlock(&db->lock);
+    MemRoom *room = find_room(db, room_id);
+    int all = room && room->participant_count > 0 && room->result_count >= room->participant_count;
+    pthread_rwlock_unlock(&db->lock);
+    return all;
+}
+
+static int memdb_get_room_question_ids(void *impl, const char *room_id, int *ids_out, int max)
+{
+    MemoryDb *db = impl;
+    pthread_rwlock_rdlock(&db->lock);
+    MemRoom *room = find_room(db, room_id);
+    int count = room ? (room->question_count < max ? room->question_count : max) : 0;
+    for (int i = 0; i < count; i++)
+        ids_out[i] = room->question_ids[i];
+    pthread_rwlock_unlock(&db->lock);
+    return count;
+}
+
+// ============================ Practice operations ============================
+static int memdb_load_questions(void *impl, DbQuestionFn fn, void *ctx)
+{
+    MemoryDb *db = impl;
+    pthread_rwlock_rdlock(&db->lock);
+    int count = 0;
+    for (int i = 0; i < db->question_count; i++)
+    {
+        MemQuestion *q = &db->questions[i];
+        DbQuestion question = {q->id, q->text, {q->options[0], q->options[1], q->options[2], q->options[3]},
+                               q->correct_answer, q->difficulty, q->category};
+        count++;
+        if (fn(ctx, &question) < 0)
+            break;
+    }
+    pthread_rwlock_unlock(&db->lock);
+    return count;
+}
+
+static int memdb_save_practice_results(void *impl, const DbPracticeResult *results, int count)
+{
+    MemoryDb *db = impl;
+    pthread_rwlock_wrlock(&db->lock);
+    for (int i = 0; i < count; i++)
+    {
+        const DbPracticeResult *r = &results[i];
+        unsigned int b = mem_hash(r->practice_id);
+        MemPractice *p = db->practices[b];
+        while (p && strcmp(p->practice_id, r->practice_id) != 0)
+            p = p->next;
+        // UNIQUE (practice_id) and FOREIGN KEY (username): skipped like the other backends
+        if (p || strlen(r->practice_id) > MEM_PRACTICE_ID_MAX || !find_user(db, r->username))
+            continue;
+
+        p = calloc(1, sizeof(MemPractice));
+        if (!p)
+        {
+            pthread_rwlock_unlock(&db->lock);
+            return -1;
+        }
+        strcpy(p->practice_id, r->practice_id);
+        strcpy(p->username, r->username);
+        p->num_questions = r->num_questions;
+        p->time_limit_minutes = r->time_limit;
+        p->start_time = (time_t)r->start_time;
+        p->score = r->score;
+        p->next = db->practices[b];
+        db->practices[b] = p;
+    }
+    pthread_rwlock_unlock(&db->lock);
+    return 0;
+}
+
+static int memdb_load_abilities(void *impl, DbAbilityFn fn, void *ctx)
+{
+    MemoryDb *db = impl;
+    pthread_rwlock_rdlock(&db->lock);
+    int count = 0;
+    for (int b = 0; b < MEM_HASH_BUCKETS; b++)
+    {
+        for (MemAbility *a = db->abilities[b]; a; a = a->next)
+        {
+            DbAbility ability = {a->username, a->category, a->rating, a->answers};
+            count++;
+            if (fn(ctx, &ability) < 0)
+            {
+                pthread_rwlock_unlock(&db->lock);
+                return count;
+            }
+        }
+    }
+    pthread_rwlock_unlock(&db->lock);
+    return count;
+}
+
+static int memdb_save_abilities(void *impl, const DbAbility *abilities, int count)
+{
+    MemoryDb *db = impl;
+    pthread_rwlock_wrlock(&db->lock);
+    for (int i = 0; i < count; i++)
+    {
+        const DbAbility *r = &abilities[i];
+        // FOREIGN KEY (username): skipped like the other backends
+        if (strlen(r->category) > MEM_CATEGORY_MAX || !find_user(db, r->username))
+            continue;
+
+        unsigned int b = mem_hash(r->username);
+        MemAbility *a = db->abilities[b];
+        while (a && (strcmp(a->username, r->username) != 0 || strcmp(a->category, r->category) != 0))
+            a = a->next;
+        if (!a)
+        {
+            // PRIMARY KEY (username, category): insert once, update afterwards
+            a = calloc(1, sizeof(MemAbility));
+            if (!a)
+            {
+                pthread_rwlock_unlock(&db->lock);
+                return -1;
+            }
+            strcpy(a->username, r->username);
+            strcpy(a->category, r->category);
+            a->next = db->abilities[b];
+            db->abilities[b] = a;
+        }
+        a->rating = r->rating;
+        a->answers = r->answers;
+    }
+    pthread_rwlock_unlock(&db->lock);
+    return 0;
+}
+
+// ============================== Item statistics ==============================
+static int memdb_load_question_stats(void *impl, DbQuestionStatsFn fn, void *ctx)
+{
+    MemoryDb *db = impl;
+    pthread_rwlock_rdlock(&db->lock);
+    int count = 0;
+    for (int i = 0; i < db->question_count; i++)
+    {
+        if (!db->questions[i].has_stats)
+            continue;
+        count++;
+        if (fn(ctx, &db->questions[i].stats) < 0)
+            break;
+    }
+    pthread_rwlock_unlock(&db->lock);
+    return count;
+}
+
+static int memdb_save_question_stats(void *impl, const DbQuestionStats *stats, int count)
+{
+    MemoryDb *db = impl;
+    pthread_rwlock_wrlock(&db->lock);
+    for (int i = 0; i < count; i++)
+    {
+        // FOREIGN KEY (question_id): id = index + 1
+        if (stats[i].question_id < 1 || stats[i].question_id > db->question_count)
+            continue;
+        MemQuestion *q = &db->questions[stats[i].question_id - 1];
+        q->stats = stats[i];
+        q->has_stats = 1;
+    }
+    pthread_rwlock_unlock(&db->lock);
+    return 0;
+}
+
+// ================================ Stats ======================================
+static int memdb_count_rooms_by_status(void *impl, int *not_started, int *in_progress, int *finished)
+{
+    MemoryDb *db = impl;
+    int counts[3] = {0, 0, 0};
+    pthread_rwlock_rdlock(&db->lock);
+    for (int i = 0; i < db->room_count; i++)
+        counts[db->room_order[i]->status]++;
+    pthread_rwlock_unlock(&db->lock);
+
+    *not_started = counts[0];
+    *in_progress = counts[1];
+    *finished = counts[2];
+    return 0;
+}
+
+// ===============================================
+// Seeding from schema.sql (db_seed.c parses the INSERTs)
+// ===============================================
+
+static int seed_insert_question(MemoryDb *db, const DbSeedRow *row)
+{
+    const char *text = db_seed_value(row, "question_text");
+    const char *options[4] = {db_seed_value(row, "option_a"), db_seed_value(row, "option_b"),
+                              db_seed_value(row, "option_c"), db_seed_value(row, "option_d")};
+    const char *correct = db_seed_value(row, "correct_answer");
+    const char *difficulty = db_seed_value(row, "difficulty");
+    const char *category = db_seed_value(row, "category");
+    if (!text || !options[0] || !options[1] || !options[2] || !options[3] || !correct ||
+        correct[0] < 'A' || correct[0] > 'D')
+        return -1;
+
+    if (ensure_capacity((void **)&db->questions, &db->question_capacity, db->question_count + 1, sizeof(MemQuestion)) < 0)
+        return -1;
+    MemQuestion *q = &db->questions[db->question_count];
+    q->id = db->question_count + 1;
+    q->text = strdup(text);
+    for (int i = 0; i < 4; i++)
+        q->options[i] = strdup(options[i]);
+    q->correct_answer = correct[0];
+    q->difficulty = strdup(difficulty ? difficulty : "medium"); // column DEFAULT
+    q->category = category ? strdup(category) : NULL;
+    db->question_count++;
+    return 0;
+}
+
+static int seed_insert_user(MemoryDb *db, const DbSeedRow *row)
+{
+    const char *username = db_seed_value(row, "username");
+    const char *password_hash = db_seed_value(row, "password_hash");
+    const char *is_locked = db_seed_value(row, "is_locked");
+    if (!username || !password_hash)
+        return -1;
+    return memdb_insert_user(db, username, password_hash, is_locked ? atoi(is_locked) : 0);
+}
+
+static int seed_insert(void *ctx, const char *table, const DbSeedRow *row)
+{
+    if (strcmp(table, "users") == 0)
+        return seed_insert_user(ctx, row);
+    if (strcmp(table, "questions") == 0)
+        return seed_insert_question(ctx, row);
+    return -1;
+}
+
+static int seed_from_schema(MemoryDb *db, const char *seed_file)
+{
+    int rows = db_seed_load(seed_file, seed_insert, db);
+    if (rows < 0)
+        return -1;
+
+    printf("[DB] Memory backend seeded from %s: %d users, %d questions\n",
+           seed_file, rows - db->question_count, db->question_count);
+    if (db->question_count == 0)
+    {
+        fprintf(stderr, "[DB ERROR] No questions found in %s\n", seed_file);
+        return -1;
+    }
+    return 0;
+}
+
+// ===============================================
+// Open / close
+// ===============================================
+
+static void memdb_close(void *impl)
+{
+    MemoryDb *db = impl;
+    for (int b = 0; b < MEM_HASH_BUCKETS; b++)
+    {
+        for (MemUser *u = db->users[b], *next; u; u = next)
+        {
+            next = u->next;
+            free(u);
+        }
+        for (MemSession *s = db->sessions[b], *next; s; s = next)
+        {
+            next = s->next;
+            free(s);
+        }
+        for (MemPractice *p = db->practices[b], *next; p; p = next)
+        {
+            next = p->next;
+            free(p);
+        }
+        for (MemAbility *a = db->abilities[b], *next; a; a = next)
+        {
+            next = a->next;
+            free(a);
+        }
+    }
+    for (int i = 0; i < db->room_count; i++)
+        room_free(db->room_order[i]);
+    free(db->room_order);
+    for (int i = 0; i < db->question_count; i++)
+    {
+        free(db->questions[i].text);
+        for (int j = 0; j < 4; j++)
+            free(db->questions[i].options[j]);
+        free(db->questions[i].difficulty);
+        free(db->questions[i].category);
+    }
+    free(db->questions);
+    pthread_rwlock_destroy(&db->lock);
+    free(db);
+}
+
+int db_memory_open(Database *db, const char *seed_file)
+{
+    MemoryDb *mdb = calloc(1, sizeof(MemoryDb));
+    if (!mdb)
+        return -1;
+    if (pthread_rwlock_init(&mdb->lock, NULL) != 0)
+    {
+        free(mdb);
+        return -1;
+    }
+    mdb->rand_seed = (unsigned int)time(NULL) ^ (unsigned int)getpid();
+
+    if (seed_from_schema(mdb, seed_file) < 0)
+    {
+        memdb_close(mdb);
+        return -1;
+    }
+
+    db->backend = &db_memory_backend;
+    db->impl = mdb;
+    return 0;
+}
+
+const DbBackend db_memory_backend = {
+    .name = DB_BACKEND_MEMORY,
+    .close = memdb_close,
+    .create_user = memdb_create_user,
+    .check_username_exists = memdb_check_username_exists,
+    .verify_login = memdb_verify_login,
+    .is_account_locked = memdb_is_account_locked,
+    .create_session = memdb_create_session,
+    .destroy_session = memdb_destroy_session,
+    .check_user_logged_in = memdb_check_user_logged_in,
+    .log_activity = memdb_log_activity,
+    .create_room = memdb_create_room,
+    .list_rooms = memdb_list_rooms,
+    .get_rooms = memdb_get_rooms,
+    .list_rooms_page = memdb_list_rooms_page,
+    .join_room = memdb_join_room,
+    .get_room_status = memdb_get_room_status,
+    .get_room_participant_count = memdb_get_room_participant_count,
+    .get_room_time_limit = memdb_get_room_time_limit,
+    .get_room_leaderboard = memdb_get_room_leaderboard,
+    .get_exam_questions = memdb_get_exam_questions,
+    .leave_room = memdb_leave_room,
+    .start_room = memdb_start_room,
+    .finish_room = memdb_finish_room,
+    .is_room_creator = memdb_is_room_creator,
+    .is_participant = memdb_is_participant,
+    .delete_room = memdb_delete_room,
+    .get_correct_answers = memdb_get_correct_answers,
+    .submit_exam = memdb_submit_exam,
+    .check_already_submitted = memdb_check_already_submitted,
+    .get_exam_result = memdb_get_exam_result,
+    .check_all_submitted = memdb_check_all_submitted,
+    .submit_exam_batch = memdb_submit_exam_batch,
+    .get_room_question_ids = memdb_get_room_question_ids,
+    .load_questions = memdb_load_questions,
+    .save_practice_results = memdb_save_practice_results,
+    .load_abilities = memdb_load_abilities,
+    .save_abilities = memdb_save_abilities,
+    .load_question_stats = memdb_load_question_stats,
+    .save_question_stats = memdb_save_question_stats,
+    .count_rooms_by_status = memdb_count_rooms_by_status,
+};
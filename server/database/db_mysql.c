@@ -0,0 +1,1721 @@
+#include "db_backend.h"
+#include "db_json.h"
+#include <mysql/mysql.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// ===============================================
+// MYSQL BACKEND - one shared connection serialized by a mutex
+// ===============================================
+
+typedef struct
+{
+    MYSQL *conn;
+    pthread_mutex_t mutex;
+} MysqlDb;
+
+extern const DbBackend db_mysql_backend;
+
+int db_mysql_open(Database *db, const char *host, const char *user, const char *password, const char *dbname, unsigned int port)
+{
+    MysqlDb *mdb = calloc(1, sizeof(MysqlDb));
+    if (!mdb)
+        return -1;
+
+    mdb->conn = mysql_init(NULL);
+    if (mdb->conn == NULL)
+    {
+        fprintf(stderr, "mysql_init() failed\n");
+        free(mdb);
+        return -1;
+    }
+
+    // Kết nối với port cụ thể
+    if (mysql_real_connect(mdb->conn, host, user, password, dbname, port, NULL, 0) == NULL)
+    {
+        fprintf(stderr, "mysql_real_connect() failed: %s\n", mysql_error(mdb->conn));
+        mysql_close(mdb->conn);
+        free(mdb);
+        return -1;
+    }
+
+    if (pthread_mutex_init(&mdb->mutex, NULL) != 0)
+    {
+        fprintf(stderr, "Mutex init failed\n");
+        mysql_close(mdb->conn);
+        free(mdb);
+        return -1;
+    }
+
+    db->backend = &db_mysql_backend;
+    db->impl = mdb;
+    return 0;
+}
+
+static void mysqldb_close(void *impl)
+{
+    MysqlDb *db = impl;
+    pthread_mutex_destroy(&db->mutex);
+    mysql_close(db->conn);
+    free(db);
+}
+
+// ============================= User operations ===============================
+static int mysqldb_create_user(void *impl, const char *username, const char *password_hash)
+{
+    MysqlDb *db = impl;
+    pthread_mutex_lock(&db->mutex);
+
+    char query[512];
+    snprintf(query, sizeof(query), "INSERT INTO users (username, password_hash) VALUES ('%s', '%s')", username, password_hash);
+
+    int result = mysql_query(db->conn, query);
+    pthread_mutex_unlock(&db->mutex);
+    return result == 0 ? 0 : -1;
+}
+
+static int mysqldb_check_username_exists(void *impl, const char *username)
+{
+    MysqlDb *db = impl;
+    pthread_mutex_lock(&db->mutex);
+
+    char query[256];
+    snprintf(query, sizeof(query), "SELECT COUNT(*) FROM users WHERE username='%s'", username);
+
+    // conn dùng để thực hiện truy vấn MySQL
+    if (mysql_query(db->conn, query) != 0)
+    {
+        pthread_mutex_unlock(&db->mutex);
+        return -1;
+    }
+    MYSQL_RES *result = mysql_store_result(db->conn); // Lấy kết quả truy vấn
+    MYSQL_ROW row = mysql_fetch_row(result);          // Lấy dòng đầu tiên
+    int exists = atoi(row[0]) > 0;                    // Nếu > 0 thì tồn tại
+    mysql_free_result(result);
+    pthread_mutex_unlock(&db->mutex);
+    return exists;
+}
+
+static int mysqldb_verify_login(void *impl, const char *username, const char *password_hash)
+{
+    MysqlDb *db = impl;
+    pthread_mutex_lock(&db->mutex);
+
+    char query[512];
+    snprintf(query, sizeof(query), "SELECT COUNT(*) FROM users WHERE username='%s' AND password_hash='%s'", username, password_hash);
+    if (mysql_query(db->conn, query) != 0)
+    {
+        pthread_mutex_unlock(&db->mutex);
+        return -1;
+    }
+    MYSQL_RES *result = mysql_store_result(db->conn);
+    MYSQL_ROW row = mysql_fetch_row(result);
+    int valid = atoi(row[0]) > 0;
+
+    mysql_free_result(result);
+    pthread_mutex_unlock(&db->mutex);
+
+    return valid;
+}
+
+static int mysqldb_is_account_locked(void *impl, const char *username)
+{
+    MysqlDb *db = impl;
+    pthread_mutex_lock(&db->mutex);
+
+    char query[256];
+    snprintf(query, sizeof(query), "SELECT is_locked FROM users WHERE username='%s'", username);
+    if (mysql_query(db->conn, query) != 0)
+    {
+        pthread_mutex_unlock(&db->mutex);
+        return -1;
+    }
+
+    MYSQL_RES *result = mysql_store_result(db->conn);
+    MYSQL_ROW row = mysql_fetch_row(result);
+    int is_locked = 0;
+    if (row != NULL)
+    {
+        is_locked = atoi(row[0]);
+    }
+
+    mysql_free_result(result);
+    pthread_mutex_unlock(&db->mutex);
+
+    return is_locked;
+}
+
+// ============================ Session operations =============================
+static int mysqldb_create_session(void *impl, const char *session_id, const char *username)
+{
+    MysqlDb *db = impl;
+    pthread_mutex_lock(&db->mutex);
+
+    // Deactivate existing sessions
+    char query1[512];
+    snprintf(query1, sizeof(query1), "UPDATE sessions SET is_active = 0 WHERE username='%s'", username);
+    mysql_query(db->conn, query1);
+
+    // Create new session
+    char query2[512];
+    snprintf(query2, sizeof(query2), "INSERT INTO sessions (session_id, username) VALUES ('%s', '%s')", session_id, username);
+    int result = mysql_query(db->conn, query2);
+
+    pthread_mutex_unlock(&db->mutex);
+    return result == 0 ? 0 : -1;
+}
+
+static int mysqldb_destroy_session(void *impl, const char *session_id)
+{
+    MysqlDb *db = impl;
+    pthread_mutex_lock(&db->mutex);
+
+    char query[512];
+    snprintf(query, sizeof(query), "UPDATE sessions SET is_active = 0 WHERE session_id='%s'", session_id);
+    int result = mysql_query(db->conn, query);
+
+    pthread_mutex_unlock(&db->mutex);
+    return result == 0 ? 0 : -1;
+}
+
+static int mysqldb_check_user_logged_in(void *impl, const char *username)
+{
+    MysqlDb *db = impl;
+    pthread_mutex_lock(&db->mutex);
+
+    char query[512];
+    snprintf(query, sizeof(query), "SELECT COUNT(*) FROM sessions WHERE username='%s' AND is_active = 1", username);
+    if (mysql_query(db->conn, query) != 0)
+    {
+        pthread_mutex_unlock(&db->mutex);
+        return -1;
+    }
+
+    MYSQL_RES *result = mysql_store_result(db->conn);
+    MYSQL_ROW row = mysql_fetch_row(result);
+    int logged_in = atoi(row[0]) > 0;
+
+    mysql_free_result(result);
+    pthread_mutex_unlock(&db->mutex);
+
+    return logged_in;
+}
+
+// =============================== Logging =====================================
+static void mysqldb_log_activity(void *impl, const char *level, const char *username, const char *action, const char *details)
+{
+    MysqlDb *db = impl;
+    pthread_mutex_lock(&db->mutex);
+
+    char query[2048];
+    char safe_details[1024] = {0};
+
+    if (details)
+    {
+        mysql_real_escape_string(db->conn, safe_details, details, strlen(details));
+    }
+
+    snprintf(query, sizeof(query),
+             "INSERT INTO activity_logs (level, username, action, details) "
+             "VALUES ('%s', '%s', '%s', '%s')",
+             level, username ? username : "SYSTEM", action, safe_details);
+
+    if (mysql_query(db->conn, query) != 0)
+    {
+        fprintf(stderr, "Failed to log activity: %s\n", mysql_error(db->conn));
+    }
+    pthread_mutex_unlock(&db->mutex);
+}
+
+// ============================= Room operations ===============================
+static int mysqldb_create_room(void *impl, const char *room_id, const char *room_name, const char *creator, int num_questions, int time_limit)
+{
+    MysqlDb *db = impl;
+    pthread_mutex_lock(&db->mutex);
+
+    // Start transaction
+    if (mysql_query(db->conn, "START TRANSACTION"))
+    {
+        fprintf(stderr, "[DB ERROR] Failed to start transaction: %s\n", mysql_error(db->conn));
+        pthread_mutex_unlock(&db->mutex);
+        return -1;
+    }
+
+    // Insert room (max_participants will use default value from schema)
+    char query1[512];
+    snprintf(query1, sizeof(query1),
+             "INSERT INTO rooms (room_id, room_name, creator, num_questions, time_limit_minutes) "
+             "VALUES ('%s', '%s', '%s', %d, %d)",
+             room_id, room_name, creator, num_questions, time_limit);
+
+    if (mysql_query(db->conn, query1))
+    {
+        fprintf(stderr, "[DB ERROR] Failed to create room: %s\n", mysql_error(db->conn));
+        mysql_query(db->conn, "ROLLBACK");
+        pthread_mutex_unlock(&db->mutex);
+        return -1;
+    }
+
+    // Select random questions and insert into room_questions
+    char query2[1024];
+    snprintf(query2, sizeof(query2),
+             "INSERT INTO room_questions (room_id, question_id, question_order) "
+             "SELECT '%s', id, (@row_number := @row_number + 1) "
+             "FROM questions, (SELECT @row_number := 0) AS t "
+             "ORDER BY RAND() LIMIT %d",
+             room_id, num_questions);
+
+    if (mysql_query(db->conn, query2))
+    {
+        fprintf(stderr, "[DB ERROR] Failed to assign questions: %s\n", mysql_error(db->conn));
+        mysql_query(db->conn, "ROLLBACK");
+        pthread_mutex_unlock(&db->mutex);
+        return -1;
+    }
+
+    // Creator auto joins, add user to participants table
+    char query3[512];
+    snprintf(query3, sizeof(query3),
+             "INSERT INTO participants (room_id, username) VALUES ('%s', '%s')",
+             room_id, creator);
+
+    if (mysql_query(db->conn, query3))
+    {
+        fprintf(stderr, "[DB ERROR] Failed to add creator as participant: %s\n", mysql_error(db->conn));
+        mysql_query(db->conn, "ROLLBACK");
+        pthread_mutex_unlock(&db->mutex);
+        return -1;
+    }
+
+    // Commit transaction
+    if (mysql_query(db->conn, "COMMIT"))
+    {
+        fprintf(stderr, "[DB ERROR] Failed to commit transaction: %s\n", mysql_error(db->conn));
+        mysql_query(db->conn, "ROLLBACK");
+        pthread_mutex_unlock(&db->mutex);
+        return -1;
+    }
+
+    pthread_mutex_unlock(&db->mutex);
+
+    printf("[DB] Room '%s' created with %d random questions assigned\n", room_id, num_questions);
+    return 0;
+}
+
+static char *mysqldb_list_rooms(void *impl, const char *status_filter)
+{
+    MysqlDb *db = impl;
+    pthread_mutex_lock(&db->mutex);
+
+    char query[1024];
+    if (strcmp(status_filter, "ALL") == 0)
+    {
+        snprintf(query, sizeof(query),
+                 "SELECT r.room_id, r.room_name, r.creator, r.status, "
+                 "COALESCE(COUNT(p.username), 0) as participant_count, "
+                 "r.max_participants, r.num_questions, r.time_limit_minutes, r.created_at "
+                 "FROM rooms r LEFT JOIN participants p ON r.room_id = p.room_id "
+                 "GROUP BY r.room_id ORDER BY r.created_at DESC");
+    }
+    else
+    {
+        snprintf(query, sizeof(query),
+                 "SELECT r.room_id, r.room_name, r.creator, r.status, "
+                 "COALESCE(COUNT(p.username), 0) as participant_count, "
+                 "r.max_participants, r.num_questions, r.time_limit_minutes, r.created_at "
+                 "FROM rooms r LEFT JOIN participants p ON r.room_id = p.room_id "
+                 "WHERE r.status='%s' "
+                 "GROUP BY r.room_id ORDER BY r.created_at DESC",
+                 status_filter);
+    }
+
+    if (mysql_query(db->conn, query)) // Execute query, if error(mysql_query return non-zero), return NULL
+    {
+        pthread_mutex_unlock(&db->mutex);
+        return NULL;
+    }
+
+    // Retrieve results, mysql_store_result fetches the result set from the last query
+    MYSQL_RES *result = mysql_store_result(db->conn);
+    if (!result)
+    {
+        pthread_mutex_unlock(&db->mutex);
+        return NULL;
+    }
+
+    // Build JSON
+    char *json = db_json_rooms_open();
+    if (!json)
+    {
+        mysql_free_result(result);
+        pthread_mutex_unlock(&db->mutex);
+        return NULL;
+    }
+
+    MYSQL_ROW row; // Fetch each row from the result set
+    while ((row = mysql_fetch_row(result)))
+    {
+        if (db_json_rooms_add(json, row) < 0)
+            break; // buffer full
+    }
+
+    db_json_rooms_close(json);
+
+    mysql_free_result(result); // Free the result set to avoid memory leaks
+    pthread_mutex_unlock(&db->mutex);
+
+    return json;
+}
+
+// Rows of the given rooms for LIST_ROOMS deltas (any status, unknown ids skipped)
+static int mysqldb_get_rooms(void *impl, const char *const *room_ids, int count, DbRoomRowFn fn, void *ctx)
+{
+    MysqlDb *db = impl;
+    if (count <= 0)
+        return 0;
+
+    // One query for all ids: room_id IN ('a','b',...), ids escaped (x2) plus quotes and comma
+    size_t size = 512 + (size_t)count * (2 * 64 + 4);
+    char *query = malloc(size);
+    if (!query)
+        return -1;
+
+    pthread_mutex_lock(&db->mutex);
+    size_t len = (size_t)snprintf(query, size,
+                                  "SELECT r.room_id, r.room_name, r.creator, r.status, "
+                                  "COALESCE(COUNT(p.username), 0) as participant_count, "
+                                  "r.max_participants, r.num_questions, r.time_limit_minutes, r.created_at "
+                                  "FROM rooms r LEFT JOIN participants p ON r.room_id = p.room_id "
+                                  "WHERE r.room_id IN (");
+    for (int i = 0; i < count; i++)
+    {
+        if (i)
+            query[len++] = ',';
+        query[len++] = '\'';
+        len += mysql_real_escape_string(db->conn, query + len, room_ids[i], strnlen(room_ids[i], 64));
+        query[len++] = '\'';
+    }
+    len += (size_t)snprintf(query + len, size - len, ") GROUP BY r.room_id");
+
+    if (mysql_real_query(db->conn, query, len))
+    {
+        fprintf(stderr, "[DB ERROR] Failed to get rooms: %s\n", mysql_error(db->conn));
+        pthread_mutex_unlock(&db->mutex);
+        free(query);
+        return -1;
+    }
+    free(query);
+
+    MYSQL_RES *result = mysql_store_result(db->conn);
+    if (!result)
+    {
+        pthread_mutex_unlock(&db->mutex);
+        return -1;
+    }
+
+    int found = 0;
+    MYSQL_ROW row;
+    while ((row = mysql_fetch_row(result)))
+    {
+        found++;
+        if (fn(ctx, row) < 0)
+            break;
+    }
+
+    mysql_free_result(result);
+    pthread_mutex_unlock(&db->mutex);
+    return found;
+}
+
+// Same order and keyset as the SQLite backend: idx_room_status_created (one
+// status) or idx_room_created (ALL) is read backwards from the cursor
+static int mysqldb_list_rooms_page(void *impl, const DbRoomPage *page, DbRoomRowFn fn, void *ctx)
+{
+    MysqlDb *db = impl;
+    char query[2048], created[64], room_id[2 * 64 + 1], creator[2 * 64 + 1], prefix[2 * 128 + 1], status[32];
+
+    const char *after_created = page->after_room_id ? page->after_created : "9999-12-31 23:59:59";
+    const char *after_room_id = page->after_room_id ? page->after_room_id : "";
+    const char *by_creator = page->creator ? page->creator : "";
+    const char *by_prefix = page->name_prefix ? page->name_prefix : "";
+
+    pthread_mutex_lock(&db->mutex);
+    mysql_real_escape_string(db->conn, created, after_created, strnlen(after_created, 31));
+    mysql_real_escape_string(db->conn, room_id, after_room_id, strnlen(after_room_id, 64));
+    mysql_real_escape_string(db->conn, creator, by_creator, strnlen(by_creator, 64));
+    mysql_real_escape_string(db->conn, prefix, by_prefix, strnlen(by_prefix, 128));
+    mysql_real_escape_string(db->conn, status, page->status, strnlen(page->status, 15));
+
+    int len = snprintf(query, sizeof(query),
+                       "SELECT r.room_id, r.room_name, r.creator, r.status, "
+                       "(SELECT COUNT(*) FROM participants p WHERE p.room_id = r.room_id) as participant_count, "
+                       "r.max_participants, r.num_questions, r.time_limit_minutes, r.created_at "
+                       "FROM rooms r WHERE (r.created_at, r.room_id) < ('%s', '%s')",
+                       created, room_id);
+    if (strcmp(page->status, "ALL") != 0)
+        len += snprintf(query + len, sizeof(query) - len, " AND r.status='%s'", status);
+    if (page->creator)
+        len += snprintf(query + len, sizeof(query) - len, " AND r.creator='%s'", creator);
+    if (*by_prefix)
+        len += snprintf(query + len, sizeof(query) - len, " AND LEFT(r.room_name, CHAR_LENGTH('%s')) = '%s'", prefix, prefix);
+    snprintf(query + len, sizeof(query) - len, " ORDER BY r.created_at DESC, r.room_id DESC LIMIT %d", page->limit);
+
+    if (mysql_query(db->conn, query))
+    {
+        fprintf(stderr, "[DB ERROR] Failed to list rooms: %s\n", mysql_error(db->conn));
+        pthread_mutex_unlock(&db->mutex);
+        return -1;
+    }
+
+    MYSQL_RES *result = mysql_store_result(db->conn);
+    if (!result)
+    {
+        pthread_mutex_unlock(&db->mutex);
+        return -1;
+    }
+
+    int rows = 0;
+    MYSQL_ROW row;
+    while ((row = mysql_fetch_row(result)))
+    {
+        rows++;
+        if (fn(ctx, row) < 0)
+            break;
+    }
+
+    mysql_free_result(result);
+    pthread_mutex_unlock(&db->mutex);
+    return rows;
+}
+
+/**
+ * @brief Add user to room participants
+ * @param impl MysqlDb (backend state)
+ * @param room_id Room ID
+ * @param username Username to add
+ * @return 1 if added, 0 if already a participant (ignored), -1 on failure
+ */
+static int mysqldb_join_room(void *impl, const char *room_id, const char *username)
+{
+    MysqlDb *db = impl;
+    pthread_mutex_lock(&db->mutex);
+
+    char query[512];
+    snprintf(query, sizeof(query),
+             "INSERT IGNORE INTO participants (room_id, username) VALUES ('%s', '%s')", room_id, username);
+    // Use INSERT IGNORE to avoid duplicate entries
+
+    int result = mysql_query(db->conn, query);
+    int affected = result == 0 ? (int)mysql_affected_rows(db->conn) : -1; // 0: already joined (ignored)
+
+    pthread_mutex_unlock(&db->mutex);
+    return affected < 0 ? -1 : affected > 0; // 1 = joined, 0 = ignored, -1 on failure
+}
+
+/**
+ * @brief Get room status
+ * @param impl MysqlDb (backend state)
+ * @param room_id Room ID
+ * @return Room status as integer (0=NOT_STARTED, 1=IN_PROGRESS, 2=FINISHED), -1 on error
+ */
+static int mysqldb_get_room_status(void *impl, const char *room_id)
+{
+    MysqlDb *db = impl;
+    pthread_mutex_lock(&db->mutex);
+
+    char query[256];
+    snprintf(query, sizeof(query), "SELECT status FROM rooms WHERE room_id='%s'", room_id);
+
+    if (mysql_query(db->conn, query))
+    {
+        pthread_mutex_unlock(&db->mutex);
+        return -1;
+    }
+
+    MYSQL_RES *result = mysql_store_result(db->conn);
+    if (!result)
+    {
+        pthread_mutex_unlock(&db->mutex);
+        return -1;
+    }
+
+    MYSQL_ROW row = mysql_fetch_row(result);
+    int status = -1;
+
+    if (row)
+    {
+        if (strcmp(row[0], "NOT_STARTED") == 0)
+            status = 0;
+        else if (strcmp(row[0], "IN_PROGRESS") == 0)
+            status = 1;
+        else if (strcmp(row[0], "FINISHED") == 0)
+            status = 2;
+    }
+
+    mysql_free_result(result);
+    pthread_mutex_unlock(&db->mutex);
+
+    return status;
+}
+
+/**
+ * @brief Get number of participants in a room
+ * @param impl MysqlDb (backend state)
+ * @param room_id Room ID
+ * @return Number of participants, -1 on error
+ */
+static int mysqldb_get_room_participant_count(void *impl, const char *room_id)
+{
+    MysqlDb *db = impl;
+    pthread_mutex_lock(&db->mutex);
+
+    char query[256];
+    snprintf(query, sizeof(query),
+             "SELECT COUNT(*) FROM participants WHERE room_id='%s'", room_id);
+
+    if (mysql_query(db->conn, query))
+    {
+        pthread_mutex_unlock(&db->mutex);
+        return -1;
+    }
+
+    MYSQL_RES *result = mysql_store_result(db->conn);
+    if (!result)
+    {
+        pthread_mutex_unlock(&db->mutex);
+        return -1;
+    }
+
+    MYSQL_ROW row = mysql_fetch_row(result);
+
+    // If row is NULL, return 0 participants
+    int count = row ? atoi(row[0]) : 0;
+
+    mysql_free_result(result);
+    pthread_mutex_unlock(&db->mutex);
+
+    return count;
+}
+
+/**
+ * @brief Get the time limit of a room
+ * @param impl MysqlDb (backend state)
+ * @param room_id Room ID
+ * @return time_limit_minutes, -1 on error / room not found
+ */
+static int mysqldb_get_room_time_limit(void *impl, const char *room_id)
+{
+    MysqlDb *db = impl;
+    pthread_mutex_lock(&db->mutex);
+
+    char query[256];
+    snprintf(query, sizeof(query),
+             "SELECT time_limit_minutes FROM rooms WHERE room_id='%s'", room_id);
+
+    if (mysql_query(db->conn, query))
+    {
+        pthread_mutex_unlock(&db->mutex);
+        return -1;
+    }
+
+    MYSQL_RES *result = mysql_store_result(db->conn);
+    if (!result)
+    {
+        pthread_mutex_unlock(&db->mutex);
+        return -1;
+    }
+
+    MYSQL_ROW row = mysql_fetch_row(result);
+    int minutes = row && row[0] ? atoi(row[0]) : -1;
+
+    mysql_free_result(result);
+    pthread_mutex_unlock(&db->mutex);
+
+    return minutes;
+}
+
+/**
+ * @brief Get leaderboard for room
+ * @param impl MysqlDb (backend state)
+ * @param room_id Room ID
+ * @return JSON string with leaderboard (must be freed), NULL on error
+ */
+static char *mysqldb_get_room_leaderboard(void *impl, const char *room_id)
+{
+    MysqlDb *db = impl;
+    pthread_mutex_lock(&db->mutex);
+
+    char query[1024];
+    snprintf(query, sizeof(query),
+             "SELECT username, score, total_questions, submit_time, time_taken_seconds "
+             "FROM exam_results WHERE room_id='%s' "
+             "ORDER BY score DESC, submit_time ASC",
+             room_id);
+
+    if (mysql_query(db->conn, query))
+    {
+        pthread_mutex_unlock(&db->mutex);
+        return NULL;
+    }
+
+    MYSQL_RES *result = mysql_store_result(db->conn);
+    if (!result)
+    {
+        pthread_mutex_unlock(&db->mutex);
+        return NULL;
+    }
+
+    // Build JSON
+    char *json = db_json_leaderboard_open();
+    if (!json)
+    {
+        mysql_free_result(result);
+        pthread_mutex_unlock(&db->mutex);
+        return NULL;
+    }
+
+    MYSQL_ROW row;
+    int rank = 1;
+    while ((row = mysql_fetch_row(result)))
+    {
+        if (db_json_leaderboard_add(json, rank++, row) < 0)
+            break; // buffer full
+    }
+
+    db_json_leaderboard_close(json);
+
+    mysql_free_result(result);
+    pthread_mutex_unlock(&db->mutex);
+
+    return json;
+}
+
+/**
+ * @brief Get exam questions for a room (without correct answers for security)
+ * @param impl MysqlDb (backend state)
+ * @param room_id Room ID
+ * @return JSON string with questions array, NULL on error
+ *
+ * Format: {"questions":[{"question_id":1,"content":"...","options":["A","B","C","D"]},...]}}
+ * IMPORTANT: NEVER include "correct_answer" field!
+ */
+static char *mysqldb_get_exam_questions(void *impl, const char *room_id)
+{
+    MysqlDb *db = impl;
+    pthread_mutex_lock(&db->mutex);
+
+    // Query to get questions for this room
+    // Join room_questions with questions table to get full question data
+    char query[2048];
+    snprintf(query, sizeof(query),
+             "SELECT q.id, q.question_text, q.option_a, q.option_b, q.option_c, q.option_d "
+             "FROM room_questions rq "
+             "JOIN questions q ON rq.question_id = q.id "
+             "WHERE rq.room_id='%s' "
+             "ORDER BY rq.question_order ASC",
+             room_id);
+
+    if (mysql_query(db->conn, query))
+    {
+        fprintf(stderr, "db_get_exam_questions query failed: %s\n", mysql_error(db->conn));
+        pthread_mutex_unlock(&db->mutex);
+        return NULL;
+    }
+
+    MYSQL_RES *result = mysql_store_result(db->conn);
+    if (!result)
+    {
+        fprintf(stderr, "db_get_exam_questions mysql_store_result failed\n");
+        pthread_mutex_unlock(&db->mutex);
+        return NULL;
+    }
+
+    // Build JSON response with questions
+    char *json = db_json_questions_open();
+    if (!json)
+    {
+        mysql_free_result(result);
+        pthread_mutex_unlock(&db->mutex);
+        return NULL;
+    }
+
+    MYSQL_ROW row;
+    int first = 1;
+    while ((row = mysql_fetch_row(result)))
+    {
+        db_json_questions_add(json, row, first);
+        first = 0;
+    }
+
+    db_json_questions_close(json);
+
+    mysql_free_result(result);
+    pthread_mutex_unlock(&db->mutex);
+
+    return json;
+}
+
+/**
+ * @brief Remove user from room participants
+ * @param impl MysqlDb (backend state)
+ * @param room_id Room ID
+ * @param username Username to remove
+ * @return 0 on success, -1 on failure
+ */
+static int mysqldb_leave_room(void *impl, const char *room_id, const char *username)
+{
+    MysqlDb *db = impl;
+    pthread_mutex_lock(&db->mutex);
+
+    char query[512];
+    snprintf(query, sizeof(query), "DELETE FROM participants WHERE room_id='%s' AND username='%s'", room_id, username);
+
+    int result = mysql_query(db->conn, query);
+
+    pthread_mutex_unlock(&db->mutex);
+    return result == 0 ? 0 : -1;
+}
+
+/**
+ * @brief Start a room exam (change status from NOT_STARTED to IN_PROGRESS)
+ * @param impl MysqlDb (backend state)
+ * @param room_id Room ID
+ * @return 0 on success, -1 on failure
+ */
+static int mysqldb_start_room(void *impl, const char *room_id)
+{
+    MysqlDb *db = impl;
+    pthread_mutex_lock(&db->mutex);
+
+    char query[512];
+
+    // Update room status to IN_PROGRESS and set start_time to NOW()
+    snprintf(query, sizeof(query), "UPDATE rooms SET status='IN_PROGRESS', start_time=NOW() WHERE room_id='%s'", room_id);
+
+    int result = mysql_query(db->conn, query);
+
+    pthread_mutex_unlock(&db->mutex);
+    return result == 0 ? 0 : -1;
+}
+
+/**
+ * @brief Finish a room exam (change status to FINISHED)
+ * @param impl MysqlDb (backend state)
+ * @param room_id Room ID
+ * @return 0 on success, -1 on failure
+ */
+static int mysqldb_finish_room(void *impl, const char *room_id)
+{
+    MysqlDb *db = impl;
+    pthread_mutex_lock(&db->mutex);
+
+    char query[512];
+    snprintf(query, sizeof(query),
+             "UPDATE rooms SET status='FINISHED', finish_time=NOW() WHERE room_id='%s'",
+             room_id);
+
+    int result = mysql_query(db->conn, query);
+
+    pthread_mutex_unlock(&db->mutex);
+
+    if (result == 0)
+    {
+        printf("[DB] Room '%s' marked as FINISHED\n", room_id);
+    }
+
+    return result == 0 ? 0 : -1;
+}
+
+/**
+ * @brief Check if user is the creator of a room
+ * @param impl MysqlDb (backend state)
+ * @param room_id Room ID
+ * @param username Username to check
+ * @return 1 if user is creator, 0 otherwise
+ */
+static int mysqldb_is_room_creator(void *impl, const char *room_id, const char *username)
+{
+    MysqlDb *db = impl;
+    pthread_mutex_lock(&db->mutex);
+
+    char query[256];
+    snprintf(query, sizeof(query), "SELECT COUNT(*) FROM rooms WHERE room_id='%s' AND creator='%s'", room_id, username);
+
+    if (mysql_query(db->conn, query))
+    {
+        pthread_mutex_unlock(&db->mutex);
+        return 0;
+    }
+
+    MYSQL_RES *result = mysql_store_result(db->conn);
+    if (!result)
+    {
+        pthread_mutex_unlock(&db->mutex);
+        return 0;
+    }
+
+    MYSQL_ROW row = mysql_fetch_row(result);
+    int is_creator = row ? (atoi(row[0]) > 0) : 0; // If count > 0, user is creator
+
+    mysql_free_result(result);
+    pthread_mutex_unlock(&db->mutex);
+
+    return is_creator;
+}
+
+/**
+ * @brief Check if user is a participant in room
+ * @param impl MysqlDb (backend state)
+ * @param room_id Room ID
+ * @param username Username to check
+ * @return 1 if user is participant, 0 otherwise
+ */
+static int mysqldb_is_participant(void *impl, const char *room_id, const char *username)
+{
+    MysqlDb *db = impl;
+    pthread_mutex_lock(&db->mutex);
+
+    char query[256];
+    snprintf(query, sizeof(query), "SELECT COUNT(*) FROM participants WHERE room_id='%s' AND username='%s'", room_id, username);
+
+    if (mysql_query(db->conn, query))
+    {
+        pthread_mutex_unlock(&db->mutex);
+        return 0;
+    }
+
+    MYSQL_RES *result = mysql_store_result(db->conn);
+    if (!result)
+    {
+        pthread_mutex_unlock(&db->mutex);
+        return 0;
+    }
+
+    MYSQL_ROW row = mysql_fetch_row(result);    // Fetch the first row from result, which contains the count
+    int in_room = row ? (atoi(row[0]) > 0) : 0; // If count > 0, user is in room
+
+    mysql_free_result(result);
+    pthread_mutex_unlock(&db->mutex);
+
+    return in_room;
+}
+
+/**
+ * @brief Delete a room and all its related data
+ * @param impl MysqlDb (backend state)
+ * @param room_id Room ID to delete
+ * @return 0 on success, -1 on error
+ *
+ * NOTE: This will cascade delete:
+ * - All participants in room_participants (ON DELETE CASCADE)
+ * - All room_questions (ON DELETE CASCADE)
+ * - All exam_results (ON DELETE CASCADE)
+ */
+static int mysqldb_delete_room(void *impl, const char *room_id)
+{
+    MysqlDb *db = impl;
+    pthread_mutex_lock(&db->mutex);
+
+    char query[256];
+    snprintf(query, sizeof(query), "DELETE FROM rooms WHERE room_id='%s'", room_id);
+
+    if (mysql_query(db->conn, query))
+    {
+        fprintf(stderr, "[DB ERROR] Failed to delete room '%s': %s\n", room_id, mysql_error(db->conn));
+        pthread_mutex_unlock(&db->mutex);
+        return -1;
+    }
+
+    int affected = mysql_affected_rows(db->conn); // Check if any row was deleted
+    pthread_mutex_unlock(&db->mutex);
+
+    if (affected == 0) // No room found with given ID
+    {
+        fprintf(stderr, "[DB WARNING] Room '%s' not found for deletion\n", room_id);
+        return -1;
+    }
+
+    printf("[DB] Room '%s' deleted successfully (cascaded to participants, questions, results)\n", room_id);
+    return 0;
+}
+
+// ==========================================
+// SUBMIT EXAM OPERATIONS
+// ==========================================
+
+/**
+ * @brief Get correct answers for a room
+ * @param impl MysqlDb (backend state)
+ * @param room_id Room ID
+ * @param answers_out Buffer to store answers (e.g., "ABCDABCD...")
+ * @param total_out Pointer to store total number of questions
+ * @return 0 on success, -1 on error
+ * Flow:
+ * 1. Query room_questions joined with questions to get correct answers
+ * 2. Store answers in answers_out as a string of characters
+ * 3. Set total_out to number of questions
+ */
+static int mysqldb_get_correct_answers(void *impl, const char *room_id, char *answers_out, int *total_out)
+{
+    MysqlDb *db = impl;
+    pthread_mutex_lock(&db->mutex);
+
+    char query[1024];
+    snprintf(query, sizeof(query),
+             "SELECT q.correct_answer FROM room_questions rq "
+             "JOIN questions q ON rq.question_id = q.id "
+             "WHERE rq.room_id = '%s' ORDER BY rq.question_order",
+             room_id);
+
+    if (mysql_query(db->conn, query))
+    {
+        fprintf(stderr, "[DB ERROR] Failed to get correct answers: %s\n", mysql_error(db->conn));
+        pthread_mutex_unlock(&db->mutex);
+        return -1;
+    }
+
+    MYSQL_RES *result = mysql_store_result(db->conn);
+    if (!result)
+    {
+        fprintf(stderr, "[DB ERROR] Failed to store result: %s\n", mysql_error(db->conn));
+        pthread_mutex_unlock(&db->mutex);
+        return -1;
+    }
+
+    MYSQL_ROW row;
+    int count = 0;
+    while ((row = mysql_fetch_row(result)))
+    {
+        answers_out[count++] = row[0][0]; // Get first character (A, B, C, or D)
+    }
+    answers_out[count] = '\0'; // Null-terminate the string
+
+    *total_out = count; // Set total number of questions
+
+    mysql_free_result(result);
+    pthread_mutex_unlock(&db->mutex);
+
+    return 0;
+}
+
+/**
+ * @brief Submit exam answers and calculate score
+ * @param impl MysqlDb (backend state)
+ * @param room_id Room ID
+ * @param username Username
+ * @param score Score achieved
+ * @param total Total questions
+ * @param answers User's answers (comma-separated: A,B,C,D...)
+ * @param time_taken Time taken in seconds
+ * @return 0 on success, -1 on error
+ */
+static int mysqldb_submit_exam(void *impl, const char *room_id, const char *username, int score, int total, const char *answers, int time_taken)
+{
+    MysqlDb *db = impl;
+    pthread_mutex_lock(&db->mutex);
+
+    // Escape the answers string to prevent SQL injection
+    char escaped_answers[4096];
+    mysql_real_escape_string(db->conn, escaped_answers, answers, strlen(answers));
+
+    char query[8192];
+    snprintf(query, sizeof(query),
+             "INSERT INTO exam_results (room_id, username, score, total_questions, "
+             "answers, time_taken_seconds) VALUES ('%s', '%s', %d, %d, '%s', %d)",
+             room_id, username, score, total, escaped_answers, time_taken);
+
+    if (mysql_query(db->conn, query))
+    {
+        fprintf(stderr, "[DB ERROR] Failed to submit exam: %s\n", mysql_error(db->conn));
+        pthread_mutex_unlock(&db->mutex);
+        return -1;
+    }
+
+    pthread_mutex_unlock(&db->mutex);
+    printf("[DB] Exam submitted for user '%s' in room '%s': %d/%d\n", username, room_id, score, total);
+
+    return 0;
+}
+
+// Multi-row INSERTs are split so one statement stays well under max_allowed_packet
+#define MYSQL_BATCH_QUERY_SIZE (256 * 1024)
+
+/**
+ * @brief Insert journaled exam results (results journal flusher)
+ * @param impl MysqlDb (backend state)
+ * @param results Results in submit order
+ * @param count Number of results
+ * @return 0 on success (duplicates skipped), -1 on error
+ */
+static int mysqldb_submit_exam_batch(void *impl, const DbExamResult *results, int count)
+{
+    MysqlDb *db = impl;
+    static const char insert_head[] =
+        "INSERT IGNORE INTO exam_results (room_id, username, score, total_questions, "
+        "answers, time_taken_seconds, submit_time) VALUES ";
+
+    // Worst case row: every character escaped (x2) plus numbers and quotes
+    size_t row_max = 0;
+    for (int i = 0; i < count; i++)
+    {
+        size_t row_len = 2 * (strlen(results[i].room_id) + strlen(results[i].username) + strlen(results[i].answers)) + 128;
+        if (row_len > row_max)
+            row_max = row_len;
+    }
+    size_t capacity = MYSQL_BATCH_QUERY_SIZE > row_max + sizeof(insert_head) ? MYSQL_BATCH_QUERY_SIZE : row_max + sizeof(insert_head);
+    char *query = malloc(capacity);
+    if (!query)
+        return -1;
+
+    pthread_mutex_lock(&db->mutex);
+
+    if (mysql_query(db->conn, "START TRANSACTION"))
+    {
+        fprintf(stderr, "[DB ERROR] Failed to start transaction: %s\n", mysql_error(db->conn));
+        pthread_mutex_unlock(&db->mutex);
+        free(query);
+        return -1;
+    }
+
+    int i = 0;
+    while (i < count)
+    {
+        size_t len = sizeof(insert_head) - 1;
+        memcpy(query, insert_head, len);
+        int rows = 0;
+        while (i < count && capacity - len > row_max)
+        {
+            const DbExamResult *r = &results[i++];
+            if (rows++ > 0)
+                query[len++] = ',';
+            len += (size_t)sprintf(query + len, "('");
+            len += mysql_real_escape_string(db->conn, query + len, r->room_id, strlen(r->room_id));
+            len += (size_t)sprintf(query + len, "', '");
+            len += mysql_real_escape_string(db->conn, query + len, r->username, strlen(r->username));
+            len += (size_t)sprintf(query + len, "', %d, %d, '", r->score, r->total);
+            len += mysql_real_escape_string(db->conn, query + len, r->answers, strlen(r->answers));
+            len += (size_t)sprintf(query + len, "', %d, FROM_UNIXTIME(%lld))", r->time_taken, r->submit_time);
+        }
+
+        if (mysql_real_query(db->conn, query, len))
+        {
+            fprintf(stderr, "[DB ERROR] Failed to submit exam batch: %s\n", mysql_error(db->conn));
+            mysql_query(db->conn, "ROLLBACK");
+            pthread_mutex_unlock(&db->mutex);
+            free(query);
+            return -1;
+        }
+    }
+
+    if (mysql_query(db->conn, "COMMIT"))
+    {
+        fprintf(stderr, "[DB ERROR] Failed to commit exam batch: %s\n", mysql_error(db->conn));
+        mysql_query(db->conn, "ROLLBACK");
+        pthread_mutex_unlock(&db->mutex);
+        free(query);
+        return -1;
+    }
+
+    pthread_mutex_unlock(&db->mutex);
+    free(query);
+    printf("[DB] Committed %d journaled exam result(s)\n", count);
+    return 0;
+}
+
+/**
+ * @brief Check if user already submitted exam for this room
+ * @param impl MysqlDb (backend state)
+ * @param room_id Room ID
+ * @param username Username
+ * @return 1 if submitted, 0 if not
+ */
+static int mysqldb_check_already_submitted(void *impl, const char *room_id, const char *username)
+{
+    MysqlDb *db = impl;
+    pthread_mutex_lock(&db->mutex);
+
+    char query[512];
+    snprintf(query, sizeof(query),
+             "SELECT COUNT(*) FROM exam_results WHERE room_id='%s' AND username='%s'",
+             room_id, username);
+
+    if (mysql_query(db->conn, query))
+    {
+        fprintf(stderr, "[DB ERROR] Failed to check submission: %s\n", mysql_error(db->conn));
+        pthread_mutex_unlock(&db->mutex);
+        return 0;
+    }
+
+    MYSQL_RES *result = mysql_store_result(db->conn);
+    if (!result)
+    {
+        pthread_mutex_unlock(&db->mutex);
+        return 0;
+    }
+
+    MYSQL_ROW row = mysql_fetch_row(result);
+    int submitted = row ? (atoi(row[0]) > 0) : 0;
+
+    mysql_free_result(result);
+    pthread_mutex_unlock(&db->mutex);
+
+    return submitted;
+}
+
+/**
+ * @brief Get exam result for user
+ * @param impl MysqlDb (backend state)
+ * @param room_id Room ID
+ * @param username Username
+ * @return String with score (e.g., "18|20"), must be freed, NULL on error
+ */
+static char *mysqldb_get_exam_result(void *impl, const char *room_id, const char *username)
+{
+    MysqlDb *db = impl;
+    pthread_mutex_lock(&db->mutex);
+
+    char query[512];
+    snprintf(query, sizeof(query),
+             "SELECT score, total_questions FROM exam_results "
+             "WHERE room_id='%s' AND username='%s'",
+             room_id, username);
+
+    if (mysql_query(db->conn, query))
+    {
+        fprintf(stderr, "[DB ERROR] Failed to get result: %s\n", mysql_error(db->conn));
+        pthread_mutex_unlock(&db->mutex);
+        return NULL;
+    }
+
+    MYSQL_RES *result = mysql_store_result(db->conn);
+    if (!result)
+    {
+        pthread_mutex_unlock(&db->mutex);
+        return NULL;
+    }
+
+    MYSQL_ROW row = mysql_fetch_row(result);
+    char *result_str = NULL; // Format: "score|total"
+
+    if (row)
+    {
+        result_str = malloc(64);
+        snprintf(result_str, 64, "%s|%s", row[0], row[1]);
+    }
+
+    mysql_free_result(result);
+    pthread_mutex_unlock(&db->mutex);
+
+    return result_str;
+}
+
+/**
+ * @brief Check if all participants in a room have submitted their exams
+ * @param impl MysqlDb (backend state)
+ * @param room_id Room ID
+ * @return 1 if all submitted, 0 otherwise
+ */
+static int mysqldb_check_all_submitted(void *impl, const char *room_id)
+{
+    MysqlDb *db = impl;
+    pthread_mutex_lock(&db->mutex);
+
+    // Get total participants count
+    char query1[512];
+    snprintf(query1, sizeof(query1),
+             "SELECT COUNT(*) FROM participants WHERE room_id='%s'",
+             room_id);
+
+    if (mysql_query(db->conn, query1))
+    {
+        pthread_mutex_unlock(&db->mutex);
+        return 0;
+    }
+
+    MYSQL_RES *result1 = mysql_store_result(db->conn);
+    if (!result1)
+    {
+        pthread_mutex_unlock(&db->mutex);
+        return 0;
+    }
+
+    MYSQL_ROW row1 = mysql_fetch_row(result1);
+    int total_participants = row1 ? atoi(row1[0]) : 0;
+    mysql_free_result(result1);
+
+    if (total_participants == 0)
+    {
+        pthread_mutex_unlock(&db->mutex);
+        return 0;
+    }
+
+    // Get total submissions count
+    char query2[512];
+    snprintf(query2, sizeof(query2),
+             "SELECT COUNT(*) FROM exam_results WHERE room_id='%s'",
+             room_id);
+
+    if (mysql_query(db->conn, query2))
+    {
+        pthread_mutex_unlock(&db->mutex);
+        return 0;
+    }
+
+    MYSQL_RES *result2 = mysql_store_result(db->conn);
+    if (!result2)
+    {
+        pthread_mutex_unlock(&db->mutex);
+        return 0;
+    }
+
+    MYSQL_ROW row2 = mysql_fetch_row(result2);
+    int total_submissions = row2 ? atoi(row2[0]) : 0; // Get submission count, if NULL return 0
+    mysql_free_result(result2);
+
+    pthread_mutex_unlock(&db->mutex);
+
+    // All submitted if counts match
+    return (total_submissions >= total_participants); // creator is not in participants
+}
+
+static int mysqldb_get_room_question_ids(void *impl, const char *room_id, int *ids_out, int max)
+{
+    MysqlDb *db = impl;
+    char escaped[2 * 64 + 1]; // room ids are short; longer input matches nothing anyway
+    char query[256];
+
+    pthread_mutex_lock(&db->mutex);
+    mysql_real_escape_string(db->conn, escaped, room_id, strnlen(room_id, 64));
+    snprintf(query, sizeof(query),
+             "SELECT question_id FROM room_questions WHERE room_id = '%s' ORDER BY question_order", escaped);
+
+    if (mysql_query(db->conn, query))
+    {
+        fprintf(stderr, "[DB ERROR] Failed to get room questions: %s\n", mysql_error(db->conn));
+        pthread_mutex_unlock(&db->mutex);
+        return -1;
+    }
+
+    MYSQL_RES *result = mysql_store_result(db->conn);
+    if (!result)
+    {
+        fprintf(stderr, "[DB ERROR] Failed to store result: %s\n", mysql_error(db->conn));
+        pthread_mutex_unlock(&db->mutex);
+        return -1;
+    }
+
+    MYSQL_ROW row;
+    int count = 0;
+    while (count < max && (row = mysql_fetch_row(result)))
+        ids_out[count++] = atoi(row[0]);
+
+    mysql_free_result(result);
+    pthread_mutex_unlock(&db->mutex);
+    return count;
+}
+
+// ============================ Practice operations ============================
+static int mysqldb_load_questions(void *impl, DbQuestionFn fn, void *ctx)
+{
+    MysqlDb *db = impl;
+    pthread_mutex_lock(&db->mutex);
+
+    if (mysql_query(db->conn, "SELECT id, question_text, option_a, option_b, option_c, option_d, "
+                              "correct_answer, difficulty, category FROM questions ORDER BY id"))
+    {
+        fprintf(stderr, "[DB ERROR] Failed to load questions: %s\n", mysql_error(db->conn));
+        pthread_mutex_unlock(&db->mutex);
+        return -1;
+    }
+
+    MYSQL_RES *result = mysql_store_result(db->conn);
+    if (!result)
+    {
+        fprintf(stderr, "[DB ERROR] Failed to store result: %s\n", mysql_error(db->conn));
+        pthread_mutex_unlock(&db->mutex);
+        return -1;
+    }
+    pthread_mutex_unlock(&db->mutex); // rows are client-side now
+
+    MYSQL_ROW row;
+    int count = 0;
+    while ((row = mysql_fetch_row(result)))
+    {
+        DbQuestion question = {atoi(row[0]), row[1], {row[2], row[3], row[4], row[5]}, row[6][0],
+                               row[7] ? row[7] : "medium", row[8]};
+        count++;
+        if (fn(ctx, &question) < 0)
+            break;
+    }
+    mysql_free_result(result);
+    return count;
+}
+
+static int mysqldb_save_practice_results(void *impl, const DbPracticeResult *results, int count)
+{
+    MysqlDb *db = impl;
+    static const char insert_head[] =
+        "INSERT IGNORE INTO practice_sessions (practice_id, username, num_questions, "
+        "time_limit_minutes, start_time, score, is_completed) VALUES ";
+
+    // Worst case row: every character escaped (x2) plus numbers and quotes
+    size_t row_max = 0;
+    for (int i = 0; i < count; i++)
+    {
+        size_t row_len = 2 * (strlen(results[i].practice_id) + strlen(results[i].username)) + 128;
+        if (row_len > row_max)
+            row_max = row_len;
+    }
+    size_t capacity = MYSQL_BATCH_QUERY_SIZE > row_max + sizeof(insert_head) ? MYSQL_BATCH_QUERY_SIZE : row_max + sizeof(insert_head);
+    char *query = malloc(capacity);
+    if (!query)
+        return -1;
+
+    pthread_mutex_lock(&db->mutex);
+
+    if (mysql_query(db->conn, "START TRANSACTION"))
+    {
+        fprintf(stderr, "[DB ERROR] Failed to start transaction: %s\n", mysql_error(db->conn));
+        pthread_mutex_unlock(&db->mutex);
+        free(query);
+        return -1;
+    }
+
+    int i = 0;
+    while (i < count)
+    {
+        size_t len = sizeof(insert_head) - 1;
+        memcpy(query, insert_head, len);
+        int rows = 0;
+        while (i < count && capacity - len > row_max)
+        {
+            const DbPracticeResult *r = &results[i++];
+            if (rows++ > 0)
+                query[len++] = ',';
+            len += (size_t)sprintf(query + len, "('");
+            len += mysql_real_escape_string(db->conn, query + len, r->practice_id, strlen(r->practice_id));
+            len += (size_t)sprintf(query + len, "', '");
+            len += mysql_real_escape_string(db->conn, query + len, r->username, strlen(r->username));
+            len += (size_t)sprintf(query + len, "', %d, %d, FROM_UNIXTIME(%lld), %d, 1)",
+                                   r->num_questions, r->time_limit, r->start_time, r->score);
+        }
+
+        if (mysql_real_query(db->conn, query, len))
+        {
+            fprintf(stderr, "[DB ERROR] Failed to save practice results: %s\n", mysql_error(db->conn));
+            mysql_query(db->conn, "ROLLBACK");
+            pthread_mutex_unlock(&db->mutex);
+            free(query);
+            return -1;
+        }
+    }
+
+    if (mysql_query(db->conn, "COMMIT"))
+    {
+        fprintf(stderr, "[DB ERROR] Failed to commit practice results: %s\n", mysql_error(db->conn));
+        mysql_query(db->conn, "ROLLBACK");
+        pthread_mutex_unlock(&db->mutex);
+        free(query);
+        return -1;
+    }
+
+    pthread_mutex_unlock(&db->mutex);
+    free(query);
+    return 0;
+}
+
+static int mysqldb_load_abilities(void *impl, DbAbilityFn fn, void *ctx)
+{
+    MysqlDb *db = impl;
+    pthread_mutex_lock(&db->mutex);
+
+    if (mysql_query(db->conn, "SELECT username, category, rating, answers FROM practice_abilities"))
+    {
+        fprintf(stderr, "[DB ERROR] Failed to load abilities: %s\n", mysql_error(db->conn));
+        pthread_mutex_unlock(&db->mutex);
+        return -1;
+    }
+
+    MYSQL_RES *result = mysql_store_result(db->conn);
+    if (!result)
+    {
+        fprintf(stderr, "[DB ERROR] Failed to store result: %s\n", mysql_error(db->conn));
+        pthread_mutex_unlock(&db->mutex);
+        return -1;
+    }
+    pthread_mutex_unlock(&db->mutex); // rows are client-side now
+
+    MYSQL_ROW row;
+    int count = 0;
+    while ((row = mysql_fetch_row(result)))
+    {
+        DbAbility ability = {row[0], row[1], atoi(row[2]), atoi(row[3])};
+        count++;
+        if (fn(ctx, &ability) < 0)
+            break;
+    }
+    mysql_free_result(result);
+    return count;
+}
+
+static int mysqldb_save_abilities(void *impl, const DbAbility *abilities, int count)
+{
+    MysqlDb *db = impl;
+    static const char insert_head[] = "INSERT IGNORE INTO practice_abilities (username, category, rating, answers) VALUES ";
+    static const char insert_tail[] = " ON DUPLICATE KEY UPDATE rating = VALUES(rating), answers = VALUES(answers)";
+
+    // Worst case row: every character escaped (x2) plus numbers and quotes
+    size_t row_max = 0;
+    for (int i = 0; i < count; i++)
+    {
+        size_t row_len = 2 * (strlen(abilities[i].username) + strlen(abilities[i].category)) + 64;
+        if (row_len > row_max)
+            row_max = row_len;
+    }
+    size_t fixed = sizeof(insert_head) + sizeof(insert_tail);
+    size_t capacity = MYSQL_BATCH_QUERY_SIZE > row_max + fixed ? MYSQL_BATCH_QUERY_SIZE : row_max + fixed;
+    char *query = malloc(capacity);
+    if (!query)
+        return -1;
+
+    pthread_mutex_lock(&db->mutex);
+
+    if (mysql_query(db->conn, "START TRANSACTION"))
+    {
+        fprintf(stderr, "[DB ERROR] Failed to start transaction: %s\n", mysql_error(db->conn));
+        pthread_mutex_unlock(&db->mutex);
+        free(query);
+        return -1;
+    }
+
+    int i = 0;
+    while (i < count)
+    {
+        size_t len = sizeof(insert_head) - 1;
+        memcpy(query, insert_head, len);
+        int rows = 0;
+        while (i < count && capacity - len > row_max + sizeof(insert_tail))
+        {
+            const DbAbility *a = &abilities[i++];
+            if (rows++ > 0)
+                query[len++] = ',';
+            len += (size_t)sprintf(query + len, "('");
+            len += mysql_real_escape_string(db->conn, query + len, a->username, strlen(a->username));
+            len += (size_t)sprintf(query + len, "', '");
+            len += mysql_real_escape_string(db->conn, query + len, a->category, strlen(a->category));
+            len += (size_t)sprintf(query + len, "', %d, %d)", a->rating, a->answers);
+        }
+        memcpy(query + len, insert_tail, sizeof(insert_tail) - 1);
+        len += sizeof(insert_tail) - 1;
+
+        if (mysql_real_query(db->conn, query, len))
+        {
+            fprintf(stderr, "[DB ERROR] Failed to save abilities: %s\n", mysql_error(db->conn));
+            mysql_query(db->conn, "ROLLBACK");
+            pthread_mutex_unlock(&db->mutex);
+            free(query);
+            return -1;
+        }
+    }
+
+    if (mysql_query(db->conn, "COMMIT"))
+    {
+        fprintf(stderr, "[DB ERROR] Failed to commit abilities: %s\n", mysql_error(db->conn));
+        mysql_query(db->conn, "ROLLBACK");
+        pthread_mutex_unlock(&db->mutex);
+        free(query);
+        return -1;
+    }
+
+    pthread_mutex_unlock(&db->mutex);
+    free(query);
+    return 0;
+}
+
+// ============================== Item statistics ==============================
+static int mysqldb_load_question_stats(void *impl, DbQuestionStatsFn fn, void *ctx)
+{
+    MysqlDb *db = impl;
+    pthread_mutex_lock(&db->mutex);
+
+    if (mysql_query(db->conn, "SELECT question_id, attempts, correct_count, option_a, option_b, option_c, "
+                              "option_d, unanswered, time_ms_total FROM question_stats"))
+    {
+        fprintf(stderr, "[DB ERROR] Failed to load question stats: %s\n", mysql_error(db->conn));
+        pthread_mutex_unlock(&db->mutex);
+        return -1;
+    }
+
+    MYSQL_RES *result = mysql_store_result(db->conn);
+    if (!result)
+    {
+        fprintf(stderr, "[DB ERROR] Failed to store result: %s\n", mysql_error(db->conn));
+        pthread_mutex_unlock(&db->mutex);
+        return -1;
+    }
+    pthread_mutex_unlock(&db->mutex); // rows are client-side now
+
+    MYSQL_ROW row;
+    int count = 0;
+    while ((row = mysql_fetch_row(result)))
+    {
+        DbQuestionStats stats = {atoi(row[0]), atoll(row[1]), atoll(row[2]),
+                                 {atoll(row[3]), atoll(row[4]), atoll(row[5]), atoll(row[6]), atoll(row[7])},
+                                 atoll(row[8])};
+        count++;
+        if (fn(ctx, &stats) < 0)
+            break;
+    }
+    mysql_free_result(result);
+    return count;
+}
+
+static int mysqldb_save_question_stats(void *impl, const DbQuestionStats *stats, int count)
+{
+    MysqlDb *db = impl;
+    static const char insert_head[] =
+        "INSERT IGNORE INTO question_stats (question_id, attempts, correct_count, option_a, option_b, "
+        "option_c, option_d, unanswered, time_ms_total) VALUES ";
+    static const char insert_tail[] =
+        " ON DUPLICATE KEY UPDATE attempts = VALUES(attempts), correct_count = VALUES(correct_count), "
+        "option_a = VALUES(option_a), option_b = VALUES(option_b), option_c = VALUES(option_c), "
+        "option_d = VALUES(option_d), unanswered = VALUES(unanswered), time_ms_total = VALUES(time_ms_total)";
+    const size_t row_max = 256; // 9 numbers
+
+    size_t capacity = MYSQL_BATCH_QUERY_SIZE;
+    char *query = malloc(capacity);
+    if (!query)
+        return -1;
+
+    pthread_mutex_lock(&db->mutex);
+
+    if (mysql_query(db->conn, "START TRANSACTION"))
+    {
+        fprintf(stderr, "[DB ERROR] Failed to start transaction: %s\n", mysql_error(db->conn));
+        pthread_mutex_unlock(&db->mutex);
+        free(query);
+        return -1;
+    }
+
+    int i = 0;
+    while (i < count)
+    {
+        size_t len = sizeof(insert_head) - 1;
+        memcpy(query, insert_head, len);
+        int rows = 0;
+        while (i < count && capacity - len > row_max + sizeof(insert_tail))
+        {
+            const DbQuestionStats *q = &stats[i++];
+            len += (size_t)sprintf(query + len, "%s(%d, %lld, %lld, %lld, %lld, %lld, %lld, %lld, %lld)", rows++ ? "," : "",
+                                   q->question_id, q->attempts, q->correct, q->choices[0], q->choices[1],
+                                   q->choices[2], q->choices[3], q->choices[4], q->time_ms);
+        }
+        memcpy(query + len, insert_tail, sizeof(insert_tail) - 1);
+        len += sizeof(insert_tail) - 1;
+
+        if (mysql_real_query(db->conn, query, len))
+        {
+            fprintf(stderr, "[DB ERROR] Failed to save question stats: %s\n", mysql_error(db->conn));
+            mysql_query(db->conn, "ROLLBACK");
+            pthread_mutex_unlock(&db->mutex);
+            free(query);
+            return -1;
+        }
+    }
+
+    if (mysql_query(db->conn, "COMMIT"))
+    {
+        fprintf(stderr, "[DB ERROR] Failed to commit question stats: %s\n", mysql_error(db->conn));
+        mysql_query(db->conn, "ROLLBACK");
+        pthread_mutex_unlock(&db->mutex);
+        free(query);
+        return -1;
+    }
+
+    pthread_mutex_unlock(&db->mutex);
+    free(query);
+    return 0;
+}
+
+// ================================ Stats ======================================
+static int mysqldb_count_rooms_by_status(void *impl, int *not_started, int *in_progress, int *finished)
+{
+    MysqlDb *db = impl;
+    pthread_mutex_lock(&db->mutex);
+
+    *not_started = *in_progress = *finished = 0;
+    if (mysql_query(db->conn, "SELECT status, COUNT(*) FROM rooms GROUP BY status"))
+    {
+        pthread_mutex_unlock(&db->mutex);
+        return -1;
+    }
+
+    MYSQL_RES *result = mysql_store_result(db->conn);
+    if (!result)
+    {
+        pthread_mutex_unlock(&db->mutex);
+        return -1;
+    }
+
+    MYSQL_ROW row;
+    while ((row = mysql_fetch_row(result)))
+    {
+        int count = atoi(row[1]);
+        if (strcmp(row[0], "NOT_STARTED") == 0)
+            *not_started = count;
+        else if (strcmp(row[0], "IN_PROGRESS") == 0)
+            *in_progress = count;
+        else if (strcmp(row[0], "FINISHED") == 0)
+            *finished = count;
+    }
+
+    mysql_free_result(result);
+    pthread_mutex_unlock(&db->mutex);
+    return 0;
+}
+
+const DbBackend db_mysql_backend = {
+    .name = DB_BACKEND_MYSQL,
+    .close = mysqldb_close,
+    .create_user = mysqldb_create_user,
+    .check_username_exists = mysqldb_check_username_exists,
+    .verify_login = mysqldb_verify_login,
+    .is_account_locked = mysqldb_is_account_locked,
+    .create_session = mysqldb_create_session,
+    .destroy_session = mysqldb_destroy_session,
+    .check_user_logged_in = mysqldb_check_user_logged_in,
+    .log_activity = mysqldb_log_activity,
+    .create_room = mysqldb_create_room,
+    .list_rooms = mysqldb_list_rooms,
+    .get_rooms = mysqldb_get_rooms,
+    .list_rooms_page = mysqldb_list_rooms_page,
+    .join_room = mysqldb_join_room,
+    .get_room_status = mysqldb_get_room_status,
+    .get_room_participant_count = mysqldb_get_room_participant_count,
+    .get_room_time_limit = mysqldb_get_room_time_limit,
+    .get_room_leaderboard = mysqldb_get_room_leaderboard,
+    .get_exam_questions = mysqldb_get_exam_questions,
+    .leave_room = mysqldb_leave_room,
+    .start_room = mysqldb_start_room,
+    .finish_room = mysqldb_finish_room,
+    .is_room_creator = mysqldb_is_room_creator,
+    .is_participant = mysqldb_is_participant,
+    .delete_room = mysqldb_delete_room,
+    .get_correct_answers = mysqldb_get_correct_answers,
+    .submit_exam = mysqldb_submit_exam,
+    .check_already_submitted = mysqldb_check_already_submitted,
+    .get_exam_result = mysqldb_get_exam_result,
+    .check_all_submitted = mysqldb_check_all_submitted,
+    .submit_exam_batch = mysqldb_submit_exam_batch,
+    .get_room_question_ids = mysqldb_get_room_question_ids,
+    .load_questions = mysqldb_load_questions,
+    .save_practice_results = mysqldb_save_practice_results,
+    .load_abilities = mysqldb_load_abilities,
+    .save_abilities = mysqldb_save_abilities,
+    .load_question_stats = mysqldb_load_question_stats,
+    .save_question_stats = mysqldb_save_question_stats,
+    .count_rooms_by_status = mysqldb_count_rooms_by_status,
+};
@@ -0,0 +1,239 @@
+#include "db_seed.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+
+static void seed_row_clear(DbSeedRow *row)
+{
+    for (int i = 0; i < row->count; i++)
+    {
+        free(row->values[i]);
+        row->values[i] = NULL;
+    }
+}
+
+const char *db_seed_value(const DbSeedRow *row, const char *column)
+{
+    for (int i = 0; i < row->count; i++)
+    {
+        if (strcmp(row->names[i], column) == 0)
+            return row->values[i];
+    }
+    return NULL;
+}
+
+static const char *skip_space(const char *p)
+{
+    while (*p && isspace((unsigned char)*p))
+        p++;
+    return p;
+}
+
+// Parse an identifier (optionally `quoted`) into a new string
+static char *parse_identifier(const char **pp)
+{
+    const char *p = skip_space(*pp);
+    int quoted = *p == '`';
+    if (quoted)
+        p++;
+    const char *start = p;
+    while (*p && (isalnum((unsigned char)*p) || *p == '_'))
+        p++;
+    if (p == start)
+        return NULL;
+    char *name = strndup(start, p - start);
+    if (quoted && *p == '`')
+        p++;
+    *pp = p;
+    return name;
+}
+
+// Parse one literal: 'string' (with '' and backslash escapes), number or NULL.
+// Returns 0 on success, -1 if the value is not a literal.
+static int parse_literal(const char **pp, char **out)
+{
+    const char *p = skip_space(*pp);
+    *out = NULL;
+
+    if (*p == '\'')
+    {
+        size_t cap = 64, len = 0;
+        char *value = malloc(cap);
+        if (!value)
+            return -1;
+        p++;
+        for (;;)
+        {
+            char ch = *p++;
+            if (ch == '\0')
+            {
+                free(value);
+                return -1;
+            }
+            if (ch == '\'')
+            {
+                if (*p != '\'')
+                    break;
+                p++; // '' -> '
+            }
+            else if (ch == '\\' && *p)
+            {
+                ch = *p++;
+                ch = ch == 'n' ? '\n' : ch == 't' ? '\t' : ch == '0' ? '\0' : ch;
+            }
+            if (len + 1 >= cap)
+            {
+                char *grown = realloc(value, cap *= 2);
+                if (!grown)
+                {
+                    free(value);
+                    return -1;
+                }
+                value = grown;
+            }
+            value[len++] = ch;
+        }
+        value[len] = '\0';
+        *out = value;
+    }
+    else if (strncasecmp(p, "NULL", 4) == 0 && !isalnum((unsigned char)p[4]))
+    {
+        p += 4;
+    }
+    else if (*p == '-' || isdigit((unsigned char)*p))
+    {
+        const char *start = p++;
+        while (isdigit((unsigned char)*p) || *p == '.')
+            p++;
+        *out = strndup(start, p - start);
+    }
+    else
+    {
+        return -1;
+    }
+
+    *pp = p;
+    return 0;
+}
+
+// Parse one INSERT statement starting after "INSERT INTO". Returns rows loaded.
+static int seed_statement(const char **pp, DbSeedInsert insert, void *ctx)
+{
+    const char *p = *pp;
+    char *table = parse_identifier(&p);
+    if (!table)
+        return 0;
+
+    DbSeedRow row;
+    memset(&row, 0, sizeof(row));
+    int loaded = 0;
+
+    p = skip_space(p);
+    if (*p++ != '(')
+        goto done;
+    for (;;)
+    {
+        if (row.count == DB_SEED_MAX_COLUMNS)
+            goto done;
+        char *name = parse_identifier(&p);
+        if (!name)
+            goto done;
+        row.names[row.count++] = name;
+        p = skip_space(p);
+        if (*p == ',')
+            p++;
+        else if (*p == ')')
+        {
+            p++;
+            break;
+        }
+        else
+            goto done;
+    }
+
+    p = skip_space(p);
+    if (strncasecmp(p, "VALUES", 6) != 0)
+        goto done;
+    p += 6;
+
+    // Tuples: (v1, v2, ...), (...) ;
+    for (;;)
+    {
+        p = skip_space(p);
+        if (*p++ != '(')
+            break;
+        int i;
+        for (i = 0; i < row.count; i++)
+        {
+            if (parse_literal(&p, &row.values[i]) < 0)
+                break;
+            p = skip_space(p);
+            if (*p == ',' && i + 1 < row.count)
+                p++;
+        }
+        p = skip_space(p);
+        if (i < row.count || *p++ != ')')
+        {
+            seed_row_clear(&row);
+            break;
+        }
+
+        if (insert(ctx, table, &row) == 0)
+            loaded++;
+        seed_row_clear(&row);
+
+        p = skip_space(p);
+        if (*p == ',')
+            p++;
+        else
+            break;
+    }
+
+done:
+    for (int i = 0; i < row.count; i++)
+        free(row.names[i]);
+    free(table);
+    *pp = p;
+    return loaded;
+}
+
+int db_seed_load(const char *path, DbSeedInsert insert, void *ctx)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f)
+    {
+        perror(path);
+        return -1;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char *sql = malloc(size + 1);
+    if (!sql || fread(sql, 1, size, f) != (size_t)size)
+    {
+        free(sql);
+        fclose(f);
+        return -1;
+    }
+    sql[size] = '\0';
+    fclose(f);
+
+    int rows = 0;
+    const char *p = sql;
+    while ((p = strstr(p, "INSERT INTO")))
+    {
+        // Skip "-- ..." comment lines
+        const char *line = p;
+        while (line > sql && line[-1] != '\n')
+            line--;
+        line = skip_space(line);
+        p += strlen("INSERT INTO");
+        if (strncmp(line, "--", 2) == 0)
+            continue;
+        rows += seed_statement(&p, insert, ctx);
+    }
+    free(sql);
+    return rows;
+}
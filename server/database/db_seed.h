@@ -0,0 +1,42 @@
+#ifndef DB_SEED_H
+#define DB_SEED_H
+
+// ===============================================
+// SAMPLE DATA LOADER - reads the INSERTs of database/schema.sql
+// ===============================================
+//
+// Only literal multi-row INSERTs are understood:
+//   INSERT INTO <table> (<col>, ...) VALUES ('text', 123, NULL), (...);
+// Anything else (DDL, procedures, INSERT ... SELECT) is skipped, so the MySQL
+// schema file can seed backends that do not run MySQL.
+
+#define DB_SEED_MAX_COLUMNS 16
+
+/**
+ * @brief One parsed row: column names and values (NULL for SQL NULL)
+ */
+typedef struct
+{
+    int count;
+    char *names[DB_SEED_MAX_COLUMNS];
+    char *values[DB_SEED_MAX_COLUMNS];
+} DbSeedRow;
+
+/**
+ * @brief Called for each row; return 0 if the row was stored, -1 to skip it
+ */
+typedef int (*DbSeedInsert)(void *ctx, const char *table, const DbSeedRow *row);
+
+/**
+ * @brief Value of a column in a row
+ * @return Value, NULL if the column is missing or NULL
+ */
+const char *db_seed_value(const DbSeedRow *row, const char *column);
+
+/**
+ * @brief Parse a .sql file and feed every literal INSERT row to insert()
+ * @return Number of rows stored (insert() returned 0), -1 if the file cannot be read
+ */
+int db_seed_load(const char *path, DbSeedInsert insert, void *ctx);
+
+#endif // DB_SEED_H
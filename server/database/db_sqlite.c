@@ -0,0 +1,1286 @@
+#include "db_backend.h"
+#include "db_json.h"
+#include "db_seed.h"
+#include <sqlite3.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ===============================================
+// SQLITE BACKEND - embedded storage for single-node deployments
+// ===============================================
+//
+// WAL mode: readers never block the writer and see the last commit.
+//  - reads : one read-only connection per client thread (pthread key), with
+//            its own prepared statements, so lookups run in parallel
+//  - writes: one connection behind write_mutex (SQLite allows one writer)
+// All statements are prepared once per connection (SQLITE_PREPARE_PERSISTENT)
+// and reset after use.
+//
+// The schema mirrors database/schema.sql (same tables, keys, CHECKs and
+// cascades). TIMESTAMP columns are stored as local "YYYY-MM-DD HH:MM:SS"
+// text, which is what the MySQL backend returns. A new database file is
+// seeded with the users/questions INSERTs of schema.sql.
+
+#define SQLITE_BUSY_TIMEOUT_MS 5000
+
+static const char *SCHEMA_SQL =
+    "CREATE TABLE IF NOT EXISTS users ("
+    "  id INTEGER PRIMARY KEY AUTOINCREMENT,"
+    "  username TEXT NOT NULL UNIQUE CHECK (length(username) <= 20),"
+    "  password_hash TEXT NOT NULL CHECK (length(password_hash) <= 65),"
+    "  is_locked INTEGER DEFAULT 0,"
+    "  created_at TEXT DEFAULT (datetime('now', 'localtime')),"
+    "  last_login TEXT NULL);"
+    "CREATE TABLE IF NOT EXISTS sessions ("
+    "  id INTEGER PRIMARY KEY AUTOINCREMENT,"
+    "  session_id TEXT NOT NULL UNIQUE CHECK (length(session_id) <= 64),"
+    "  username TEXT NOT NULL REFERENCES users(username) ON DELETE CASCADE,"
+    "  login_time TEXT DEFAULT (datetime('now', 'localtime')),"
+    "  last_activity TEXT DEFAULT (datetime('now', 'localtime')),"
+    "  is_active INTEGER DEFAULT 1);"
+    "CREATE INDEX IF NOT EXISTS idx_sessions_username ON sessions(username, is_active);"
+    "CREATE TABLE IF NOT EXISTS questions ("
+    "  id INTEGER PRIMARY KEY AUTOINCREMENT,"
+    "  question_text TEXT NOT NULL,"
+    "  option_a TEXT NOT NULL, option_b TEXT NOT NULL, option_c TEXT NOT NULL, option_d TEXT NOT NULL,"
+    "  correct_answer TEXT NOT NULL CHECK (correct_answer IN ('A', 'B', 'C', 'D')),"
+    "  difficulty TEXT DEFAULT 'medium' CHECK (difficulty IN ('easy', 'medium', 'hard')),"
+    "  category TEXT,"
+    "  created_at TEXT DEFAULT (datetime('now', 'localtime')));"
+    "CREATE TABLE IF NOT EXISTS rooms ("
+    "  id INTEGER PRIMARY KEY AUTOINCREMENT,"
+    "  room_id TEXT NOT NULL UNIQUE CHECK (length(room_id) <= 32),"
+    "  room_name TEXT NOT NULL CHECK (length(room_name) <= 100),"
+    "  creator TEXT NOT NULL REFERENCES users(username) ON DELETE CASCADE,"
+    "  num_questions INTEGER NOT NULL CHECK (num_questions >= 5 AND num_questions <= 50),"
+    "  time_limit_minutes INTEGER NOT NULL CHECK (time_limit_minutes >= 5 AND time_limit_minutes <= 120),"
+    "  max_participants INTEGER DEFAULT 50,"
+    "  status TEXT DEFAULT 'NOT_STARTED' CHECK (status IN ('NOT_STARTED', 'IN_PROGRESS', 'FINISHED')),"
+    "  created_at TEXT DEFAULT (datetime('now', 'localtime')),"
+    "  start_time TEXT NULL,"
+    "  finish_time TEXT NULL);"
+    "CREATE INDEX IF NOT EXISTS idx_room_status_created ON rooms(status, created_at);"
+    "CREATE INDEX IF NOT EXISTS idx_room_created ON rooms(created_at, room_id);"
+    "CREATE TABLE IF NOT EXISTS room_questions ("
+    "  id INTEGER PRIMARY KEY AUTOINCREMENT,"
+    "  room_id TEXT NOT NULL REFERENCES rooms(room_id) ON DELETE CASCADE,"
+    "  question_id INTEGER NOT NULL REFERENCES questions(id) ON DELETE CASCADE,"
+    "  question_order INTEGER NOT NULL,"
+    "  UNIQUE (room_id, question_id));"
+    "CREATE TABLE IF NOT EXISTS participants ("
+    "  id INTEGER PRIMARY KEY AUTOINCREMENT,"
+    "  room_id TEXT NOT NULL REFERENCES rooms(room_id) ON DELETE CASCADE,"
+    "  username TEXT NOT NULL REFERENCES users(username) ON DELETE CASCADE,"
+    "  joined_at TEXT DEFAULT (datetime('now', 'localtime')),"
+    "  UNIQUE (room_id, username));"
+    "CREATE INDEX IF NOT EXISTS idx_participants_username ON participants(username);"
+    "CREATE TABLE IF NOT EXISTS exam_results ("
+    "  id INTEGER PRIMARY KEY AUTOINCREMENT,"
+    "  room_id TEXT NOT NULL REFERENCES rooms(room_id) ON DELETE CASCADE,"
+    "  username TEXT NOT NULL REFERENCES users(username) ON DELETE CASCADE,"
+    "  score INTEGER NOT NULL,"
+    "  total_questions INTEGER NOT NULL,"
+    "  submit_time TEXT DEFAULT (datetime('now', 'localtime')),"
+    "  time_taken_seconds INTEGER,"
+    "  answers TEXT,"
+    "  UNIQUE (room_id, username));"
+    "CREATE INDEX IF NOT EXISTS idx_results_room_score ON exam_results(room_id, score DESC, submit_time ASC);"
+    "CREATE TABLE IF NOT EXISTS practice_sessions ("
+    "  id INTEGER PRIMARY KEY AUTOINCREMENT,"
+    "  practice_id TEXT NOT NULL UNIQUE,"
+    "  username TEXT NOT NULL REFERENCES users(username) ON DELETE CASCADE,"
+    "  num_questions INTEGER NOT NULL,"
+    "  time_limit_minutes INTEGER NOT NULL,"
+    "  start_time TEXT DEFAULT (datetime('now', 'localtime')),"
+    "  score INTEGER,"
+    "  is_completed INTEGER DEFAULT 0);"
+    "CREATE TABLE IF NOT EXISTS practice_questions ("
+    "  id INTEGER PRIMARY KEY AUTOINCREMENT,"
+    "  practice_id TEXT NOT NULL REFERENCES practice_sessions(practice_id) ON DELETE CASCADE,"
+    "  question_id INTEGER NOT NULL REFERENCES questions(id) ON DELETE CASCADE,"
+    "  question_order INTEGER NOT NULL);"
+    "CREATE TABLE IF NOT EXISTS practice_abilities ("
+    "  username TEXT NOT NULL REFERENCES users(username) ON DELETE CASCADE,"
+    "  category TEXT NOT NULL CHECK (length(category) <= 50),"
+    "  rating INTEGER NOT NULL DEFAULT 1500,"
+    "  answers INTEGER NOT NULL DEFAULT 0,"
+    "  updated_at TEXT DEFAULT (datetime('now', 'localtime')),"
+    "  PRIMARY KEY (username, category));"
+    "CREATE TABLE IF NOT EXISTS question_stats ("
+    "  question_id INTEGER PRIMARY KEY REFERENCES questions(id) ON DELETE CASCADE,"
+    "  attempts INTEGER NOT NULL DEFAULT 0,"
+    "  correct_count INTEGER NOT NULL DEFAULT 0,"
+    "  option_a INTEGER NOT NULL DEFAULT 0, option_b INTEGER NOT NULL DEFAULT 0,"
+    "  option_c INTEGER NOT NULL DEFAULT 0, option_d INTEGER NOT NULL DEFAULT 0,"
+    "  unanswered INTEGER NOT NULL DEFAULT 0,"
+    "  time_ms_total INTEGER NOT NULL DEFAULT 0,"
+    "  updated_at TEXT DEFAULT (datetime('now', 'localtime')));"
+    "CREATE TABLE IF NOT EXISTS activity_logs ("
+    "  id INTEGER PRIMARY KEY AUTOINCREMENT,"
+    "  timestamp TEXT DEFAULT (datetime('now', 'localtime')),"
+    "  level TEXT DEFAULT 'INFO' CHECK (level IN ('INFO', 'WARNING', 'ERROR')),"
+    "  username TEXT,"
+    "  action TEXT NOT NULL,"
+    "  details TEXT,"
+    "  ip_address TEXT);";
+
+// ----- read statements (per-thread connections) -----
+#define SQLITE_READ_STATEMENTS(X)                                                                                  \
+    X(USER_EXISTS, "SELECT COUNT(*) FROM users WHERE username=?")                                                  \
+    X(VERIFY_LOGIN, "SELECT COUNT(*) FROM users WHERE username=? AND password_hash=?")                             \
+    X(IS_LOCKED, "SELECT is_locked FROM users WHERE username=?")                                                   \
+    X(LOGGED_IN, "SELECT COUNT(*) FROM sessions WHERE username=? AND is_active=1")                                 \
+    X(LIST_ROOMS, "SELECT r.room_id, r.room_name, r.creator, r.status, COUNT(p.username), "                        \
+                  "r.max_participants, r.num_questions, r.time_limit_minutes, r.created_at "                       \
+                  "FROM rooms r LEFT JOIN participants p ON r.room_id = p.room_id "                                \
+                  "WHERE ?1 = 'ALL' OR r.status = upper(?1) "                                                      \
+                  "GROUP BY r.room_id ORDER BY r.created_at DESC, r.id DESC")                                      \
+    X(ROOM_ROW, "SELECT r.room_id, r.room_name, r.creator, r.status, COUNT(p.username), "                          \
+                "r.max_participants, r.num_questions, r.time_limit_minutes, r.created_at "                         \
+                "FROM rooms r LEFT JOIN participants p ON r.room_id = p.room_id "                                  \
+                "WHERE r.room_id = ? GROUP BY r.room_id")                                                          \
+    X(ROOM_PAGE, "SELECT r.room_id, r.room_name, r.creator, r.status, "                                            \
+                 "(SELECT COUNT(*) FROM participants p WHERE p.room_id = r.room_id), "                             \
+                 "r.max_participants, r.num_questions, r.time_limit_minutes, r.created_at FROM rooms r "           \
+                 "WHERE (r.created_at, r.room_id) < (?1, ?2) "                                                     \
+                 "AND (?3 IS NULL OR r.creator = ?3) "                                                             \
+                 "AND (?4 IS NULL OR substr(r.room_name, 1, length(?4)) = ?4) "                                    \
+                 "ORDER BY r.created_at DESC, r.room_id DESC LIMIT ?5")                                            \
+    X(ROOM_PAGE_STATUS, "SELECT r.room_id, r.room_name, r.creator, r.status, "                                     \
+                        "(SELECT COUNT(*) FROM participants p WHERE p.room_id = r.room_id), "                      \
+                        "r.max_participants, r.num_questions, r.time_limit_minutes, r.created_at FROM rooms r "    \
+                        "WHERE r.status = ?6 AND (r.created_at, r.room_id) < (?1, ?2) "                            \
+                        "AND (?3 IS NULL OR r.creator = ?3) "                                                      \
+                        "AND (?4 IS NULL OR substr(r.room_name, 1, length(?4)) = ?4) "                             \
+                        "ORDER BY r.created_at DESC, r.room_id DESC LIMIT ?5")                                     \
+    X(ROOM_STATUS, "SELECT status FROM rooms WHERE room_id=?")                                                     \
+    X(PARTICIPANT_COUNT, "SELECT COUNT(*) FROM participants WHERE room_id=?")                                      \
+    X(ROOM_TIME_LIMIT, "SELECT time_limit_minutes FROM rooms WHERE room_id=?")                                     \
+    X(LEADERBOARD, "SELECT username, score, total_questions, submit_time, time_taken_seconds "                     \
+                   "FROM exam_results WHERE room_id=? ORDER BY score DESC, submit_time ASC, id ASC")               \
+    X(EXAM_QUESTIONS, "SELECT q.id, q.question_text, q.option_a, q.option_b, q.option_c, q.option_d "              \
+                      "FROM room_questions rq JOIN questions q ON rq.question_id = q.id "                          \
+                      "WHERE rq.room_id=? ORDER BY rq.question_order ASC")                                         \
+    X(IS_CREATOR, "SELECT COUNT(*) FROM rooms WHERE room_id=? AND creator=?")                                      \
+    X(IS_PARTICIPANT, "SELECT COUNT(*) FROM participants WHERE room_id=? AND username=?")                          \
+    X(CORRECT_ANSWERS, "SELECT q.correct_answer FROM room_questions rq JOIN questions q ON rq.question_id = q.id " \
+                       "WHERE rq.room_id=? ORDER BY rq.question_order")                                            \
+    X(ALREADY_SUBMITTED, "SELECT COUNT(*) FROM exam_results WHERE room_id=? AND username=?")                       \
+    X(EXAM_RESULT, "SELECT score, total_questions FROM exam_results WHERE room_id=? AND username=?")               \
+    X(RESULT_COUNT, "SELECT COUNT(*) FROM exam_results WHERE room_id=?")                                           \
+    X(QUESTIONS, "SELECT id, question_text, option_a, option_b, option_c, option_d, correct_answer, "              \
+                 "difficulty, category FROM questions ORDER BY id")                                                \
+    X(ABILITIES, "SELECT username, category, rating, answers FROM practice_abilities")                             \
+    X(ROOM_QUESTION_IDS, "SELECT question_id FROM room_questions WHERE room_id=? ORDER BY question_order")         \
+    X(QUESTION_STATS, "SELECT question_id, attempts, correct_count, option_a, option_b, option_c, option_d, "      \
+                      "unanswered, time_ms_total FROM question_stats")                                             \
+    X(COUNT_BY_STATUS, "SELECT status, COUNT(*) FROM rooms GROUP BY status")
+
+// ----- write statements (single writer connection) -----
+#define SQLITE_WRITE_STATEMENTS(X)                                                                              \
+    X(BEGIN, "BEGIN IMMEDIATE")                                                                                 \
+    X(COMMIT, "COMMIT")                                                                                         \
+    X(ROLLBACK, "ROLLBACK")                                                                                     \
+    X(CREATE_USER, "INSERT INTO users (username, password_hash) VALUES (?, ?)")                                 \
+    X(SEED_USER, "INSERT OR IGNORE INTO users (username, password_hash, is_locked) VALUES (?, ?, ?)")           \
+    X(SEED_QUESTION, "INSERT INTO questions (question_text, option_a, option_b, option_c, option_d, "           \
+                     "correct_answer, difficulty, category) VALUES (?, ?, ?, ?, ?, ?, ?, ?)")                   \
+    X(SESSION_DEACTIVATE_USER, "UPDATE sessions SET is_active = 0 WHERE username=? AND is_active = 1")          \
+    X(SESSION_INSERT, "INSERT INTO sessions (session_id, username) VALUES (?, ?)")                              \
+    X(SESSION_DESTROY, "UPDATE sessions SET is_active = 0 WHERE session_id=?")                                  \
+    X(LOG_ACTIVITY, "INSERT INTO activity_logs (level, username, action, details) VALUES (?, ?, ?, ?)")         \
+    X(ROOM_INSERT, "INSERT INTO rooms (room_id, room_name, creator, num_questions, time_limit_minutes) "        \
+                   "VALUES (?, ?, ?, ?, ?)")                                                                    \
+    X(ROOM_ASSIGN_QUESTIONS, "INSERT INTO room_questions (room_id, question_id, question_order) "               \
+                             "SELECT ?1, id, row_number() OVER () "                                             \
+                             "FROM (SELECT id FROM questions ORDER BY random() LIMIT ?2)")                      \
+    X(PARTICIPANT_INSERT, "INSERT INTO participants (room_id, username) VALUES (?, ?)")                         \
+    X(PARTICIPANT_JOIN, "INSERT OR IGNORE INTO participants (room_id, username) VALUES (?, ?)")                 \
+    X(PARTICIPANT_LEAVE, "DELETE FROM participants WHERE room_id=? AND username=?")                             \
+    X(ROOM_START, "UPDATE rooms SET status='IN_PROGRESS', start_time=datetime('now', 'localtime') "             \
+                  "WHERE room_id=?")                                                                            \
+    X(ROOM_FINISH, "UPDATE rooms SET status='FINISHED', finish_time=datetime('now', 'localtime') "              \
+                   "WHERE room_id=?")                                                                           \
+    X(ROOM_DELETE, "DELETE FROM rooms WHERE room_id=?")                                                         \
+    X(SUBMIT_EXAM, "INSERT INTO exam_results (room_id, username, score, total_questions, answers, "             \
+                   "time_taken_seconds) VALUES (?, ?, ?, ?, ?, ?)")                                             \
+    X(SUBMIT_EXAM_AT, "INSERT INTO exam_results (room_id, username, score, total_questions, answers, "          \
+                      "time_taken_seconds, submit_time) "                                                       \
+                      "VALUES (?, ?, ?, ?, ?, ?, datetime(?, 'unixepoch', 'localtime'))")                       \
+    X(PRACTICE_INSERT, "INSERT INTO practice_sessions (practice_id, username, num_questions, "                  \
+                       "time_limit_minutes, start_time, score, is_completed) "                                  \
+                       "VALUES (?, ?, ?, ?, datetime(?, 'unixepoch', 'localtime'), ?, 1)")                      \
+    X(ABILITY_UPSERT, "INSERT INTO practice_abilities (username, category, rating, answers) "                   \
+                      "VALUES (?, ?, ?, ?) ON CONFLICT (username, category) DO UPDATE SET "                     \
+                      "rating=excluded.rating, answers=excluded.answers, "                                      \
+                      "updated_at=datetime('now', 'localtime')")                                                \
+    X(QUESTION_STATS_UPSERT, "INSERT INTO question_stats (question_id, attempts, correct_count, option_a, "     \
+                             "option_b, option_c, option_d, unanswered, time_ms_total) "                        \
+                             "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?) ON CONFLICT (question_id) DO UPDATE SET "      \
+                             "attempts=excluded.attempts, correct_count=excluded.correct_count, "               \
+                             "option_a=excluded.option_a, option_b=excluded.option_b, "                         \
+                             "option_c=excluded.option_c, option_d=excluded.option_d, "                         \
+                             "unanswered=excluded.unanswered, time_ms_total=excluded.time_ms_total, "           \
+                             "updated_at=datetime('now', 'localtime')")
+
+#define SQLITE_ENUM(name, sql) SQ_##name,
+#define SQLITE_SQL(name, sql) sql,
+
+typedef enum
+{
+    SQLITE_READ_STATEMENTS(SQLITE_ENUM)
+    SQ_READ_COUNT
+} SqliteReadStatement;
+
+typedef enum
+{
+    SQLITE_WRITE_STATEMENTS(SQLITE_ENUM)
+    SQ_WRITE_COUNT
+} SqliteWriteStatement;
+
+static const char *READ_SQL[] = {SQLITE_READ_STATEMENTS(SQLITE_SQL)};
+static const char *WRITE_SQL[] = {SQLITE_WRITE_STATEMENTS(SQLITE_SQL)};
+
+typedef struct SqliteReader
+{
+    struct SqliteDb *owner;
+    sqlite3 *conn;
+    sqlite3_stmt *stmts[SQ_READ_COUNT]; // prepared on first use
+    struct SqliteReader *next;          // owner->readers list
+} SqliteReader;
+
+typedef struct SqliteDb
+{
+    char *path;
+
+    pthread_mutex_t write_mutex;
+    sqlite3 *writer;
+    sqlite3_stmt *write_stmts[SQ_WRITE_COUNT];
+
+    pthread_key_t reader_key;       // SqliteReader of the calling thread
+    pthread_mutex_t readers_mutex;  // guards readers
+    SqliteReader *readers;          // all open readers, closed with the db
+} SqliteDb;
+
+extern const DbBackend db_sqlite_backend;
+
+// ===============================================
+// Connections and statements
+// ===============================================
+
+static int sqlite_configure(sqlite3 *conn)
+{
+    sqlite3_busy_timeout(conn, SQLITE_BUSY_TIMEOUT_MS);
+    return sqlite3_exec(conn, "PRAGMA foreign_keys = ON", NULL, NULL, NULL);
+}
+
+static void reader_close(SqliteReader *reader)
+{
+    for (int i = 0; i < SQ_READ_COUNT; i++)
+        sqlite3_finalize(reader->stmts[i]);
+    sqlite3_close(reader->conn);
+    free(reader);
+}
+
+// pthread key destructor: the client thread exited
+static void reader_release(void *value)
+{
+    SqliteReader *reader = value;
+    SqliteDb *db = reader->owner;
+
+    pthread_mutex_lock(&db->readers_mutex);
+    SqliteReader **link = &db->readers;
+    while (*link && *link != reader)
+        link = &(*link)->next;
+    if (*link)
+        *link = reader->next;
+    pthread_mutex_unlock(&db->readers_mutex);
+
+    reader_close(reader);
+}
+
+static SqliteReader *reader_get(SqliteDb *db)
+{
+    SqliteReader *reader = pthread_getspecific(db->reader_key);
+    if (reader)
+        return reader;
+
+    reader = calloc(1, sizeof(SqliteReader));
+    if (!reader)
+        return NULL;
+    reader->owner = db;
+    if (sqlite3_open_v2(db->path, &reader->conn, SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX, NULL) != SQLITE_OK)
+    {
+        fprintf(stderr, "[DB ERROR] sqlite reader open failed: %s\n", sqlite3_errmsg(reader->conn));
+        sqlite3_close(reader->conn);
+        free(reader);
+        return NULL;
+    }
+    sqlite_configure(reader->conn);
+
+    pthread_mutex_lock(&db->readers_mutex);
+    reader->next = db->readers;
+    db->readers = reader;
+    pthread_mutex_unlock(&db->readers_mutex);
+
+    pthread_setspecific(db->reader_key, reader);
+    return reader;
+}
+
+// Bind parameters: 's' = text, 'i' = int, 'l' = long long
+static int bind_params(sqlite3_stmt *stmt, const char *types, va_list args)
+{
+    for (int i = 0; types[i]; i++)
+    {
+        int rc;
+        if (types[i] == 'i')
+            rc = sqlite3_bind_int(stmt, i + 1, va_arg(args, int));
+        else if (types[i] == 'l')
+            rc = sqlite3_bind_int64(stmt, i + 1, va_arg(args, long long));
+        else
+            rc = sqlite3_bind_text(stmt, i + 1, va_arg(args, const char *), -1, SQLITE_STATIC);
+        if (rc != SQLITE_OK)
+            return rc;
+    }
+    return SQLITE_OK;
+}
+
+/**
+ * @brief Prepared, bound read statement of this thread (NULL on error).
+ * Caller steps it, then calls sqlite3_reset().
+ */
+static sqlite3_stmt *read_statement(SqliteDb *db, SqliteReadStatement id, const char *types, ...)
+{
+    SqliteReader *reader = reader_get(db);
+    if (!reader)
+        return NULL;
+
+    if (!reader->stmts[id] &&
+        sqlite3_prepare_v3(reader->conn, READ_SQL[id], -1, SQLITE_PREPARE_PERSISTENT, &reader->stmts[id], NULL) != SQLITE_OK)
+    {
+        fprintf(stderr, "[DB ERROR] sqlite prepare failed: %s\n", sqlite3_errmsg(reader->conn));
+        return NULL;
+    }
+
+    sqlite3_stmt *stmt = reader->stmts[id];
+    va_list args;
+    va_start(args, types);
+    int rc = bind_params(stmt, types, args);
+    va_end(args);
+    if (rc != SQLITE_OK)
+    {
+        sqlite3_reset(stmt);
+        return NULL;
+    }
+    return stmt;
+}
+
+/**
+ * @brief First column of the first row as int, fallback on error / no row
+ */
+static int read_int(SqliteDb *db, SqliteReadStatement id, int fallback, const char *types, ...)
+{
+    SqliteReader *reader = reader_get(db);
+    if (!reader)
+        return fallback;
+
+    if (!reader->stmts[id] &&
+        sqlite3_prepare_v3(reader->conn, READ_SQL[id], -1, SQLITE_PREPARE_PERSISTENT, &reader->stmts[id], NULL) != SQLITE_OK)
+        return fallback;
+
+    sqlite3_stmt *stmt = reader->stmts[id];
+    va_list args;
+    va_start(args, types);
+    int rc = bind_params(stmt, types, args);
+    va_end(args);
+
+    int value = fallback;
+    if (rc == SQLITE_OK && sqlite3_step(stmt) == SQLITE_ROW)
+        value = sqlite3_column_int(stmt, 0);
+    sqlite3_reset(stmt);
+    return value;
+}
+
+/**
+ * @brief Run a write statement to completion. Caller holds write_mutex.
+ * @return SQLite result code (SQLITE_DONE on success)
+ */
+static int write_run(SqliteDb *db, SqliteWriteStatement id, const char *types, ...)
+{
+    sqlite3_stmt *stmt = db->write_stmts[id];
+    va_list args;
+    va_start(args, types);
+    int rc = bind_params(stmt, types, args);
+    va_end(args);
+    if (rc == SQLITE_OK)
+        rc = sqlite3_step(stmt);
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+    return rc;
+}
+
+// Row of text columns in the MYSQL_ROW layout the JSON builders expect
+static void row_texts(sqlite3_stmt *stmt, char **row, int columns)
+{
+    for (int i = 0; i < columns; i++)
+    {
+        const char *text = (const char *)sqlite3_column_text(stmt, i);
+        row[i] = (char *)(text ? text : "");
+    }
+}
+
+// ============================= User operations ===============================
+static int sqlitedb_create_user(void *impl, const char *username, const char *password_hash)
+{
+    SqliteDb *db = impl;
+    pthread_mutex_lock(&db->write_mutex);
+    int rc = write_run(db, SQ_CREATE_USER, "ss", username, password_hash);
+    pthread_mutex_unlock(&db->write_mutex);
+    return rc == SQLITE_DONE ? 0 : -1;
+}
+
+static int sqlitedb_check_username_exists(void *impl, const char *username)
+{
+    int count = read_int(impl, SQ_USER_EXISTS, -1, "s", username);
+    return count < 0 ? -1 : count > 0;
+}
+
+static int sqlitedb_verify_login(void *impl, const char *username, const char *password_hash)
+{
+    int count = read_int(impl, SQ_VERIFY_LOGIN, -1, "ss", username, password_hash);
+    return count < 0 ? -1 : count > 0;
+}
+
+static int sqlitedb_is_account_locked(void *impl, const char *username)
+{
+    return read_int(impl, SQ_IS_LOCKED, 0, "s", username);
+}
+
+// ============================ Session operations =============================
+static int sqlitedb_create_session(void *impl, const char *session_id, const char *username)
+{
+    SqliteDb *db = impl;
+    pthread_mutex_lock(&db->write_mutex);
+
+    if (write_run(db, SQ_BEGIN, "") != SQLITE_DONE)
+    {
+        fprintf(stderr, "[DB ERROR] Failed to start transaction: %s\n", sqlite3_errmsg(db->writer));
+        pthread_mutex_unlock(&db->write_mutex);
+        return -1;
+    }
+
+    // Deactivate existing sessions, then create the new one in the same commit
+    const char *step = NULL;
+    if (write_run(db, SQ_SESSION_DEACTIVATE_USER, "s", username) != SQLITE_DONE)
+        step = "deactivate sessions";
+    else if (write_run(db, SQ_SESSION_INSERT, "ss", session_id, username) != SQLITE_DONE)
+        step = "create session";
+    else if (write_run(db, SQ_COMMIT, "") != SQLITE_DONE)
+        step = "commit transaction";
+
+    if (step)
+    {
+        fprintf(stderr, "[DB ERROR] Failed to %s: %s\n", step, sqlite3_errmsg(db->writer));
+        write_run(db, SQ_ROLLBACK, "");
+        pthread_mutex_unlock(&db->write_mutex);
+        return -1;
+    }
+
+    pthread_mutex_unlock(&db->write_mutex);
+    return 0;
+}
+
+static int sqlitedb_destroy_session(void *impl, const char *session_id)
+{
+    SqliteDb *db = impl;
+    pthread_mutex_lock(&db->write_mutex);
+    int rc = write_run(db, SQ_SESSION_DESTROY, "s", session_id);
+    pthread_mutex_unlock(&db->write_mutex);
+    return rc == SQLITE_DONE ? 0 : -1;
+}
+
+static int sqlitedb_check_user_logged_in(void *impl, const char *username)
+{
+    int count = read_int(impl, SQ_LOGGED_IN, -1, "s", username);
+    return count < 0 ? -1 : count > 0;
+}
+
+// =============================== Logging =====================================
+static void sqlitedb_log_activity(void *impl, const char *level, const char *username, const char *action, const char *details)
+{
+    SqliteDb *db = impl;
+    pthread_mutex_lock(&db->write_mutex);
+    int rc = write_run(db, SQ_LOG_ACTIVITY, "ssss", level, username ? username : "SYSTEM", action, details ? details : "");
+    if (rc != SQLITE_DONE)
+        fprintf(stderr, "Failed to log activity: %s\n", sqlite3_errmsg(db->writer));
+    pthread_mutex_unlock(&db->write_mutex);
+}
+
+// ============================= Room operations ===============================
+static int sqlitedb_create_room(void *impl, const char *room_id, const char *room_name, const char *creator, int num_questions, int time_limit)
+{
+    SqliteDb *db = impl;
+    pthread_mutex_lock(&db->write_mutex);
+
+    if (write_run(db, SQ_BEGIN, "") != SQLITE_DONE)
+    {
+        fprintf(stderr, "[DB ERROR] Failed to start transaction: %s\n", sqlite3_errmsg(db->writer));
+        pthread_mutex_unlock(&db->write_mutex);
+        return -1;
+    }
+
+    const char *step = NULL;
+    if (write_run(db, SQ_ROOM_INSERT, "sssii", room_id, room_name, creator, num_questions, time_limit) != SQLITE_DONE)
+        step = "create room";
+    // Select random questions and insert into room_questions
+    else if (write_run(db, SQ_ROOM_ASSIGN_QUESTIONS, "si", room_id, num_questions) != SQLITE_DONE)
+        step = "assign questions";
+    // Creator auto joins
+    else if (write_run(db, SQ_PARTICIPANT_INSERT, "ss", room_id, creator) != SQLITE_DONE)
+        step = "add creator as participant";
+    else if (write_run(db, SQ_COMMIT, "") != SQLITE_DONE)
+        step = "commit transaction";
+
+    if (step)
+    {
+        fprintf(stderr, "[DB ERROR] Failed to %s: %s\n", step, sqlite3_errmsg(db->writer));
+        write_run(db, SQ_ROLLBACK, "");
+        pthread_mutex_unlock(&db->write_mutex);
+        return -1;
+    }
+
+    pthread_mutex_unlock(&db->write_mutex);
+
+    printf("[DB] Room '%s' created with %d random questions assigned\n", room_id, num_questions);
+    return 0;
+}
+
+static char *sqlitedb_list_rooms(void *impl, const char *status_filter)
+{
+    sqlite3_stmt *stmt = read_statement(impl, SQ_LIST_ROOMS, "s", status_filter);
+    if (!stmt)
+        return NULL;
+
+    char *json = db_json_rooms_open();
+    if (json)
+    {
+        char *row[9];
+        while (sqlite3_step(stmt) == SQLITE_ROW)
+        {
+            row_texts(stmt, row, 9);
+            if (db_json_rooms_add(json, row) < 0)
+                break; // buffer full
+        }
+        db_json_rooms_close(json);
+    }
+    sqlite3_reset(stmt);
+    return json;
+}
+
+static int sqlitedb_get_rooms(void *impl, const char *const *room_ids, int count, DbRoomRowFn fn, void *ctx)
+{
+    int found = 0;
+    for (int i = 0; i < count; i++)
+    {
+        sqlite3_stmt *stmt = read_statement(impl, SQ_ROOM_ROW, "s", room_ids[i]);
+        if (!stmt)
+            return -1;
+
+        int stop = 0;
+        if (sqlite3_step(stmt) == SQLITE_ROW) // no row: deleted
+        {
+            char *row[9];
+            row_texts(stmt, row, 9);
+            found++;
+            stop = fn(ctx, row) < 0;
+        }
+        sqlite3_reset(stmt);
+        if (stop)
+            break;
+    }
+    return found;
+}
+
+// Keyset pages walk idx_room_status_created (one status) or idx_room_created
+// (ALL) backwards from the cursor; the first page starts above every row.
+#define ROOM_PAGE_START "9999-12-31 23:59:59"
+
+static int sqlitedb_list_rooms_page(void *impl, const DbRoomPage *page, DbRoomRowFn fn, void *ctx)
+{
+    const char *after_created = page->after_room_id ? page->after_created : ROOM_PAGE_START;
+    const char *after_room_id = page->after_room_id ? page->after_room_id : "";
+    const char *prefix = page->name_prefix && *page->name_prefix ? page->name_prefix : NULL;
+
+    sqlite3_stmt *stmt = strcmp(page->status, "ALL") == 0
+                             ? read_statement(impl, SQ_ROOM_PAGE, "ssssi", after_created, after_room_id, page->creator, prefix, page->limit)
+                             : read_statement(impl, SQ_ROOM_PAGE_STATUS, "ssssis", after_created, after_room_id, page->creator, prefix, page->limit, page->status);
+    if (!stmt)
+        return -1;
+
+    int rows = 0;
+    while (sqlite3_step(stmt) == SQLITE_ROW)
+    {
+        char *row[9];
+        row_texts(stmt, row, 9);
+        rows++;
+        if (fn(ctx, row) < 0)
+            break;
+    }
+    sqlite3_reset(stmt);
+    return rows;
+}
+
+static int sqlitedb_join_room(void *impl, const char *room_id, const char *username)
+{
+    SqliteDb *db = impl;
+    pthread_mutex_lock(&db->write_mutex);
+    int rc = write_run(db, SQ_PARTICIPANT_JOIN, "ss", room_id, username);
+    int joined = rc == SQLITE_DONE && sqlite3_changes(db->writer) > 0;
+    pthread_mutex_unlock(&db->write_mutex);
+    // MySQL's INSERT IGNORE also ignores foreign key failures
+    return rc == SQLITE_DONE || (rc & 0xff) == SQLITE_CONSTRAINT ? joined : -1;
+}
+
+static int sqlitedb_get_room_status(void *impl, const char *room_id)
+{
+    sqlite3_stmt *stmt = read_statement(impl, SQ_ROOM_STATUS, "s", room_id);
+    if (!stmt)
+        return -1;
+
+    int status = -1;
+    if (sqlite3_step(stmt) == SQLITE_ROW)
+    {
+        const char *text = (const char *)sqlite3_column_text(stmt, 0);
+        if (strcmp(text, "NOT_STARTED") == 0)
+            status = 0;
+        else if (strcmp(text, "IN_PROGRESS") == 0)
+            status = 1;
+        else if (strcmp(text, "FINISHED") == 0)
+            status = 2;
+    }
+    sqlite3_reset(stmt);
+    return status;
+}
+
+static int sqlitedb_get_room_participant_count(void *impl, const char *room_id)
+{
+    return read_int(impl, SQ_PARTICIPANT_COUNT, -1, "s", room_id);
+}
+
+static int sqlitedb_get_room_time_limit(void *impl, const char *room_id)
+{
+    return read_int(impl, SQ_ROOM_TIME_LIMIT, -1, "s", room_id);
+}
+
+// ============================= Exam operations ===============================
+static char *sqlitedb_get_room_leaderboard(void *impl, const char *room_id)
+{
+    sqlite3_stmt *stmt = read_statement(impl, SQ_LEADERBOARD, "s", room_id);
+    if (!stmt)
+        return NULL;
+
+    char *json = db_json_leaderboard_open();
+    if (json)
+    {
+        char *row[5];
+        int rank = 1;
+        while (sqlite3_step(stmt) == SQLITE_ROW)
+        {
+            row_texts(stmt, row, 5);
+            if (db_json_leaderboard_add(json, rank++, row) < 0)
+                break; // buffer full
+        }
+        db_json_leaderboard_close(json);
+    }
+    sqlite3_reset(stmt);
+    return json;
+}
+
+static char *sqlitedb_get_exam_questions(void *impl, const char *room_id)
+{
+    sqlite3_stmt *stmt = read_statement(impl, SQ_EXAM_QUESTIONS, "s", room_id);
+    if (!stmt)
+        return NULL;
+
+    char *json = db_json_questions_open();
+    if (json)
+    {
+        char *row[6];
+        int first = 1;
+        while (sqlite3_step(stmt) == SQLITE_ROW)
+        {
+            row_texts(stmt, row, 6);
+            db_json_questions_add(json, row, first);
+            first = 0;
+        }
+        db_json_questions_close(json);
+    }
+    sqlite3_reset(stmt);
+    return json;
+}
+
+static int sqlitedb_leave_room(void *impl, const char *room_id, const char *username)
+{
+    SqliteDb *db = impl;
+    pthread_mutex_lock(&db->write_mutex);
+    int rc = write_run(db, SQ_PARTICIPANT_LEAVE, "ss", room_id, username);
+    pthread_mutex_unlock(&db->write_mutex);
+    return rc == SQLITE_DONE ? 0 : -1;
+}
+
+static int sqlitedb_start_room(void *impl, const char *room_id)
+{
+    SqliteDb *db = impl;
+    pthread_mutex_lock(&db->write_mutex);
+    int rc = write_run(db, SQ_ROOM_START, "s", room_id);
+    pthread_mutex_unlock(&db->write_mutex);
+    return rc == SQLITE_DONE ? 0 : -1;
+}
+
+static int sqlitedb_finish_room(void *impl, const char *room_id)
+{
+    SqliteDb *db = impl;
+    pthread_mutex_lock(&db->write_mutex);
+    int rc = write_run(db, SQ_ROOM_FINISH, "s", room_id);
+    pthread_mutex_unlock(&db->write_mutex);
+
+    if (rc == SQLITE_DONE)
+    {
+        printf("[DB] Room '%s' marked as FINISHED\n", room_id);
+    }
+    return rc == SQLITE_DONE ? 0 : -1;
+}
+
+static int sqlitedb_is_room_creator(void *impl, const char *room_id, const char *username)
+{
+    return read_int(impl, SQ_IS_CREATOR, 0, "ss", room_id, username) > 0;
+}
+
+static int sqlitedb_is_participant(void *impl, const char *room_id, const char *username)
+{
+    return read_int(impl, SQ_IS_PARTICIPANT, 0, "ss", room_id, username) > 0;
+}
+
+static int sqlitedb_delete_room(void *impl, const char *room_id)
+{
+    SqliteDb *db = impl;
+    pthread_mutex_lock(&db->write_mutex);
+    int rc = write_run(db, SQ_ROOM_DELETE, "s", room_id);
+    int affected = rc == SQLITE_DONE ? sqlite3_changes(db->writer) : 0;
+    if (rc != SQLITE_DONE)
+        fprintf(stderr, "[DB ERROR] Failed to delete room '%s': %s\n", room_id, sqlite3_errmsg(db->writer));
+    pthread_mutex_unlock(&db->write_mutex);
+
+    if (rc != SQLITE_DONE)
+        return -1;
+    if (affected == 0) // No room found with given ID
+    {
+        fprintf(stderr, "[DB WARNING] Room '%s' not found for deletion\n", room_id);
+        return -1;
+    }
+
+    printf("[DB] Room '%s' deleted successfully (cascaded to participants, questions, results)\n", room_id);
+    return 0;
+}
+
+// ========================== Submit exam operations ===========================
+static int sqlitedb_get_correct_answers(void *impl, const char *room_id, char *answers_out, int *total_out)
+{
+    sqlite3_stmt *stmt = read_statement(impl, SQ_CORRECT_ANSWERS, "s", room_id);
+    if (!stmt)
+        return -1;
+
+    int count = 0;
+    while (sqlite3_step(stmt) == SQLITE_ROW)
+        answers_out[count++] = ((const char *)sqlite3_column_text(stmt, 0))[0]; // A, B, C, or D
+    answers_out[count] = '\0';
+    *total_out = count;
+
+    sqlite3_reset(stmt);
+    return 0;
+}
+
+static int sqlitedb_submit_exam(void *impl, const char *room_id, const char *username, int score, int total, const char *answers, int time_taken)
+{
+    SqliteDb *db = impl;
+    pthread_mutex_lock(&db->write_mutex);
+    int rc = write_run(db, SQ_SUBMIT_EXAM, "ssiisi", room_id, username, score, total, answers, time_taken);
+    if (rc != SQLITE_DONE)
+        fprintf(stderr, "[DB ERROR] Failed to submit exam: %s\n", sqlite3_errmsg(db->writer));
+    pthread_mutex_unlock(&db->write_mutex);
+
+    if (rc != SQLITE_DONE)
+        return -1;
+    printf("[DB] Exam submitted for user '%s' in room '%s': %d/%d\n", username, room_id, score, total);
+    return 0;
+}
+
+// The results journal is truncated once this returns, and synchronous =
+// NORMAL does not sync the WAL on commit: these commits are synced (FULL)
+static int sqlitedb_submit_exam_batch(void *impl, const DbExamResult *results, int count)
+{
+    SqliteDb *db = impl;
+    pthread_mutex_lock(&db->write_mutex);
+
+    if (sqlite3_exec(db->writer, "PRAGMA synchronous = FULL", NULL, NULL, NULL) != SQLITE_OK ||
+        write_run(db, SQ_BEGIN, "") != SQLITE_DONE)
+    {
+        fprintf(stderr, "[DB ERROR] Failed to start transaction: %s\n", sqlite3_errmsg(db->writer));
+        sqlite3_exec(db->writer, "PRAGMA synchronous = NORMAL", NULL, NULL, NULL);
+        pthread_mutex_unlock(&db->write_mutex);
+        return -1;
+    }
+
+    int stored = 0;
+    for (int i = 0; i < count; i++)
+    {
+        const DbExamResult *r = &results[i];
+        int rc = write_run(db, SQ_SUBMIT_EXAM_AT, "ssiisil", r->room_id, r->username, r->score, r->total,
+                           r->answers, r->time_taken, r->submit_time);
+        if (rc == SQLITE_DONE)
+            stored++;
+        else if ((rc & 0xff) != SQLITE_CONSTRAINT) // duplicates / deleted rooms are skipped
+        {
+            fprintf(stderr, "[DB ERROR] Failed to submit exam batch: %s\n", sqlite3_errmsg(db->writer));
+            write_run(db, SQ_ROLLBACK, "");
+            sqlite3_exec(db->writer, "PRAGMA synchronous = NORMAL", NULL, NULL, NULL);
+            pthread_mutex_unlock(&db->write_mutex);
+            return -1;
+        }
+    }
+
+    if (write_run(db, SQ_COMMIT, "") != SQLITE_DONE)
+    {
+        fprintf(stderr, "[DB ERROR] Failed to commit exam batch: %s\n", sqlite3_errmsg(db->writer));
+        write_run(db, SQ_ROLLBACK, "");
+        sqlite3_exec(db->writer, "PRAGMA synchronous = NORMAL", NULL, NULL, NULL);
+        pthread_mutex_unlock(&db->write_mutex);
+        return -1;
+    }
+
+    sqlite3_exec(db->writer, "PRAGMA synchronous = NORMAL", NULL, NULL, NULL);
+    pthread_mutex_unlock(&db->write_mutex);
+    printf("[DB] Committed %d/%d journaled exam result(s)\n", stored, count);
+    return 0;
+}
+
+static int sqlitedb_check_already_submitted(void *impl, const char *room_id, const char *username)
+{
+    return read_int(impl, SQ_ALREADY_SUBMITTED, 0, "ss", room_id, username) > 0;
+}
+
+static char *sqlitedb_get_exam_result(void *impl, const char *room_id, const char *username)
+{
+    sqlite3_stmt *stmt = read_statement(impl, SQ_EXAM_RESULT, "ss", room_id, username);
+    if (!stmt)
+        return NULL;
+
+    char *result_str = NULL; // Format: "score|total"
+    if (sqlite3_step(stmt) == SQLITE_ROW)
+    {
+        result_str = malloc(64);
+        if (result_str)
+            snprintf(result_str, 64, "%d|%d", sqlite3_column_int(stmt, 0), sqlite3_column_int(stmt, 1));
+    }
+    sqlite3_reset(stmt);
+    return result_str;
+}
+
+static int sqlitedb_check_all_submitted(void *impl, const char *room_id)
+{
+    int total_participants = read_int(impl, SQ_PARTICIPANT_COUNT, 0, "s", room_id);
+    if (total_participants == 0)
+        return 0;
+    int total_submissions = read_int(impl, SQ_RESULT_COUNT, 0, "s", room_id);
+    return total_submissions >= total_participants;
+}
+
+static int sqlitedb_get_room_question_ids(void *impl, const char *room_id, int *ids_out, int max)
+{
+    sqlite3_stmt *stmt = read_statement(impl, SQ_ROOM_QUESTION_IDS, "s", room_id);
+    if (!stmt)
+        return -1;
+
+    int count = 0;
+    while (count < max && sqlite3_step(stmt) == SQLITE_ROW)
+        ids_out[count++] = sqlite3_column_int(stmt, 0);
+    sqlite3_reset(stmt);
+    return count;
+}
+
+// ============================ Practice operations ============================
+static int sqlitedb_load_questions(void *impl, DbQuestionFn fn, void *ctx)
+{
+    sqlite3_stmt *stmt = read_statement(impl, SQ_QUESTIONS, "");
+    if (!stmt)
+        return -1;
+
+    int count = 0;
+    while (sqlite3_step(stmt) == SQLITE_ROW)
+    {
+        char *row[9];
+        row_texts(stmt, row, 9);
+        DbQuestion question = {sqlite3_column_int(stmt, 0), row[1], {row[2], row[3], row[4], row[5]}, row[6][0],
+                               row[7][0] ? row[7] : "medium", sqlite3_column_type(stmt, 8) == SQLITE_NULL ? NULL : row[8]};
+        count++;
+        if (fn(ctx, &question) < 0)
+            break;
+    }
+    sqlite3_reset(stmt);
+    return count;
+}
+
+static int sqlitedb_save_practice_results(void *impl, const DbPracticeResult *results, int count)
+{
+    SqliteDb *db = impl;
+    pthread_mutex_lock(&db->write_mutex);
+
+    if (write_run(db, SQ_BEGIN, "") != SQLITE_DONE)
+    {
+        fprintf(stderr, "[DB ERROR] Failed to start transaction: %s\n", sqlite3_errmsg(db->writer));
+        pthread_mutex_unlock(&db->write_mutex);
+        return -1;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        const DbPracticeResult *r = &results[i];
+        int rc = write_run(db, SQ_PRACTICE_INSERT, "ssiili", r->practice_id, r->username, r->num_questions,
+                           r->time_limit, r->start_time, r->score);
+        if (rc != SQLITE_DONE && (rc & 0xff) != SQLITE_CONSTRAINT) // duplicates / deleted users are skipped
+        {
+            fprintf(stderr, "[DB ERROR] Failed to save practice results: %s\n", sqlite3_errmsg(db->writer));
+            write_run(db, SQ_ROLLBACK, "");
+            pthread_mutex_unlock(&db->write_mutex);
+            return -1;
+        }
+    }
+
+    if (write_run(db, SQ_COMMIT, "") != SQLITE_DONE)
+    {
+        fprintf(stderr, "[DB ERROR] Failed to commit practice results: %s\n", sqlite3_errmsg(db->writer));
+        write_run(db, SQ_ROLLBACK, "");
+        pthread_mutex_unlock(&db->write_mutex);
+        return -1;
+    }
+
+    pthread_mutex_unlock(&db->write_mutex);
+    return 0;
+}
+
+static int sqlitedb_load_abilities(void *impl, DbAbilityFn fn, void *ctx)
+{
+    sqlite3_stmt *stmt = read_statement(impl, SQ_ABILITIES, "");
+    if (!stmt)
+        return -1;
+
+    int count = 0;
+    while (sqlite3_step(stmt) == SQLITE_ROW)
+    {
+        DbAbility ability = {(const char *)sqlite3_column_text(stmt, 0), (const char *)sqlite3_column_text(stmt, 1),
+                             sqlite3_column_int(stmt, 2), sqlite3_column_int(stmt, 3)};
+        count++;
+        if (fn(ctx, &ability) < 0)
+            break;
+    }
+    sqlite3_reset(stmt);
+    return count;
+}
+
+static int sqlitedb_save_abilities(void *impl, const DbAbility *abilities, int count)
+{
+    SqliteDb *db = impl;
+    pthread_mutex_lock(&db->write_mutex);
+
+    if (write_run(db, SQ_BEGIN, "") != SQLITE_DONE)
+    {
+        fprintf(stderr, "[DB ERROR] Failed to start transaction: %s\n", sqlite3_errmsg(db->writer));
+        pthread_mutex_unlock(&db->write_mutex);
+        return -1;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        const DbAbility *a = &abilities[i];
+        int rc = write_run(db, SQ_ABILITY_UPSERT, "ssii", a->username, a->category, a->rating, a->answers);
+        if (rc != SQLITE_DONE && (rc & 0xff) != SQLITE_CONSTRAINT) // deleted users are skipped
+        {
+            fprintf(stderr, "[DB ERROR] Failed to save abilities: %s\n", sqlite3_errmsg(db->writer));
+            write_run(db, SQ_ROLLBACK, "");
+            pthread_mutex_unlock(&db->write_mutex);
+            return -1;
+        }
+    }
+
+    if (write_run(db, SQ_COMMIT, "") != SQLITE_DONE)
+    {
+        fprintf(stderr, "[DB ERROR] Failed to commit abilities: %s\n", sqlite3_errmsg(db->writer));
+        write_run(db, SQ_ROLLBACK, "");
+        pthread_mutex_unlock(&db->write_mutex);
+        return -1;
+    }
+
+    pthread_mutex_unlock(&db->write_mutex);
+    return 0;
+}
+
+// ============================== Item statistics ==============================
+static int sqlitedb_load_question_stats(void *impl, DbQuestionStatsFn fn, void *ctx)
+{
+    sqlite3_stmt *stmt = read_statement(impl, SQ_QUESTION_STATS, "");
+    if (!stmt)
+        return -1;
+
+    int count = 0;
+    while (sqlite3_step(stmt) == SQLITE_ROW)
+    {
+        DbQuestionStats stats = {sqlite3_column_int(stmt, 0), sqlite3_column_int64(stmt, 1), sqlite3_column_int64(stmt, 2),
+                                 {sqlite3_column_int64(stmt, 3), sqlite3_column_int64(stmt, 4), sqlite3_column_int64(stmt, 5),
+                                  sqlite3_column_int64(stmt, 6), sqlite3_column_int64(stmt, 7)},
+                                 sqlite3_column_int64(stmt, 8)};
+        count++;
+        if (fn(ctx, &stats) < 0)
+            break;
+    }
+    sqlite3_reset(stmt);
+    return count;
+}
+
+static int sqlitedb_save_question_stats(void *impl, const DbQuestionStats *stats, int count)
+{
+    SqliteDb *db = impl;
+    pthread_mutex_lock(&db->write_mutex);
+
+    if (write_run(db, SQ_BEGIN, "") != SQLITE_DONE)
+    {
+        fprintf(stderr, "[DB ERROR] Failed to start transaction: %s\n", sqlite3_errmsg(db->writer));
+        pthread_mutex_unlock(&db->write_mutex);
+        return -1;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        const DbQuestionStats *q = &stats[i];
+        int rc = write_run(db, SQ_QUESTION_STATS_UPSERT, "illllllll", q->question_id, q->attempts, q->correct,
+                           q->choices[0], q->choices[1], q->choices[2], q->choices[3], q->choices[4], q->time_ms);
+        if (rc != SQLITE_DONE && (rc & 0xff) != SQLITE_CONSTRAINT) // deleted questions are skipped
+        {
+            fprintf(stderr, "[DB ERROR] Failed to save question stats: %s\n", sqlite3_errmsg(db->writer));
+            write_run(db, SQ_ROLLBACK, "");
+            pthread_mutex_unlock(&db->write_mutex);
+            return -1;
+        }
+    }
+
+    if (write_run(db, SQ_COMMIT, "") != SQLITE_DONE)
+    {
+        fprintf(stderr, "[DB ERROR] Failed to commit question stats: %s\n", sqlite3_errmsg(db->writer));
+        write_run(db, SQ_ROLLBACK, "");
+        pthread_mutex_unlock(&db->write_mutex);
+        return -1;
+    }
+
+    pthread_mutex_unlock(&db->write_mutex);
+    return 0;
+}
+
+// ================================ Stats ======================================
+static int sqlitedb_count_rooms_by_status(void *impl, int *not_started, int *in_progress, int *finished)
+{
+    *not_started = *in_progress = *finished = 0;
+    sqlite3_stmt *stmt = read_statement(impl, SQ_COUNT_BY_STATUS, "");
+    if (!stmt)
+        return -1;
+
+    while (sqlite3_step(stmt) == SQLITE_ROW)
+    {
+        const char *status = (const char *)sqlite3_column_text(stmt, 0);
+        int count = sqlite3_column_int(stmt, 1);
+        if (strcmp(status, "NOT_STARTED") == 0)
+            *not_started = count;
+        else if (strcmp(status, "IN_PROGRESS") == 0)
+            *in_progress = count;
+        else if (strcmp(status, "FINISHED") == 0)
+            *finished = count;
+    }
+    sqlite3_reset(stmt);
+    return 0;
+}
+
+// ===============================================
+// Seeding (new database file only)
+// ===============================================
+
+static int seed_insert(void *ctx, const char *table, const DbSeedRow *row)
+{
+    SqliteDb *db = ctx;
+    if (strcmp(table, "users") == 0)
+    {
+        const char *username = db_seed_value(row, "username");
+        const char *password_hash = db_seed_value(row, "password_hash");
+        const char *is_locked = db_seed_value(row, "is_locked");
+        if (!username || !password_hash)
+            return -1;
+        return write_run(db, SQ_SEED_USER, "ssi", username, password_hash, is_locked ? atoi(is_locked) : 0) == SQLITE_DONE ? 0 : -1;
+    }
+    if (strcmp(table, "questions") == 0)
+    {
+        const char *difficulty = db_seed_value(row, "difficulty");
+        const char *category = db_seed_value(row, "category");
+        sqlite3_stmt *stmt = db->write_stmts[SQ_SEED_QUESTION];
+        static const char *columns[] = {"question_text", "option_a", "option_b", "option_c", "option_d", "correct_answer"};
+        for (int i = 0; i < 6; i++)
+            sqlite3_bind_text(stmt, i + 1, db_seed_value(row, columns[i]), -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 7, difficulty ? difficulty : "medium", -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 8, category, -1, SQLITE_STATIC);
+        int rc = sqlite3_step(stmt);
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+        return rc == SQLITE_DONE ? 0 : -1;
+    }
+    return -1;
+}
+
+static int seed_if_empty(SqliteDb *db, const char *seed_file)
+{
+    sqlite3_stmt *stmt;
+    int questions = 0;
+    if (sqlite3_prepare_v2(db->writer, "SELECT COUNT(*) FROM questions", -1, &stmt, NULL) == SQLITE_OK)
+    {
+        if (sqlite3_step(stmt) == SQLITE_ROW)
+            questions = sqlite3_column_int(stmt, 0);
+        sqlite3_finalize(stmt);
+    }
+    if (questions > 0)
+        return 0;
+
+    write_run(db, SQ_BEGIN, "");
+    int rows = db_seed_load(seed_file, seed_insert, db);
+    if (rows <= 0 || write_run(db, SQ_COMMIT, "") != SQLITE_DONE)
+    {
+        fprintf(stderr, "[DB ERROR] Failed to seed %s from %s\n", db->path, seed_file);
+        write_run(db, SQ_ROLLBACK, "");
+        return -1;
+    }
+    printf("[DB] SQLite database %s seeded from %s (%d rows)\n", db->path, seed_file, rows);
+    return 0;
+}
+
+// ===============================================
+// Open / close
+// ===============================================
+
+static void sqlitedb_close(void *impl)
+{
+    SqliteDb *db = impl;
+
+    // Readers of threads that are still alive (their key destructor will not run)
+    pthread_mutex_lock(&db->readers_mutex);
+    SqliteReader *reader = db->readers;
+    db->readers = NULL;
+    pthread_mutex_unlock(&db->readers_mutex);
+    while (reader)
+    {
+        SqliteReader *next = reader->next;
+        reader_close(reader);
+        reader = next;
+    }
+    pthread_key_delete(db->reader_key);
+
+    for (int i = 0; i < SQ_WRITE_COUNT; i++)
+        sqlite3_finalize(db->write_stmts[i]);
+    sqlite3_close(db->writer);
+    pthread_mutex_destroy(&db->write_mutex);
+    pthread_mutex_destroy(&db->readers_mutex);
+    free(db->path);
+    free(db);
+}
+
+int db_sqlite_open(Database *db, const char *path, const char *seed_file)
+{
+    SqliteDb *sdb = calloc(1, sizeof(SqliteDb));
+    if (!sdb)
+        return -1;
+    sdb->path = strdup(path);
+    pthread_mutex_init(&sdb->write_mutex, NULL);
+    pthread_mutex_init(&sdb->readers_mutex, NULL);
+    pthread_key_create(&sdb->reader_key, reader_release);
+
+    char *error = NULL;
+    if (sqlite3_open_v2(path, &sdb->writer, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX, NULL) != SQLITE_OK ||
+        sqlite_configure(sdb->writer) != SQLITE_OK ||
+        sqlite3_exec(sdb->writer, "PRAGMA journal_mode = WAL; PRAGMA synchronous = NORMAL;", NULL, NULL, &error) != SQLITE_OK ||
+        sqlite3_exec(sdb->writer, SCHEMA_SQL, NULL, NULL, &error) != SQLITE_OK)
+    {
+        fprintf(stderr, "[DB ERROR] sqlite open %s failed: %s\n", path, error ? error : sqlite3_errmsg(sdb->writer));
+        sqlite3_free(error);
+        sqlitedb_close(sdb);
+        return -1;
+    }
+
+    for (int i = 0; i < SQ_WRITE_COUNT; i++)
+    {
+        if (sqlite3_prepare_v3(sdb->writer, WRITE_SQL[i], -1, SQLITE_PREPARE_PERSISTENT, &sdb->write_stmts[i], NULL) != SQLITE_OK)
+        {
+            fprintf(stderr, "[DB ERROR] sqlite prepare failed: %s\n", sqlite3_errmsg(sdb->writer));
+            sqlitedb_close(sdb);
+            return -1;
+        }
+    }
+
+    if (seed_if_empty(sdb, seed_file) < 0)
+    {
+        sqlitedb_close(sdb);
+        return -1;
+    }
+
+    db->backend = &db_sqlite_backend;
+    db->impl = sdb;
+    return 0;
+}
+
+const DbBackend db_sqlite_backend = {
+    .name = DB_BACKEND_SQLITE,
+    .close = sqlitedb_close,
+    .create_user = sqlitedb_create_user,
+    .check_username_exists = sqlitedb_check_username_exists,
+    .verify_login = sqlitedb_verify_login,
+    .is_account_locked = sqlitedb_is_account_locked,
+    .create_session = sqlitedb_create_session,
+    .destroy_session = sqlitedb_destroy_session,
+    .check_user_logged_in = sqlitedb_check_user_logged_in,
+    .log_activity = sqlitedb_log_activity,
+    .create_room = sqlitedb_create_room,
+    .list_rooms = sqlitedb_list_rooms,
+    .get_rooms = sqlitedb_get_rooms,
+    .list_rooms_page = sqlitedb_list_rooms_page,
+    .join_room = sqlitedb_join_room,
+    .get_room_status = sqlitedb_get_room_status,
+    .get_room_participant_count = sqlitedb_get_room_participant_count,
+    .get_room_time_limit = sqlitedb_get_room_time_limit,
+    .get_room_leaderboard = sqlitedb_get_room_leaderboard,
+    .get_exam_questions = sqlitedb_get_exam_questions,
+    .leave_room = sqlitedb_leave_room,
+    .start_room = sqlitedb_start_room,
+    .finish_room = sqlitedb_finish_room,
+    .is_room_creator = sqlitedb_is_room_creator,
+    .is_participant = sqlitedb_is_participant,
+    .delete_room = sqlitedb_delete_room,
+    .get_correct_answers = sqlitedb_get_correct_answers,
+    .submit_exam = sqlitedb_submit_exam,
+    .check_already_submitted = sqlitedb_check_already_submitted,
+    .get_exam_result = sqlitedb_get_exam_result,
+    .check_all_submitted = sqlitedb_check_all_submitted,
+    .submit_exam_batch = sqlitedb_submit_exam_batch,
+    .get_room_question_ids = sqlitedb_get_room_question_ids,
+    .load_questions = sqlitedb_load_questions,
+    .save_practice_results = sqlitedb_save_practice_results,
+    .load_abilities = sqlitedb_load_abilities,
+    .save_abilities = sqlitedb_save_abilities,
+    .load_question_stats = sqlitedb_load_question_stats,
+    .save_question_stats = sqlitedb_save_question_stats,
+    .count_rooms_by_status = sqlitedb_count_rooms_by_status,
+};
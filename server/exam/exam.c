@@ -1,7 +1,14 @@
 #include "exam.h"
 #include "../server.h"
 #include "../auth/auth.h"
+#include "../leaderboard/leaderboard.h"
+#include "exam_timer.h"
+#include "../answers/answers.h"
+#include "../room/room_counters.h"
+#include "../room/lobby.h"
+#include "../stats/item_stats.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <time.h>
 
@@ -72,11 +79,8 @@ void handle_get_exam(Server *server, ClientSession *client, Message *msg)
     }
 
     // Send response: 150 DATA <length>\n<JSON>
-    char buffer[1024 * 1024]; // 1MB buffer for exam data
-    int len = create_data_message(150, exam_json, strlen(exam_json), buffer, sizeof(buffer));
-    if (len > 0)
+    if (send_data_message(client, CODE_EXAM_DATA, exam_json, strlen(exam_json)) == 0)
     {
-        send_full(client->socket_fd, buffer, len);
         db_log_activity(server->db, "INFO", client->username, "GET_EXAM", "Success");
     }
     else
@@ -123,8 +127,26 @@ void handle_view_result(Server *server, ClientSession *client, Message *msg)
         return;
     }
 
-    // Get leaderboard (returns JSON)
-    char *leaderboard_json = db_get_room_leaderboard(server->db, room_id);
+    // COMPRESS session: the ZDATA frame cached with the in-memory ranking (compressed
+    // once per leaderboard version, not once per viewer)
+    if (client->compress)
+    {
+        size_t frame_len = 0;
+        char *frame = leaderboard_get_zdata(room_id, &frame_len);
+        if (frame)
+        {
+            send_reply(client->socket_fd, frame, frame_len);
+            free(frame);
+            db_log_activity(server->db, "INFO", client->username, "VIEW_RESULT", "Viewed results for room");
+            printf("[VIEW_RESULT] User '%s' viewed results for room '%s'\n", client->username, room_id);
+            return;
+        }
+    }
+
+    // Get leaderboard (returns JSON): in-memory ranking, database for rooms created before startup
+    char *leaderboard_json = leaderboard_get_json(room_id);
+    if (!leaderboard_json)
+        leaderboard_json = db_get_room_leaderboard(server->db, room_id);
     if (!leaderboard_json)
     {
         send_error_or_response(client->socket_fd, CODE_INTERNAL_ERROR, "Failed to get leaderboard");
@@ -133,11 +155,8 @@ void handle_view_result(Server *server, ClientSession *client, Message *msg)
     }
 
     // send response: 127 DATA <length>\n<JSON leaderboard>
-    char buffer[MAX_DATA_SIZE];
-    int len = create_data_message(CODE_RESULT_DATA, leaderboard_json, strlen(leaderboard_json), buffer, sizeof(buffer));
-    if (len > 0)
+    if (send_data_message(client, CODE_RESULT_DATA, leaderboard_json, strlen(leaderboard_json)) == 0)
     {
-        send_full(client->socket_fd, buffer, len);
         db_log_activity(server->db, "INFO", client->username, "VIEW_RESULT", "Viewed results for room");
     }
     else
@@ -152,21 +171,149 @@ void handle_view_result(Server *server, ClientSession *client, Message *msg)
 /**
  * @brief Broadcast message to all participants in room
  */
-void broadcast_to_room(Server *server, const char *room_id, const char *message)
+// Send to every active session whose current_room (or subscribed_room) is room_id;
+// sessions that sent COMPRESS get zmessage instead when there is one (compressed once for all).
+// The sessions are copied under clients_mutex and written outside it (push_to_targets),
+// so a client that stops reading cannot hold up the server.
+static int broadcast_to_sessions(Server *server, const char *room_id, const char *message, size_t len,
+                                 const char *zmessage, size_t zlen, int subscribers)
 {
+    PushTarget targets[MAX_CLIENTS];
+    int count = 0;
+    pthread_mutex_lock(&server->push_mutex);
     pthread_mutex_lock(&server->clients_mutex);
 
     for (int i = 0; i < MAX_CLIENTS; i++)
     {
         ClientSession *client = &server->clients[i];
-        if (client->active && strcmp(client->current_room, room_id) == 0)
+        const char *room = subscribers ? client->subscribed_room : client->current_room;
+        if (client->active && strcmp(room, room_id) == 0)
         {
-            send_full(client->socket_fd, message, strlen(message));
-            printf("  [BROADCAST] Sent to user '%s'\n", client->username);
+            targets[count].socket_fd = client->socket_fd;
+            targets[count].compress = client->compress;
+            strcpy(targets[count].username, client->username);
+            count++;
+            if (!subscribers)
+                printf("  [BROADCAST] Sending to user '%s'\n", client->username);
         }
     }
 
     pthread_mutex_unlock(&server->clients_mutex);
+    int sent = push_to_targets(targets, count, message, len, zmessage, zlen);
+    pthread_mutex_unlock(&server->push_mutex);
+    return sent;
+}
+
+void broadcast_to_room(Server *server, const char *room_id, const char *message)
+{
+    broadcast_to_sessions(server, room_id, message, strlen(message), NULL, 0, 0);
+}
+
+int broadcast_leaderboard_delta(const char *room_id, const char *json, size_t len, void *ctx)
+{
+    Server *server = ctx;
+    size_t size = len + 64;
+    char *buffer = malloc(size);
+    if (!buffer)
+        return -1;
+    char *zbuffer = len >= COMPRESS_MIN_BYTES ? malloc(size) : NULL;
+    int z_len = zbuffer ? create_zdata_message(CODE_LEADERBOARD_PUSH, json, len, zbuffer, size) : 0;
+
+    int sent = -1;
+    int msg_len = create_data_message(CODE_LEADERBOARD_PUSH, json, len, buffer, size);
+    if (msg_len > 0)
+        sent = broadcast_to_sessions(server, room_id, buffer, (size_t)msg_len,
+                                     z_len > 0 ? zbuffer : NULL, z_len > 0 ? (size_t)z_len : 0, 1);
+    free(zbuffer);
+    free(buffer);
+    return sent;
+}
+
+/**
+ * @brief Handle SUBSCRIBE_LEADERBOARD command - live leaderboard for the room creator
+ */
+void handle_subscribe_leaderboard(Server *server, ClientSession *client, Message *msg)
+{
+    // Check authentication
+    if (!check_authentication(client))
+    {
+        send_error_or_response(client->socket_fd, CODE_NOT_LOGGED, "Not authenticated");
+        return;
+    }
+
+    if (msg->param_count < 1)
+    {
+        send_error_or_response(client->socket_fd, CODE_INVALID_PARAMS, "Usage: SUBSCRIBE_LEADERBOARD <room_id>");
+        return;
+    }
+
+    const char *room_id = msg->params[0];
+
+    if (strlen(room_id) >= MAX_ROOM_ID_LEN || db_get_room_status(server->db, room_id) < 0)
+    {
+        send_error_or_response(client->socket_fd, CODE_ROOM_NOT_FOUND, room_id);
+        return;
+    }
+
+    // Results stay hidden from participants until FINISHED: only the creator (proctor) may watch
+    if (!db_is_room_creator(server->db, room_id, client->username))
+    {
+        send_error_or_response(client->socket_fd, CODE_NOT_CREATOR, room_id);
+        db_log_activity(server->db, "WARNING", client->username, "SUBSCRIBE_LEADERBOARD", "Not room creator");
+        return;
+    }
+
+    // Send the snapshot and subscribe under push_mutex: every delta
+    // broadcast after this point reaches the client after the snapshot
+    pthread_mutex_lock(&server->push_mutex);
+    size_t len = 0;
+    char *snapshot = leaderboard_snapshot(room_id, &len);
+    int sent = snapshot ? send_data_push(client, CODE_LEADERBOARD_PUSH, snapshot, len) : -1;
+    if (sent == 0)
+    {
+        pthread_mutex_lock(&server->clients_mutex);
+        snprintf(client->subscribed_room, sizeof(client->subscribed_room), "%.*s", MAX_ROOM_ID_LEN - 1, room_id);
+        pthread_mutex_unlock(&server->clients_mutex);
+    }
+    pthread_mutex_unlock(&server->push_mutex);
+    free(snapshot);
+
+    if (sent < 0)
+    {
+        // Room created before the server started: no in-memory leaderboard
+        send_error_or_response(client->socket_fd, CODE_INVALID_STATE, "Live leaderboard not available for this room");
+        return;
+    }
+
+    db_log_activity(server->db, "INFO", client->username, "SUBSCRIBE_LEADERBOARD", room_id);
+    printf("[SUBSCRIBE_LEADERBOARD] User '%s' watching room '%s'\n", client->username, room_id);
+}
+
+/**
+ * @brief Handle UNSUBSCRIBE_LEADERBOARD command
+ */
+void handle_unsubscribe_leaderboard(Server *server, ClientSession *client, Message *msg)
+{
+    (void)msg;
+    if (!check_authentication(client))
+    {
+        send_error_or_response(client->socket_fd, CODE_NOT_LOGGED, "Not authenticated");
+        return;
+    }
+
+    pthread_mutex_lock(&server->clients_mutex);
+    memset(client->subscribed_room, 0, sizeof(client->subscribed_room));
+    pthread_mutex_unlock(&server->clients_mutex);
+
+    send_error_or_response(client->socket_fd, CODE_LEADERBOARD_PUSH, "UNSUBSCRIBED");
+}
+
+// Question ids of the room for item statistics, read once per room
+static int track_item_stats_room(Server *server, const char *room_id)
+{
+    int ids[ITEM_STATS_MAX_QUESTIONS];
+    int count = db_get_room_question_ids(server->db, room_id, ids, ITEM_STATS_MAX_QUESTIONS);
+    return count > 0 ? item_stats_track_room(room_id, ids, count) : -1;
 }
 
 /**
@@ -224,26 +371,89 @@ void handle_start_exam(Server *server, ClientSession *client, Message *msg)
         return;
     }
 
+    int time_limit = db_get_room_time_limit(server->db, room_id);
+    if (time_limit <= 0)
+    {
+        send_error_or_response(client->socket_fd, CODE_INTERNAL_ERROR, "Failed to start exam");
+        db_log_activity(server->db, "ERROR", client->username, "START_EXAM", "Failed to get time limit");
+        return;
+    }
+
+    // Arm the server-side timer first: no submission is accepted without it,
+    // and a concurrent START_EXAM of the same room fails here
+    time_t deadline;
+    if (exam_timer_arm(room_id, time_limit * 60, &deadline) < 0)
+    {
+        send_error_or_response(client->socket_fd, CODE_ROOM_IN_PROGRESS, "Exam is already in progress");
+        db_log_activity(server->db, "WARNING", client->username, "START_EXAM", "Timer already armed");
+        return;
+    }
+
     // Start room (update status to IN_PROGRESS)
     if (db_start_room(server->db, room_id) < 0)
     {
+        exam_timer_cancel(room_id);
         send_error_or_response(client->socket_fd, CODE_INTERNAL_ERROR, "Failed to start exam");
         db_log_activity(server->db, "ERROR", client->username, "START_EXAM", "Database error");
         return;
     }
+    lobby_room_changed(room_id, LOBBY_STARTED, 0);
+    // Graded sheets then only touch counters (retried at the first submit if this fails)
+    track_item_stats_room(server, room_id);
 
     // Get start time
     time_t now = time(NULL);
     char timestamp[64];
     strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+    char deadline_str[64];
+    strftime(deadline_str, sizeof(deadline_str), "%Y-%m-%dT%H:%M:%S", localtime(&deadline));
+
+    // --push-exam: serialize the exam once and send it right after START_OK,
+    // instead of every participant asking for it with GET_EXAM at the same moment
+    char *broadcast_msg = NULL, *zbroadcast_msg = NULL;
+    size_t broadcast_len = 0, zbroadcast_len = 0;
+    char *exam_json = server->options.push_exam ? db_get_exam_questions(server->db, room_id) : NULL;
+    if (exam_json)
+    {
+        size_t exam_len = strlen(exam_json);
+        size_t size = exam_len + 512; // START_OK line + 150 DATA header
+        broadcast_msg = malloc(size);
+        if (broadcast_msg)
+        {
+            // 125 START_OK room_id|start|deadline|EXAM + 150 DATA: each participant gets a single send
+            int start_len = snprintf(broadcast_msg, size, "125 START_OK %s|%s|%s|%s\n", room_id, timestamp, deadline_str, START_OK_EXAM_PUSHED);
+            int data_len = create_data_message(CODE_EXAM_DATA, exam_json, exam_len, broadcast_msg + start_len, size - (size_t)start_len);
+            if (data_len > 0)
+                broadcast_len = (size_t)start_len + (size_t)data_len;
+
+            // Same with 150 ZDATA for the sessions that sent COMPRESS
+            zbroadcast_msg = exam_len >= COMPRESS_MIN_BYTES ? malloc(size) : NULL;
+            if (zbroadcast_msg)
+            {
+                memcpy(zbroadcast_msg, broadcast_msg, (size_t)start_len);
+                int z_len = create_zdata_message(CODE_EXAM_DATA, exam_json, exam_len, zbroadcast_msg + start_len, size - (size_t)start_len);
+                if (z_len > 0)
+                    zbroadcast_len = (size_t)start_len + (size_t)z_len;
+            }
+        }
+        free(exam_json);
+    }
 
-    // Prepare broadcast message
-    char broadcast_msg[256];
-    snprintf(broadcast_msg, sizeof(broadcast_msg), "125 START_OK %s|%s\n", room_id, timestamp);
-
-    // Broadcast to all participants
-    printf("[START_EXAM] Broadcasting to room '%s'...\n", room_id);
-    broadcast_to_room(server, room_id, broadcast_msg);
+    printf("[START_EXAM] Broadcasting to room '%s'%s...\n", room_id, broadcast_len ? " (with exam)" : "");
+    if (broadcast_len > 0)
+    {
+        broadcast_to_sessions(server, room_id, broadcast_msg, broadcast_len,
+                              zbroadcast_len ? zbroadcast_msg : NULL, zbroadcast_len, 0);
+    }
+    else
+    {
+        // Prepare broadcast message: 125 START_OK room_id|start|deadline (participants send GET_EXAM)
+        char start_msg[256];
+        snprintf(start_msg, sizeof(start_msg), "125 START_OK %s|%s|%s\n", room_id, timestamp, deadline_str);
+        broadcast_to_room(server, room_id, start_msg);
+    }
+    free(broadcast_msg);
+    free(zbroadcast_msg);
 
     // Update all client sessions in this room to IN_EXAM state
     pthread_mutex_lock(&server->clients_mutex);
@@ -258,10 +468,85 @@ void handle_start_exam(Server *server, ClientSession *client, Message *msg)
 
     // Log activity
     char details[256];
-    snprintf(details, sizeof(details), "Exam started at %s", timestamp);
+    snprintf(details, sizeof(details), "Exam started at %s, deadline %s", timestamp, deadline_str);
     db_log_activity(server->db, "INFO", client->username, "START_EXAM", details);
 
-    printf("[START_EXAM] Room '%s' started by '%s' at %s\n", room_id, client->username, timestamp);
+    printf("[START_EXAM] Room '%s' started by '%s' at %s (deadline %s)\n", room_id, client->username, timestamp, deadline_str);
+}
+
+int grade_answers(const char *answers, const char *correct_answers, int total, int *answered)
+{
+    int score = 0;
+    char *answer_copy = strdup(answers);         // Make a modifiable copy
+    char *answer_tok = strtok(answer_copy, ","); // Tokenize by comma
+    int idx = 0;                                 // Index for questions
+
+    // Compare each answer with correct answers
+    while (answer_tok && idx < total)
+    {
+        // Trim whitespace and compare first char (A, B, C, D)
+        while (*answer_tok == ' ')
+            answer_tok++; // Skip leading spaces
+
+        if (answer_tok[0] == correct_answers[idx])
+        {
+            score++;
+        }
+        answer_tok = strtok(NULL, ",");
+        idx++;
+    }
+
+    free(answer_copy);
+    *answered = idx;
+    return score;
+}
+
+/**
+ * @brief Grade answers and store the result (DB / results journal, leaderboard)
+ * @return 0 on success, CODE_INVALID_PARAMS (answer count) or CODE_INTERNAL_ERROR, with error set
+ */
+static int grade_and_store(Server *server, const char *room_id, const char *username, const char *answers, int time_taken,
+                           int *score_out, int *total_out, char *error, size_t error_size)
+{
+    // Get correct answers and total questions
+    int total = 0;
+    char correct_answers[256]; // Format: "ABCD..."
+
+    if (db_get_correct_answers(server->db, room_id, correct_answers, &total) < 0)
+    {
+        snprintf(error, error_size, "Failed to get correct answers");
+        return CODE_INTERNAL_ERROR;
+    }
+
+    // Parse and count correct answers
+    int idx = 0; // Number of answers graded
+    int score = grade_answers(answers, correct_answers, total, &idx);
+
+    // Check answer count matches
+    if (idx != total)
+    {
+        snprintf(error, error_size, "Answer count mismatch: expected %d, got %d", total, idx);
+        return CODE_INVALID_PARAMS;
+    }
+
+    // Save result to database
+    if (db_submit_exam(server->db, room_id, username, score, total, answers, time_taken) < 0)
+    {
+        snprintf(error, error_size, "Database error");
+        return CODE_INTERNAL_ERROR;
+    }
+
+    leaderboard_add_result(room_id, username, score, total, time_taken, time(NULL));
+    answers_discard(room_id, username);
+
+    // Room started before this run (or its ids could not be read at START_EXAM)
+    if (item_stats_record(room_id, answers, correct_answers, time_taken) == ITEM_STATS_UNKNOWN &&
+        track_item_stats_room(server, room_id) == 0)
+        item_stats_record(room_id, answers, correct_answers, time_taken);
+
+    *score_out = score;
+    *total_out = total;
+    return 0;
 }
 
 /**
@@ -276,15 +561,15 @@ void handle_submit_exam(Server *server, ClientSession *client, Message *msg)
         return;
     }
 
-    // Validate params (room_id|answers)
-    if (msg->param_count < 2)
+    // Validate params (room_id[|answers]; without answers: the SAVE_ANSWER sheet)
+    if (msg->param_count < 1)
     {
-        send_error_or_response(client->socket_fd, CODE_SYNTAX_ERROR, "Usage: SUBMIT_EXAM room_id|answers");
+        send_error_or_response(client->socket_fd, CODE_SYNTAX_ERROR, "Usage: SUBMIT_EXAM room_id[|answers]");
         return;
     }
 
     const char *room_id = msg->params[0];
-    const char *answers = msg->params[1];
+    const char *answers = msg->param_count >= 2 ? msg->params[1] : NULL;
 
     // Check room exists
     int status = db_get_room_status(server->db, room_id);
@@ -340,58 +625,39 @@ void handle_submit_exam(Server *server, ClientSession *client, Message *msg)
         return;
     }
 
-    // Get correct answers and total questions
-    int score = 0;
-    int total = 0;
-    char correct_answers[256]; // Format: "ABCD..."
-
-    if (db_get_correct_answers(server->db, room_id, correct_answers, &total) < 0)
+    // Deadline and time taken come from the server-side timer (not tracked: 0)
+    int time_taken = 0;
+    if (exam_timer_check(room_id, &time_taken) == EXAM_TIMER_EXPIRED)
     {
-        send_error_or_response(client->socket_fd, CODE_INTERNAL_ERROR, "Failed to grade");
-        db_log_activity(server->db, "ERROR", client->username, "SUBMIT_EXAM", "Failed to get correct answers");
+        send_error_or_response(client->socket_fd, CODE_TIME_EXPIRED, room_id);
+        db_log_activity(server->db, "WARNING", client->username, "SUBMIT_EXAM", "Time expired");
         return;
     }
 
-    // Parse and count correct answers
-    char *answer_copy = strdup(answers);         // Make a modifiable copy
-    char *answer_tok = strtok(answer_copy, ","); // Tokenize by comma
-    int idx = 0;                                 // Index for questions
-
-    // Compare each answer with correct answers
-    while (answer_tok && idx < total)
+    // No answers in the command: grade the sheet filled by SAVE_ANSWER
+    char sheet[ANSWERS_MAX_QUESTIONS * 2];
+    if (!answers)
     {
-        // Trim whitespace and compare first char (A, B, C, D)
-        while (*answer_tok == ' ')
-            answer_tok++; // Skip leading spaces
-
-        if (answer_tok[0] == correct_answers[idx])
+        int total = answers_question_count(room_id);
+        char correct_answers[256];
+        if (total <= 0 && db_get_correct_answers(server->db, room_id, correct_answers, &total) < 0)
+            total = -1;
+        if (total <= 0 || answers_sheet_csv(room_id, client->username, total, sheet, sizeof(sheet)) < 0)
         {
-            score++;
+            send_error_or_response(client->socket_fd, CODE_SYNTAX_ERROR, "No saved answers: SUBMIT_EXAM room_id|answers");
+            return;
         }
-        answer_tok = strtok(NULL, ",");
-        idx++;
+        answers = sheet;
     }
 
-    free(answer_copy);
-
-    // Check answer count matches
-    if (idx != total)
-    {
-        char error_msg[128];
-        snprintf(error_msg, sizeof(error_msg), "Answer count mismatch: expected %d, got %d", total, idx);
-        send_error_or_response(client->socket_fd, CODE_INVALID_PARAMS, error_msg);
-        db_log_activity(server->db, "WARNING", client->username, "SUBMIT_EXAM", error_msg);
-        return;
-    }
-
-    // TODO: Calculate time taken (compare with start_time from room)
-    int time_taken = 0;
-
-    // Save result to database
-    if (db_submit_exam(server->db, room_id, client->username, score, total, answers, time_taken) < 0)
+    int score = 0;
+    int total = 0;
+    char error_msg[128];
+    int code = grade_and_store(server, room_id, client->username, answers, time_taken, &score, &total, error_msg, sizeof(error_msg));
+    if (code != 0)
     {
-        send_error_or_response(client->socket_fd, CODE_INTERNAL_ERROR, "Failed to save result");
-        db_log_activity(server->db, "ERROR", client->username, "SUBMIT_EXAM", "Database error");
+        send_error_or_response(client->socket_fd, code, code == CODE_INVALID_PARAMS ? error_msg : "Failed to save result");
+        db_log_activity(server->db, code == CODE_INVALID_PARAMS ? "WARNING" : "ERROR", client->username, "SUBMIT_EXAM", error_msg);
         return;
     }
 
@@ -409,16 +675,189 @@ void handle_submit_exam(Server *server, ClientSession *client, Message *msg)
     snprintf(details, sizeof(details), "Score: %d/%d", score, total);
     db_log_activity(server->db, "INFO", client->username, "SUBMIT_EXAM", details);
 
-    printf("[SUBMIT_EXAM] User '%s' scored %d/%d in room '%s'\n", client->username, score, total, room_id);
+    int rank, ranked;
+    if (leaderboard_rank(room_id, client->username, &rank, &ranked) == 0)
+        printf("[SUBMIT_EXAM] User '%s' scored %d/%d in room '%s' (rank %d/%d)\n", client->username, score, total, room_id, rank, ranked);
+    else
+        printf("[SUBMIT_EXAM] User '%s' scored %d/%d in room '%s'\n", client->username, score, total, room_id);
+
+    // Check if all participants have submitted (in-memory counters; rooms from a previous run ask the DB)
+    int completed = room_counters_submit(room_id);
+    if (completed == ROOM_COUNTERS_UNKNOWN)
+        completed = db_check_all_submitted(server->db, room_id);
+    if (completed)
+        exam_room_completed(server, room_id);
+}
+
+/**
+ * @brief Auto-finish a room whose participants have all submitted
+ */
+void exam_room_completed(Server *server, const char *room_id)
+{
+    if (db_finish_room(server->db, room_id) == 0)
+    {
+        lobby_room_changed(room_id, LOBBY_FINISHED, 0);
+        exam_timer_cancel(room_id);
+        answers_remove_room(room_id);
+        room_counters_remove(room_id);
+        item_stats_remove_room(room_id);
+        printf("[AUTO-FINISH] Room '%s' finished - all participants submitted\n", room_id);
+        db_log_activity(server->db, "INFO", "SYSTEM", "AUTO_FINISH_ROOM", room_id);
+    }
+}
+
+/**
+ * @brief Handle SAVE_ANSWER command - autosave one answer (room_id|qidx|choice)
+ */
+void handle_save_answer(Server *server, ClientSession *client, Message *msg)
+{
+    // Check authentication
+    if (!check_authentication(client))
+    {
+        send_error_or_response(client->socket_fd, CODE_NOT_LOGGED, "Not authenticated");
+        return;
+    }
+
+    // Validate params (room_id|qidx|choice)
+    char *end = NULL;
+    long qidx = msg->param_count >= 3 ? strtol(msg->params[1], &end, 10) : -1;
+    if (msg->param_count < 3 || !end || *end != '\0' || end == msg->params[1] || strlen(msg->params[2]) != 1)
+    {
+        send_error_or_response(client->socket_fd, CODE_SYNTAX_ERROR, "Usage: SAVE_ANSWER room_id|qidx|choice");
+        return;
+    }
+
+    const char *room_id = msg->params[0];
+    char choice = msg->params[2][0];
+
+    if (exam_timer_check(room_id, NULL) == EXAM_TIMER_EXPIRED)
+    {
+        send_error_or_response(client->socket_fd, CODE_TIME_EXPIRED, room_id);
+        return;
+    }
 
-    // Check if all participants have submitted
-    if (db_check_all_submitted(server->db, room_id))
+    // Fast path: the sheet exists, so the checks below already passed (memory + journal only)
+    int answered = 0;
+    int rc = answers_save(room_id, client->username, (int)qidx, choice, 0, &answered);
+    if (rc == ANSWERS_UNKNOWN)
     {
-        // Auto-finish the room
-        if (db_finish_room(server->db, room_id) == 0)
+        // First answer of this user: same checks as SUBMIT_EXAM
+        int status = db_get_room_status(server->db, room_id);
+        if (status < 0)
         {
-            printf("[AUTO-FINISH] Room '%s' finished - all participants submitted\n", room_id);
-            db_log_activity(server->db, "INFO", "SYSTEM", "AUTO_FINISH_ROOM", room_id);
+            send_error_or_response(client->socket_fd, CODE_ROOM_NOT_FOUND, room_id);
+            return;
+        }
+        if (status != 1) // 1 = IN_PROGRESS
+        {
+            send_error_or_response(client->socket_fd, status == 0 ? CODE_ROOM_IN_PROGRESS : CODE_ROOM_FINISHED,
+                                   status == 0 ? "Room not started yet" : room_id);
+            return;
+        }
+        if (!db_is_participant(server->db, room_id, client->username) && !db_is_room_creator(server->db, room_id, client->username))
+        {
+            send_error_or_response(client->socket_fd, CODE_NOT_IN_ROOM, room_id);
+            db_log_activity(server->db, "WARNING", client->username, "SAVE_ANSWER", "Not in room");
+            return;
+        }
+        if (db_check_already_submitted(server->db, room_id, client->username))
+        {
+            send_error_or_response(client->socket_fd, CODE_ALREADY_SUBMITTED, "Already submitted");
+            return;
         }
+
+        int total = answers_question_count(room_id);
+        char correct_answers[256];
+        if (total <= 0 && (db_get_correct_answers(server->db, room_id, correct_answers, &total) < 0 ||
+                           answers_track_room(room_id, total) < 0))
+        {
+            send_error_or_response(client->socket_fd, CODE_INTERNAL_ERROR, "Failed to save answer");
+            db_log_activity(server->db, "ERROR", client->username, "SAVE_ANSWER", "Failed to load exam");
+            return;
+        }
+        rc = answers_save(room_id, client->username, (int)qidx, choice, 1, &answered);
+    }
+
+    if (rc == ANSWERS_BAD_INDEX)
+    {
+        send_error_or_response(client->socket_fd, CODE_INVALID_PARAMS, "qidx out of range or choice not A-D");
+        return;
+    }
+    if (rc != ANSWERS_OK)
+    {
+        send_error_or_response(client->socket_fd, CODE_INTERNAL_ERROR, "Failed to save answer");
+        db_log_activity(server->db, "ERROR", client->username, "SAVE_ANSWER", "Answer sheet error");
+        return;
+    }
+
+    // 133 answered|total
+    char response[64];
+    snprintf(response, sizeof(response), "%d|%d", answered, answers_question_count(room_id));
+    send_error_or_response(client->socket_fd, CODE_ANSWER_SAVED, response);
+}
+
+void exam_time_expired(const char *room_id, void *ctx)
+{
+    Server *server = ctx;
+
+    // Already finished (everyone submitted) or deleted: nothing to do
+    if (db_get_room_status(server->db, room_id) != 1)
+    {
+        answers_remove_room(room_id);
+        room_counters_remove(room_id);
+        item_stats_remove_room(room_id);
+        exam_timer_cancel(room_id);
+        return;
+    }
+
+    // Participants who did not submit are graded from their SAVE_ANSWER sheet
+    int time_taken = 0;
+    exam_timer_check(room_id, &time_taken); // the whole time limit
+    int total = 0, count = 0, graded = 0;
+    char correct_answers[256];
+    AnswerSheetCopy *sheets = NULL;
+    if (db_get_correct_answers(server->db, room_id, correct_answers, &total) == 0)
+        sheets = answers_room_sheets(room_id, total, &count);
+    for (int i = 0; i < count; i++)
+    {
+        if (db_check_already_submitted(server->db, room_id, sheets[i].username))
+            continue;
+        int score, questions;
+        char error[128];
+        if (grade_and_store(server, room_id, sheets[i].username, sheets[i].answers, time_taken, &score, &questions, error, sizeof(error)) == 0)
+            graded++;
+        else
+            db_log_activity(server->db, "ERROR", sheets[i].username, "AUTO_SUBMIT", error);
+    }
+    free(sheets);
+    answers_remove_room(room_id);
+    room_counters_remove(room_id);
+    item_stats_remove_room(room_id);
+    if (graded > 0)
+        printf("[AUTO-SUBMIT] Room '%s': %d saved answer sheet(s) graded at the deadline\n", room_id, graded);
+
+    if (db_finish_room(server->db, room_id) == 0)
+    {
+        lobby_room_changed(room_id, LOBBY_FINISHED, 0);
+        char broadcast_msg[128];
+        snprintf(broadcast_msg, sizeof(broadcast_msg), "%d TIME_EXPIRED %s\n", CODE_TIME_EXPIRED, room_id);
+        broadcast_to_room(server, room_id, broadcast_msg);
+
+        // Participants who did not submit leave the exam
+        pthread_mutex_lock(&server->clients_mutex);
+        for (int i = 0; i < MAX_CLIENTS; i++)
+        {
+            ClientSession *client = &server->clients[i];
+            if (client->active && strcmp(client->current_room, room_id) == 0)
+            {
+                client->state = STATE_AUTHENTICATED;
+                memset(client->current_room, 0, sizeof(client->current_room));
+            }
+        }
+        pthread_mutex_unlock(&server->clients_mutex);
+
+        printf("[AUTO-FINISH] Room '%s' finished - time limit reached\n", room_id);
+        db_log_activity(server->db, "INFO", "SYSTEM", "AUTO_FINISH_ROOM", room_id);
     }
+    exam_timer_cancel(room_id);
 }
@@ -58,12 +58,12 @@ void handle_start_exam(Server *server, ClientSession *client, Message *msg);
  * @brief Xử lý nộp bài thi
  * @param server Pointer tới Server instance
  * @param client Pointer tới ClientSession
- * @param msg Message đã parse (SUBMIT_EXAM room_id|answers)
+ * @param msg Message đã parse (SUBMIT_EXAM room_id|answers, hoặc room_id để nộp sheet SAVE_ANSWER)
  *
  * Flow:
  * 1. Check user in room
  * 2. Check chưa nộp (avoid duplicate)
- * 3. Check time not expired (TODO)
+ * 3. Check time not expired (exam_timer -> 230)
  * 4. Validate answer count
  * 5. Grade exam (compare với correct_answers)
  * 6. Save result to DB
@@ -72,6 +72,35 @@ void handle_start_exam(Server *server, ClientSession *client, Message *msg);
  */
 void handle_submit_exam(Server *server, ClientSession *client, Message *msg);
 
+/**
+ * @brief Xử lý theo dõi bảng xếp hạng trực tiếp (chỉ creator)
+ * @param server Pointer tới Server instance
+ * @param client Pointer tới ClientSession
+ * @param msg Message đã parse (SUBSCRIBE_LEADERBOARD room_id)
+ *
+ * Flow:
+ * 1. Check room exists (223 if not)
+ * 2. Check user là creator (226 if not)
+ * 3. Response: 128 DATA <length>\n<JSON snapshot>
+ * 4. Sau đó server push 128 DATA <length>\n<JSON delta> (tối đa LEADERBOARD_PUSH_HZ lần/giây)
+ */
+void handle_subscribe_leaderboard(Server *server, ClientSession *client, Message *msg);
+
+/**
+ * @brief Hủy theo dõi bảng xếp hạng (UNSUBSCRIBE_LEADERBOARD) - 128 UNSUBSCRIBED
+ */
+void handle_unsubscribe_leaderboard(Server *server, ClientSession *client, Message *msg);
+
+/**
+ * @brief Chấm bài: so sánh từng đáp án (phân tách bởi ',') với correct_answers
+ * @param answers Đáp án của user, ví dụ "A,B, C,D"
+ * @param correct_answers Đáp án đúng, ví dụ "ABCD"
+ * @param total Số câu hỏi
+ * @param answered Output: số đáp án đã chấm (so với total để phát hiện thiếu câu)
+ * @return Số câu đúng
+ */
+int grade_answers(const char *answers, const char *correct_answers, int total, int *answered);
+
 /**
  * @brief Broadcast message tới tất cả participants trong room
  * @param server Server instance
@@ -80,4 +109,36 @@ void handle_submit_exam(Server *server, ClientSession *client, Message *msg);
  */
 void broadcast_to_room(Server *server, const char *room_id, const char *message);
 
+/**
+ * @brief Gửi delta bảng xếp hạng tới các session đã SUBSCRIBE_LEADERBOARD room_id
+ * (LeaderboardPushFn, ctx = Server*)
+ * @return Số session đã gửi, -1 nếu lỗi
+ */
+int broadcast_leaderboard_delta(const char *room_id, const char *json, size_t len, void *ctx);
+
+/**
+ * @brief Hết giờ làm bài (callback của exam_timer, ctx = Server*)
+ *
+ * Kết thúc room nếu vẫn IN_PROGRESS, gửi "230 TIME_EXPIRED room_id" tới các
+ * participant chưa nộp và đưa họ về trạng thái AUTHENTICATED.
+ */
+void exam_time_expired(const char *room_id, void *ctx);
+
+/**
+ * @brief Kết thúc room khi mọi participant đã nộp bài (room_counters báo COMPLETE)
+ * @param server Server instance
+ * @param room_id Room ID
+ */
+void exam_room_completed(Server *server, const char *room_id);
+
+/**
+ * @brief Xử lý lưu từng câu trả lời trong lúc thi (SAVE_ANSWER room_id|qidx|choice)
+ *
+ * qidx: vị trí câu hỏi (từ 0) trong danh sách GET_EXAM, choice: A-D.
+ * Câu trả lời được ghi vào answer sheet trong bộ nhớ (+ journal nếu có);
+ * SUBMIT_EXAM room_id (không kèm answers) và hết giờ sẽ chấm từ sheet này.
+ * Response: 133 answered|total
+ */
+void handle_save_answer(Server *server, ClientSession *client, Message *msg);
+
 #endif // EXAM_H
\ No newline at end of file
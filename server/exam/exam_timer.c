@@ -0,0 +1,308 @@
+#include "exam_timer.h"
+#include "../protocol/protocol.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct ExamTimer
+{
+    char room_id[MAX_ROOM_ID_LEN];
+    struct ExamTimer *next; // hash chain
+    long long start_ns;     // CLOCK_MONOTONIC
+    long long limit_ns;
+    long long fire_ns;      // start + limit + grace
+    int heap_index;         // position in heap, -1 once fired
+} ExamTimer;
+
+// One mutex for everything: arm/cancel happen once per exam, check once per submit
+static pthread_mutex_t timer_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t timer_cond; // CLOCK_MONOTONIC, set up in exam_timer_start
+static pthread_t timer_thread;
+static int timer_running;
+static ExamTimerExpireFn expire_fn;
+static void *expire_ctx;
+
+static ExamTimer *timers[EXAM_TIMER_BUCKETS];
+static ExamTimer **heap; // min-heap on fire_ns
+static int heap_count;
+static int heap_capacity;
+
+static long long monotonic_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static unsigned int hash_string(const char *s)
+{
+    unsigned int h = 2166136261u; // FNV-1a
+    while (*s)
+    {
+        h ^= (unsigned char)*s++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// Caller holds timer_mutex
+static ExamTimer **find_slot(const char *room_id)
+{
+    ExamTimer **slot = &timers[hash_string(room_id) % EXAM_TIMER_BUCKETS];
+    while (*slot && strcmp((*slot)->room_id, room_id) != 0)
+        slot = &(*slot)->next;
+    return slot;
+}
+
+// ===============================================
+// Min-heap (caller holds timer_mutex)
+// ===============================================
+
+static void heap_set(int index, ExamTimer *timer)
+{
+    heap[index] = timer;
+    timer->heap_index = index;
+}
+
+static void heap_sift_up(int index)
+{
+    ExamTimer *timer = heap[index];
+    while (index > 0)
+    {
+        int parent = (index - 1) / 2;
+        if (heap[parent]->fire_ns <= timer->fire_ns)
+            break;
+        heap_set(index, heap[parent]);
+        index = parent;
+    }
+    heap_set(index, timer);
+}
+
+static void heap_sift_down(int index)
+{
+    ExamTimer *timer = heap[index];
+    for (;;)
+    {
+        int child = 2 * index + 1;
+        if (child >= heap_count)
+            break;
+        if (child + 1 < heap_count && heap[child + 1]->fire_ns < heap[child]->fire_ns)
+            child++;
+        if (timer->fire_ns <= heap[child]->fire_ns)
+            break;
+        heap_set(index, heap[child]);
+        index = child;
+    }
+    heap_set(index, timer);
+}
+
+static int heap_push(ExamTimer *timer)
+{
+    if (heap_count == heap_capacity)
+    {
+        int capacity = heap_capacity ? heap_capacity * 2 : 64;
+        ExamTimer **grown = realloc(heap, (size_t)capacity * sizeof(*heap));
+        if (!grown)
+            return -1;
+        heap = grown;
+        heap_capacity = capacity;
+    }
+    heap_set(heap_count++, timer);
+    heap_sift_up(timer->heap_index);
+    return 0;
+}
+
+static void heap_remove(ExamTimer *timer)
+{
+    int index = timer->heap_index;
+    timer->heap_index = -1;
+    ExamTimer *last = heap[--heap_count];
+    if (last == timer)
+        return;
+    heap_set(index, last);
+    if (index > 0 && heap[(index - 1) / 2]->fire_ns > last->fire_ns)
+        heap_sift_up(index);
+    else
+        heap_sift_down(index);
+}
+
+// ===============================================
+// Timer thread
+// ===============================================
+
+static void *timer_loop(void *arg)
+{
+    (void)arg;
+    pthread_mutex_lock(&timer_mutex);
+    while (timer_running)
+    {
+        if (heap_count == 0)
+        {
+            pthread_cond_wait(&timer_cond, &timer_mutex);
+            continue;
+        }
+
+        ExamTimer *next = heap[0];
+        if (next->fire_ns > monotonic_ns())
+        {
+            struct timespec wake = {(time_t)(next->fire_ns / 1000000000LL), (long)(next->fire_ns % 1000000000LL)};
+            pthread_cond_timedwait(&timer_cond, &timer_mutex, &wake);
+            continue; // heap may have changed (arm / cancel / stop)
+        }
+
+        // Expired: stays in the table (check -> EXPIRED) until the callback cancels it
+        heap_remove(next);
+        char room_id[MAX_ROOM_ID_LEN];
+        memcpy(room_id, next->room_id, sizeof(room_id));
+        pthread_mutex_unlock(&timer_mutex);
+
+        expire_fn(room_id, expire_ctx);
+
+        pthread_mutex_lock(&timer_mutex);
+    }
+    pthread_mutex_unlock(&timer_mutex);
+    return NULL;
+}
+
+// ===============================================
+// API
+// ===============================================
+
+int exam_timer_start(ExamTimerExpireFn expire, void *ctx)
+{
+    pthread_mutex_lock(&timer_mutex);
+    if (timer_running)
+    {
+        pthread_mutex_unlock(&timer_mutex);
+        return -1;
+    }
+
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&timer_cond, &attr);
+    pthread_condattr_destroy(&attr);
+
+    expire_fn = expire;
+    expire_ctx = ctx;
+    timer_running = 1;
+    if (pthread_create(&timer_thread, NULL, timer_loop, NULL) != 0)
+    {
+        timer_running = 0;
+        pthread_cond_destroy(&timer_cond);
+        pthread_mutex_unlock(&timer_mutex);
+        return -1;
+    }
+    pthread_mutex_unlock(&timer_mutex);
+    return 0;
+}
+
+void exam_timer_stop(void)
+{
+    pthread_mutex_lock(&timer_mutex);
+    if (!timer_running)
+    {
+        pthread_mutex_unlock(&timer_mutex);
+        return;
+    }
+    timer_running = 0;
+    pthread_cond_signal(&timer_cond);
+    pthread_mutex_unlock(&timer_mutex);
+    pthread_join(timer_thread, NULL);
+
+    pthread_mutex_lock(&timer_mutex);
+    for (int i = 0; i < EXAM_TIMER_BUCKETS; i++)
+    {
+        while (timers[i])
+        {
+            ExamTimer *next = timers[i]->next;
+            free(timers[i]);
+            timers[i] = next;
+        }
+    }
+    free(heap);
+    heap = NULL;
+    heap_count = heap_capacity = 0;
+    pthread_cond_destroy(&timer_cond);
+    pthread_mutex_unlock(&timer_mutex);
+}
+
+int exam_timer_arm(const char *room_id, int limit_seconds, time_t *deadline_out)
+{
+    if (limit_seconds <= 0)
+        return -1;
+
+    pthread_mutex_lock(&timer_mutex);
+    ExamTimer **slot = find_slot(room_id);
+    if (!timer_running || *slot)
+    {
+        pthread_mutex_unlock(&timer_mutex);
+        return -1;
+    }
+
+    ExamTimer *timer = calloc(1, sizeof(ExamTimer));
+    if (!timer)
+    {
+        pthread_mutex_unlock(&timer_mutex);
+        return -1;
+    }
+    snprintf(timer->room_id, sizeof(timer->room_id), "%s", room_id);
+    timer->start_ns = monotonic_ns();
+    timer->limit_ns = (long long)limit_seconds * 1000000000LL;
+    timer->fire_ns = timer->start_ns + timer->limit_ns + EXAM_TIMER_GRACE_SEC * 1000000000LL;
+
+    if (heap_push(timer) < 0)
+    {
+        free(timer);
+        pthread_mutex_unlock(&timer_mutex);
+        return -1;
+    }
+    *slot = timer;
+
+    // New earliest deadline: the thread is sleeping on a later one
+    if (timer->heap_index == 0)
+        pthread_cond_signal(&timer_cond);
+    pthread_mutex_unlock(&timer_mutex);
+
+    if (deadline_out)
+        *deadline_out = time(NULL) + limit_seconds;
+    return 0;
+}
+
+int exam_timer_check(const char *room_id, int *elapsed_out)
+{
+    long long now = monotonic_ns();
+
+    pthread_mutex_lock(&timer_mutex);
+    ExamTimer *timer = *find_slot(room_id);
+    if (!timer)
+    {
+        pthread_mutex_unlock(&timer_mutex);
+        return EXAM_TIMER_UNKNOWN;
+    }
+    long long elapsed = now - timer->start_ns;
+    int expired = now >= timer->fire_ns;
+    if (elapsed > timer->limit_ns)
+        elapsed = timer->limit_ns; // inside the grace period
+    pthread_mutex_unlock(&timer_mutex);
+
+    if (elapsed_out)
+        *elapsed_out = (int)(elapsed / 1000000000LL);
+    return expired ? EXAM_TIMER_EXPIRED : EXAM_TIMER_RUNNING;
+}
+
+void exam_timer_cancel(const char *room_id)
+{
+    pthread_mutex_lock(&timer_mutex);
+    ExamTimer **slot = find_slot(room_id);
+    ExamTimer *timer = *slot;
+    if (timer)
+    {
+        *slot = timer->next;
+        if (timer->heap_index >= 0)
+            heap_remove(timer);
+        free(timer);
+    }
+    pthread_mutex_unlock(&timer_mutex);
+}
@@ -0,0 +1,64 @@
+#ifndef EXAM_TIMER_H
+#define EXAM_TIMER_H
+
+#include <time.h>
+
+// ===============================================
+// EXAM TIMER - server-side deadline of running exams
+// ===============================================
+//
+// START_EXAM arms a timer for the room: start and deadline are taken from
+// CLOCK_MONOTONIC, so time_taken and late submissions do not depend on the
+// wall clock (NTP steps) or on the client. A single thread sleeps until the
+// earliest deadline (min-heap) and calls the expire callback, which finishes
+// the room; nothing polls the database.
+//
+// Rooms started before this process was started are not tracked:
+// exam_timer_check() returns EXAM_TIMER_UNKNOWN and callers accept the
+// submission as before.
+
+#define EXAM_TIMER_BUCKETS 256   // room hash table
+#define EXAM_TIMER_GRACE_SEC 2   // late submissions still accepted (network delay)
+
+#define EXAM_TIMER_UNKNOWN -1 // room not tracked
+#define EXAM_TIMER_RUNNING 0  // before deadline (+ grace)
+#define EXAM_TIMER_EXPIRED 1  // past deadline (+ grace)
+
+/**
+ * @brief Called from the timer thread when a room's deadline (+ grace) has passed
+ * No timer lock is held: the callback may call exam_timer_cancel().
+ */
+typedef void (*ExamTimerExpireFn)(const char *room_id, void *ctx);
+
+/**
+ * @brief Start the timer thread
+ * @return 0 on success, -1 on error (already running)
+ */
+int exam_timer_start(ExamTimerExpireFn expire, void *ctx);
+
+/**
+ * @brief Stop the timer thread and drop every timer (pending rooms are not finished)
+ */
+void exam_timer_stop(void);
+
+/**
+ * @brief Start the clock of a room
+ * @param limit_seconds Time limit
+ * @param deadline_out Optional: wall-clock deadline (for START_OK)
+ * @return 0 on success, -1 if the room already has a timer or on error
+ */
+int exam_timer_arm(const char *room_id, int limit_seconds, time_t *deadline_out);
+
+/**
+ * @brief Time spent in the exam so far
+ * @param elapsed_out Optional: seconds since START_EXAM (at most the time limit)
+ * @return EXAM_TIMER_RUNNING, EXAM_TIMER_EXPIRED or EXAM_TIMER_UNKNOWN
+ */
+int exam_timer_check(const char *room_id, int *elapsed_out);
+
+/**
+ * @brief Forget a room's timer (room finished early, deleted, or START failed)
+ */
+void exam_timer_cancel(const char *room_id);
+
+#endif // EXAM_TIMER_H
@@ -0,0 +1,678 @@
+#include "leaderboard.h"
+#include "../protocol/protocol.h"
+#include "../database/db_json.h"
+#include "../stats/stats.h"
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct LbNode
+{
+    char username[MAX_USERNAME_LEN + 1];
+    int score;
+    int total;
+    int time_taken;
+    time_t submit_time;
+    unsigned long seq;        // arrival order (ties on score and submit_time)
+    struct LbNode *hash_next; // room->users chain
+    int level;
+    struct
+    {
+        struct LbNode *next;
+        unsigned int span; // level-0 nodes skipped by this link
+    } link[];
+} LbNode;
+
+typedef struct
+{
+    LbNode *node;
+    int rank; // rank right after the insert
+} LbDelta;
+
+typedef struct RoomBoard
+{
+    char room_id[MAX_ROOM_ID_LEN];
+    struct RoomBoard *next; // hash chain
+
+    pthread_mutex_t mutex;
+    LbNode *head; // sentinel with LEADERBOARD_MAX_LEVEL links
+    int level;
+    int count;
+    unsigned long next_seq;
+    unsigned int seed; // rand_r state for node levels
+
+    LbNode **users; // username -> node (for rank lookups)
+    int user_buckets;
+
+    char *json; // cached snapshot, NULL after an insert
+    char *zdata; // json as a 127 ZDATA frame for COMPRESS sessions, NULL after an insert
+    int zdata_len; // 0: not built yet, -1: json goes as plain DATA (small or does not shrink)
+
+    LbDelta *deltas; // inserts not pushed to subscribers yet
+    int delta_count;
+    int delta_capacity;
+} RoomBoard;
+
+/**
+ * @brief Growable text buffer for push messages
+ */
+typedef struct
+{
+    char *data;
+    size_t len;
+    size_t capacity;
+    int failed;
+} LbBuffer;
+
+/**
+ * @brief One delta ready to send (built under the board lock, sent without it)
+ */
+typedef struct LbPush
+{
+    struct LbPush *next;
+    char room_id[MAX_ROOM_ID_LEN];
+    LbBuffer json;
+} LbPush;
+
+// Readers of a RoomBoard hold rooms_lock (read) + board->mutex, so
+// leaderboard_remove_room (write) never frees a board in use.
+static pthread_rwlock_t rooms_lock = PTHREAD_RWLOCK_INITIALIZER;
+static RoomBoard *rooms[LEADERBOARD_BUCKETS];
+static StatsCache *snapshot_cache;
+static StatsCache *zdata_cache;
+
+// Push thread (leaderboard_start_push)
+static pthread_mutex_t push_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t push_cond = PTHREAD_COND_INITIALIZER;
+static pthread_t push_thread;
+static int push_running;
+static int push_interval_ms;
+static LeaderboardPushFn push_fn;
+static void *push_ctx;
+
+static unsigned int hash_string(const char *s)
+{
+    unsigned int h = 2166136261u; // FNV-1a
+    while (*s)
+    {
+        h ^= (unsigned char)*s++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// Caller holds rooms_lock
+static RoomBoard *find_board(const char *room_id)
+{
+    RoomBoard *board = rooms[hash_string(room_id) % LEADERBOARD_BUCKETS];
+    while (board && strcmp(board->room_id, room_id) != 0)
+        board = board->next;
+    return board;
+}
+
+static LbNode *node_create(int level)
+{
+    LbNode *node = calloc(1, sizeof(LbNode) + (size_t)level * sizeof(node->link[0]));
+    if (node)
+        node->level = level;
+    return node;
+}
+
+static void board_free(RoomBoard *board)
+{
+    LbNode *node = board->head;
+    while (node)
+    {
+        LbNode *next = node->link[0].next;
+        free(node);
+        node = next;
+    }
+    pthread_mutex_destroy(&board->mutex);
+    free(board->users);
+    free(board->json);
+    free(board->zdata);
+    free(board->deltas);
+    free(board);
+}
+
+// Ranking order: a before b
+static int ranks_before(const LbNode *a, const LbNode *b)
+{
+    if (a->score != b->score)
+        return a->score > b->score;
+    if (a->submit_time != b->submit_time)
+        return a->submit_time < b->submit_time;
+    return a->seq < b->seq;
+}
+
+static int random_level(RoomBoard *board)
+{
+    int level = 1;
+    while (level < LEADERBOARD_MAX_LEVEL && (rand_r(&board->seed) & 3) == 0)
+        level++;
+    return level;
+}
+
+static LbNode *find_user(RoomBoard *board, const char *username)
+{
+    LbNode *node = board->users[hash_string(username) % (unsigned int)board->user_buckets];
+    while (node && strcmp(node->username, username) != 0)
+        node = node->hash_next;
+    return node;
+}
+
+// Keep about one user per bucket
+static int users_reserve(RoomBoard *board)
+{
+    if (board->count < board->user_buckets)
+        return 0;
+    int buckets = board->user_buckets * 2;
+    LbNode **users = calloc((size_t)buckets, sizeof(LbNode *));
+    if (!users)
+        return -1;
+    for (LbNode *node = board->head->link[0].next; node; node = node->link[0].next)
+    {
+        unsigned int b = hash_string(node->username) % (unsigned int)buckets;
+        node->hash_next = users[b];
+        users[b] = node;
+    }
+    free(board->users);
+    board->users = users;
+    board->user_buckets = buckets;
+    return 0;
+}
+
+/**
+ * @brief Skip list insert, keeping the spans (rank = sum of spans on the path)
+ */
+static void board_insert(RoomBoard *board, LbNode *node)
+{
+    LbNode *update[LEADERBOARD_MAX_LEVEL];
+    unsigned int rank[LEADERBOARD_MAX_LEVEL];
+
+    LbNode *x = board->head;
+    for (int i = board->level - 1; i >= 0; i--)
+    {
+        rank[i] = i == board->level - 1 ? 0 : rank[i + 1];
+        while (x->link[i].next && ranks_before(x->link[i].next, node))
+        {
+            rank[i] += x->link[i].span;
+            x = x->link[i].next;
+        }
+        update[i] = x;
+    }
+
+    if (node->level > board->level)
+    {
+        for (int i = board->level; i < node->level; i++)
+        {
+            rank[i] = 0;
+            update[i] = board->head;
+            board->head->link[i].span = (unsigned int)board->count;
+        }
+        board->level = node->level;
+    }
+
+    for (int i = 0; i < node->level; i++)
+    {
+        node->link[i].next = update[i]->link[i].next;
+        update[i]->link[i].next = node;
+        node->link[i].span = update[i]->link[i].span - (rank[0] - rank[i]);
+        update[i]->link[i].span = (rank[0] - rank[i]) + 1;
+    }
+    for (int i = node->level; i < board->level; i++)
+        update[i]->link[i].span++;
+
+    board->count++;
+}
+
+static int board_rank(RoomBoard *board, const LbNode *node)
+{
+    unsigned int rank = 0;
+    LbNode *x = board->head;
+    for (int i = board->level - 1; i >= 0; i--)
+    {
+        while (x->link[i].next && !ranks_before(node, x->link[i].next))
+        {
+            rank += x->link[i].span;
+            x = x->link[i].next;
+        }
+        if (x == node)
+            return (int)rank;
+    }
+    return -1;
+}
+
+static char *board_serialize(RoomBoard *board)
+{
+    char *json = db_json_leaderboard_open();
+    if (!json)
+        return NULL;
+
+    char score[16], total[16], submit_time[20], time_taken[16];
+    char *row[5] = {NULL, score, total, submit_time, time_taken};
+    int rank = 1;
+    for (LbNode *node = board->head->link[0].next; node; node = node->link[0].next)
+    {
+        struct tm tm_info;
+        localtime_r(&node->submit_time, &tm_info);
+        strftime(submit_time, sizeof(submit_time), "%Y-%m-%d %H:%M:%S", &tm_info);
+        snprintf(score, sizeof(score), "%d", node->score);
+        snprintf(total, sizeof(total), "%d", node->total);
+        snprintf(time_taken, sizeof(time_taken), "%d", node->time_taken);
+        row[0] = node->username;
+        if (db_json_leaderboard_add(json, rank++, row) < 0)
+            break; // buffer full (same cut-off as the database path)
+    }
+    db_json_leaderboard_close(json);
+    return json;
+}
+
+static void buffer_append(LbBuffer *buf, const char *format, ...)
+{
+    if (buf->failed)
+        return;
+    while (1)
+    {
+        va_list args;
+        va_start(args, format);
+        int n = vsnprintf(buf->data + buf->len, buf->capacity - buf->len, format, args);
+        va_end(args);
+        if (n < 0)
+        {
+            buf->failed = 1;
+            return;
+        }
+        if ((size_t)n < buf->capacity - buf->len)
+        {
+            buf->len += (size_t)n;
+            return;
+        }
+        size_t capacity = buf->capacity ? buf->capacity * 2 : 1024;
+        while (capacity - buf->len <= (size_t)n)
+            capacity *= 2;
+        char *data = realloc(buf->data, capacity);
+        if (!data)
+        {
+            buf->failed = 1;
+            return;
+        }
+        buf->data = data;
+        buf->capacity = capacity;
+    }
+}
+
+static void buffer_append_entry(LbBuffer *buf, const LbNode *node, int rank, int first)
+{
+    buffer_append(buf, "%s{\"rank\":%d,\"username\":\"%s\",\"score\":%d,\"total\":%d,\"time_taken\":%d",
+                  first ? "" : ",", rank, node->username, node->score, node->total, node->time_taken);
+}
+
+// Caller holds board->mutex
+static void board_record_delta(RoomBoard *board, LbNode *node)
+{
+    if (board->delta_count == board->delta_capacity)
+    {
+        int capacity = board->delta_capacity ? board->delta_capacity * 2 : 16;
+        LbDelta *deltas = realloc(board->deltas, (size_t)capacity * sizeof(LbDelta));
+        if (!deltas)
+            return; // subscribers see a version gap and resubscribe
+        board->deltas = deltas;
+        board->delta_capacity = capacity;
+    }
+    board->deltas[board->delta_count].node = node;
+    board->deltas[board->delta_count].rank = board_rank(board, node);
+    board->delta_count++;
+}
+
+/**
+ * @brief Turn the pending inserts of every room into delta messages
+ */
+static LbPush *collect_deltas(void)
+{
+    LbPush *pushes = NULL;
+    pthread_rwlock_rdlock(&rooms_lock);
+    for (int b = 0; b < LEADERBOARD_BUCKETS; b++)
+    {
+        for (RoomBoard *board = rooms[b]; board; board = board->next)
+        {
+            pthread_mutex_lock(&board->mutex);
+            if (board->delta_count > 0)
+            {
+                LbPush *push = calloc(1, sizeof(LbPush));
+                if (push)
+                {
+                    snprintf(push->room_id, sizeof(push->room_id), "%s", board->room_id);
+                    buffer_append(&push->json, "{\"type\":\"delta\",\"room_id\":\"%s\",\"version\":%lu,\"inserts\":[",
+                                  board->room_id, board->next_seq);
+                    for (int i = 0; i < board->delta_count; i++)
+                    {
+                        LbNode *node = board->deltas[i].node;
+                        buffer_append_entry(&push->json, node, board->deltas[i].rank, i == 0);
+                        buffer_append(&push->json, ",\"version\":%lu}", node->seq + 1);
+                    }
+                    buffer_append(&push->json, "]}");
+                    push->next = pushes;
+                    pushes = push;
+                }
+                board->delta_count = 0;
+            }
+            pthread_mutex_unlock(&board->mutex);
+        }
+    }
+    pthread_rwlock_unlock(&rooms_lock);
+    return pushes;
+}
+
+static void *push_loop(void *arg)
+{
+    (void)arg;
+    pthread_mutex_lock(&push_mutex);
+    while (push_running)
+    {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += (long)push_interval_ms * 1000000L;
+        deadline.tv_sec += deadline.tv_nsec / 1000000000L;
+        deadline.tv_nsec %= 1000000000L;
+        while (push_running && pthread_cond_timedwait(&push_cond, &push_mutex, &deadline) == 0)
+            ;
+        if (!push_running)
+            break;
+        pthread_mutex_unlock(&push_mutex);
+
+        // At most one delta per room per interval; sockets are written without any leaderboard lock
+        LbPush *push = collect_deltas();
+        while (push)
+        {
+            LbPush *next = push->next;
+            if (!push->json.failed)
+                push_fn(push->room_id, push->json.data, push->json.len, push_ctx);
+            free(push->json.data);
+            free(push);
+            push = next;
+        }
+
+        pthread_mutex_lock(&push_mutex);
+    }
+    pthread_mutex_unlock(&push_mutex);
+    return NULL;
+}
+
+// ===============================================
+// Public API
+// ===============================================
+
+void leaderboard_track_room(const char *room_id)
+{
+    RoomBoard *board = calloc(1, sizeof(RoomBoard));
+    if (!board)
+        return;
+    board->head = node_create(LEADERBOARD_MAX_LEVEL);
+    board->user_buckets = 16;
+    board->users = calloc((size_t)board->user_buckets, sizeof(LbNode *));
+    if (!board->head || !board->users)
+    {
+        free(board->head);
+        free(board->users);
+        free(board);
+        return;
+    }
+    snprintf(board->room_id, sizeof(board->room_id), "%s", room_id);
+    pthread_mutex_init(&board->mutex, NULL);
+    board->level = 1;
+    board->seed = hash_string(room_id);
+
+    unsigned int b = hash_string(room_id) % LEADERBOARD_BUCKETS;
+    pthread_rwlock_wrlock(&rooms_lock);
+    if (!snapshot_cache)
+        snapshot_cache = stats_register_cache("leaderboard");
+    if (!zdata_cache)
+        zdata_cache = stats_register_cache("leaderboard_zdata");
+    if (find_board(room_id))
+    {
+        pthread_rwlock_unlock(&rooms_lock);
+        board_free(board);
+        return;
+    }
+    board->next = rooms[b];
+    rooms[b] = board;
+    pthread_rwlock_unlock(&rooms_lock);
+}
+
+void leaderboard_remove_room(const char *room_id)
+{
+    pthread_rwlock_wrlock(&rooms_lock);
+    RoomBoard **link = &rooms[hash_string(room_id) % LEADERBOARD_BUCKETS];
+    while (*link && strcmp((*link)->room_id, room_id) != 0)
+        link = &(*link)->next;
+    RoomBoard *board = *link;
+    if (board)
+        *link = board->next;
+    pthread_rwlock_unlock(&rooms_lock);
+
+    if (board)
+        board_free(board);
+}
+
+int leaderboard_add_result(const char *room_id, const char *username, int score, int total, int time_taken, time_t submit_time)
+{
+    pthread_rwlock_rdlock(&rooms_lock);
+    RoomBoard *board = find_board(room_id);
+    if (!board)
+    {
+        pthread_rwlock_unlock(&rooms_lock);
+        return -1;
+    }
+
+    pthread_mutex_lock(&board->mutex);
+    int rc = -1;
+    // One result per user, like exam_results UNIQUE (room_id, username)
+    if (!find_user(board, username) && users_reserve(board) == 0)
+    {
+        LbNode *node = node_create(random_level(board));
+        if (node)
+        {
+            snprintf(node->username, sizeof(node->username), "%s", username);
+            node->score = score;
+            node->total = total;
+            node->time_taken = time_taken;
+            node->submit_time = submit_time;
+            node->seq = board->next_seq++;
+            board_insert(board, node);
+
+            unsigned int b = hash_string(username) % (unsigned int)board->user_buckets;
+            node->hash_next = board->users[b];
+            board->users[b] = node;
+
+            free(board->json);
+            board->json = NULL;
+            free(board->zdata);
+            board->zdata = NULL;
+            board->zdata_len = 0;
+            if (push_fn)
+                board_record_delta(board, node);
+            rc = 0;
+        }
+    }
+    pthread_mutex_unlock(&board->mutex);
+    pthread_rwlock_unlock(&rooms_lock);
+    return rc;
+}
+
+char *leaderboard_get_json(const char *room_id)
+{
+    pthread_rwlock_rdlock(&rooms_lock);
+    RoomBoard *board = find_board(room_id);
+    if (!board)
+    {
+        pthread_rwlock_unlock(&rooms_lock);
+        return NULL;
+    }
+
+    pthread_mutex_lock(&board->mutex);
+    if (board->json)
+    {
+        stats_cache_hit(snapshot_cache);
+    }
+    else
+    {
+        stats_cache_miss(snapshot_cache);
+        board->json = board_serialize(board);
+    }
+    char *copy = board->json ? strdup(board->json) : NULL;
+    pthread_mutex_unlock(&board->mutex);
+    pthread_rwlock_unlock(&rooms_lock);
+    return copy;
+}
+
+char *leaderboard_get_zdata(const char *room_id, size_t *len_out)
+{
+    pthread_rwlock_rdlock(&rooms_lock);
+    RoomBoard *board = find_board(room_id);
+    if (!board)
+    {
+        pthread_rwlock_unlock(&rooms_lock);
+        return NULL;
+    }
+
+    pthread_mutex_lock(&board->mutex);
+    if (board->zdata_len != 0)
+    {
+        stats_cache_hit(zdata_cache);
+    }
+    else
+    {
+        stats_cache_miss(zdata_cache);
+        if (!board->json)
+            board->json = board_serialize(board);
+        size_t json_len = board->json ? strlen(board->json) : 0;
+        board->zdata_len = -1;
+        if (json_len >= COMPRESS_MIN_BYTES)
+        {
+            size_t size = json_len + 64;
+            board->zdata = malloc(size);
+            int len = board->zdata ? create_zdata_message(CODE_RESULT_DATA, board->json, json_len, board->zdata, size) : -1;
+            if (len > 0)
+            {
+                board->zdata_len = len;
+            }
+            else
+            {
+                free(board->zdata);
+                board->zdata = NULL;
+                if (len < 0) // zlib/malloc error: try again next time
+                    board->zdata_len = 0;
+            }
+        }
+    }
+
+    char *copy = NULL;
+    if (board->zdata)
+    {
+        copy = malloc((size_t)board->zdata_len);
+        if (copy)
+        {
+            memcpy(copy, board->zdata, (size_t)board->zdata_len);
+            *len_out = (size_t)board->zdata_len;
+        }
+    }
+    pthread_mutex_unlock(&board->mutex);
+    pthread_rwlock_unlock(&rooms_lock);
+    return copy;
+}
+
+int leaderboard_rank(const char *room_id, const char *username, int *rank_out, int *count_out)
+{
+    pthread_rwlock_rdlock(&rooms_lock);
+    RoomBoard *board = find_board(room_id);
+    int rank = -1;
+    if (board)
+    {
+        pthread_mutex_lock(&board->mutex);
+        LbNode *node = find_user(board, username);
+        if (node)
+            rank = board_rank(board, node);
+        if (count_out)
+            *count_out = board->count;
+        pthread_mutex_unlock(&board->mutex);
+    }
+    pthread_rwlock_unlock(&rooms_lock);
+
+    if (rank < 0)
+        return -1;
+    *rank_out = rank;
+    return 0;
+}
+
+char *leaderboard_snapshot(const char *room_id, size_t *len_out)
+{
+    pthread_rwlock_rdlock(&rooms_lock);
+    RoomBoard *board = find_board(room_id);
+    if (!board)
+    {
+        pthread_rwlock_unlock(&rooms_lock);
+        return NULL;
+    }
+
+    LbBuffer buf = {0};
+    pthread_mutex_lock(&board->mutex);
+    buffer_append(&buf, "{\"type\":\"snapshot\",\"room_id\":\"%s\",\"version\":%lu,\"leaderboard\":[",
+                  board->room_id, board->next_seq);
+    int rank = 1;
+    for (LbNode *node = board->head->link[0].next; node; node = node->link[0].next, rank++)
+    {
+        buffer_append_entry(&buf, node, rank, rank == 1);
+        buffer_append(&buf, "}");
+    }
+    buffer_append(&buf, "]}");
+    pthread_mutex_unlock(&board->mutex);
+    pthread_rwlock_unlock(&rooms_lock);
+
+    if (buf.failed)
+    {
+        free(buf.data);
+        return NULL;
+    }
+    *len_out = buf.len;
+    return buf.data;
+}
+
+int leaderboard_start_push(int max_per_second, LeaderboardPushFn push, void *ctx)
+{
+    pthread_mutex_lock(&push_mutex);
+    if (push_running)
+    {
+        pthread_mutex_unlock(&push_mutex);
+        return -1;
+    }
+    push_interval_ms = 1000 / (max_per_second > 0 ? max_per_second : 1);
+    push_fn = push;
+    push_ctx = ctx;
+    push_running = 1;
+    if (pthread_create(&push_thread, NULL, push_loop, NULL) != 0)
+    {
+        push_running = 0;
+        push_fn = NULL;
+        pthread_mutex_unlock(&push_mutex);
+        return -1;
+    }
+    pthread_mutex_unlock(&push_mutex);
+    return 0;
+}
+
+void leaderboard_stop_push(void)
+{
+    pthread_mutex_lock(&push_mutex);
+    if (!push_running)
+    {
+        pthread_mutex_unlock(&push_mutex);
+        return;
+    }
+    push_running = 0;
+    pthread_cond_signal(&push_cond);
+    pthread_mutex_unlock(&push_mutex);
+    pthread_join(push_thread, NULL);
+}
@@ -0,0 +1,93 @@
+#ifndef LEADERBOARD_H
+#define LEADERBOARD_H
+
+#include <stddef.h>
+#include <time.h>
+
+// ===============================================
+// LEADERBOARD - per-room ranking kept in memory
+// ===============================================
+//
+// Each room created by this process gets an order-statistic skip list keyed
+// by (score DESC, submit_time ASC, arrival ASC), the order of
+// db_get_room_leaderboard. handle_submit_exam inserts every accepted result,
+// so VIEW_RESULT and rank lookups need no database query. The serialized JSON
+// is cached until the next insert. (Concurrent submits with the same score
+// in the same second may tie-break in a different order than the DB row id.)
+//
+// Rooms created before the server started are not tracked: callers fall back
+// to the database (leaderboard_get_json() returns NULL).
+
+#define LEADERBOARD_BUCKETS 1024 // room hash table
+#define LEADERBOARD_MAX_LEVEL 16 // skip list height (p = 1/4 -> ~4^16 entries)
+#define LEADERBOARD_PUSH_HZ 4    // live pushes per room per second (at most)
+
+// Live stream (SUBSCRIBE_LEADERBOARD): a subscriber first gets a snapshot,
+// then deltas. Both carry "version" = number of results in the room.
+//   {"type":"snapshot","room_id":"..","version":N,"leaderboard":[{"rank":..,"username":..,"score":..,"total":..,"time_taken":..},...]}
+//   {"type":"delta","room_id":"..","version":N,"inserts":[{<entry>,"version":v},...]}
+// Inserts are listed oldest first with the rank they got when inserted;
+// applying them in order (each shifts the ranks below it) reproduces the
+// board. Inserts with version <= the snapshot version are already in it.
+// A gap in versions means a delta was lost: subscribe again.
+
+/**
+ * @brief Deliver a delta to the subscribers of a room (called from the push thread)
+ */
+typedef int (*LeaderboardPushFn)(const char *room_id, const char *json, size_t len, void *ctx);
+
+/**
+ * @brief Start tracking a newly created room (no results yet)
+ */
+void leaderboard_track_room(const char *room_id);
+
+/**
+ * @brief Forget a room (deleted)
+ */
+void leaderboard_remove_room(const char *room_id);
+
+/**
+ * @brief Insert an accepted result
+ * @return 0 on success, -1 if the room is not tracked
+ */
+int leaderboard_add_result(const char *room_id, const char *username, int score, int total, int time_taken, time_t submit_time);
+
+/**
+ * @brief Leaderboard JSON (same format as db_get_room_leaderboard)
+ * @return malloc'd copy of the cached snapshot, NULL if the room is not tracked
+ */
+char *leaderboard_get_json(const char *room_id);
+
+/**
+ * @brief Leaderboard as a "127 ZDATA" frame, compressed once per version
+ * @return malloc'd copy of the cached frame, NULL if the room is not tracked
+ * or the JSON goes as plain DATA (under COMPRESS_MIN_BYTES or does not shrink)
+ */
+char *leaderboard_get_zdata(const char *room_id, size_t *len_out);
+
+/**
+ * @brief 1-based rank of a user, O(log n)
+ * @param count_out Optional: number of results in the room
+ * @return 0 on success, -1 if the room is not tracked or the user has no result
+ */
+int leaderboard_rank(const char *room_id, const char *username, int *rank_out, int *count_out);
+
+/**
+ * @brief Snapshot message of the live stream
+ * @return malloc'd JSON, NULL if the room is not tracked
+ */
+char *leaderboard_snapshot(const char *room_id, size_t *len_out);
+
+/**
+ * @brief Start the push thread: every 1/max_per_second s, rooms with new
+ * results get one coalesced delta through push()
+ * @return 0 on success, -1 on error (already running)
+ */
+int leaderboard_start_push(int max_per_second, LeaderboardPushFn push, void *ctx);
+
+/**
+ * @brief Stop the push thread
+ */
+void leaderboard_stop_push(void);
+
+#endif // LEADERBOARD_H
@@ -0,0 +1,242 @@
+#include "log_format.h"
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @brief One printf conversion inside a format string
+ */
+typedef struct
+{
+    const char *start; // points at '%'
+    size_t prefix_len; // '%' + flags + width + precision (without length modifier)
+    int stars;         // number of '*' (0..2)
+    char conversion;   // d, s, f, ...
+    uint8_t type;      // LogArgType
+    const char *end;   // first char after the conversion
+} LogSpec;
+
+/**
+ * @brief Find the next conversion starting at p
+ * @return 1 if found, 0 if none left, -1 if unsupported
+ * "%%" is skipped (the caller copies it as a literal).
+ */
+static int next_spec(const char *p, LogSpec *spec)
+{
+    while ((p = strchr(p, '%')) != NULL)
+    {
+        if (p[1] == '%')
+        {
+            p += 2;
+            continue;
+        }
+
+        memset(spec, 0, sizeof(LogSpec));
+        spec->start = p++;
+
+        while (*p && strchr("-+ #0'", *p))
+            p++;
+        if (*p == '*')
+        {
+            spec->stars++;
+            p++;
+        }
+        while (*p >= '0' && *p <= '9')
+            p++;
+        if (*p == '.')
+        {
+            p++;
+            if (*p == '*')
+            {
+                spec->stars++;
+                p++;
+            }
+            while (*p >= '0' && *p <= '9')
+                p++;
+        }
+        spec->prefix_len = p - spec->start;
+
+        int is_long = 0;
+        while (*p && strchr("hlLqjzt", *p))
+        {
+            if (*p != 'h')
+                is_long = 1;
+            p++;
+        }
+
+        spec->conversion = *p;
+        switch (*p)
+        {
+        case 'd':
+        case 'i':
+        case 'u':
+        case 'x':
+        case 'X':
+        case 'o':
+        case 'c':
+            spec->type = is_long ? LOG_ARG_LONG : LOG_ARG_INT;
+            break;
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+            spec->type = LOG_ARG_DOUBLE;
+            break;
+        case 's':
+            spec->type = LOG_ARG_STRING;
+            break;
+        case 'p':
+            spec->type = LOG_ARG_PTR;
+            break;
+        default:
+            return -1; // %n, wide chars, ... are not supported
+        }
+        spec->end = p + 1;
+        return 1;
+    }
+    return 0;
+}
+
+int log_format_parse(const char *format, uint8_t *types)
+{
+    int count = 0;
+    const char *p = format;
+    LogSpec spec;
+    int found;
+
+    while ((found = next_spec(p, &spec)) == 1)
+    {
+        if (count + spec.stars + 1 > LOG_MAX_ARGS)
+            return -1;
+        for (int i = 0; i < spec.stars; i++)
+            types[count++] = LOG_ARG_INT;
+        types[count++] = spec.type;
+        p = spec.end;
+    }
+    return found < 0 ? -1 : count;
+}
+
+/**
+ * @brief Copy literal text, turning "%%" into '%'
+ */
+static size_t copy_literal(const char *from, const char *to, char *out, size_t out_size, size_t len)
+{
+    while (from < to && len + 1 < out_size)
+    {
+        if (from[0] == '%' && from + 1 < to && from[1] == '%')
+            from++;
+        out[len++] = *from++;
+    }
+    return len;
+}
+
+// Read one encoded value; returns 0 if the args buffer is truncated
+static int read_arg(const char **cursor, const char *end, void *value, size_t size)
+{
+    if ((size_t)(end - *cursor) < size)
+        return 0;
+    memcpy(value, *cursor, size);
+    *cursor += size;
+    return 1;
+}
+
+#define RENDER_ARG(value)                                                         \
+    (spec.stars == 0   ? snprintf(out + len, out_size - len, fmt, value)          \
+     : spec.stars == 1 ? snprintf(out + len, out_size - len, fmt, star[0], value) \
+                       : snprintf(out + len, out_size - len, fmt, star[0], star[1], value))
+
+int log_format_render(const char *format, const char *args, size_t args_len, char *out, size_t out_size)
+{
+    const char *cursor = args;
+    const char *end = args + args_len;
+    const char *p = format;
+    size_t len = 0;
+    LogSpec spec;
+
+    if (out_size == 0)
+        return 0;
+
+    while (next_spec(p, &spec) == 1 && len + 1 < out_size)
+    {
+        len = copy_literal(p, spec.start, out, out_size, len);
+        p = spec.end;
+
+        int32_t star[2] = {0, 0};
+        for (int i = 0; i < spec.stars; i++)
+            if (!read_arg(&cursor, end, &star[i], sizeof(int32_t)))
+                goto done;
+
+        // Rebuild the conversion with a fixed length modifier for the stored type
+        char fmt[32];
+        size_t prefix = spec.prefix_len < sizeof(fmt) - 4 ? spec.prefix_len : sizeof(fmt) - 4;
+        memcpy(fmt, spec.start, prefix);
+        if (spec.type == LOG_ARG_LONG)
+        {
+            fmt[prefix++] = 'l';
+            fmt[prefix++] = 'l';
+        }
+        fmt[prefix++] = spec.conversion;
+        fmt[prefix] = '\0';
+
+        int written = 0;
+        switch (spec.type)
+        {
+        case LOG_ARG_INT:
+        {
+            int32_t v;
+            if (!read_arg(&cursor, end, &v, sizeof(v)))
+                goto done;
+            written = RENDER_ARG(v);
+            break;
+        }
+        case LOG_ARG_LONG:
+        {
+            int64_t v;
+            if (!read_arg(&cursor, end, &v, sizeof(v)))
+                goto done;
+            written = RENDER_ARG((long long)v);
+            break;
+        }
+        case LOG_ARG_DOUBLE:
+        {
+            double v;
+            if (!read_arg(&cursor, end, &v, sizeof(v)))
+                goto done;
+            written = RENDER_ARG(v);
+            break;
+        }
+        case LOG_ARG_PTR:
+        {
+            uint64_t v;
+            if (!read_arg(&cursor, end, &v, sizeof(v)))
+                goto done;
+            written = RENDER_ARG((void *)(uintptr_t)v);
+            break;
+        }
+        case LOG_ARG_STRING:
+        {
+            uint16_t slen;
+            char str[1024];
+            if (!read_arg(&cursor, end, &slen, sizeof(slen)) || (size_t)(end - cursor) < slen)
+                goto done;
+            size_t copy = slen < sizeof(str) - 1 ? slen : sizeof(str) - 1;
+            memcpy(str, cursor, copy);
+            str[copy] = '\0';
+            cursor += slen;
+            written = RENDER_ARG(str);
+            break;
+        }
+        }
+
+        if (written > 0)
+            len += (size_t)written < out_size - len ? (size_t)written : out_size - len - 1;
+    }
+    len = copy_literal(p, p + strlen(p), out, out_size, len);
+
+done:
+    out[len] = '\0';
+    return (int)len;
+}
@@ -0,0 +1,72 @@
+#ifndef LOG_FORMAT_H
+#define LOG_FORMAT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ===============================================
+// BINARY LOG FORMAT - shared by logger and log_decoder
+// ===============================================
+//
+// File layout (host byte order):
+//   header : "EXLOGBIN" (8 bytes) + u32 version
+//   entries: u8 tag followed by the tag's payload
+//
+//   'F' format definition : u16 id, u16 len, <len bytes format string>
+//   'R' record            : u16 format_id, u8 level, i64 timestamp_ns,
+//                           u8 user_len, <user>, u8 action_len, <action>,
+//                           u16 args_len, <encoded args>
+//   'T' text record       : u8 level, i64 timestamp_ns,
+//                           u8 user_len, <user>, u8 action_len, <action>,
+//                           u16 msg_len, <msg>
+//
+// A format is always defined in a file before the first record that uses it.
+// Encoded args follow the conversion order of the format string:
+//   LOG_ARG_INT    -> i32
+//   LOG_ARG_LONG   -> i64
+//   LOG_ARG_DOUBLE -> f64
+//   LOG_ARG_PTR    -> u64
+//   LOG_ARG_STRING -> u16 len + <len bytes>
+
+#define LOG_BINARY_MAGIC "EXLOGBIN"
+#define LOG_BINARY_MAGIC_LEN 8
+#define LOG_BINARY_VERSION 1
+
+#define LOG_TAG_FORMAT 'F'
+#define LOG_TAG_RECORD 'R'
+#define LOG_TAG_TEXT 'T'
+
+#define LOG_MAX_FORMATS 1024 // distinct format strings per process
+#define LOG_MAX_ARGS 16      // conversions per format string
+
+typedef enum
+{
+    LOG_ARG_INT,
+    LOG_ARG_LONG,
+    LOG_ARG_DOUBLE,
+    LOG_ARG_PTR,
+    LOG_ARG_STRING
+} LogArgType;
+
+/**
+ * @brief Parse printf conversions of a format string into argument types
+ * @param format Printf-style format string
+ * @param types Output array (at least LOG_MAX_ARGS entries)
+ * @return Number of arguments, -1 if the format is unsupported
+ *
+ * '*' width/precision count as LOG_ARG_INT arguments.
+ */
+int log_format_parse(const char *format, uint8_t *types);
+
+/**
+ * @brief Render a format string with encoded args back to text
+ * @param format Printf-style format string
+ * @param args Encoded args (see layout above)
+ * @param args_len Length of encoded args
+ * @param out Output buffer
+ * @param out_size Output buffer size
+ * @return Number of chars written (excluding '\0')
+ */
+int log_format_render(const char *format, const char *args, size_t args_len, char *out, size_t out_size);
+
+#endif // LOG_FORMAT_H
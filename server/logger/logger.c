@@ -1,48 +1,123 @@
+#define _GNU_SOURCE // fallocate
 #include "logger.h"
+#include "log_format.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdarg.h>
+#include <stdint.h>
+#include <stdatomic.h>
 #include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <zlib.h>
 
-static FILE *log_file = NULL;
-static pthread_mutex_t log_mutex = PTHREAD_MUTEX_INITIALIZER;
+#define LOG_RING_MASK (LOG_RING_SIZE - 1)
+#define LOG_RECORD_PAD 0x01
+#define LOG_RECORD_BINARY 0x02 // payload message = encoded args of format_id
+#define LOG_FORMAT_SLOTS (LOG_MAX_FORMATS * 2)
+#define LOG_ALIGN(n) (((n) + 7) & ~(size_t)7)
 
 /**
- * @brief Initialize logger
- * @param filename Log file path (NULL for stdout only)
- * @return 0 on success, -1 on error
+ * @brief Record header stored in the ring, followed by user, action and message bytes
  */
-int logger_init(const char *filename)
+typedef struct
 {
-    pthread_mutex_lock(&log_mutex);
+    uint32_t size; // total record size (header + payload), 8-byte aligned
+    uint8_t level;
+    uint8_t user_len;
+    uint8_t action_len;
+    uint8_t flags;
+    uint16_t format_id;
+    uint16_t msg_len;
+    int64_t timestamp; // nanoseconds since epoch
+} LogRecordHeader;
 
-    if (filename)
-    {
-        log_file = fopen(filename, "a");
-        if (!log_file)
-        {
-            pthread_mutex_unlock(&log_mutex);
-            return -1;
-        }
-    }
-    pthread_mutex_unlock(&log_mutex);
-    return 0;
-}
+/**
+ * @brief Single-producer single-consumer ring buffer, one per logging thread
+ * producer = owning thread, consumer = writer thread
+ */
+typedef struct LogRing
+{
+    _Atomic size_t head; // chỉ thread sở hữu ghi
+    _Atomic size_t tail; // chỉ writer thread ghi
+    _Atomic int orphaned;
+    _Atomic uint64_t dropped;
+    struct LogRing *_Atomic next;
+    char data[LOG_RING_SIZE];
+} LogRing;
+
+static struct LogRing *_Atomic ring_list = NULL;
+static __thread LogRing *thread_ring = NULL;
+static pthread_key_t ring_key;
+static pthread_once_t ring_key_once = PTHREAD_ONCE_INIT;
 
 /**
- * @brief Close Logger
+ * @brief Interned format string (binary mode)
  */
-void logger_close()
+typedef struct
 {
-    pthread_mutex_lock(&log_mutex);
-    if (log_file)
-    {
-        fclose(log_file);
-        log_file = NULL;
-    }
-    pthread_mutex_unlock(&log_mutex);
-}
+    const char *format;
+    int nargs;
+    uint8_t types[LOG_MAX_ARGS];
+} LogFormatInfo;
+
+/**
+ * @brief Lock-free pointer -> id hash slot
+ * id: 0 = being registered, -1 = unsupported (log as text), >0 = format id
+ */
+typedef struct
+{
+    const char *_Atomic key;
+    _Atomic int id;
+} LogFormatSlot;
+
+static LogFormatSlot format_slots[LOG_FORMAT_SLOTS];
+static LogFormatInfo formats[LOG_MAX_FORMATS + 1]; // indexed by id, 1-based
+static _Atomic int next_format_id = 1;
+
+// Published by the writer thread for logger_get_stats()
+static _Atomic int stat_rings = 0;
+static _Atomic size_t stat_backlog_bytes = 0;
+static _Atomic uint64_t stat_dropped_total = 0;
+static _Atomic int stat_compress_pending = 0;
+
+static int log_fd = -1;
+static char log_path[512];
+static LogFileFormat log_format = LOG_FORMAT_TEXT;
+static size_t rotate_max_bytes = LOG_ROTATE_MAX_BYTES;
+static int rotate_interval = LOG_ROTATE_INTERVAL_SECONDS;
+static pthread_t writer_thread;
+static _Atomic int writer_running = 0;
+
+// Writer-side state (only touched by the writer thread)
+static char batch[LOG_BATCH_SIZE];
+static size_t batch_len = 0;
+static char console_batch[LOG_BATCH_SIZE];
+static size_t console_len = 0;
+static time_t cached_sec = -1;
+static char cached_time[32];
+static uint8_t format_emitted[LOG_MAX_FORMATS + 1]; // formats already defined in the current file
+static size_t segment_bytes = 0;                     // size of the current file
+static time_t segment_start = 0;
+
+/**
+ * @brief Rotated segment waiting for compression
+ */
+typedef struct CompressJob
+{
+    char path[600];
+    struct CompressJob *next;
+} CompressJob;
+
+// Compressor thread state (queue is the only shared part, writer -> compressor)
+static pthread_t compress_thread;
+static pthread_mutex_t compress_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t compress_cond = PTHREAD_COND_INITIALIZER;
+static CompressJob *compress_head = NULL;
+static CompressJob *compress_tail = NULL;
+static int compress_running = 0;
 
 /**
  * @brief Convert log level to string
@@ -64,6 +139,171 @@ const char *log_level_string(LogLevel level)
     }
 }
 
+// ============================== Producer side ================================
+
+/**
+ * @brief Thread exit hook: hand the ring over to the writer, which frees it once drained
+ */
+static void ring_release(void *arg)
+{
+    LogRing *ring = (LogRing *)arg;
+    atomic_store_explicit(&ring->orphaned, 1, memory_order_release);
+}
+
+static void ring_key_create(void)
+{
+    pthread_key_create(&ring_key, ring_release);
+}
+
+/**
+ * @brief Get (or lazily create) the calling thread's ring
+ * Registration is a lock-free push onto ring_list.
+ */
+static LogRing *ring_get(void)
+{
+    if (thread_ring)
+        return thread_ring;
+
+    LogRing *ring = calloc(1, sizeof(LogRing));
+    if (!ring)
+        return NULL;
+
+    pthread_once(&ring_key_once, ring_key_create);
+    pthread_setspecific(ring_key, ring);
+
+    LogRing *old_head = atomic_load_explicit(&ring_list, memory_order_relaxed);
+    do
+    {
+        atomic_store_explicit(&ring->next, old_head, memory_order_relaxed);
+    } while (!atomic_compare_exchange_weak_explicit(&ring_list, &old_head, ring,
+                                                    memory_order_release, memory_order_relaxed));
+
+    thread_ring = ring;
+    return ring;
+}
+
+/**
+ * @brief Map a format string pointer to its id, registering it on first use
+ * Call sites pass string literals, so the pointer identifies the format.
+ */
+static int format_lookup(const char *format)
+{
+    size_t idx = (((uintptr_t)format >> 3) * 0x9E3779B97F4A7C15ULL) % LOG_FORMAT_SLOTS;
+
+    for (size_t probe = 0; probe < LOG_FORMAT_SLOTS; probe++)
+    {
+        LogFormatSlot *slot = &format_slots[(idx + probe) % LOG_FORMAT_SLOTS];
+        const char *key = atomic_load_explicit(&slot->key, memory_order_acquire);
+
+        if (key == NULL)
+        {
+            if (!atomic_compare_exchange_strong_explicit(&slot->key, &key, format,
+                                                         memory_order_acq_rel, memory_order_acquire))
+            {
+                if (key != format)
+                    continue; // another format took the slot
+            }
+            else
+            {
+                // We own the slot: assign an id and parse the conversions
+                int id = atomic_fetch_add(&next_format_id, 1);
+                if (id > LOG_MAX_FORMATS)
+                {
+                    atomic_store_explicit(&slot->id, -1, memory_order_release);
+                    return -1;
+                }
+                formats[id].format = format;
+                formats[id].nargs = log_format_parse(format, formats[id].types);
+                atomic_store_explicit(&slot->id, formats[id].nargs < 0 ? -1 : id, memory_order_release);
+                return formats[id].nargs < 0 ? -1 : id;
+            }
+        }
+        else if (key != format)
+        {
+            continue;
+        }
+
+        int id;
+        while ((id = atomic_load_explicit(&slot->id, memory_order_acquire)) == 0)
+            ; // registration in progress on another thread
+        return id;
+    }
+    return -1;
+}
+
+/**
+ * @brief Encode raw args according to the interned format
+ * Strings are copied (length-prefixed) and truncated to fit the record.
+ */
+static size_t encode_args(const LogFormatInfo *info, char *out, va_list args)
+{
+    size_t len = 0;
+    for (int i = 0; i < info->nargs; i++)
+    {
+        switch (info->types[i])
+        {
+        case LOG_ARG_INT:
+        {
+            int32_t v = va_arg(args, int);
+            if (len + sizeof(v) > LOG_MAX_MESSAGE)
+                return len;
+            memcpy(out + len, &v, sizeof(v));
+            len += sizeof(v);
+            break;
+        }
+        case LOG_ARG_LONG:
+        {
+            int64_t v = va_arg(args, long long);
+            if (len + sizeof(v) > LOG_MAX_MESSAGE)
+                return len;
+            memcpy(out + len, &v, sizeof(v));
+            len += sizeof(v);
+            break;
+        }
+        case LOG_ARG_DOUBLE:
+        {
+            double v = va_arg(args, double);
+            if (len + sizeof(v) > LOG_MAX_MESSAGE)
+                return len;
+            memcpy(out + len, &v, sizeof(v));
+            len += sizeof(v);
+            break;
+        }
+        case LOG_ARG_PTR:
+        {
+            uint64_t v = (uintptr_t)va_arg(args, void *);
+            if (len + sizeof(v) > LOG_MAX_MESSAGE)
+                return len;
+            memcpy(out + len, &v, sizeof(v));
+            len += sizeof(v);
+            break;
+        }
+        case LOG_ARG_STRING:
+        {
+            const char *str = va_arg(args, const char *);
+            if (!str)
+                str = "(null)";
+            if (len + sizeof(uint16_t) > LOG_MAX_MESSAGE)
+                return len;
+            size_t room = LOG_MAX_MESSAGE - len - sizeof(uint16_t);
+            uint16_t slen = (uint16_t)strnlen(str, room);
+            memcpy(out + len, &slen, sizeof(slen));
+            memcpy(out + len + sizeof(slen), str, slen);
+            len += sizeof(slen) + slen;
+            break;
+        }
+        }
+    }
+    return len;
+}
+
+static int64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME_COARSE, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
 /**
  * @brief Log event
  */
@@ -71,42 +311,631 @@ const char *log_level_string(LogLevel level)
 //  [2024-06-01 12:00:00] [INFO] [john_doe] LOGIN: User username logged in successfully
 void log_event(LogLevel level, const char *username, const char *action, const char *format, ...)
 {
-    pthread_mutex_lock(&log_mutex);
+    if (!atomic_load_explicit(&writer_running, memory_order_acquire))
+        return;
 
-    // Get timestamp
-    time_t now = time(NULL);
-    char time_str[32];
-    strftime(time_str, sizeof(time_str), "%Y-%m-%d %H:%M:%S", localtime(&now));
+    LogRing *ring = ring_get();
+    if (!ring)
+        return;
+
+    size_t user_len = username ? strnlen(username, 255) : 0;
+    size_t action_len = action ? strnlen(action, LOG_MAX_ACTION) : 0;
+    size_t max_size = LOG_ALIGN(sizeof(LogRecordHeader) + user_len + action_len + LOG_MAX_MESSAGE + 1);
+
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+
+    // Records never wrap: pad to the end of the buffer if the tail space is too small
+    size_t pos = head & LOG_RING_MASK;
+    size_t pad = (LOG_RING_SIZE - pos < max_size) ? LOG_RING_SIZE - pos : 0;
+    if (LOG_RING_SIZE - (head - tail) < pad + max_size)
+    {
+        atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    if (pad >= sizeof(LogRecordHeader))
+    {
+        LogRecordHeader *pad_hdr = (LogRecordHeader *)(ring->data + pos);
+        pad_hdr->size = (uint32_t)pad;
+        pad_hdr->flags = LOG_RECORD_PAD;
+    }
+    pos = (head + pad) & LOG_RING_MASK;
+
+    LogRecordHeader *hdr = (LogRecordHeader *)(ring->data + pos);
+    char *payload = (char *)(hdr + 1);
+    memcpy(payload, username, user_len);
+    memcpy(payload + user_len, action, action_len);
+
+    int format_id = log_format == LOG_FORMAT_BINARY ? format_lookup(format) : -1;
+    int msg_len;
 
-    // Format message
-    char message[1024];
     va_list args;           // dùng để duyệt qua các tham số biến thiên
     va_start(args, format); // bắt đầu lấy tham số sau format
-    vsnprintf(message, sizeof(message), format, args);
+    if (format_id > 0)
+    {
+        // Binary mode: record the format id and raw args, no formatting here
+        msg_len = (int)encode_args(&formats[format_id], payload + user_len + action_len, args);
+        hdr->flags = LOG_RECORD_BINARY;
+        hdr->format_id = (uint16_t)format_id;
+    }
+    else
+    {
+        // Format message directly into the ring (no intermediate buffer)
+        msg_len = vsnprintf(payload + user_len + action_len, LOG_MAX_MESSAGE + 1, format, args);
+        if (msg_len < 0)
+            msg_len = 0;
+        if (msg_len > LOG_MAX_MESSAGE)
+            msg_len = LOG_MAX_MESSAGE;
+        hdr->flags = 0;
+        hdr->format_id = 0;
+    }
     va_end(args); // kết thúc lấy tham số biến thiên
 
-    // Format log entry
-    char log_entry[2048];
-    snprintf(log_entry, sizeof(log_entry), "[%s] [%s] [%s] %s: %s\n",
-             time_str,
-             log_level_string(level),
-             username ? username : "SYSTEM",
-             action,
-             message);
+    hdr->level = (uint8_t)level;
+    hdr->user_len = (uint8_t)user_len;
+    hdr->action_len = (uint8_t)action_len;
+    hdr->msg_len = (uint16_t)msg_len;
+    hdr->timestamp = now_ns();
+    hdr->size = (uint32_t)LOG_ALIGN(sizeof(LogRecordHeader) + user_len + action_len + msg_len);
+
+    atomic_store_explicit(&ring->head, head + pad + hdr->size, memory_order_release);
+}
+
+// =============================== Writer side =================================
+
+static void write_all(int fd, const char *buf, size_t len)
+{
+    while (len > 0)
+    {
+        ssize_t n = write(fd, buf, len);
+        if (n <= 0)
+            return;
+        buf += n;
+        len -= n;
+    }
+}
+
+static void flush_batches(void)
+{
+    if (batch_len > 0 && log_fd >= 0)
+    {
+        write_all(log_fd, batch, batch_len);
+        segment_bytes += batch_len;
+    }
+    batch_len = 0;
+
+    if (console_len > 0)
+        write_all(STDOUT_FILENO, console_batch, console_len);
+    console_len = 0;
+}
+
+// ============================ Segment rotation ===============================
+
+/**
+ * @brief Compress a closed segment to <path>.gz and remove the original
+ */
+static void compress_segment(const char *path)
+{
+    char tmp_path[640], gz_path[640];
+    snprintf(gz_path, sizeof(gz_path), "%s.gz", path);
+    snprintf(tmp_path, sizeof(tmp_path), "%s.gz.tmp", path);
+
+    int in = open(path, O_RDONLY);
+    if (in < 0)
+        return;
+    gzFile out = gzopen(tmp_path, "wb6");
+    if (!out)
+    {
+        close(in);
+        return;
+    }
+
+    char buf[64 * 1024];
+    ssize_t n;
+    int ok = 1;
+    while ((n = read(in, buf, sizeof(buf))) > 0)
+    {
+        if (gzwrite(out, buf, (unsigned)n) != (int)n)
+        {
+            ok = 0;
+            break;
+        }
+    }
+    close(in);
+
+    if (gzclose(out) != Z_OK || n < 0 || !ok)
+    {
+        unlink(tmp_path);
+        return;
+    }
+    if (rename(tmp_path, gz_path) == 0)
+        unlink(path);
+}
+
+static void *compressor_main(void *arg)
+{
+    (void)arg;
+    pthread_mutex_lock(&compress_mutex);
+    while (compress_running || compress_head)
+    {
+        if (!compress_head)
+        {
+            pthread_cond_wait(&compress_cond, &compress_mutex);
+            continue;
+        }
+        CompressJob *job = compress_head;
+        compress_head = job->next;
+        if (!compress_head)
+            compress_tail = NULL;
+        atomic_fetch_sub_explicit(&stat_compress_pending, 1, memory_order_relaxed);
+
+        pthread_mutex_unlock(&compress_mutex);
+        compress_segment(job->path);
+        free(job);
+        pthread_mutex_lock(&compress_mutex);
+    }
+    pthread_mutex_unlock(&compress_mutex);
+    return NULL;
+}
+
+static void compress_enqueue(const char *path)
+{
+    CompressJob *job = calloc(1, sizeof(CompressJob));
+    if (!job)
+        return;
+    snprintf(job->path, sizeof(job->path), "%s", path);
+
+    pthread_mutex_lock(&compress_mutex);
+    if (compress_tail)
+        compress_tail->next = job;
+    else
+        compress_head = job;
+    compress_tail = job;
+    atomic_fetch_add_explicit(&stat_compress_pending, 1, memory_order_relaxed);
+    pthread_cond_signal(&compress_cond);
+    pthread_mutex_unlock(&compress_mutex);
+}
+
+/**
+ * @brief Open (or reopen) log_path as the current segment
+ * New segments are preallocated so appends do not extend the file block by block.
+ */
+static int open_segment(void)
+{
+    log_fd = open(log_path, O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (log_fd < 0)
+        return -1;
+
+    struct stat st;
+    segment_bytes = fstat(log_fd, &st) == 0 ? (size_t)st.st_size : 0;
+    segment_start = time(NULL);
+    memset(format_emitted, 0, sizeof(format_emitted));
+
+    if (segment_bytes == 0)
+    {
+        if (rotate_max_bytes > 0)
+            fallocate(log_fd, FALLOC_FL_KEEP_SIZE, 0, (off_t)rotate_max_bytes); // best effort
+
+        // New binary file: write the header so log_decoder can recognize it
+        if (log_format == LOG_FORMAT_BINARY)
+        {
+            uint32_t version = LOG_BINARY_VERSION;
+            write_all(log_fd, LOG_BINARY_MAGIC, LOG_BINARY_MAGIC_LEN);
+            write_all(log_fd, (const char *)&version, sizeof(version));
+            segment_bytes = LOG_BINARY_MAGIC_LEN + sizeof(version);
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Close the current segment, releasing unused preallocated blocks
+ */
+static void close_segment(void)
+{
+    if (log_fd < 0)
+        return;
+    struct stat st;
+    if (fstat(log_fd, &st) == 0)
+        ftruncate(log_fd, st.st_size);
+    close(log_fd);
+    log_fd = -1;
+}
+
+/**
+ * @brief Rename the current segment to <path>.<timestamp>, start a new one, compress the old one
+ * Runs on the writer thread only; logging threads keep filling their rings meanwhile.
+ */
+static void rotate_segment(void)
+{
+    close_segment();
+
+    char stamp[32], rotated[600];
+    time_t now = time(NULL);
+    struct tm tm_buf;
+    localtime_r(&now, &tm_buf);
+    strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &tm_buf);
+    snprintf(rotated, sizeof(rotated), "%s.%s", log_path, stamp);
+
+    // Several rotations within one second: add a counter
+    struct stat st;
+    for (int i = 1; stat(rotated, &st) == 0 && i < 1000; i++)
+        snprintf(rotated, sizeof(rotated), "%s.%s.%d", log_path, stamp, i);
+
+    if (rename(log_path, rotated) == 0)
+        compress_enqueue(rotated);
+
+    open_segment();
+}
+
+static int rotation_due(size_t pending)
+{
+    if (log_fd < 0)
+        return 0;
+    size_t header = log_format == LOG_FORMAT_BINARY ? LOG_BINARY_MAGIC_LEN + sizeof(uint32_t) : 0;
+    if (segment_bytes + batch_len <= header)
+        return 0; // never rotate an empty segment
+    if (rotate_max_bytes > 0 && segment_bytes + batch_len + pending > rotate_max_bytes)
+        return 1;
+    if (rotate_interval > 0 && time(NULL) - segment_start >= rotate_interval)
+        return 1;
+    return 0;
+}
+
+/**
+ * @brief Format timestamp, calling localtime/strftime at most once per second
+ */
+static const char *format_time(time_t sec)
+{
+    if (sec != cached_sec)
+    {
+        struct tm tm_buf;
+        localtime_r(&sec, &tm_buf);
+        strftime(cached_time, sizeof(cached_time), "%Y-%m-%d %H:%M:%S", &tm_buf);
+        cached_sec = sec;
+    }
+    return cached_time;
+}
+
+/**
+ * @brief Format one text line: [time] [LEVEL] [user] ACTION: msg\n
+ */
+static int format_line(char *out, size_t out_size, LogLevel level, int64_t timestamp,
+                       const char *user, size_t user_len, const char *action, size_t action_len,
+                       const char *msg, size_t msg_len)
+{
+    int len = snprintf(out, out_size, "[%s] [%s] [%.*s] %.*s: %.*s\n",
+                       format_time((time_t)(timestamp / 1000000000LL)),
+                       log_level_string(level),
+                       user_len ? (int)user_len : 6, user_len ? user : "SYSTEM",
+                       (int)action_len, action,
+                       (int)msg_len, msg);
+    if (len < 0)
+        return 0;
+    return (size_t)len < out_size ? len : (int)out_size - 1;
+}
+
+static void append(const void *data, size_t len)
+{
+    memcpy(batch + batch_len, data, len);
+    batch_len += len;
+}
+
+/**
+ * @brief Append a length-prefixed string entry field (u8 len + bytes)
+ */
+static void append_str8(const char *str, size_t len)
+{
+    uint8_t len8 = (uint8_t)len;
+    append(&len8, 1);
+    append(str, len);
+}
+
+static void emit_record(const LogRecordHeader *hdr)
+{
+    const char *user = (const char *)(hdr + 1);
+    const char *action = user + hdr->user_len;
+    const char *msg = action + hdr->action_len;
+    LogLevel level = (LogLevel)hdr->level;
+
+    size_t max_entry = 64 + 255 + LOG_MAX_ACTION + LOG_MAX_MESSAGE + 2 * (LOG_MAX_MESSAGE + 1);
+    if (LOG_BATCH_SIZE - batch_len < max_entry || LOG_BATCH_SIZE - console_len < max_entry)
+        flush_batches();
+
+    // Rotate between entries so format definitions stay in the same file as their records
+    if (rotate_max_bytes > 0 && segment_bytes + batch_len + max_entry > rotate_max_bytes && rotation_due(max_entry))
+    {
+        flush_batches();
+        rotate_segment();
+    }
+
+    char rendered[LOG_MAX_MESSAGE + 1];
+    size_t rendered_len = hdr->msg_len;
+    if (hdr->flags & LOG_RECORD_BINARY)
+    {
+        // Console mirror needs text; the file gets the raw args
+        rendered_len = 0;
+        if (level == LOG_ERROR || level == LOG_WARNING)
+        {
+            rendered_len = log_format_render(formats[hdr->format_id].format, msg, hdr->msg_len,
+                                             rendered, sizeof(rendered));
+        }
+    }
+    else
+    {
+        memcpy(rendered, msg, rendered_len);
+    }
+
+    if (log_format == LOG_FORMAT_BINARY)
+    {
+        uint8_t tag = (hdr->flags & LOG_RECORD_BINARY) ? LOG_TAG_RECORD : LOG_TAG_TEXT;
+        if (tag == LOG_TAG_RECORD && !format_emitted[hdr->format_id])
+        {
+            // Define the format in this file before its first use
+            const char *format = formats[hdr->format_id].format;
+            uint8_t def_tag = LOG_TAG_FORMAT;
+            uint16_t fmt_len = (uint16_t)strnlen(format, LOG_MAX_MESSAGE);
+            append(&def_tag, 1);
+            append(&hdr->format_id, sizeof(uint16_t));
+            append(&fmt_len, sizeof(fmt_len));
+            append(format, fmt_len);
+            format_emitted[hdr->format_id] = 1;
+        }
 
-    // Write to log file
-    if (log_file)
+        append(&tag, 1);
+        if (tag == LOG_TAG_RECORD)
+            append(&hdr->format_id, sizeof(uint16_t));
+        append(&hdr->level, 1);
+        append(&hdr->timestamp, sizeof(int64_t));
+        append_str8(user, hdr->user_len);
+        append_str8(action, hdr->action_len);
+        append(&hdr->msg_len, sizeof(uint16_t));
+        append(msg, hdr->msg_len);
+    }
+    else
     {
-        fputs(log_entry, log_file);
-        fflush(log_file);
+        batch_len += format_line(batch + batch_len, LOG_BATCH_SIZE - batch_len, level, hdr->timestamp,
+                                 user, hdr->user_len, action, hdr->action_len, rendered, rendered_len);
     }
 
     // in ra console nếu là lỗi hoặc cảnh báo
     if (level == LOG_ERROR || level == LOG_WARNING)
     {
-        fputs(log_entry, stdout);
-        fflush(stdout);
+        console_len += format_line(console_batch + console_len, LOG_BATCH_SIZE - console_len, level, hdr->timestamp,
+                                   user, hdr->user_len, action, hdr->action_len, rendered, rendered_len);
+    }
+}
+
+/**
+ * @brief Writer-generated message (e.g. drop notices), emitted as a text record
+ */
+static void emit_internal(LogLevel level, const char *action, const char *msg)
+{
+    struct
+    {
+        LogRecordHeader hdr;
+        char payload[LOG_MAX_ACTION + LOG_MAX_MESSAGE];
+    } rec;
+    memset(&rec.hdr, 0, sizeof(rec.hdr));
+
+    size_t action_len = strnlen(action, LOG_MAX_ACTION);
+    size_t msg_len = strnlen(msg, LOG_MAX_MESSAGE);
+    memcpy(rec.payload, action, action_len);
+    memcpy(rec.payload + action_len, msg, msg_len);
+    rec.hdr.level = (uint8_t)level;
+    rec.hdr.action_len = (uint8_t)action_len;
+    rec.hdr.msg_len = (uint16_t)msg_len;
+    rec.hdr.timestamp = now_ns();
+    emit_record(&rec.hdr);
+}
+
+/**
+ * @brief Drain one ring into the batch buffers
+ * @return Number of records consumed
+ */
+static int drain_ring(LogRing *ring, size_t *backlog)
+{
+    int count = 0;
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    size_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    *backlog += head - tail;
+
+    while (tail != head)
+    {
+        size_t pos = tail & LOG_RING_MASK;
+        if (LOG_RING_SIZE - pos < sizeof(LogRecordHeader))
+        {
+            tail += LOG_RING_SIZE - pos; // implicit padding
+            continue;
+        }
+
+        LogRecordHeader *hdr = (LogRecordHeader *)(ring->data + pos);
+        if (!(hdr->flags & LOG_RECORD_PAD))
+        {
+            emit_record(hdr);
+            count++;
+        }
+        tail += hdr->size;
+    }
+    atomic_store_explicit(&ring->tail, tail, memory_order_release);
+
+    uint64_t dropped = atomic_exchange_explicit(&ring->dropped, 0, memory_order_relaxed);
+    if (dropped > 0)
+    {
+        atomic_fetch_add_explicit(&stat_dropped_total, dropped, memory_order_relaxed);
+        char msg[64];
+        snprintf(msg, sizeof(msg), "%llu messages dropped (ring full)", (unsigned long long)dropped);
+        emit_internal(LOG_WARNING, "LOGGER", msg);
     }
+    return count;
+}
+
+/**
+ * @brief Unlink and free a drained ring whose thread has exited
+ * Only the writer removes nodes; producers only push at the head.
+ */
+static void ring_unlink(LogRing *prev, LogRing *ring)
+{
+    LogRing *next = atomic_load_explicit(&ring->next, memory_order_relaxed);
+    if (prev)
+    {
+        atomic_store_explicit(&prev->next, next, memory_order_relaxed);
+    }
+    else
+    {
+        LogRing *expected = ring;
+        if (!atomic_compare_exchange_strong_explicit(&ring_list, &expected, next,
+                                                     memory_order_acq_rel, memory_order_acquire))
+        {
+            // New rings were pushed in front: find the predecessor again
+            LogRing *p = expected;
+            while (atomic_load_explicit(&p->next, memory_order_relaxed) != ring)
+                p = atomic_load_explicit(&p->next, memory_order_relaxed);
+            atomic_store_explicit(&p->next, next, memory_order_relaxed);
+        }
+    }
+    free(ring);
+}
+
+static int drain_all(void)
+{
+    int count = 0, rings = 0;
+    size_t backlog = 0;
+    LogRing *prev = NULL;
+    LogRing *ring = atomic_load_explicit(&ring_list, memory_order_acquire);
+
+    while (ring)
+    {
+        int orphaned = atomic_load_explicit(&ring->orphaned, memory_order_acquire);
+        count += drain_ring(ring, &backlog);
+        LogRing *next = atomic_load_explicit(&ring->next, memory_order_relaxed);
+
+        if (orphaned)
+        {
+            ring_unlink(prev, ring);
+        }
+        else
+        {
+            prev = ring;
+            rings++;
+        }
+        ring = next;
+    }
+    flush_batches();
+
+    atomic_store_explicit(&stat_rings, rings, memory_order_relaxed);
+    atomic_store_explicit(&stat_backlog_bytes, backlog, memory_order_relaxed);
+    return count;
+}
+
+static void *writer_main(void *arg)
+{
+    (void)arg;
+    while (atomic_load_explicit(&writer_running, memory_order_acquire))
+    {
+        int drained = drain_all();
+        if (rotation_due(0))
+            rotate_segment(); // time-based rotation (batch is empty after drain_all)
+
+        if (drained == 0)
+        {
+            struct timespec ts = {0, LOG_IDLE_SLEEP_MS * 1000000L};
+            nanosleep(&ts, NULL);
+        }
+    }
+    drain_all(); // final drain after logger_close()
+    return NULL;
+}
+
+// ================================ Lifecycle ==================================
+
+/**
+ * @brief Initialize logger
+ * @param filename Log file path (NULL for stdout only)
+ * @return 0 on success, -1 on error
+ */
+int logger_init(const char *filename)
+{
+    return logger_init_format(filename, LOG_FORMAT_TEXT);
+}
+
+/**
+ * @brief Initialize logger with an explicit file format
+ */
+int logger_init_format(const char *filename, LogFileFormat format)
+{
+    if (atomic_load(&writer_running))
+        return 0;
+
+    log_format = format;
+    if (filename)
+    {
+        snprintf(log_path, sizeof(log_path), "%s", filename);
+        if (open_segment() < 0)
+        {
+            return -1;
+        }
+
+        compress_running = 1;
+        if (pthread_create(&compress_thread, NULL, compressor_main, NULL) != 0)
+            compress_running = 0; // rotated segments stay uncompressed
+    }
+
+    static int atexit_registered = 0;
+    if (!atexit_registered)
+    {
+        atexit(logger_close); // drain the rings even if main() returns early
+        atexit_registered = 1;
+    }
+
+    atomic_store(&writer_running, 1);
+    if (pthread_create(&writer_thread, NULL, writer_main, NULL) != 0)
+    {
+        atomic_store(&writer_running, 0);
+        close_segment();
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Close Logger
+ */
+void logger_close()
+{
+    if (!atomic_exchange(&writer_running, 0))
+        return;
+
+    pthread_join(writer_thread, NULL);
+    close_segment();
+
+    // Let the compressor finish pending segments
+    pthread_mutex_lock(&compress_mutex);
+    int had_compressor = compress_running;
+    compress_running = 0;
+    pthread_cond_signal(&compress_cond);
+    pthread_mutex_unlock(&compress_mutex);
+    if (had_compressor)
+        pthread_join(compress_thread, NULL);
+}
+
+/**
+ * @brief Snapshot of the logger queues (values published by the writer thread)
+ */
+void logger_get_stats(LoggerStats *stats)
+{
+    stats->rings = atomic_load_explicit(&stat_rings, memory_order_relaxed);
+    stats->backlog_bytes = atomic_load_explicit(&stat_backlog_bytes, memory_order_relaxed);
+    stats->dropped = atomic_load_explicit(&stat_dropped_total, memory_order_relaxed);
+    stats->compress_pending = atomic_load_explicit(&stat_compress_pending, memory_order_relaxed);
+}
 
-    pthread_mutex_unlock(&log_mutex);
-}
\ No newline at end of file
+/**
+ * @brief Configure segment rotation
+ */
+void logger_set_rotation(size_t max_bytes, int interval_seconds)
+{
+    rotate_max_bytes = max_bytes;
+    rotate_interval = interval_seconds;
+}
@@ -14,18 +14,81 @@ typedef enum {
     LOG_ERROR    // dùng cho các lỗi
 } LogLevel;
 
+/**
+ * @brief Log file formats
+ */
+typedef enum {
+    LOG_FORMAT_TEXT,  // [time] [LEVEL] [user] ACTION: msg
+    LOG_FORMAT_BINARY // format id + raw args, render with bin/log_decoder
+} LogFileFormat;
+
+// Async logger tuning
+#define LOG_RING_SIZE (64 * 1024)     // bytes per thread ring buffer (power of two)
+#define LOG_MAX_MESSAGE 1023          // max formatted message length (same as old stack buffer)
+#define LOG_MAX_ACTION 63             // max action name length
+#define LOG_BATCH_SIZE (64 * 1024)    // writer batch size per write() call
+#define LOG_IDLE_SLEEP_MS 10          // writer sleep when all rings are empty
+
+// Log rotation defaults (see logger_set_rotation)
+#define LOG_ROTATE_MAX_BYTES (256UL * 1024 * 1024) // rotate when the segment reaches 256 MB
+#define LOG_ROTATE_INTERVAL_SECONDS (24 * 60 * 60) // rotate at least once a day
+
+/**
+ * @brief Logger queue depths (for STATS)
+ */
+typedef struct
+{
+    int rings;                  // live per-thread rings
+    size_t backlog_bytes;       // bytes pending in all rings at the last writer pass
+    unsigned long long dropped; // records dropped because a ring was full (total)
+    int compress_pending;       // rotated segments waiting for gzip
+} LoggerStats;
+
 /**
  * @brief Initialize logger
  * @param filename Log file path (NULL for stdout only)
  * @return 0 on success, -1 on error
+ *
+ * Starts the background writer thread. Each logging thread gets its own
+ * SPSC ring buffer on first use; the writer drains all rings, formats the
+ * lines and writes them in batches.
  */
 int logger_init(const char *filename);
 
+/**
+ * @brief Initialize logger with an explicit file format
+ * @param filename Log file path (NULL for stdout only)
+ * @param format LOG_FORMAT_TEXT or LOG_FORMAT_BINARY
+ * @return 0 on success, -1 on error
+ *
+ * In binary mode call sites only record the interned format id and the raw
+ * args; formatting is deferred to the offline decoder (tools/log_decoder.c).
+ * Warnings and errors are still rendered to stdout by the writer thread.
+ */
+int logger_init_format(const char *filename, LogFileFormat format);
+
 /**
  * @brief Close Logger
- */    
+ * Stops the writer thread after draining every ring, then closes the file.
+ */
 void logger_close();
 
+/**
+ * @brief Configure segment rotation (call before logger_init)
+ * @param max_bytes Rotate when the file would exceed this size (0 = no size limit)
+ * @param interval_seconds Rotate when the segment is older than this (0 = no time limit)
+ *
+ * The writer thread renames the full segment to <file>.<YYYYmmdd-HHMMSS>,
+ * opens a new preallocated file and hands the old one to a background
+ * thread that gzips it. Logging threads are never involved.
+ */
+void logger_set_rotation(size_t max_bytes, int interval_seconds);
+
+/**
+ * @brief Read logger queue depths without touching the rings
+ */
+void logger_get_stats(LoggerStats *stats);
+
 /**
  * @brief Log a message
  * @param level Log level
@@ -33,9 +96,12 @@ void logger_close();
  * @param action Action/Event name
  * @param format Printf-style format string
  * @param ... Variable arguments
- * 
+ *
  * Format: [TIMESTAMP] [LEVEL] [USERNAME] action: message
  * Example: [2025-11-30 14:30:00] [INFO] [john123] LOGIN: Successful login
+ *
+ * Never blocks: the record is copied into the calling thread's ring buffer.
+ * If the ring is full the record is dropped and counted.
  */
 void log_event(LogLevel level, const char *username, const char *action, const char *format, ...);
 
@@ -46,4 +112,4 @@ void log_event(LogLevel level, const char *username, const char *action, const c
  */
 const char* log_level_to_string(LogLevel level);
 
-#endif // LOGGER_H
\ No newline at end of file
+#endif // LOGGER_H
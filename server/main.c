@@ -1,16 +1,116 @@
 #include "server.h"
+#include <string.h>
 #include <unistd.h>
+#include <signal.h>
+#include "metrics/metrics.h"
+#include "leaderboard/leaderboard.h"
+#include "room/lobby.h"
+#include "room/room_id.h"
+#include "exam/exam_timer.h"
+#include "practice/practice.h"
+#include "stats/item_stats.h"
+#include "answers/answers.h"
+
+static void print_usage(const char *prog)
+{
+    fprintf(stderr, "Usage: %s [--binary-log] [--metrics-port N] [--capture FILE] [--db mysql|memory|sqlite] [--db-seed FILE] [--db-path FILE] [--results-journal FILE] [--push-exam] [--answers-journal FILE] [--node-id N]\n", prog);
+    fprintf(stderr, "  --binary-log       write %s in binary format (decode with bin/log_decoder)\n", SERVER_BINARY_LOG_FILE);
+    fprintf(stderr, "  --metrics-port N   serve Prometheus metrics on 127.0.0.1:N (default %d, 0 = off)\n", METRICS_PORT);
+    fprintf(stderr, "  --capture FILE     record inbound commands for bin/replay (contains passwords)\n");
+    fprintf(stderr, "  --db BACKEND       %s (default), %s (in-process, no persistence) or %s (embedded file)\n", DB_BACKEND_MYSQL, DB_BACKEND_MEMORY, DB_BACKEND_SQLITE);
+    fprintf(stderr, "  --db-seed FILE     sample data for --db %s and new --db %s files (default %s)\n", DB_BACKEND_MEMORY, DB_BACKEND_SQLITE, DB_MEMORY_SEED_FILE);
+    fprintf(stderr, "  --db-path FILE     database file for --db %s (default %s)\n", DB_BACKEND_SQLITE, DB_SQLITE_FILE);
+    fprintf(stderr, "  --results-journal FILE  acknowledge SUBMIT_EXAM once journaled, commit results in batches\n");
+    fprintf(stderr, "  --push-exam        send the exam with START_OK (participants skip GET_EXAM)\n");
+    fprintf(stderr, "  --answers-journal FILE  keep SAVE_ANSWER sheets across restarts\n");
+    fprintf(stderr, "  --node-id N        room id node, 0..%d, distinct per server on one database (default 0)\n", ROOM_ID_MAX_NODE);
+}
+
+// Ctrl+C / kill: exit() so the atexit handlers (log rings, --capture file) flush
+static void *signal_main(void *arg)
+{
+    sigset_t *signals = (sigset_t *)arg;
+    int sig = 0;
+    sigwait(signals, &sig);
+    printf("\nSignal %d received, shutting down\n", sig);
+    exit(0);
+}
 
 // main function
-int main()
+int main(int argc, char **argv)
 {
     Server server;
+    ServerOptions options;
+    memset(&options, 0, sizeof(options));
+    options.metrics_port = METRICS_PORT;
+    options.db_backend = DB_BACKEND_MYSQL;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--binary-log") == 0)
+        {
+            options.binary_log = 1;
+        }
+        else if (strcmp(argv[i], "--metrics-port") == 0 && i + 1 < argc)
+        {
+            options.metrics_port = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--capture") == 0 && i + 1 < argc)
+        {
+            options.capture_file = argv[++i];
+        }
+        else if (strcmp(argv[i], "--db") == 0 && i + 1 < argc &&
+                 (strcmp(argv[i + 1], DB_BACKEND_MYSQL) == 0 || strcmp(argv[i + 1], DB_BACKEND_MEMORY) == 0 ||
+                  strcmp(argv[i + 1], DB_BACKEND_SQLITE) == 0))
+        {
+            options.db_backend = argv[++i];
+        }
+        else if (strcmp(argv[i], "--db-seed") == 0 && i + 1 < argc)
+        {
+            options.db_seed = argv[++i];
+        }
+        else if (strcmp(argv[i], "--db-path") == 0 && i + 1 < argc)
+        {
+            options.db_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "--results-journal") == 0 && i + 1 < argc)
+        {
+            options.results_journal = argv[++i];
+        }
+        else if (strcmp(argv[i], "--push-exam") == 0)
+        {
+            options.push_exam = 1;
+        }
+        else if (strcmp(argv[i], "--answers-journal") == 0 && i + 1 < argc)
+        {
+            options.answers_journal = argv[++i];
+        }
+        else if (strcmp(argv[i], "--node-id") == 0 && i + 1 < argc)
+        {
+            options.node_id = atoi(argv[++i]);
+        }
+        else
+        {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    // Blocked before any thread starts, so only signal_main receives them
+    static sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, NULL);
+    pthread_t signal_thread;
+    if (pthread_create(&signal_thread, NULL, signal_main, &signals) != 0)
+        pthread_sigmask(SIG_UNBLOCK, &signals, NULL);
 
     printf("===========================================\n");
     printf("   ONLINE EXAM SYSTEM SERVER\n");
     printf("===========================================\n\n");
 
-    if (server_init(&server, SERVER_PORT) != 0)
+    if (server_init(&server, SERVER_PORT, &options) != 0)
     {
         fprintf(stderr, "Server initialization failed. Exiting.\n");
         return 1;
@@ -19,6 +119,12 @@ int main()
     server_start(&server);
 
     // Cleanup
+    leaderboard_stop_push();
+    lobby_stop_push();
+    exam_timer_stop();
+    answers_close();
+    practice_stop();
+    item_stats_stop();
     if (server.db)
     {
         db_disconnect(server.db);
@@ -26,9 +132,9 @@ int main()
         server.db = NULL;
     }
     close(server.server_fd);
-    logger_close();
 
     printf("\nServer shut down cleanly\n");
     log_event(LOG_INFO, NULL, "SERVER", "Server shut down cleanly");
+    logger_close(); // last: drains the records above, later ones are dropped
     return 0;
 }
@@ -0,0 +1,396 @@
+#include "metrics.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+// ========================== Per-thread slabs ================================
+
+/**
+ * @brief Histograms owned by one thread
+ * Only the owning thread writes; the scrape thread reads with relaxed loads.
+ * Slabs are never freed: when a thread exits its slab is released and the
+ * next new thread reuses it, so totals stay cumulative.
+ */
+typedef struct MetricsSlab
+{
+    MetricsHistogram commands[METRIC_CMD_COUNT];
+    MetricsHistogram db[METRIC_DB_COUNT];
+    atomic_int in_use;
+    struct MetricsSlab *next;
+} MetricsSlab;
+
+static _Atomic(MetricsSlab *) slab_list = NULL;
+static __thread MetricsSlab *thread_slab = NULL;
+static pthread_key_t slab_key;
+static pthread_once_t slab_key_once = PTHREAD_ONCE_INIT;
+static atomic_int db_inflight = 0;
+
+static const char *command_names[METRIC_CMD_COUNT] = {
+#define METRICS_NAME(name) #name,
+    METRICS_COMMANDS(METRICS_NAME)
+#undef METRICS_NAME
+};
+
+static const char *db_op_names[METRIC_DB_COUNT] = {
+#define METRICS_NAME(name) "db_" #name,
+    METRICS_DB_OPS(METRICS_NAME)
+#undef METRICS_NAME
+};
+
+// Single writer: a plain load + store is enough, no locked instruction needed
+#define SLAB_ADD(field, value) \
+    __atomic_store_n(&(field), __atomic_load_n(&(field), __ATOMIC_RELAXED) + (value), __ATOMIC_RELAXED)
+
+static void release_slab(void *arg)
+{
+    MetricsSlab *slab = (MetricsSlab *)arg;
+    atomic_store_explicit(&slab->in_use, 0, memory_order_release);
+}
+
+static void create_slab_key(void)
+{
+    pthread_key_create(&slab_key, release_slab);
+}
+
+static MetricsSlab *get_slab(void)
+{
+    if (thread_slab)
+        return thread_slab;
+
+    pthread_once(&slab_key_once, create_slab_key);
+
+    // Reuse a slab released by an exited thread
+    MetricsSlab *slab;
+    for (slab = atomic_load(&slab_list); slab; slab = slab->next)
+    {
+        int expected = 0;
+        if (atomic_compare_exchange_strong(&slab->in_use, &expected, 1))
+            break;
+    }
+
+    if (!slab)
+    {
+        slab = calloc(1, sizeof(MetricsSlab));
+        if (!slab)
+            return NULL;
+        atomic_store(&slab->in_use, 1);
+
+        MetricsSlab *head = atomic_load(&slab_list);
+        do
+        {
+            slab->next = head;
+        } while (!atomic_compare_exchange_weak(&slab_list, &head, slab));
+    }
+
+    pthread_setspecific(slab_key, slab);
+    thread_slab = slab;
+    return slab;
+}
+
+// ============================ Histogram math ================================
+
+static size_t bucket_index(uint64_t value)
+{
+    if (value < METRICS_SUB_COUNT)
+        return (size_t)value;
+    if (value >= (1ULL << METRICS_MAX_EXP))
+        value = (1ULL << METRICS_MAX_EXP) - 1;
+
+    int exp = 63 - __builtin_clzll(value);
+    int shift = exp - METRICS_SUB_BITS;
+    size_t sub = (size_t)(value >> shift) & (METRICS_SUB_COUNT - 1);
+    return (size_t)(exp - METRICS_SUB_BITS + 1) * METRICS_SUB_COUNT + sub;
+}
+
+// Exclusive upper bound of a bucket, in ns
+static uint64_t bucket_upper(size_t index)
+{
+    if (index < METRICS_SUB_COUNT)
+        return index + 1;
+    size_t group = index / METRICS_SUB_COUNT;
+    size_t sub = index % METRICS_SUB_COUNT;
+    int shift = (int)group - 1;
+    return ((uint64_t)(METRICS_SUB_COUNT + sub) << shift) + (1ULL << shift);
+}
+
+static void histogram_add(MetricsHistogram *h, uint64_t value)
+{
+    SLAB_ADD(h->sum_ns, value);
+    SLAB_ADD(h->buckets[bucket_index(value)], 1);
+}
+
+static void histogram_merge(MetricsHistogram *out, const MetricsHistogram *h)
+{
+    out->sum_ns += __atomic_load_n(&h->sum_ns, __ATOMIC_RELAXED);
+    for (size_t i = 0; i < METRICS_BUCKETS; i++)
+    {
+        uint64_t n = __atomic_load_n(&h->buckets[i], __ATOMIC_RELAXED);
+        out->buckets[i] += n;
+        out->count += n; // count derived from buckets so +Inf == _count
+    }
+}
+
+uint64_t metrics_percentile(const MetricsHistogram *h, double percentile)
+{
+    if (h->count == 0)
+        return 0;
+    uint64_t target = (uint64_t)((double)h->count * percentile / 100.0 + 0.5);
+    if (target == 0)
+        target = 1;
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < METRICS_BUCKETS; i++)
+    {
+        seen += h->buckets[i];
+        if (seen >= target)
+            return bucket_upper(i);
+    }
+    return bucket_upper(METRICS_BUCKETS - 1);
+}
+
+// ============================== Recording ===================================
+
+MetricCommand metrics_command_from_name(const char *command)
+{
+    for (int i = 0; i < METRIC_CMD_UNKNOWN; i++)
+    {
+        if (strcmp(command, command_names[i]) == 0)
+            return (MetricCommand)i;
+    }
+    return METRIC_CMD_UNKNOWN;
+}
+
+const char *metrics_command_name(MetricCommand cmd)
+{
+    return command_names[cmd];
+}
+
+void metrics_record_command(MetricCommand cmd, uint64_t elapsed_ns)
+{
+    MetricsSlab *slab = get_slab();
+    if (slab)
+        histogram_add(&slab->commands[cmd], elapsed_ns);
+}
+
+void metrics_record_db(MetricDbOp op, uint64_t elapsed_ns)
+{
+    MetricsSlab *slab = get_slab();
+    if (slab)
+        histogram_add(&slab->db[op], elapsed_ns);
+}
+
+MetricsDbTimer metrics_db_begin(MetricDbOp op)
+{
+    atomic_fetch_add_explicit(&db_inflight, 1, memory_order_relaxed);
+    MetricsDbTimer timer = {op, metrics_now_ns()};
+    return timer;
+}
+
+void metrics_db_end(MetricsDbTimer *timer)
+{
+    metrics_record_db(timer->op, metrics_now_ns() - timer->start_ns);
+    atomic_fetch_sub_explicit(&db_inflight, 1, memory_order_relaxed);
+}
+
+int metrics_db_inflight(void)
+{
+    return atomic_load_explicit(&db_inflight, memory_order_relaxed);
+}
+
+void metrics_snapshot_command(MetricCommand cmd, MetricsHistogram *out)
+{
+    memset(out, 0, sizeof(MetricsHistogram));
+    for (MetricsSlab *slab = atomic_load(&slab_list); slab; slab = slab->next)
+        histogram_merge(out, &slab->commands[cmd]);
+}
+
+void metrics_snapshot_db(MetricDbOp op, MetricsHistogram *out)
+{
+    memset(out, 0, sizeof(MetricsHistogram));
+    for (MetricsSlab *slab = atomic_load(&slab_list); slab; slab = slab->next)
+        histogram_merge(out, &slab->db[op]);
+}
+
+// ========================= Prometheus exposition ============================
+
+typedef struct
+{
+    char *data;
+    size_t len;
+    size_t cap;
+} TextBuffer;
+
+static void text_append(TextBuffer *buf, const char *format, ...)
+{
+    for (;;)
+    {
+        va_list args;
+        va_start(args, format);
+        int n = buf->data ? vsnprintf(buf->data + buf->len, buf->cap - buf->len, format, args) : -1;
+        va_end(args);
+
+        if (n >= 0 && (size_t)n < buf->cap - buf->len)
+        {
+            buf->len += (size_t)n;
+            return;
+        }
+
+        size_t new_cap = buf->cap ? buf->cap * 2 : 16384;
+        char *data = realloc(buf->data, new_cap);
+        if (!data)
+            return;
+        buf->data = data;
+        buf->cap = new_cap;
+    }
+}
+
+// Exported bucket boundaries (seconds); finer buckets stay internal
+static const double export_bounds[] = {0.00005, 0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01,
+                                       0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10};
+
+static void write_histogram(TextBuffer *buf, const char *metric, const char *label, const char *value,
+                            const MetricsHistogram *h)
+{
+    size_t bucket = 0;
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < sizeof(export_bounds) / sizeof(export_bounds[0]); i++)
+    {
+        uint64_t bound_ns = (uint64_t)(export_bounds[i] * 1e9);
+        while (bucket < METRICS_BUCKETS && bucket_upper(bucket) <= bound_ns + 1)
+            cumulative += h->buckets[bucket++];
+        text_append(buf, "%s_bucket{%s=\"%s\",le=\"%g\"} %llu\n", metric, label, value, export_bounds[i],
+                    (unsigned long long)cumulative);
+    }
+    text_append(buf, "%s_bucket{%s=\"%s\",le=\"+Inf\"} %llu\n", metric, label, value, (unsigned long long)h->count);
+    text_append(buf, "%s_sum{%s=\"%s\"} %.9f\n", metric, label, value, (double)h->sum_ns / 1e9);
+    text_append(buf, "%s_count{%s=\"%s\"} %llu\n", metric, label, value, (unsigned long long)h->count);
+}
+
+static void render_metrics(TextBuffer *buf)
+{
+    MetricsHistogram h;
+
+    text_append(buf, "# HELP exam_command_duration_seconds Time spent handling a client command.\n");
+    text_append(buf, "# TYPE exam_command_duration_seconds histogram\n");
+    for (int i = 0; i < METRIC_CMD_COUNT; i++)
+    {
+        metrics_snapshot_command((MetricCommand)i, &h);
+        write_histogram(buf, "exam_command_duration_seconds", "command", command_names[i], &h);
+    }
+
+    text_append(buf, "# HELP exam_db_duration_seconds Time spent in a db_* call, including waiting for the connection.\n");
+    text_append(buf, "# TYPE exam_db_duration_seconds histogram\n");
+    for (int i = 0; i < METRIC_DB_COUNT; i++)
+    {
+        metrics_snapshot_db((MetricDbOp)i, &h);
+        write_histogram(buf, "exam_db_duration_seconds", "function", db_op_names[i], &h);
+    }
+
+    text_append(buf, "# HELP exam_db_inflight db_* calls currently running.\n");
+    text_append(buf, "# TYPE exam_db_inflight gauge\n");
+    text_append(buf, "exam_db_inflight %d\n", metrics_db_inflight());
+}
+
+static void send_all(int fd, const char *data, size_t len)
+{
+    while (len > 0)
+    {
+        ssize_t n = send(fd, data, len, MSG_NOSIGNAL);
+        if (n <= 0)
+            return;
+        data += n;
+        len -= (size_t)n;
+    }
+}
+
+static void serve_request(int fd)
+{
+    // Only the request line matters; a slow client cannot hold the thread for long
+    struct timeval timeout = {1, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    char request[1024];
+    ssize_t n = recv(fd, request, sizeof(request) - 1, 0);
+    if (n <= 0)
+        return;
+    request[n] = '\0';
+
+    if (strncmp(request, "GET /metrics", 12) != 0)
+    {
+        const char *not_found = "HTTP/1.0 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+        send_all(fd, not_found, strlen(not_found));
+        return;
+    }
+
+    TextBuffer body = {0};
+    render_metrics(&body);
+
+    char header[256];
+    int header_len = snprintf(header, sizeof(header),
+                              "HTTP/1.0 200 OK\r\n"
+                              "Content-Type: text/plain; version=0.0.4\r\n"
+                              "Content-Length: %zu\r\n"
+                              "Connection: close\r\n\r\n",
+                              body.len);
+    send_all(fd, header, (size_t)header_len);
+    if (body.data)
+        send_all(fd, body.data, body.len);
+    free(body.data);
+}
+
+static void *metrics_main(void *arg)
+{
+    int listen_fd = (int)(intptr_t)arg;
+    for (;;)
+    {
+        int fd = accept(listen_fd, NULL, NULL);
+        if (fd < 0)
+            continue;
+        serve_request(fd);
+        close(fd);
+    }
+    return NULL;
+}
+
+int metrics_init(int port)
+{
+    if (port <= 0)
+        return 0;
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0)
+        return -1;
+
+    int opt = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+
+    // Local only: scraped by an agent on the same host
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, 8) < 0)
+    {
+        close(fd);
+        return -1;
+    }
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, metrics_main, (void *)(intptr_t)fd) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+    pthread_detach(thread);
+    return 0;
+}
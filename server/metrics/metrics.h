@@ -0,0 +1,194 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdint.h>
+#include <time.h>
+
+// ===============================================
+// METRICS - per-command / per-db-call latency histograms
+// ===============================================
+//
+// Each thread records into its own slab (single writer, relaxed stores), so
+// recording is a few adds with no lock and no shared cache line. The scrape
+// thread sums all slabs and serves Prometheus text on 127.0.0.1:<port>.
+
+#define METRICS_PORT 9100 // default scrape port (0 = disabled)
+
+// Histogram layout: values in ns, 8 linear sub-buckets per power of two
+// (<= 12.5% relative error), up to 2^36 ns (~68 s).
+#define METRICS_SUB_BITS 3
+#define METRICS_SUB_COUNT (1 << METRICS_SUB_BITS)
+#define METRICS_MAX_EXP 36
+#define METRICS_BUCKETS ((METRICS_MAX_EXP - METRICS_SUB_BITS + 1) * METRICS_SUB_COUNT)
+
+// Commands dispatched by handle_client (name must match the MSG_* string)
+#define METRICS_COMMANDS(X)    \
+    X(REGISTER)                \
+    X(LOGIN)                   \
+    X(LOGOUT)                  \
+    X(PRACTICE)                \
+    X(SUBMIT_PRACTICE)         \
+    X(PRACTICE_NEXT)           \
+    X(PRACTICE_ANSWER)         \
+    X(LIST_ROOMS)              \
+    X(LIST_ROOMS_PAGE)         \
+    X(CREATE_ROOM)             \
+    X(JOIN_ROOM)               \
+    X(LEAVE_ROOM)              \
+    X(START_EXAM)              \
+    X(GET_EXAM)                \
+    X(SUBMIT_EXAM)             \
+    X(SAVE_ANSWER)             \
+    X(VIEW_RESULT)             \
+    X(PING)                    \
+    X(COMPRESS)                \
+    X(STATS)                   \
+    X(ITEM_STATS)              \
+    X(SUBSCRIBE_LEADERBOARD)   \
+    X(UNSUBSCRIBE_LEADERBOARD) \
+    X(SUBSCRIBE_LOBBY)         \
+    X(UNSUBSCRIBE_LOBBY)       \
+    X(UNKNOWN)
+
+// Timed database functions (db_<name>)
+#define METRICS_DB_OPS(X)          \
+    X(create_user)                 \
+    X(check_username_exists)       \
+    X(verify_login)                \
+    X(is_account_locked)           \
+    X(create_session)              \
+    X(destroy_session)             \
+    X(check_user_logged_in)        \
+    X(log_activity)                \
+    X(create_room)                 \
+    X(list_rooms)                  \
+    X(get_rooms)                   \
+    X(list_rooms_page)             \
+    X(join_room)                   \
+    X(get_room_status)             \
+    X(get_room_participant_count)  \
+    X(get_room_time_limit)         \
+    X(get_room_leaderboard)        \
+    X(get_exam_questions)          \
+    X(leave_room)                  \
+    X(start_room)                  \
+    X(finish_room)                 \
+    X(is_room_creator)             \
+    X(is_participant)              \
+    X(delete_room)                 \
+    X(get_correct_answers)         \
+    X(submit_exam)                 \
+    X(check_already_submitted)     \
+    X(get_exam_result)             \
+    X(check_all_submitted)         \
+    X(submit_exam_batch)           \
+    X(get_room_question_ids)       \
+    X(load_questions)              \
+    X(save_practice_results)       \
+    X(load_abilities)              \
+    X(save_abilities)              \
+    X(load_question_stats)         \
+    X(save_question_stats)         \
+    X(count_rooms_by_status)
+
+#define METRICS_ENUM_CMD(name) METRIC_CMD_##name,
+#define METRICS_ENUM_DB(name) METRIC_DB_##name,
+
+typedef enum
+{
+    METRICS_COMMANDS(METRICS_ENUM_CMD)
+    METRIC_CMD_COUNT
+} MetricCommand;
+
+typedef enum
+{
+    METRICS_DB_OPS(METRICS_ENUM_DB)
+    METRIC_DB_COUNT
+} MetricDbOp;
+
+/**
+ * @brief Aggregated histogram (sum of all thread slabs)
+ */
+typedef struct
+{
+    uint64_t count;
+    uint64_t sum_ns;
+    uint64_t buckets[METRICS_BUCKETS];
+} MetricsHistogram;
+
+/**
+ * @brief Start the Prometheus scrape thread
+ * @param port Local TCP port (127.0.0.1 only), 0 = do not serve
+ * @return 0 on success, -1 on error
+ */
+int metrics_init(int port);
+
+/**
+ * @brief Monotonic clock in ns (start/end of a timed section)
+ */
+static inline uint64_t metrics_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Map a command name to its metric id (METRIC_CMD_UNKNOWN if not listed)
+ */
+MetricCommand metrics_command_from_name(const char *command);
+
+/**
+ * @brief Name of a command metric ("LOGIN", ...)
+ */
+const char *metrics_command_name(MetricCommand cmd);
+
+/**
+ * @brief Record one command execution
+ */
+void metrics_record_command(MetricCommand cmd, uint64_t elapsed_ns);
+
+/**
+ * @brief Record one db_* call
+ */
+void metrics_record_db(MetricDbOp op, uint64_t elapsed_ns);
+
+/**
+ * @brief Sum all thread slabs for one command / db op
+ */
+void metrics_snapshot_command(MetricCommand cmd, MetricsHistogram *out);
+void metrics_snapshot_db(MetricDbOp op, MetricsHistogram *out);
+
+/**
+ * @brief Value at the given percentile (0..100) of a snapshot, in ns
+ */
+uint64_t metrics_percentile(const MetricsHistogram *h, double percentile);
+
+/**
+ * @brief Number of db_* calls currently running (including waiting for the connection)
+ */
+int metrics_db_inflight(void);
+
+// ----------------------------------------------------------------------------
+// Scope timer for db_* functions: one line at the top of the function,
+// recorded automatically on every return path.
+//
+//   int db_create_user(...)
+//   {
+//       METRICS_DB_SCOPE(create_user);
+//       ...
+// ----------------------------------------------------------------------------
+
+typedef struct
+{
+    MetricDbOp op;
+    uint64_t start_ns;
+} MetricsDbTimer;
+
+MetricsDbTimer metrics_db_begin(MetricDbOp op);
+void metrics_db_end(MetricsDbTimer *timer);
+
+#define METRICS_DB_SCOPE(name) \
+    MetricsDbTimer metrics_db_timer_ __attribute__((cleanup(metrics_db_end), unused)) = metrics_db_begin(METRIC_DB_##name)
+
+#endif // METRICS_H
@@ -0,0 +1,244 @@
+#include "ability.h"
+#include "../protocol/protocol.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+typedef struct AbilityEntry
+{
+    char username[MAX_USERNAME_LEN + 1];
+    unsigned char category;
+    unsigned char dirty;             // on the dirty list
+    short rating;
+    int answers;
+    struct AbilityEntry *next;       // hash chain
+    struct AbilityEntry *next_dirty; // changed since the last flush
+} AbilityEntry;
+
+// Categories: filled at startup, read-only afterwards (no lock)
+static char category_names[ABILITY_MAX_CATEGORIES][ABILITY_CATEGORY_MAX + 1];
+static int category_count;
+
+// Entries are only freed by ability_clear, so the writer may keep pointers
+static pthread_mutex_t ability_mutex = PTHREAD_MUTEX_INITIALIZER;
+static AbilityEntry *entries[ABILITY_BUCKETS];
+static AbilityEntry *dirty_head;
+static atomic_int dirty_count;
+
+// Expected score (per mille) of a player rated d above the question, d = 0, 25, .., 800
+static const short EXPECTED_PER_MILLE[] = {500, 536, 571, 606, 640, 673, 703, 733, 760, 785, 808,
+                                           830, 849, 867, 882, 896, 909, 920, 930, 939, 947, 954,
+                                           960, 965, 969, 973, 977, 980, 983, 985, 987, 989, 990};
+
+static int expected_per_mille(int diff)
+{
+    int sign = diff < 0 ? -1 : 1;
+    int d = diff * sign;
+    if (d >= 800)
+        return sign > 0 ? 990 : 10;
+    int i = d / 25;
+    int e = EXPECTED_PER_MILLE[i] + (EXPECTED_PER_MILLE[i + 1] - EXPECTED_PER_MILLE[i]) * (d % 25) / 25;
+    return sign > 0 ? e : 1000 - e;
+}
+
+static unsigned int entry_hash(const char *username, int category)
+{
+    unsigned int h = 2166136261u; // FNV-1a
+    for (; *username; username++)
+        h = (h ^ (unsigned char)*username) * 16777619u;
+    h = (h ^ (unsigned int)category) * 16777619u;
+    return h & (ABILITY_BUCKETS - 1);
+}
+
+// Caller holds ability_mutex
+static AbilityEntry *find_entry(const char *username, int category)
+{
+    for (AbilityEntry *e = entries[entry_hash(username, category)]; e; e = e->next)
+    {
+        if (e->category == category && strcmp(e->username, username) == 0)
+            return e;
+    }
+    return NULL;
+}
+
+// Caller holds ability_mutex
+static AbilityEntry *add_entry(const char *username, int category)
+{
+    AbilityEntry *e = calloc(1, sizeof(AbilityEntry));
+    if (!e)
+        return NULL;
+    snprintf(e->username, sizeof(e->username), "%s", username);
+    e->category = (unsigned char)category;
+    e->rating = ABILITY_INITIAL_RATING;
+    unsigned int b = entry_hash(username, category);
+    e->next = entries[b];
+    entries[b] = e;
+    return e;
+}
+
+// Caller holds ability_mutex
+static void mark_dirty(AbilityEntry *e)
+{
+    if (e->dirty)
+        return;
+    e->dirty = 1;
+    e->next_dirty = dirty_head;
+    dirty_head = e;
+    atomic_fetch_add(&dirty_count, 1);
+}
+
+// ===============================================
+// Categories
+// ===============================================
+
+int ability_category_add(const char *name)
+{
+    int found = ability_category_find(name);
+    if (found >= 0)
+        return found;
+    if (category_count == ABILITY_MAX_CATEGORIES || strlen(name) > ABILITY_CATEGORY_MAX)
+        return -1;
+    strcpy(category_names[category_count], name);
+    return category_count++;
+}
+
+int ability_category_find(const char *name)
+{
+    for (int i = 0; i < category_count; i++)
+    {
+        if (strcasecmp(category_names[i], name) == 0)
+            return i;
+    }
+    return -1;
+}
+
+const char *ability_category_name(int category)
+{
+    return category >= 0 && category < category_count ? category_names[category] : "";
+}
+
+int ability_category_count(void)
+{
+    return category_count;
+}
+
+// ===============================================
+// Ratings
+// ===============================================
+
+static int load_row(void *ctx, const DbAbility *row)
+{
+    (void)ctx;
+    // Categories no longer in the question bank keep their row in the DB
+    int category = ability_category_add(row->category);
+    if (category < 0 || strlen(row->username) > MAX_USERNAME_LEN)
+        return 0;
+
+    AbilityEntry *e = find_entry(row->username, category);
+    if (!e && !(e = add_entry(row->username, category)))
+        return -1;
+    e->rating = (short)(row->rating < ABILITY_MIN_RATING ? ABILITY_MIN_RATING : row->rating > ABILITY_MAX_RATING ? ABILITY_MAX_RATING : row->rating);
+    e->answers = row->answers;
+    return 0;
+}
+
+int ability_load(Database *db)
+{
+    pthread_mutex_lock(&ability_mutex);
+    int rows = db_load_abilities(db, load_row, NULL);
+    pthread_mutex_unlock(&ability_mutex);
+    return rows;
+}
+
+int ability_rating(const char *username, int category)
+{
+    pthread_mutex_lock(&ability_mutex);
+    AbilityEntry *e = find_entry(username, category);
+    int rating = e ? e->rating : ABILITY_INITIAL_RATING;
+    pthread_mutex_unlock(&ability_mutex);
+    return rating;
+}
+
+int ability_update(const char *username, int category, int item_rating, int correct)
+{
+    pthread_mutex_lock(&ability_mutex);
+    AbilityEntry *e = find_entry(username, category);
+    if (!e && !(e = add_entry(username, category)))
+    {
+        pthread_mutex_unlock(&ability_mutex);
+        return ABILITY_INITIAL_RATING; // out of memory: estimate not kept
+    }
+
+    // Elo step: rating += K * (actual - expected)
+    int k = e->answers < ABILITY_PROVISIONAL_ANSWERS ? ABILITY_K_PROVISIONAL : ABILITY_K;
+    int delta = k * ((correct ? 1000 : 0) - expected_per_mille(e->rating - item_rating));
+    int rating = e->rating + (delta >= 0 ? delta + 500 : delta - 500) / 1000;
+    if (rating < ABILITY_MIN_RATING)
+        rating = ABILITY_MIN_RATING;
+    if (rating > ABILITY_MAX_RATING)
+        rating = ABILITY_MAX_RATING;
+    e->rating = (short)rating;
+    e->answers++;
+    mark_dirty(e);
+    pthread_mutex_unlock(&ability_mutex);
+    return rating;
+}
+
+int ability_dirty_count(void)
+{
+    return atomic_load(&dirty_count);
+}
+
+int ability_flush(Database *db)
+{
+    static AbilityEntry *taken[ABILITY_WRITE_BATCH]; // writer thread only
+    DbAbility rows[ABILITY_WRITE_BATCH];
+
+    pthread_mutex_lock(&ability_mutex);
+    int count = 0;
+    while (dirty_head && count < ABILITY_WRITE_BATCH)
+    {
+        AbilityEntry *e = dirty_head;
+        dirty_head = e->next_dirty;
+        e->dirty = 0;
+        taken[count] = e;
+        rows[count] = (DbAbility){e->username, category_names[e->category], e->rating, e->answers};
+        count++;
+    }
+    atomic_fetch_sub(&dirty_count, count);
+    pthread_mutex_unlock(&ability_mutex);
+    if (count == 0)
+        return 0;
+
+    if (db_save_abilities(db, rows, count) < 0)
+    {
+        // Written again next time (entries updated meanwhile are dirty already)
+        pthread_mutex_lock(&ability_mutex);
+        for (int i = 0; i < count; i++)
+            mark_dirty(taken[i]);
+        pthread_mutex_unlock(&ability_mutex);
+        return -1;
+    }
+    return count;
+}
+
+void ability_clear(void)
+{
+    pthread_mutex_lock(&ability_mutex);
+    for (int b = 0; b < ABILITY_BUCKETS; b++)
+    {
+        while (entries[b])
+        {
+            AbilityEntry *next = entries[b]->next;
+            free(entries[b]);
+            entries[b] = next;
+        }
+    }
+    dirty_head = NULL;
+    atomic_store(&dirty_count, 0);
+    pthread_mutex_unlock(&ability_mutex);
+    category_count = 0;
+}
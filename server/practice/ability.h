@@ -0,0 +1,85 @@
+#ifndef ABILITY_H
+#define ABILITY_H
+
+#include "../database/database.h"
+
+// ===============================================
+// ABILITY - năng lực luyện tập theo (user, chủ đề), thang Elo
+// ===============================================
+//
+// One entry per (username, category) in a hash table that lives for the
+// whole run: read once at startup (db_load_abilities), updated in memory by
+// PRACTICE_ANSWER, and written back in batches by the practice writer thread
+// (ability_flush). A rating is on the question scale of practice.c: 1500 is
+// a user who answers a medium question right half the time. A crash loses
+// the updates since the last flush.
+
+#define ABILITY_BUCKETS 4096          // power of 2
+#define ABILITY_MAX_CATEGORIES 64     // distinct question categories (fixed after startup)
+#define ABILITY_CATEGORY_MAX 50       // practice_abilities.category VARCHAR(50)
+#define ABILITY_INITIAL_RATING 1500
+#define ABILITY_MIN_RATING 100
+#define ABILITY_MAX_RATING 3000
+#define ABILITY_K_PROVISIONAL 40      // K-factor for the first answers: converge fast
+#define ABILITY_K 20                  // K-factor afterwards
+#define ABILITY_PROVISIONAL_ANSWERS 20
+#define ABILITY_WRITE_BATCH 256       // rows per db_save_abilities
+
+/**
+ * @brief Thêm chủ đề (chỉ gọi lúc khởi động, trước khi có client)
+ * @return id chủ đề (0..ABILITY_MAX_CATEGORIES-1), -1 nếu bảng chủ đề đã đầy
+ */
+int ability_category_add(const char *name);
+
+/**
+ * @brief Tìm chủ đề theo tên (không phân biệt hoa thường)
+ * @return id chủ đề, -1 nếu không có
+ */
+int ability_category_find(const char *name);
+
+/**
+ * @brief Tên chủ đề theo id
+ */
+const char *ability_category_name(int category);
+
+/**
+ * @brief Số chủ đề đã thêm
+ */
+int ability_category_count(void);
+
+/**
+ * @brief Nạp năng lực đã lưu (gọi lúc khởi động, sau khi thêm chủ đề của ngân hàng câu hỏi)
+ * @return Số dòng đã nạp, -1 nếu lỗi DB
+ */
+int ability_load(Database *db);
+
+/**
+ * @brief Năng lực hiện tại của user trong chủ đề (ABILITY_INITIAL_RATING nếu chưa có)
+ */
+int ability_rating(const char *username, int category);
+
+/**
+ * @brief Cập nhật năng lực sau một câu trả lời (một bước Elo), đánh dấu cần ghi DB
+ * @param item_rating Độ khó của câu hỏi (cùng thang)
+ * @param correct 1 nếu trả lời đúng
+ * @return Năng lực mới
+ */
+int ability_update(const char *username, int category, int item_rating, int correct);
+
+/**
+ * @brief Số dòng đã thay đổi, chưa ghi DB
+ */
+int ability_dirty_count(void);
+
+/**
+ * @brief Ghi tối đa ABILITY_WRITE_BATCH dòng đã thay đổi (writer thread)
+ * @return Số dòng đã ghi, -1 nếu lỗi DB (các dòng được ghi lại lần sau)
+ */
+int ability_flush(Database *db);
+
+/**
+ * @brief Giải phóng bảng năng lực (sau khi writer thread đã dừng)
+ */
+void ability_clear(void);
+
+#endif // ABILITY_H
@@ -0,0 +1,846 @@
+#include "practice.h"
+#include "ability.h"
+#include "../server.h"
+#include "../auth/auth.h"
+#include "../exam/exam.h"
+#include "../exam/exam_timer.h"
+#include "../database/db_json.h"
+#include "../metrics/metrics.h"
+#include "../logger/logger.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+typedef struct
+{
+    int id;
+    char correct_answer;
+    short rating;   // PRACTICE_RATING_* of its difficulty, on the ability scale
+    short category; // ability category, -1 if the category table is full
+    char *json;     // GET_EXAM entry (db_json_questions_add), rendered once
+} PracticeQuestion;
+
+// Bank indexes of one category sorted by (rating, id): PRACTICE_NEXT binary-searches it
+typedef struct
+{
+    int *items;
+    int count;
+} CategoryIndex;
+
+typedef struct PracticeSession
+{
+    char username[MAX_USERNAME_LEN + 1];
+    char practice_id[MAX_ROOM_ID_LEN];
+    struct PracticeSession *next; // hash chain
+    int question_count;
+    int questions[PRACTICE_MAX_QUESTIONS]; // indexes into bank (PRACTICE_NEXT: ring of the last ones asked)
+    int time_limit;                        // minutes
+    time_t start_time;
+    int category; // PRACTICE_NEXT session: ability category; -1 for PRACTICE
+    int pending;  // PRACTICE_NEXT session: bank index waiting for PRACTICE_ANSWER, -1 if none
+    int score;    // PRACTICE_NEXT session: correct answers so far
+} PracticeSession;
+
+typedef struct
+{
+    char practice_id[MAX_ROOM_ID_LEN];
+    char username[MAX_USERNAME_LEN + 1];
+    int num_questions;
+    int time_limit;
+    int score;
+    long long start_time;
+} PracticeScore;
+
+// Question bank: filled by practice_start, read-only afterwards (no lock)
+static PracticeQuestion *bank;
+static int bank_count;
+static CategoryIndex category_index[ABILITY_MAX_CATEGORIES];
+
+// Active sessions; bank_order is shuffled in place under the same lock
+static pthread_mutex_t sessions_mutex = PTHREAD_MUTEX_INITIALIZER;
+static PracticeSession *sessions[PRACTICE_SESSION_BUCKETS];
+static int *bank_order;
+static unsigned int rand_seed;
+static atomic_uint practice_seq;
+
+// Scores waiting for the writer (ring buffer)
+static pthread_mutex_t queue_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t queue_cond = PTHREAD_COND_INITIALIZER;
+static PracticeScore queue[PRACTICE_QUEUE_SIZE];
+static int queue_head;
+static int queue_count;
+static unsigned long long queue_dropped;
+static int writer_running;
+static pthread_t writer_thread;
+static Database *writer_db;
+
+static unsigned int hash_string(const char *s)
+{
+    unsigned int h = 2166136261u; // FNV-1a
+    while (*s)
+    {
+        h ^= (unsigned char)*s++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// Caller holds sessions_mutex
+static PracticeSession **find_session_slot(const char *username)
+{
+    PracticeSession **slot = &sessions[hash_string(username) % PRACTICE_SESSION_BUCKETS];
+    while (*slot && strcmp((*slot)->username, username) != 0)
+        slot = &(*slot)->next;
+    return slot;
+}
+
+// ===============================================
+// Question bank
+// ===============================================
+
+static int bank_add(void *ctx, const DbQuestion *q)
+{
+    int *capacity = ctx;
+    if (q->correct_answer < 'A' || q->correct_answer > 'D')
+        return 0; // CHECK constraint: never graded
+
+    if (bank_count == *capacity)
+    {
+        int grown_capacity = *capacity ? *capacity * 2 : 256;
+        PracticeQuestion *grown = realloc(bank, (size_t)grown_capacity * sizeof(*bank));
+        if (!grown)
+            return -1;
+        bank = grown;
+        *capacity = grown_capacity;
+    }
+
+    // Same entry as GET_EXAM, so clients reuse their exam display
+    char id[16];
+    char entry[4096 + DB_JSON_TAIL_RESERVE + 2];
+    snprintf(id, sizeof(id), "%d", q->id);
+    char *row[6] = {id, (char *)q->text, (char *)q->options[0], (char *)q->options[1], (char *)q->options[2], (char *)q->options[3]};
+    entry[0] = '\0';
+    db_json_questions_add(entry, row, 1);
+
+    PracticeQuestion *question = &bank[bank_count];
+    question->id = q->id;
+    question->correct_answer = q->correct_answer;
+    question->rating = strcmp(q->difficulty, "easy") == 0   ? PRACTICE_RATING_EASY
+                       : strcmp(q->difficulty, "hard") == 0 ? PRACTICE_RATING_HARD
+                                                            : PRACTICE_RATING_MEDIUM;
+    question->category = (short)ability_category_add(q->category ? q->category : PRACTICE_DEFAULT_CATEGORY);
+    question->json = strdup(entry);
+    if (!question->json)
+        return -1;
+    bank_count++;
+    return 0;
+}
+
+// Caller holds sessions_mutex. Partial Fisher-Yates on bank_order: the first
+// count slots are a uniform sample whatever order earlier draws left behind.
+static void draw_questions(int *out, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        int j = i + rand_r(&rand_seed) % (bank_count - i);
+        int tmp = bank_order[i];
+        bank_order[i] = bank_order[j];
+        bank_order[j] = tmp;
+        out[i] = bank_order[i];
+    }
+}
+
+static int compare_rating(const void *a, const void *b)
+{
+    const PracticeQuestion *qa = &bank[*(const int *)a];
+    const PracticeQuestion *qb = &bank[*(const int *)b];
+    if (qa->rating != qb->rating)
+        return qa->rating - qb->rating;
+    return qa->id - qb->id;
+}
+
+static int build_category_index(void)
+{
+    int sizes[ABILITY_MAX_CATEGORIES] = {0};
+    for (int i = 0; i < bank_count; i++)
+    {
+        if (bank[i].category >= 0)
+            sizes[bank[i].category]++;
+    }
+    for (int c = 0; c < ABILITY_MAX_CATEGORIES; c++)
+    {
+        if (sizes[c] > 0 && !(category_index[c].items = malloc((size_t)sizes[c] * sizeof(int))))
+            return -1;
+    }
+    for (int i = 0; i < bank_count; i++)
+    {
+        if (bank[i].category >= 0)
+        {
+            CategoryIndex *index = &category_index[bank[i].category];
+            index->items[index->count++] = i;
+        }
+    }
+    for (int c = 0; c < ABILITY_MAX_CATEGORIES; c++)
+    {
+        if (category_index[c].count > 1)
+            qsort(category_index[c].items, (size_t)category_index[c].count, sizeof(int), compare_rating);
+    }
+    return 0;
+}
+
+// First position of index rated >= rating
+static int lower_bound(const CategoryIndex *index, int rating)
+{
+    int lo = 0;
+    int hi = index->count;
+    while (lo < hi)
+    {
+        int mid = lo + (hi - lo) / 2;
+        if (bank[index->items[mid]].rating < rating)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+// Among the last window questions of the ring
+static int recently_asked(const PracticeSession *session, int question, int window)
+{
+    for (int i = 1; i <= window; i++)
+    {
+        if (session->questions[(session->question_count - i) % PRACTICE_MAX_QUESTIONS] == question)
+            return 1;
+    }
+    return 0;
+}
+
+// Caller holds sessions_mutex. Binary search for the questions rated closest
+// to the (jittered) ability, a random one of them, else the nearest question
+// not asked recently. The window leaves half the category to choose from.
+static int pick_question(const PracticeSession *session, int ability)
+{
+    const CategoryIndex *index = &category_index[session->category];
+    int window = session->question_count < PRACTICE_MAX_QUESTIONS ? session->question_count : PRACTICE_MAX_QUESTIONS;
+    if (window > index->count / 2)
+        window = index->count / 2;
+    int target = ability + rand_r(&rand_seed) % (2 * PRACTICE_RATING_JITTER + 1) - PRACTICE_RATING_JITTER;
+    int pos = lower_bound(index, target);
+    if (pos == index->count ||
+        (pos > 0 && target - bank[index->items[pos - 1]].rating <= bank[index->items[pos]].rating - target))
+        pos--;
+
+    int rating = bank[index->items[pos]].rating;
+    int first = lower_bound(index, rating);
+    int start = first + rand_r(&rand_seed) % (lower_bound(index, rating + 1) - first);
+
+    // start, start+1, start-1, start+2, ...: same rating first, then the neighbours
+    for (int step = 0; step < 2 * index->count; step++)
+    {
+        int probe = step % 2 ? start + (step + 1) / 2 : start - step / 2;
+        if (probe >= 0 && probe < index->count && !recently_asked(session, index->items[probe], window))
+            return index->items[probe];
+    }
+    return index->items[start]; // not reached
+}
+
+// {"practice_id":..,"time_limit_minutes":..,"questions":[...]} (malloc'd)
+static char *session_json(const PracticeSession *session, size_t *len_out)
+{
+    size_t size = 256;
+    for (int i = 0; i < session->question_count; i++)
+        size += strlen(bank[session->questions[i]].json) + 2;
+
+    char *json = malloc(size);
+    if (!json)
+        return NULL;
+    size_t len = (size_t)snprintf(json, size, "{\n  \"practice_id\": \"%s\",\n  \"time_limit_minutes\": %d,\n  \"questions\": [\n",
+                                  session->practice_id, session->time_limit);
+    for (int i = 0; i < session->question_count; i++)
+    {
+        const char *entry = bank[session->questions[i]].json;
+        size_t entry_len = strlen(entry);
+        if (i > 0)
+        {
+            memcpy(json + len, ",\n", 2);
+            len += 2;
+        }
+        memcpy(json + len, entry, entry_len);
+        len += entry_len;
+    }
+    len += (size_t)snprintf(json + len, size - len, "\n  ]\n}");
+    *len_out = len;
+    return json;
+}
+
+// {"practice_id":..,"category":..,"rating":..,"questions":[<pending question>]} (malloc'd)
+static char *next_json(const PracticeSession *session, int rating, size_t *len_out)
+{
+    const char *entry = bank[session->pending].json;
+    size_t size = strlen(entry) + ABILITY_CATEGORY_MAX + 256;
+    char *json = malloc(size);
+    if (!json)
+        return NULL;
+    *len_out = (size_t)snprintf(json, size, "{\n  \"practice_id\": \"%s\",\n  \"category\": \"%s\",\n  \"rating\": %d,\n  \"questions\": [\n%s\n  ]\n}",
+                                session->practice_id, ability_category_name(session->category), rating, entry);
+    return json;
+}
+
+// ===============================================
+// Score writer
+// ===============================================
+
+static void enqueue_score(const PracticeSession *session, int score)
+{
+    pthread_mutex_lock(&queue_mutex);
+    if (queue_count == PRACTICE_QUEUE_SIZE)
+    {
+        // DB down for a long time: keep the newest scores
+        queue_head = (queue_head + 1) % PRACTICE_QUEUE_SIZE;
+        queue_count--;
+        queue_dropped++;
+    }
+    PracticeScore *entry = &queue[(queue_head + queue_count) % PRACTICE_QUEUE_SIZE];
+    snprintf(entry->practice_id, sizeof(entry->practice_id), "%s", session->practice_id);
+    snprintf(entry->username, sizeof(entry->username), "%s", session->username);
+    entry->num_questions = session->question_count;
+    entry->time_limit = session->time_limit;
+    entry->score = score;
+    entry->start_time = (long long)session->start_time;
+    queue_count++;
+    if (queue_count >= PRACTICE_WRITE_BATCH)
+        pthread_cond_signal(&queue_cond);
+    pthread_mutex_unlock(&queue_mutex);
+}
+
+// Write up to one batch from the head of the queue; 0 when committed (or nothing to do)
+static int flush_batch(void)
+{
+    static PracticeScore batch[PRACTICE_WRITE_BATCH]; // writer thread only
+    DbPracticeResult results[PRACTICE_WRITE_BATCH];
+
+    pthread_mutex_lock(&queue_mutex);
+    int count = queue_count < PRACTICE_WRITE_BATCH ? queue_count : PRACTICE_WRITE_BATCH;
+    for (int i = 0; i < count; i++)
+        batch[i] = queue[(queue_head + i) % PRACTICE_QUEUE_SIZE];
+    pthread_mutex_unlock(&queue_mutex);
+    if (count == 0)
+        return 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        results[i] = (DbPracticeResult){batch[i].practice_id, batch[i].username, batch[i].num_questions,
+                                        batch[i].time_limit, batch[i].score, batch[i].start_time};
+    }
+    if (db_save_practice_results(writer_db, results, count) < 0)
+        return -1;
+
+    // Dequeue what was written; entries dropped meanwhile (queue full) shifted the head
+    pthread_mutex_lock(&queue_mutex);
+    int written = 0;
+    while (written < count && queue_count > 0 &&
+           strcmp(queue[queue_head].practice_id, batch[written].practice_id) == 0)
+    {
+        queue_head = (queue_head + 1) % PRACTICE_QUEUE_SIZE;
+        queue_count--;
+        written++;
+    }
+    pthread_mutex_unlock(&queue_mutex);
+    return 0;
+}
+
+static void *writer_loop(void *arg)
+{
+    (void)arg;
+    pthread_mutex_lock(&queue_mutex);
+    while (writer_running)
+    {
+        struct timespec wake;
+        clock_gettime(CLOCK_REALTIME, &wake);
+        wake.tv_sec += PRACTICE_WRITE_INTERVAL_MS / 1000;
+        wake.tv_nsec += (PRACTICE_WRITE_INTERVAL_MS % 1000) * 1000000L;
+        if (wake.tv_nsec >= 1000000000L)
+        {
+            wake.tv_sec++;
+            wake.tv_nsec -= 1000000000L;
+        }
+        if (queue_count < PRACTICE_WRITE_BATCH)
+            pthread_cond_timedwait(&queue_cond, &queue_mutex, &wake);
+        if (!writer_running || (queue_count == 0 && ability_dirty_count() == 0))
+            continue;
+
+        // Exams first: wait for an idle database unless the queue is filling up
+        if (metrics_db_inflight() > 0 && queue_count < PRACTICE_QUEUE_SIZE / 2)
+            continue;
+        pthread_mutex_unlock(&queue_mutex);
+
+        if (flush_batch() < 0)
+            log_event(LOG_WARNING, NULL, "PRACTICE", "Failed to save practice scores, retrying");
+        if (ability_flush(writer_db) < 0)
+            log_event(LOG_WARNING, NULL, "PRACTICE", "Failed to save practice abilities, retrying");
+
+        pthread_mutex_lock(&queue_mutex);
+    }
+    pthread_mutex_unlock(&queue_mutex);
+    return NULL;
+}
+
+// ===============================================
+// API
+// ===============================================
+
+int practice_start(Database *db)
+{
+    int capacity = 0;
+    if (db_load_questions(db, bank_add, &capacity) < 0 || bank_count == 0)
+    {
+        fprintf(stderr, "Practice question bank unavailable\n");
+        log_event(LOG_WARNING, NULL, "PRACTICE", "Question bank unavailable, PRACTICE disabled");
+    }
+    if (bank_count > 0)
+    {
+        bank_order = malloc((size_t)bank_count * sizeof(int));
+        if (!bank_order || build_category_index() < 0)
+            return -1;
+        for (int i = 0; i < bank_count; i++)
+            bank_order[i] = i;
+    }
+    int abilities = ability_load(db);
+    if (abilities < 0)
+        log_event(LOG_WARNING, NULL, "PRACTICE", "Failed to load practice abilities, starting from %d", ABILITY_INITIAL_RATING);
+    rand_seed = (unsigned int)time(NULL) ^ (unsigned int)getpid();
+
+    writer_db = db;
+    writer_running = 1;
+    if (pthread_create(&writer_thread, NULL, writer_loop, NULL) != 0)
+    {
+        writer_running = 0;
+        return -1;
+    }
+    printf("Practice question bank: %d question(s), %d categories, %d ability estimate(s) in memory\n",
+           bank_count, ability_category_count(), abilities > 0 ? abilities : 0);
+    return 0;
+}
+
+void practice_stop(void)
+{
+    pthread_mutex_lock(&queue_mutex);
+    int running = writer_running;
+    writer_running = 0;
+    pthread_cond_signal(&queue_cond);
+    pthread_mutex_unlock(&queue_mutex);
+    if (!running)
+        return;
+    pthread_join(writer_thread, NULL);
+
+    // Last scores: the database is still connected
+    int pending;
+    do
+    {
+        pthread_mutex_lock(&queue_mutex);
+        pending = queue_count;
+        pthread_mutex_unlock(&queue_mutex);
+    } while (pending > 0 && flush_batch() == 0);
+    if (pending > 0 || queue_dropped > 0)
+        log_event(LOG_WARNING, NULL, "PRACTICE", "%d practice score(s) not saved, %llu dropped", pending, queue_dropped);
+    while (ability_flush(writer_db) > 0)
+        ;
+    if (ability_dirty_count() > 0)
+        log_event(LOG_WARNING, NULL, "PRACTICE", "%d practice abilities not saved", ability_dirty_count());
+    ability_clear();
+
+    pthread_mutex_lock(&sessions_mutex);
+    for (int i = 0; i < PRACTICE_SESSION_BUCKETS; i++)
+    {
+        while (sessions[i])
+        {
+            PracticeSession *next = sessions[i]->next;
+            free(sessions[i]);
+            sessions[i] = next;
+        }
+    }
+    pthread_mutex_unlock(&sessions_mutex);
+    for (int i = 0; i < bank_count; i++)
+        free(bank[i].json);
+    free(bank);
+    free(bank_order);
+    for (int c = 0; c < ABILITY_MAX_CATEGORIES; c++)
+    {
+        free(category_index[c].items);
+        category_index[c].items = NULL;
+        category_index[c].count = 0;
+    }
+    bank = NULL;
+    bank_order = NULL;
+    bank_count = 0;
+}
+
+// Remove the user's session if it is still practice_id; 0 if removed
+static int take_session(const char *username, const char *practice_id)
+{
+    pthread_mutex_lock(&sessions_mutex);
+    PracticeSession **slot = find_session_slot(username);
+    PracticeSession *session = *slot;
+    int found = session && strcmp(session->practice_id, practice_id) == 0;
+    if (found)
+    {
+        *slot = session->next;
+        free(session);
+    }
+    pthread_mutex_unlock(&sessions_mutex);
+    return found ? 0 : -1;
+}
+
+void practice_discard(const char *username)
+{
+    pthread_mutex_lock(&sessions_mutex);
+    PracticeSession **slot = find_session_slot(username);
+    PracticeSession *session = *slot;
+    if (session)
+    {
+        *slot = session->next;
+        free(session);
+    }
+    pthread_mutex_unlock(&sessions_mutex);
+}
+
+static PracticeSession *new_session(const char *username, int time_limit)
+{
+    PracticeSession *session = calloc(1, sizeof(PracticeSession));
+    if (!session)
+        return NULL;
+    snprintf(session->username, sizeof(session->username), "%s", username);
+    snprintf(session->practice_id, sizeof(session->practice_id), "P%ld%04u", (long)time(NULL), atomic_fetch_add(&practice_seq, 1) % 10000);
+    session->time_limit = time_limit;
+    session->start_time = time(NULL);
+    session->category = -1;
+    session->pending = -1;
+    return session;
+}
+
+// Caller holds sessions_mutex. A new session replaces the unfinished one
+static void insert_session(PracticeSession *session)
+{
+    PracticeSession **slot = find_session_slot(session->username);
+    if (*slot)
+    {
+        PracticeSession *old = *slot;
+        *slot = old->next;
+        free(old);
+    }
+    unsigned int b = hash_string(session->username) % PRACTICE_SESSION_BUCKETS;
+    session->next = sessions[b];
+    sessions[b] = session;
+}
+
+// 140 DATA <length>\n<JSON>; 0 if sent
+static int send_practice_data(ClientSession *client, const char *json, size_t json_len)
+{
+    return json ? send_data_message(client, CODE_DATA, json, json_len) : -1;
+}
+
+/**
+ * @brief Handle PRACTICE command
+ */
+void handle_practice(Server *server, ClientSession *client, Message *msg)
+{
+    (void)server;
+
+    // Check authentication
+    if (!check_authentication(client))
+    {
+        send_error_or_response(client->socket_fd, CODE_NOT_LOGGED, "Not authenticated");
+        return;
+    }
+
+    if (client->state == STATE_IN_ROOM || client->state == STATE_IN_EXAM)
+    {
+        send_error_or_response(client->socket_fd, CODE_INVALID_STATE, "Leave the room before practicing");
+        return;
+    }
+
+    // Params: [num_questions[|time_limit_minutes]]
+    int num_questions = msg->param_count > 0 && msg->params[0][0] ? atoi(msg->params[0]) : PRACTICE_DEFAULT_QUESTIONS;
+    int time_limit = msg->param_count > 1 ? atoi(msg->params[1]) : num_questions; // 1 minute per question
+    if (num_questions <= 0 || num_questions > PRACTICE_MAX_QUESTIONS || time_limit <= 0)
+    {
+        send_error_or_response(client->socket_fd, CODE_INVALID_PARAMS, "Usage: PRACTICE [num_questions(1-50)[|time_limit_minutes]]");
+        return;
+    }
+    if (bank_count == 0)
+    {
+        send_error_or_response(client->socket_fd, CODE_INTERNAL_ERROR, "Practice unavailable");
+        return;
+    }
+    if (num_questions > bank_count)
+        num_questions = bank_count;
+
+    PracticeSession *session = new_session(client->username, time_limit);
+    if (!session)
+    {
+        send_error_or_response(client->socket_fd, CODE_INTERNAL_ERROR, "Out of memory");
+        return;
+    }
+    session->question_count = num_questions;
+
+    pthread_mutex_lock(&sessions_mutex);
+    draw_questions(session->questions, num_questions);
+    insert_session(session);
+
+    size_t json_len = 0;
+    char *json = session_json(session, &json_len);
+    pthread_mutex_unlock(&sessions_mutex);
+
+    // Send response: 140 DATA <length>\n<JSON>
+    if (send_practice_data(client, json, json_len) == 0)
+    {
+        client->state = STATE_IN_PRACTICE;
+        log_event(LOG_INFO, client->username, "PRACTICE", "%d questions, %d min", num_questions, time_limit); // not db_log_activity: no DB traffic
+    }
+    else
+    {
+        practice_discard(client->username);
+        send_error_or_response(client->socket_fd, CODE_INTERNAL_ERROR, "Failed to build practice");
+    }
+    free(json);
+}
+
+/**
+ * @brief Handle SUBMIT_PRACTICE command
+ */
+void handle_submit_practice(Server *server, ClientSession *client, Message *msg)
+{
+    (void)server;
+
+    // Check authentication
+    if (!check_authentication(client))
+    {
+        send_error_or_response(client->socket_fd, CODE_NOT_LOGGED, "Not authenticated");
+        return;
+    }
+
+    if (msg->param_count < 2)
+    {
+        send_error_or_response(client->socket_fd, CODE_SYNTAX_ERROR, "Usage: SUBMIT_PRACTICE practice_id|answers");
+        return;
+    }
+    const char *practice_id = msg->params[0];
+    const char *answers = msg->params[1];
+
+    // Grade a copy; the session is removed only once the submission is accepted
+    PracticeSession session;
+    pthread_mutex_lock(&sessions_mutex);
+    PracticeSession *found = *find_session_slot(client->username);
+    int exists = found && found->category < 0 && strcmp(found->practice_id, practice_id) == 0;
+    if (exists)
+        session = *found;
+    pthread_mutex_unlock(&sessions_mutex);
+
+    if (!exists)
+    {
+        send_error_or_response(client->socket_fd, CODE_INVALID_PARAMS, "No such practice");
+        return;
+    }
+
+    // Same grace period as exams
+    if (time(NULL) > session.start_time + (time_t)session.time_limit * 60 + EXAM_TIMER_GRACE_SEC)
+    {
+        take_session(client->username, practice_id);
+        if (client->state == STATE_IN_PRACTICE)
+            client->state = STATE_AUTHENTICATED;
+        send_error_or_response(client->socket_fd, CODE_TIME_EXPIRED, practice_id);
+        log_event(LOG_INFO, client->username, "SUBMIT_PRACTICE", "Time expired (%s)", practice_id);
+        return;
+    }
+
+    char correct[PRACTICE_MAX_QUESTIONS + 1];
+    for (int i = 0; i < session.question_count; i++)
+        correct[i] = bank[session.questions[i]].correct_answer;
+    correct[session.question_count] = '\0';
+
+    int answered = 0;
+    int score = grade_answers(answers, correct, session.question_count, &answered);
+    if (answered != session.question_count)
+    {
+        char error[128];
+        snprintf(error, sizeof(error), "Expected %d answers, got %d", session.question_count, answered);
+        send_error_or_response(client->socket_fd, CODE_INVALID_PARAMS, error);
+        return;
+    }
+
+    // Concurrent SUBMIT_PRACTICE / PRACTICE of the same user: only one is graded
+    if (take_session(client->username, practice_id) < 0)
+    {
+        send_error_or_response(client->socket_fd, CODE_INVALID_PARAMS, "No such practice");
+        return;
+    }
+    if (client->state == STATE_IN_PRACTICE)
+        client->state = STATE_AUTHENTICATED;
+    enqueue_score(&session, score);
+
+    // Send response: 141 score|total|A,B,C,... (correct answers)
+    char response[256];
+    int len = snprintf(response, sizeof(response), "%d|%d|", score, session.question_count);
+    for (int i = 0; i < session.question_count; i++)
+        len += snprintf(response + len, sizeof(response) - len, i ? ",%c" : "%c", correct[i]);
+    send_error_or_response(client->socket_fd, CODE_PRACTICE_RESULT, response);
+
+    // File log only: practice stays off the database
+    log_event(LOG_INFO, client->username, "SUBMIT_PRACTICE", "Score: %d/%d", score, session.question_count);
+}
+
+// 302 with the categories PRACTICE_NEXT accepts
+static void send_categories(ClientSession *client, const char *error)
+{
+    char message[1024];
+    int len = snprintf(message, sizeof(message), "%s. Categories: ", error);
+    for (int c = 0, listed = 0; c < ability_category_count() && len < (int)sizeof(message); c++)
+    {
+        if (category_index[c].count > 0)
+            len += snprintf(message + len, sizeof(message) - len, listed++ ? ", %s" : "%s", ability_category_name(c));
+    }
+    send_error_or_response(client->socket_fd, CODE_INVALID_PARAMS, message);
+}
+
+/**
+ * @brief Handle PRACTICE_NEXT command
+ */
+void handle_practice_next(Server *server, ClientSession *client, Message *msg)
+{
+    (void)server;
+
+    // Check authentication
+    if (!check_authentication(client))
+    {
+        send_error_or_response(client->socket_fd, CODE_NOT_LOGGED, "Not authenticated");
+        return;
+    }
+
+    if (client->state == STATE_IN_ROOM || client->state == STATE_IN_EXAM)
+    {
+        send_error_or_response(client->socket_fd, CODE_INVALID_STATE, "Leave the room before practicing");
+        return;
+    }
+
+    // Params: [category] (required to start, optional to continue)
+    int category = -1;
+    if (msg->param_count > 0 && msg->params[0][0])
+    {
+        category = ability_category_find(msg->params[0]);
+        if (category < 0 || category_index[category].count == 0)
+        {
+            send_categories(client, "Unknown category");
+            return;
+        }
+    }
+
+    pthread_mutex_lock(&sessions_mutex);
+    PracticeSession *session = *find_session_slot(client->username);
+    if (!session || session->category < 0 || (category >= 0 && category != session->category))
+    {
+        if (category < 0)
+        {
+            pthread_mutex_unlock(&sessions_mutex);
+            send_categories(client, "Usage: PRACTICE_NEXT category");
+            return;
+        }
+        if (!(session = new_session(client->username, 0)))
+        {
+            pthread_mutex_unlock(&sessions_mutex);
+            send_error_or_response(client->socket_fd, CODE_INTERNAL_ERROR, "Out of memory");
+            return;
+        }
+        session->category = category;
+        insert_session(session);
+    }
+
+    // Asking again before PRACTICE_ANSWER returns the same question
+    int rating = ability_rating(client->username, session->category);
+    if (session->pending < 0)
+    {
+        session->pending = pick_question(session, rating);
+        session->questions[session->question_count % PRACTICE_MAX_QUESTIONS] = session->pending;
+        session->question_count++;
+    }
+    int asked = session->question_count;
+    size_t json_len = 0;
+    char *json = next_json(session, rating, &json_len);
+    pthread_mutex_unlock(&sessions_mutex);
+
+    // Send response: 140 DATA <length>\n<JSON>
+    if (send_practice_data(client, json, json_len) == 0)
+    {
+        client->state = STATE_IN_PRACTICE;
+        log_event(LOG_INFO, client->username, "PRACTICE_NEXT", "Question %d, rating %d", asked, rating);
+    }
+    else
+    {
+        send_error_or_response(client->socket_fd, CODE_INTERNAL_ERROR, "Failed to build practice");
+    }
+    free(json);
+}
+
+/**
+ * @brief Handle PRACTICE_ANSWER command
+ */
+void handle_practice_answer(Server *server, ClientSession *client, Message *msg)
+{
+    (void)server;
+
+    // Check authentication
+    if (!check_authentication(client))
+    {
+        send_error_or_response(client->socket_fd, CODE_NOT_LOGGED, "Not authenticated");
+        return;
+    }
+
+    if (msg->param_count < 2)
+    {
+        send_error_or_response(client->socket_fd, CODE_SYNTAX_ERROR, "Usage: PRACTICE_ANSWER practice_id|answer");
+        return;
+    }
+    const char *practice_id = msg->params[0];
+    const char *answer = msg->params[1];
+    while (*answer == ' ')
+        answer++;
+    if (answer[0] < 'A' || answer[0] > 'D')
+    {
+        send_error_or_response(client->socket_fd, CODE_INVALID_PARAMS, "Answer must be A, B, C or D");
+        return;
+    }
+
+    // Grade under the lock: concurrent answers to one question count once
+    pthread_mutex_lock(&sessions_mutex);
+    PracticeSession *session = *find_session_slot(client->username);
+    if (!session || session->category < 0 || session->pending < 0 || strcmp(session->practice_id, practice_id) != 0)
+    {
+        pthread_mutex_unlock(&sessions_mutex);
+        send_error_or_response(client->socket_fd, CODE_INVALID_PARAMS, "No pending practice question");
+        return;
+    }
+    const PracticeQuestion *question = &bank[session->pending];
+    int correct = answer[0] == question->correct_answer;
+    char correct_answer = question->correct_answer;
+    int item_rating = question->rating;
+    int category = session->category;
+    session->pending = -1;
+    session->score += correct;
+    int score = session->score;
+    int asked = session->question_count;
+    pthread_mutex_unlock(&sessions_mutex);
+
+    int rating = ability_update(client->username, category, item_rating, correct);
+
+    // Send response: 141 correct(0/1)|1|correct answer|new rating
+    char response[64];
+    snprintf(response, sizeof(response), "%d|1|%c|%d", correct, correct_answer, rating);
+    send_error_or_response(client->socket_fd, CODE_PRACTICE_RESULT, response);
+
+    // File log only: abilities reach the database through the writer
+    log_event(LOG_INFO, client->username, "PRACTICE_ANSWER", "%s: %d/%d, rating %d",
+              ability_category_name(category), score, asked, rating);
+}
@@ -0,0 +1,115 @@
+#ifndef PRACTICE_H
+#define PRACTICE_H
+
+#include "../protocol/protocol.h"
+#include "../database/database.h"
+
+typedef struct ClientSession ClientSession;
+typedef struct Server Server;
+
+// ===============================================
+// PRACTICE - luyện tập, chạy hoàn toàn trong bộ nhớ
+// ===============================================
+//
+// The question bank is read once at startup (db_load_questions); PRACTICE
+// draws questions from it and SUBMIT_PRACTICE grades against it, so neither
+// command touches the database. Only the final score is persisted, by a
+// writer thread that batches practice_sessions rows and backs off while
+// other db_* calls (live exams) are running. A crash loses the scores still
+// queued; practice scores are not exam results.
+//
+// PRACTICE_NEXT / PRACTICE_ANSWER is the adaptive mode: one question at a
+// time from a category, rated by difficulty, picked by binary search near the
+// user's ability in that category (ability.h), which each answer moves by one
+// Elo step. The same writer thread persists the changed abilities.
+
+#define PRACTICE_MAX_QUESTIONS 50       // like CREATE_ROOM (MAX_PARTICIPANTS rooms draw at most 50)
+#define PRACTICE_DEFAULT_QUESTIONS 10
+#define PRACTICE_SESSION_BUCKETS 1024   // active sessions, keyed by username
+#define PRACTICE_QUEUE_SIZE 4096        // finished sessions waiting for the writer (oldest dropped when full)
+#define PRACTICE_WRITE_BATCH 256        // rows per db_save_practice_results
+#define PRACTICE_WRITE_INTERVAL_MS 1000 // writer wake-up period
+#define PRACTICE_RATING_EASY 1300       // question ratings (ability scale) by difficulty
+#define PRACTICE_RATING_MEDIUM 1500
+#define PRACTICE_RATING_HARD 1700
+#define PRACTICE_RATING_JITTER 100      // PRACTICE_NEXT aims at ability +- jitter, not always one difficulty
+#define PRACTICE_DEFAULT_CATEGORY "General" // questions without a category
+
+/**
+ * @brief Nạp ngân hàng câu hỏi vào bộ nhớ và khởi động writer thread
+ * @param db Database (chỉ dùng lúc khởi động và bởi writer thread)
+ * @return 0 nếu thành công, -1 nếu lỗi (không tạo được thread)
+ *
+ * Ngân hàng câu hỏi rỗng (lỗi DB) không phải lỗi: PRACTICE trả 500.
+ */
+int practice_start(Database *db);
+
+/**
+ * @brief Dừng writer thread sau khi ghi nốt các kết quả còn trong hàng đợi
+ * Gọi trước db_disconnect().
+ */
+void practice_stop(void);
+
+/**
+ * @brief Xử lý bắt đầu luyện tập
+ * @param server Pointer tới Server instance
+ * @param client Pointer tới ClientSession
+ * @param msg Message đã parse (PRACTICE [num_questions[|time_limit_minutes]])
+ *
+ * Flow:
+ * 1. Check authentication, client không ở trong room
+ * 2. Chọn ngẫu nhiên num_questions câu từ ngân hàng trong bộ nhớ
+ * 3. Lưu phiên luyện tập (thay phiên cũ nếu có)
+ * 4. Response: 140 DATA <length>\n{"practice_id":..,"time_limit_minutes":..,"questions":[...]}
+ */
+void handle_practice(Server *server, ClientSession *client, Message *msg);
+
+/**
+ * @brief Xử lý nộp bài luyện tập
+ * @param server Pointer tới Server instance
+ * @param client Pointer tới ClientSession
+ * @param msg Message đã parse (SUBMIT_PRACTICE practice_id|answers)
+ *
+ * Flow:
+ * 1. Check phiên luyện tập của user và practice_id
+ * 2. Check thời gian (quá hạn -> 230, phiên bị hủy)
+ * 3. Chấm điểm trong bộ nhớ, đưa điểm vào hàng đợi ghi DB
+ * 4. Response: 141 score|total|đáp án đúng (A,B,C,...)
+ */
+void handle_submit_practice(Server *server, ClientSession *client, Message *msg);
+
+/**
+ * @brief Xử lý lấy câu luyện tập thích ứng tiếp theo
+ * @param server Pointer tới Server instance
+ * @param client Pointer tới ClientSession
+ * @param msg Message đã parse (PRACTICE_NEXT [category])
+ *
+ * Flow:
+ * 1. Check authentication, client không ở trong room
+ * 2. category mới -> phiên thích ứng mới (thay phiên cũ); bỏ trống -> tiếp tục phiên hiện tại
+ * 3. Câu chưa trả lời -> gửi lại câu đó; nếu không chọn câu có độ khó gần năng lực nhất
+ *    (tìm nhị phân, bỏ qua các câu vừa hỏi)
+ * 4. Response: 140 DATA <length>\n{"practice_id":..,"category":..,"rating":..,"questions":[1 câu]}
+ *    Category không hợp lệ -> 302 kèm danh sách category
+ */
+void handle_practice_next(Server *server, ClientSession *client, Message *msg);
+
+/**
+ * @brief Xử lý trả lời câu luyện tập thích ứng
+ * @param server Pointer tới Server instance
+ * @param client Pointer tới ClientSession
+ * @param msg Message đã parse (PRACTICE_ANSWER practice_id|answer)
+ *
+ * Flow:
+ * 1. Check câu đang chờ của phiên (mỗi câu chỉ chấm một lần)
+ * 2. Chấm trong bộ nhớ, cập nhật năng lực (một bước Elo)
+ * 3. Response: 141 đúng(0/1)|1|đáp án đúng|năng lực mới
+ */
+void handle_practice_answer(Server *server, ClientSession *client, Message *msg);
+
+/**
+ * @brief Hủy phiên luyện tập đang dở (logout / ngắt kết nối)
+ */
+void practice_discard(const char *username);
+
+#endif // PRACTICE_H
@@ -1,5 +1,6 @@
 #include "protocol.h"
 #include <ctype.h>
+#include <zlib.h>
 #include <sys/socket.h>
 #include <unistd.h>
 
@@ -188,6 +189,31 @@ int create_data_message(int code, const char *data, size_t data_len, char *buffe
     return header_len + data_len;
 }
 
+// Format: "CODE ZDATA <length> <raw_length>\n<zlib data>"
+// Ví dụ: "150 ZDATA 812 4096\n<812 bytes>"
+int create_zdata_message(int code, const char *data, size_t data_len, char *buffer, size_t buffer_size)
+{
+    char header[64];
+    size_t reserve = sizeof(header); // header written in front once the size is known
+    if (buffer_size <= reserve)
+        return -1;
+
+    // Only worth it if it shrinks: anything past data_len means send DATA instead
+    uLongf z_len = buffer_size - reserve < data_len ? buffer_size - reserve : data_len;
+    int rc = compress2((Bytef *)buffer + reserve, &z_len, (const Bytef *)data, data_len, Z_DEFAULT_COMPRESSION);
+    if (rc == Z_BUF_ERROR)
+        return 0;
+    if (rc != Z_OK)
+        return -1;
+    if (z_len >= data_len)
+        return 0;
+
+    int header_len = snprintf(header, sizeof(header), "%d ZDATA %lu %zu\n", code, (unsigned long)z_len, data_len);
+    memcpy(buffer, header, (size_t)header_len);
+    memmove(buffer + header_len, buffer + reserve, z_len);
+    return header_len + (int)z_len;
+}
+
 // Format: "CODE MESSAGE\n"
 // Ví dụ: "110 LOGIN_OK sess_12345\n"
 int create_simple_response(int code, const char *message, char *buffer, size_t buffer_size)
@@ -284,6 +310,8 @@ const char *get_code_description(int code)
         return "ALREADY_SUBMITTED";
     case CODE_DATA:
         return "DATA";
+    case CODE_COMPRESS_OK:
+        return "COMPRESS_OK";
     case CODE_PRACTICE_RESULT:
         return "PRACTICE_RESULT";
     case CODE_EXAM_DATA:
@@ -16,25 +16,34 @@
 #define CODE_LOGOUT_OK 132 // Đăng xuất thành công
 
 // Room Management Codes
-#define CODE_ROOM_CREATED 120  // Tạo phòng thành công
-#define CODE_ROOMS_DATA 121    // Danh sách phòng
-#define CODE_ROOM_JOIN_OK 122  // Vào phòng thành công
-#define CODE_ROOM_LEAVE_OK 123 // Rời phòng thành công
-#define CODE_START_OK 125      // Bắt đầu thi
-#define CODE_RESULT_DATA 127   // Dữ liệu kết quả
+#define CODE_ROOM_CREATED 120     // Tạo phòng thành công
+#define CODE_ROOMS_DATA 121       // Danh sách phòng
+#define CODE_ROOM_JOIN_OK 122     // Vào phòng thành công
+#define CODE_ROOM_LEAVE_OK 123    // Rời phòng thành công
+#define CODE_START_OK 125         // Bắt đầu thi
+#define CODE_ROOMS_NOT_MODIFIED 126 // Danh sách phòng không đổi (LIST_ROOMS since_version)
+#define CODE_RESULT_DATA 127      // Dữ liệu kết quả
+#define CODE_LEADERBOARD_PUSH 128 // Bảng xếp hạng trực tiếp (snapshot / delta)
+#define CODE_LOBBY_PUSH 129       // Thay đổi danh sách phòng (SUBSCRIBE_LOBBY)
+
+// 125 START_OK room_id|start|deadline[|EXAM]: "EXAM" = đề thi (150 DATA) gửi ngay sau (--push-exam)
+#define START_OK_EXAM_PUSHED "EXAM"
 
 // Exam & Submit Codes
 #define CODE_SUBMIT_OK 130         // Nộp bài lần đầu
 #define CODE_ALREADY_SUBMITTED 131 // Đã nộp rồi
+#define CODE_ANSWER_SAVED 133      // Đã lưu câu trả lời (SAVE_ANSWER)
 
 // Data Transfer Codes
 #define CODE_DATA 140            // Dữ liệu luyện tập
 #define CODE_PRACTICE_RESULT 141 // Kết quả luyện tập
 #define CODE_EXAM_DATA 150       // Dữ liệu đề thi
+#define CODE_STATS_DATA 160      // Thống kê server (admin)
 
 // Ping/Pong
 #define CODE_PONG 200   // Response to PING
 #define CODE_WHOAMI 201 // Trả thông tin user
+#define CODE_COMPRESS_OK 202 // Bật nén DATA cho kết nối (COMPRESS)
 
 // Authentication Errors
 #define CODE_ACCOUNT_LOCKED 211    // Tài khoản bị khóa
@@ -81,16 +90,27 @@
 #define MSG_LOGOUT "LOGOUT"
 #define MSG_PRACTICE "PRACTICE"
 #define MSG_SUBMIT_PRACTICE "SUBMIT_PRACTICE"
+#define MSG_PRACTICE_NEXT "PRACTICE_NEXT"
+#define MSG_PRACTICE_ANSWER "PRACTICE_ANSWER"
 #define MSG_CREATE_ROOM "CREATE_ROOM"
 #define MSG_LIST_ROOMS "LIST_ROOMS"
+#define MSG_LIST_ROOMS_PAGE "LIST_ROOMS_PAGE"
 #define MSG_JOIN_ROOM "JOIN_ROOM"
 #define MSG_LEAVE_ROOM "LEAVE_ROOM"
 #define MSG_START_EXAM "START_EXAM"
 #define MSG_GET_EXAM "GET_EXAM"
 #define MSG_SUBMIT_EXAM "SUBMIT_EXAM"
+#define MSG_SAVE_ANSWER "SAVE_ANSWER"
 #define MSG_VIEW_RESULT "VIEW_RESULT"
 #define MSG_PING "PING"
 #define MSG_WHOAMI "WHOAMI"
+#define MSG_STATS "STATS"
+#define MSG_COMPRESS "COMPRESS"
+#define MSG_ITEM_STATS "ITEM_STATS"
+#define MSG_SUBSCRIBE_LEADERBOARD "SUBSCRIBE_LEADERBOARD"
+#define MSG_UNSUBSCRIBE_LEADERBOARD "UNSUBSCRIBE_LEADERBOARD"
+#define MSG_SUBSCRIBE_LOBBY "SUBSCRIBE_LOBBY"
+#define MSG_UNSUBSCRIBE_LOBBY "UNSUBSCRIBE_LOBBY"
 
 // ==========================================
 // PROTOCOL CONSTANTS
@@ -106,6 +126,10 @@
 #define MAX_PARAMS 10
 #define DELIMITER '\n'
 
+// COMPRESS deflate: DATA lớn được gửi nén (zlib) dạng "CODE ZDATA <length> <raw_length>\n<data>"
+#define COMPRESS_DEFLATE "deflate"
+#define COMPRESS_MIN_BYTES 1024 // nhỏ hơn: gửi DATA thường
+
 // ==========================================
 // STRUCTURES - Cấu trúc dữ liệu giao thức
 // ==========================================
@@ -179,6 +203,20 @@ int create_control_message(const char *command, const char **params, int param_c
  */
 int create_data_message(int code, const char *data, size_t data_len, char *buffer, size_t buffer_size);
 
+/**
+ * @brief Tạo data message nén deflate (zlib), cho kết nối đã gửi COMPRESS
+ * @param code Response code
+ * @param data Dữ liệu gốc
+ * @param data_len Độ dài data gốc
+ * @param buffer Buffer output (cần data_len + 64 bytes là đủ)
+ * @param buffer_size Kích thước buffer
+ * @return Số bytes đã ghi, 0 nếu nén không nhỏ hơn (gửi DATA thường), -1 nếu lỗi
+ *
+ * Format: "CODE ZDATA <length> <raw_length>\n<length bytes zlib>"
+ * Ví dụ: "150 ZDATA 812 4096\n<812 bytes>"
+ */
+int create_zdata_message(int code, const char *data, size_t data_len, char *buffer, size_t buffer_size);
+
 /**
  * @brief Tạo response đơn giản (chỉ code + message)
  * @param code Response code
@@ -0,0 +1,232 @@
+#include "lobby.h"
+#include "room_catalog.h"
+#include "../protocol/protocol.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct
+{
+    LobbyEventType type;
+    long long version;
+    int participants;
+    char room_id[MAX_ROOM_ID_LEN];
+    char room_name[MAX_ROOM_NAME_LEN + 1]; // LOBBY_CREATED only
+    char creator[MAX_USERNAME_LEN + 1];    // LOBBY_CREATED only
+} LobbyEvent;
+
+static const char *EVENT_NAMES[] = {"created", "participants", "started", "finished", "deleted"};
+
+// Events of the current tick; the push thread swaps the two buffers
+static pthread_mutex_t lobby_mutex = PTHREAD_MUTEX_INITIALIZER;
+static LobbyEvent buffers[2][LOBBY_MAX_PENDING];
+static LobbyEvent *pending = buffers[0];
+static int pending_count;
+static int pending_overflow;
+static long long pending_since_ms; // queued_at_ms of the batch
+static LobbyStats stats;
+
+// Push thread (lobby_start_push)
+static pthread_mutex_t push_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t push_cond = PTHREAD_COND_INITIALIZER;
+static pthread_t push_thread;
+static int push_running;
+static int push_interval_ms;
+static LobbyPushFn push_fn;
+static void *push_ctx;
+
+static long long now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+// Caller holds lobby_mutex; NULL once the tick is full
+static LobbyEvent *queue_event(const char *room_id, LobbyEventType type)
+{
+    long long version = room_catalog_touch(room_id); // under lobby_mutex: versions stay in queue order
+    stats.events++;
+    if (pending_count == 0 && !pending_overflow)
+        pending_since_ms = now_ms();
+
+    // Only the last participant count of a room matters
+    if (type == LOBBY_PARTICIPANTS)
+    {
+        for (int i = pending_count - 1; i >= 0; i--)
+        {
+            if (pending[i].type == LOBBY_PARTICIPANTS && strcmp(pending[i].room_id, room_id) == 0)
+            {
+                pending[i].version = version;
+                return &pending[i];
+            }
+        }
+    }
+
+    if (pending_count == LOBBY_MAX_PENDING)
+    {
+        pending_overflow = 1;
+        return NULL;
+    }
+    LobbyEvent *event = &pending[pending_count++];
+    memset(event, 0, sizeof(*event));
+    event->type = type;
+    event->version = version;
+    snprintf(event->room_id, sizeof(event->room_id), "%s", room_id);
+    return event;
+}
+
+void lobby_room_created(const char *room_id, const char *room_name, const char *creator)
+{
+    pthread_mutex_lock(&lobby_mutex);
+    LobbyEvent *event = queue_event(room_id, LOBBY_CREATED);
+    if (event)
+    {
+        snprintf(event->room_name, sizeof(event->room_name), "%s", room_name);
+        snprintf(event->creator, sizeof(event->creator), "%s", creator);
+        event->participants = 1; // the creator
+    }
+    pthread_mutex_unlock(&lobby_mutex);
+}
+
+void lobby_room_changed(const char *room_id, LobbyEventType type, int participants)
+{
+    pthread_mutex_lock(&lobby_mutex);
+    LobbyEvent *event = queue_event(room_id, type);
+    if (event)
+        event->participants = participants;
+    pthread_mutex_unlock(&lobby_mutex);
+}
+
+// {"version":..,"queued_at_ms":..,"events":[..]} or the resync batch; malloc'd
+static char *batch_json(const LobbyEvent *events, int count, int overflow, long long since_ms, size_t *len_out)
+{
+    long long version = room_catalog_version();
+    size_t size = 128 + (size_t)count * 384; // longest event (room name + creator) fits in 384
+    char *json = malloc(size);
+    if (!json)
+        return NULL;
+
+    size_t len;
+    if (overflow)
+    {
+        len = (size_t)snprintf(json, size, "{\"version\":%lld,\"resync\":true}", version);
+    }
+    else
+    {
+        len = (size_t)snprintf(json, size, "{\"version\":%lld,\"queued_at_ms\":%lld,\"events\":[", version, since_ms);
+        for (int i = 0; i < count; i++)
+        {
+            const LobbyEvent *e = &events[i];
+            len += (size_t)snprintf(json + len, size - len, "%s{\"type\":\"%s\",\"version\":%lld,\"room_id\":\"%s\"",
+                                    i ? "," : "", EVENT_NAMES[e->type], e->version, e->room_id);
+            if (e->type == LOBBY_CREATED)
+                len += (size_t)snprintf(json + len, size - len, ",\"room_name\":\"%s\",\"creator\":\"%s\",\"participants\":%d}",
+                                        e->room_name, e->creator, e->participants);
+            else if (e->type == LOBBY_PARTICIPANTS)
+                len += (size_t)snprintf(json + len, size - len, ",\"participants\":%d}", e->participants);
+            else
+                len += (size_t)snprintf(json + len, size - len, "}");
+        }
+        len += (size_t)snprintf(json + len, size - len, "]}");
+    }
+    *len_out = len;
+    return json;
+}
+
+static void push_batch(void)
+{
+    pthread_mutex_lock(&lobby_mutex);
+    LobbyEvent *events = pending;
+    int count = pending_count, overflow = pending_overflow;
+    long long since_ms = pending_since_ms;
+    pending = pending == buffers[0] ? buffers[1] : buffers[0];
+    pending_count = 0;
+    pending_overflow = 0;
+    pthread_mutex_unlock(&lobby_mutex);
+    if (count == 0 && !overflow)
+        return;
+
+    // Sockets are written without lobby_mutex: handlers keep queueing meanwhile
+    size_t len = 0;
+    char *json = batch_json(events, count, overflow, since_ms, &len);
+    int sent = json ? push_fn(json, len, push_ctx) : 0;
+    free(json);
+
+    pthread_mutex_lock(&lobby_mutex);
+    stats.batches++;
+    stats.deliveries += (unsigned long long)(sent > 0 ? sent : 0);
+    stats.resyncs += (unsigned long long)overflow;
+    pthread_mutex_unlock(&lobby_mutex);
+}
+
+static void *push_loop(void *arg)
+{
+    (void)arg;
+    pthread_mutex_lock(&push_mutex);
+    while (push_running)
+    {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += (long)push_interval_ms * 1000000L;
+        deadline.tv_sec += deadline.tv_nsec / 1000000000L;
+        deadline.tv_nsec %= 1000000000L;
+        while (push_running && pthread_cond_timedwait(&push_cond, &push_mutex, &deadline) == 0)
+            ;
+        if (!push_running)
+            break;
+        pthread_mutex_unlock(&push_mutex);
+
+        push_batch();
+
+        pthread_mutex_lock(&push_mutex);
+    }
+    pthread_mutex_unlock(&push_mutex);
+    return NULL;
+}
+
+int lobby_start_push(int max_per_second, LobbyPushFn push, void *ctx)
+{
+    pthread_mutex_lock(&push_mutex);
+    if (push_running)
+    {
+        pthread_mutex_unlock(&push_mutex);
+        return -1;
+    }
+    push_interval_ms = 1000 / (max_per_second > 0 ? max_per_second : 1);
+    push_fn = push;
+    push_ctx = ctx;
+    push_running = 1;
+    if (pthread_create(&push_thread, NULL, push_loop, NULL) != 0)
+    {
+        push_running = 0;
+        push_fn = NULL;
+        pthread_mutex_unlock(&push_mutex);
+        return -1;
+    }
+    pthread_mutex_unlock(&push_mutex);
+    return 0;
+}
+
+void lobby_stop_push(void)
+{
+    pthread_mutex_lock(&push_mutex);
+    if (!push_running)
+    {
+        pthread_mutex_unlock(&push_mutex);
+        return;
+    }
+    push_running = 0;
+    pthread_cond_signal(&push_cond);
+    pthread_mutex_unlock(&push_mutex);
+    pthread_join(push_thread, NULL);
+}
+
+void lobby_get_stats(LobbyStats *out)
+{
+    pthread_mutex_lock(&lobby_mutex);
+    *out = stats;
+    pthread_mutex_unlock(&lobby_mutex);
+}
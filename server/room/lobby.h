@@ -0,0 +1,77 @@
+#ifndef LOBBY_H
+#define LOBBY_H
+
+#include <stddef.h>
+
+// ===============================================
+// LOBBY - room list changes pushed to SUBSCRIBE_LOBBY sessions
+// ===============================================
+//
+// Room handlers report each change here (this also bumps the room catalog
+// version, see room_catalog.h). Events are queued and a push thread sends
+// everything queued during the last tick as one message, built (and
+// compressed) once for all subscribers:
+//   {"version":V,"queued_at_ms":T,"events":[
+//     {"type":"created","version":v,"room_id":"..","room_name":"..","creator":"..","participants":1},
+//     {"type":"participants","version":v,"room_id":"..","participants":N},
+//     {"type":"started"|"finished"|"deleted","version":v,"room_id":".."}]}
+// Several participant changes of a room in one tick are sent as the last
+// one. queued_at_ms (unix ms) is when the oldest event of the batch was
+// queued. If more than LOBBY_MAX_PENDING events pile up in one tick the
+// batch is replaced by {"version":V,"resync":true}: fetch
+// LIST_ROOMS <filter>|<last version seen> instead.
+
+#define LOBBY_PUSH_HZ 10        // batches per second (at most)
+#define LOBBY_MAX_PENDING 512   // events per tick before a resync batch
+
+typedef enum
+{
+    LOBBY_CREATED,
+    LOBBY_PARTICIPANTS,
+    LOBBY_STARTED,
+    LOBBY_FINISHED,
+    LOBBY_DELETED
+} LobbyEventType;
+
+/**
+ * @brief Deliver a batch to every lobby subscriber (called from the push thread)
+ * @return Number of sessions it was sent to
+ */
+typedef int (*LobbyPushFn)(const char *json, size_t len, void *ctx);
+
+typedef struct
+{
+    unsigned long long events;     // queued
+    unsigned long long batches;    // pushed (including resync)
+    unsigned long long deliveries; // batches x subscribers
+    unsigned long long resyncs;
+} LobbyStats;
+
+/**
+ * @brief A room was created (call after the DB insert)
+ */
+void lobby_room_created(const char *room_id, const char *room_name, const char *creator);
+
+/**
+ * @brief A room changed or was deleted (call after the DB update)
+ * @param participants New participant count (LOBBY_PARTICIPANTS only)
+ */
+void lobby_room_changed(const char *room_id, LobbyEventType type, int participants);
+
+/**
+ * @brief Start the push thread: every 1/max_per_second s, queued events go out through push()
+ * @return 0 on success, -1 on error (already running)
+ */
+int lobby_start_push(int max_per_second, LobbyPushFn push, void *ctx);
+
+/**
+ * @brief Stop the push thread
+ */
+void lobby_stop_push(void);
+
+/**
+ * @brief Counters since startup (STATS)
+ */
+void lobby_get_stats(LobbyStats *out);
+
+#endif // LOBBY_H
@@ -1,12 +1,34 @@
 #include "room.h"
+#include "room_counters.h"
+#include "room_catalog.h"
+#include "lobby.h"
+#include "room_id.h"
 #include "../server.h"
 #include "../auth/auth.h"
+#include "../leaderboard/leaderboard.h"
+#include "../exam/exam.h"
+#include "../exam/exam_timer.h"
+#include "../answers/answers.h"
+#include "../stats/item_stats.h"
+#include "../database/db_json.h"
+#include "../capture/capture.h"
+#include <ctype.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <time.h>
 
 #define MAX_PARTICIPANTS 50
 
+// Participant count for the lobby: in memory, from the DB for rooms of an earlier run
+static void lobby_participants_changed(Server *server, const char *room_id)
+{
+    int participants = room_counters_participants(room_id);
+    if (participants == ROOM_COUNTERS_UNKNOWN)
+        participants = db_get_room_participant_count(server->db, room_id);
+    lobby_room_changed(room_id, LOBBY_PARTICIPANTS, participants);
+}
+
 /**
  * @brief Handle CREATE_ROOM command
  */
@@ -57,9 +79,9 @@ void handle_create_room(Server *server, ClientSession *client, Message *msg)
         return;
     }
 
-    // Generate unique room ID
+    // Generate unique room ID (Snowflake, see room_id.h: no collision within a second)
     char room_id[MAX_ROOM_ID_LEN];
-    snprintf(room_id, sizeof(room_id), "%ld", time(NULL)); // Use timestamp as room ID
+    room_id_format(room_id_next(), room_id);
 
     // Create room in database (stored procedure handles question selection)
     if (db_create_room(server->db, room_id, room_name, client->username, num_questions, time_limit) < 0)
@@ -68,6 +90,11 @@ void handle_create_room(Server *server, ClientSession *client, Message *msg)
         db_log_activity(server->db, "ERROR", client->username, "CREATE_ROOM", "Database error");
         return;
     }
+    if (capture_enabled())
+        capture_room_created(client->conn_id, room_id); // replay maps it to the target's id
+    leaderboard_track_room(room_id);
+    room_counters_track(room_id, 1); // the creator is a participant
+    lobby_room_created(room_id, room_name, client->username);
 
     // Update client session
     strcpy(client->current_room, room_id);
@@ -84,6 +111,74 @@ void handle_create_room(Server *server, ClientSession *client, Message *msg)
     printf("[CREATE_ROOM] User '%s' created room '%s' (%s)\n", client->username, room_name, room_id);
 }
 
+// Rooms changed since the client's version, re-read by id (LIST_ROOMS delta)
+typedef struct
+{
+    const char *filter;
+    char *json; // {"rooms":[...]}: changed rooms that still match the filter
+    char (*room_ids)[MAX_ROOM_ID_LEN];
+    int count;
+    char listed[ROOM_CATALOG_MAX_DELTA]; // room_ids[i] is in json
+    int overflow;                        // json full: send the full list instead
+} RoomDelta;
+
+static int add_delta_row(void *ctx, char **row)
+{
+    RoomDelta *delta = ctx;
+    if (strcmp(delta->filter, "ALL") != 0 && strcmp(delta->filter, row[3]) != 0)
+        return 0; // no longer matches the filter: reported as removed
+    if (db_json_rooms_add(delta->json, row) < 0)
+    {
+        delta->overflow = 1;
+        return -1;
+    }
+    for (int i = 0; i < delta->count; i++)
+    {
+        if (strcmp(delta->room_ids[i], row[0]) == 0)
+            delta->listed[i] = 1;
+    }
+    return 0;
+}
+
+// {"version":..,"since":..,"removed":[..],"rooms":[..]}, NULL on error or overflow
+static char *build_room_delta(Database *db, const char *filter, long long since, long long version,
+                              char room_ids[][MAX_ROOM_ID_LEN], int count)
+{
+    RoomDelta delta = {.filter = filter, .room_ids = room_ids, .count = count};
+    delta.json = db_json_rooms_open();
+    if (!delta.json)
+        return NULL;
+
+    const char *ids[ROOM_CATALOG_MAX_DELTA];
+    for (int i = 0; i < count; i++)
+        ids[i] = room_ids[i];
+    if (db_get_rooms(db, ids, count, add_delta_row, &delta) < 0 || delta.overflow)
+    {
+        free(delta.json);
+        return NULL;
+    }
+    db_json_rooms_close(delta.json);
+
+    // Deleted rooms (no row) and rooms that left the filter
+    size_t size = strlen(delta.json) + 128 + (size_t)count * (MAX_ROOM_ID_LEN + 3);
+    char *out = malloc(size);
+    if (out)
+    {
+        int len = snprintf(out, size, "{\n  \"version\": %lld,\n  \"since\": %lld,\n  \"removed\": [", version, since);
+        int first = 1;
+        for (int i = 0; i < count; i++)
+        {
+            if (delta.listed[i])
+                continue;
+            len += snprintf(out + len, size - len, "%s\"%s\"", first ? "" : ",", room_ids[i]);
+            first = 0;
+        }
+        snprintf(out + len, size - len, "],\n%s", delta.json + 2); // skip "{\n"
+    }
+    free(delta.json);
+    return out;
+}
+
 /**
  * @brief Handle LIST_ROOMS command
  */
@@ -97,7 +192,7 @@ void handle_list_rooms(Server *server, ClientSession *client, Message *msg)
     }
 
     // Get filter (default: ALL)
-    const char *filter = msg->param_count > 0 ? msg->params[0] : "ALL";
+    const char *filter = msg->param_count > 0 && strlen(msg->params[0]) > 0 ? msg->params[0] : "ALL";
 
     // Validate filter
     if (strcmp(filter, "ALL") != 0 &&
@@ -109,8 +204,51 @@ void handle_list_rooms(Server *server, ClientSession *client, Message *msg)
         return;
     }
 
-    // Get room list from database (returns JSON string)
-    char *json_data = db_list_rooms(server->db, filter);
+    // Optional version of the client's last list
+    long long since = -1;
+    if (msg->param_count > 1 && strlen(msg->params[1]) > 0)
+    {
+        char *end;
+        since = strtoll(msg->params[1], &end, 10);
+        if (*end != '\0' || since < 0)
+        {
+            send_error_or_response(client->socket_fd, CODE_INVALID_PARAMS, "since_version must be a version returned by LIST_ROOMS");
+            return;
+        }
+    }
+
+    char *json_data = NULL;
+    if (since >= 0)
+    {
+        char changed[ROOM_CATALOG_MAX_DELTA][MAX_ROOM_ID_LEN];
+        long long version;
+        int count = room_catalog_changes_since(since, changed, ROOM_CATALOG_MAX_DELTA, &version);
+        if (count == 0)
+        {
+            char reply[64];
+            snprintf(reply, sizeof(reply), "NOT_MODIFIED %lld", version);
+            send_error_or_response(client->socket_fd, CODE_ROOMS_NOT_MODIFIED, reply);
+            return;
+        }
+        if (count > 0)
+            json_data = build_room_delta(server->db, filter, since, version, changed, count);
+        // Too old, too many changes or delta failed: full list below
+    }
+
+    if (!json_data)
+    {
+        // Version first: rooms changed during the query are sent again next time
+        long long version = room_catalog_version();
+        char *rooms = db_list_rooms(server->db, filter);
+        if (rooms)
+        {
+            size_t size = strlen(rooms) + 64;
+            json_data = malloc(size);
+            if (json_data)
+                snprintf(json_data, size, "{\n  \"version\": %lld,\n%s", version, rooms + 2); // skip "{\n"
+            free(rooms);
+        }
+    }
     if (!json_data)
     {
         send_error_or_response(client->socket_fd, CODE_INTERNAL_ERROR, "Failed to fetch rooms");
@@ -119,12 +257,8 @@ void handle_list_rooms(Server *server, ClientSession *client, Message *msg)
     }
 
     // Send response with length prefixing
-    char buffer[MAX_MESSAGE_LEN];
-    int len = create_data_message(CODE_ROOMS_DATA, json_data, strlen(json_data), buffer, sizeof(buffer));
-
-    if (len > 0)
+    if (send_data_message(client, CODE_ROOMS_DATA, json_data, strlen(json_data)) == 0)
     {
-        send_full(client->socket_fd, buffer, len);
         db_log_activity(server->db, "INFO", client->username, "LIST_ROOMS", filter);
     }
     else
@@ -137,6 +271,155 @@ void handle_list_rooms(Server *server, ClientSession *client, Message *msg)
     printf("[LIST_ROOMS] User '%s' requested room list (filter: %s)\n", client->username, filter);
 }
 
+// Cursor of a page: created_at digits + '.' + room_id ("20241001123456.1727760896")
+static int encode_room_cursor(const char *created_at, const char *room_id, char *out, size_t size)
+{
+    char digits[15];
+    int n = 0;
+    for (const char *c = created_at ? created_at : ""; *c && n < 15; c++)
+    {
+        if (*c >= '0' && *c <= '9')
+            digits[n++] = *c;
+    }
+    if (n != 14)
+        return -1;
+    digits[n] = '\0';
+    return snprintf(out, size, "%s.%s", digits, room_id) < (int)size ? 0 : -1;
+}
+
+// Back to (created_at "YYYY-MM-DD HH:MM:SS", room_id); -1 if it is not one of ours
+static int decode_room_cursor(const char *cursor, char created_at[20], char room_id[MAX_ROOM_ID_LEN])
+{
+    const char *dot = strchr(cursor, '.');
+    if (!dot || dot - cursor != 14 || strlen(dot + 1) == 0 || strlen(dot + 1) >= MAX_ROOM_ID_LEN)
+        return -1;
+    for (const char *c = cursor; c < dot; c++)
+    {
+        if (*c < '0' || *c > '9')
+            return -1;
+    }
+    for (const char *c = dot + 1; *c; c++)
+    {
+        if (!isalnum((unsigned char)*c) && *c != '_' && *c != '-')
+            return -1;
+    }
+    snprintf(created_at, 20, "%.4s-%.2s-%.2s %.2s:%.2s:%.2s", cursor, cursor + 4, cursor + 6, cursor + 8, cursor + 10, cursor + 12);
+    strcpy(room_id, dot + 1);
+    return 0;
+}
+
+// One page of rooms; the row after the last one only tells that there is a next page
+typedef struct
+{
+    char *json;
+    int limit;
+    int added;
+    int more;
+    char cursor[64]; // of the last room added
+} RoomPage;
+
+static int add_page_row(void *ctx, char **row)
+{
+    RoomPage *page = ctx;
+    if (page->added == page->limit || db_json_rooms_add(page->json, row) < 0 ||
+        encode_room_cursor(row[8], row[0], page->cursor, sizeof(page->cursor)) < 0)
+    {
+        page->more = 1; // resumes at this row
+        return -1;
+    }
+    page->added++;
+    return 0;
+}
+
+/**
+ * @brief Handle LIST_ROOMS_PAGE command
+ */
+void handle_list_rooms_page(Server *server, ClientSession *client, Message *msg)
+{
+    // Check authentication
+    if (!check_authentication(client))
+    {
+        send_error_or_response(client->socket_fd, CODE_NOT_LOGGED, "Not authenticated");
+        return;
+    }
+
+    // LIST_ROOMS_PAGE [filter|page_size|cursor|creator|name_prefix]: trailing params may be
+    // left out, "-" keeps the default of one in the middle (the parser drops empty params)
+    const char *param[5] = {"", "", "", "", ""};
+    for (int i = 0; i < msg->param_count && i < 5; i++)
+        param[i] = strcmp(msg->params[i], "-") == 0 ? "" : msg->params[i];
+
+    DbRoomPage query = {.status = *param[0] ? param[0] : "ALL", .limit = ROOM_PAGE_DEFAULT_SIZE};
+    if (strcmp(query.status, "ALL") != 0 &&
+        strcmp(query.status, "NOT_STARTED") != 0 &&
+        strcmp(query.status, "IN_PROGRESS") != 0 &&
+        strcmp(query.status, "FINISHED") != 0)
+    {
+        send_error_or_response(client->socket_fd, CODE_INVALID_PARAMS, "Filter must be: ALL, NOT_STARTED, IN_PROGRESS, or FINISHED");
+        return;
+    }
+
+    if (*param[1])
+    {
+        query.limit = atoi(param[1]);
+        if (query.limit <= 0 || query.limit > ROOM_PAGE_MAX_SIZE)
+        {
+            send_error_or_response(client->socket_fd, CODE_INVALID_PARAMS, "page_size must be between 1 and 50");
+            return;
+        }
+    }
+
+    char after_created[20], after_room_id[MAX_ROOM_ID_LEN];
+    if (*param[2])
+    {
+        if (decode_room_cursor(param[2], after_created, after_room_id) < 0)
+        {
+            send_error_or_response(client->socket_fd, CODE_INVALID_PARAMS, "cursor must be a next_cursor returned by LIST_ROOMS_PAGE");
+            return;
+        }
+        query.after_created = after_created;
+        query.after_room_id = after_room_id;
+    }
+
+    if (strlen(param[3]) > MAX_USERNAME_LEN || strlen(param[4]) > MAX_ROOM_NAME_LEN)
+    {
+        send_error_or_response(client->socket_fd, CODE_INVALID_PARAMS, "creator or name_prefix too long");
+        return;
+    }
+    query.creator = *param[3] ? param[3] : NULL;
+    query.name_prefix = *param[4] ? param[4] : NULL;
+
+    // One row more than the page: tells whether there is a next page
+    RoomPage page = {.json = db_json_rooms_open(), .limit = query.limit};
+    query.limit++;
+    char *json_data = NULL;
+    if (page.json && db_list_rooms_page(server->db, &query, add_page_row, &page) >= 0)
+    {
+        size_t size = strlen(page.json) + sizeof(page.cursor) + 64;
+        json_data = malloc(size);
+        if (json_data)
+        {
+            if (page.more)
+                snprintf(json_data, size, "%s  ],\n  \"next_cursor\": \"%s\"\n}", page.json, page.cursor);
+            else
+                snprintf(json_data, size, "%s  ],\n  \"next_cursor\": null\n}", page.json);
+        }
+    }
+    free(page.json);
+    if (!json_data)
+    {
+        send_error_or_response(client->socket_fd, CODE_INTERNAL_ERROR, "Failed to fetch rooms");
+        db_log_activity(server->db, "ERROR", client->username, "LIST_ROOMS_PAGE", "Database error");
+        return;
+    }
+
+    if (send_data_message(client, CODE_ROOMS_DATA, json_data, strlen(json_data)) < 0)
+        send_error_or_response(client->socket_fd, CODE_INTERNAL_ERROR, "Response too large");
+    free(json_data);
+
+    printf("[LIST_ROOMS_PAGE] User '%s' requested %d room(s) (filter: %s)\n", client->username, page.added, query.status);
+}
+
 /**
  * @brief Handle JOIN_ROOM command
  */
@@ -192,12 +475,18 @@ void handle_join_room(Server *server, ClientSession *client, Message *msg)
     }
 
     // Join room
-    if (db_join_room(server->db, room_id, client->username) < 0)
+    int joined = db_join_room(server->db, room_id, client->username);
+    if (joined < 0)
     {
         send_error_or_response(client->socket_fd, CODE_INTERNAL_ERROR, "Failed to join room");
         db_log_activity(server->db, "ERROR", client->username, "JOIN_ROOM", "Database error");
         return;
     }
+    if (joined) // 0: JOIN_ROOM again, already counted
+    {
+        room_counters_join(room_id);
+        lobby_participants_changed(server, room_id);
+    }
 
     // Update client session
     strcpy(client->current_room, room_id);
@@ -254,6 +543,12 @@ void handle_leave_room(Server *server, ClientSession *client, Message *msg)
             db_log_activity(server->db, "ERROR", client->username, "LEAVE_ROOM", "Failed to delete room");
             return;
         }
+        leaderboard_remove_room(room_id);
+        exam_timer_cancel(room_id);
+        answers_remove_room(room_id);
+        room_counters_remove(room_id);
+        item_stats_remove_room(room_id);
+        lobby_room_changed(room_id, LOBBY_DELETED, 0);
 
         // Update client session
         memset(client->current_room, 0, sizeof(client->current_room));
@@ -275,6 +570,8 @@ void handle_leave_room(Server *server, ClientSession *client, Message *msg)
             db_log_activity(server->db, "ERROR", client->username, "LEAVE_ROOM", "Database error");
             return;
         }
+        int completed = room_counters_leave(room_id);
+        lobby_participants_changed(server, room_id);
 
         // Update client session
         memset(client->current_room, 0, sizeof(client->current_room));
@@ -286,5 +583,99 @@ void handle_leave_room(Server *server, ClientSession *client, Message *msg)
         db_log_activity(server->db, "INFO", client->username, "LEAVE_ROOM", room_id);
 
         printf("[LEAVE_ROOM] Participant '%s' left room '%s'\n", client->username, room_id);
+
+        // Everyone still in the running exam has submitted
+        if (completed == ROOM_COUNTERS_COMPLETE)
+            exam_room_completed(server, room_id);
     }
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Handle SUBSCRIBE_LOBBY command
+ */
+void handle_subscribe_lobby(Server *server, ClientSession *client, Message *msg)
+{
+    (void)msg;
+    if (!check_authentication(client))
+    {
+        send_error_or_response(client->socket_fd, CODE_NOT_LOGGED, "Not authenticated");
+        return;
+    }
+
+    // Under push_mutex: no batch goes out between reading the version and subscribing
+    char reply[64], line[96];
+    PushTarget target = {client->socket_fd, client->compress, ""};
+    snprintf(target.username, sizeof(target.username), "%s", client->username);
+    pthread_mutex_lock(&server->push_mutex);
+    snprintf(reply, sizeof(reply), "SUBSCRIBED %lld", room_catalog_version());
+    int len = create_simple_response(CODE_LOBBY_PUSH, reply, line, sizeof(line));
+    if (len > 0 && send_push(&target, line, (size_t)len) == 0)
+    {
+        pthread_mutex_lock(&server->clients_mutex);
+        client->lobby = 1;
+        pthread_mutex_unlock(&server->clients_mutex);
+    }
+    pthread_mutex_unlock(&server->push_mutex);
+
+    db_log_activity(server->db, "INFO", client->username, "SUBSCRIBE_LOBBY", reply);
+    printf("[SUBSCRIBE_LOBBY] User '%s' watching the lobby\n", client->username);
+}
+
+/**
+ * @brief Handle UNSUBSCRIBE_LOBBY command
+ */
+void handle_unsubscribe_lobby(Server *server, ClientSession *client, Message *msg)
+{
+    (void)msg;
+    if (!check_authentication(client))
+    {
+        send_error_or_response(client->socket_fd, CODE_NOT_LOGGED, "Not authenticated");
+        return;
+    }
+
+    pthread_mutex_lock(&server->clients_mutex);
+    client->lobby = 0;
+    pthread_mutex_unlock(&server->clients_mutex);
+
+    send_error_or_response(client->socket_fd, CODE_LOBBY_PUSH, "UNSUBSCRIBED");
+}
+
+int broadcast_lobby(const char *json, size_t len, void *ctx)
+{
+    Server *server = ctx;
+    size_t size = len + 64;
+    char *buffer = malloc(size);
+    if (!buffer)
+        return -1;
+    char *zbuffer = len >= COMPRESS_MIN_BYTES ? malloc(size) : NULL;
+    int z_len = zbuffer ? create_zdata_message(CODE_LOBBY_PUSH, json, len, zbuffer, size) : 0;
+
+    int sent = -1;
+    int msg_len = create_data_message(CODE_LOBBY_PUSH, json, len, buffer, size);
+    if (msg_len > 0)
+    {
+        // Built (and compressed) once; subscribers are copied under clients_mutex
+        // and written outside it, so one that stops reading only loses its session
+        PushTarget targets[MAX_CLIENTS];
+        int count = 0;
+        pthread_mutex_lock(&server->push_mutex);
+        pthread_mutex_lock(&server->clients_mutex);
+        for (int i = 0; i < MAX_CLIENTS; i++)
+        {
+            ClientSession *client = &server->clients[i];
+            if (!client->active || !client->lobby)
+                continue;
+            targets[count].socket_fd = client->socket_fd;
+            targets[count].compress = client->compress;
+            strcpy(targets[count].username, client->username);
+            count++;
+        }
+        pthread_mutex_unlock(&server->clients_mutex);
+        sent = push_to_targets(targets, count, buffer, (size_t)msg_len, z_len > 0 ? zbuffer : NULL,
+                               z_len > 0 ? (size_t)z_len : 0);
+        pthread_mutex_unlock(&server->push_mutex);
+    }
+    free(zbuffer);
+    free(buffer);
+    return sent;
+}
@@ -25,16 +25,37 @@ void handle_create_room(Server *server, ClientSession *client, Message *msg);
  * @brief Handle LIST_ROOMS command
  * @param server Pointer to Server instance
  * @param client Pointer to ClientSession
- * @param msg Message parsed (LIST_ROOMS [filter])
+ * @param msg Message parsed (LIST_ROOMS [filter][|since_version])
  * Flow:
  * 1. Check authentication
  * 2. Validate filter parameter
- * 3. Query database for room list
+ * 3. since_version given: rooms changed since then (room_catalog), re-read by id
+ * 4. Otherwise (or version too old / too many changes): query database for room list
  * Filter options: ALL, NOT_STARTED, IN_PROGRESS, FINISHED
- * Response: 121 DATA <length>\n<JSON>
+ * Response: 121 DATA <length>\n{"version":..,"rooms":[...]}
+ *           121 DATA <length>\n{"version":..,"since":..,"removed":[room_id,...],"rooms":[...]} (delta)
+ *           126 NOT_MODIFIED <version> (nothing changed since since_version)
  */
 void handle_list_rooms(Server *server, ClientSession *client, Message *msg);
 
+#define ROOM_PAGE_DEFAULT_SIZE 20
+#define ROOM_PAGE_MAX_SIZE 50
+
+/**
+ * @brief Handle LIST_ROOMS_PAGE command (keyset pagination, mới nhất trước)
+ * @param server Pointer to Server instance
+ * @param client Pointer to ClientSession
+ * @param msg Message parsed (LIST_ROOMS_PAGE [filter|page_size|cursor|creator|name_prefix])
+ *            trailing params may be left out, "-" = default (e.g. LIST_ROOMS_PAGE ALL|-|-|alice)
+ * Flow:
+ * 1. Check authentication
+ * 2. Validate filter, page_size (1..50, default 20) and cursor
+ * 3. Query one page after the cursor (created_at, room_id), filtered by creator / name prefix
+ * Cursor is opaque: pass back the next_cursor of the previous page, "-" for the first page
+ * Response: 121 DATA <length>\n{"rooms":[...],"next_cursor":"..." | null}
+ */
+void handle_list_rooms_page(Server *server, ClientSession *client, Message *msg);
+
 /**
  * @brief Handle joining a room
  * @param server Pointer to Server instance
@@ -66,4 +87,29 @@ void handle_join_room(Server *server, ClientSession *client, Message *msg);
  */
 void handle_leave_room(Server *server, ClientSession *client, Message *msg);
 
+/**
+ * @brief Theo dõi thay đổi danh sách phòng (SUBSCRIBE_LOBBY)
+ * @param server Pointer tới Server instance
+ * @param client Pointer tới ClientSession
+ * @param msg Message đã parse (SUBSCRIBE_LOBBY)
+ *
+ * Flow:
+ * 1. Check authentication (221)
+ * 2. Response: 129 SUBSCRIBED <version> (version của room catalog)
+ * 3. Sau đó server push 129 DATA <length>\n<JSON batch> (tối đa LOBBY_PUSH_HZ lần/giây, xem lobby.h)
+ *    Event có version <= version của danh sách client đang có (LIST_ROOMS) thì đã nằm trong đó
+ */
+void handle_subscribe_lobby(Server *server, ClientSession *client, Message *msg);
+
+/**
+ * @brief Hủy theo dõi lobby (UNSUBSCRIBE_LOBBY) - 129 UNSUBSCRIBED
+ */
+void handle_unsubscribe_lobby(Server *server, ClientSession *client, Message *msg);
+
+/**
+ * @brief Gửi một batch lobby tới các session đã SUBSCRIBE_LOBBY (LobbyPushFn, ctx = Server*)
+ * @return Số session đã gửi, -1 nếu lỗi
+ */
+int broadcast_lobby(const char *json, size_t len, void *ctx);
+
 #endif // ROOM_H
\ No newline at end of file
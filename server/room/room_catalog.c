@@ -0,0 +1,69 @@
+#include "room_catalog.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+// Change with version v sits at log[(v - base - 1) % ROOM_CATALOG_LOG_SIZE]
+static pthread_mutex_t catalog_mutex = PTHREAD_MUTEX_INITIALIZER;
+static char change_log[ROOM_CATALOG_LOG_SIZE][MAX_ROOM_ID_LEN];
+static long long base_version;
+static long long current_version;
+
+void room_catalog_init(void)
+{
+    pthread_mutex_lock(&catalog_mutex);
+    base_version = (long long)time(NULL) * ROOM_CATALOG_EPOCH_STRIDE;
+    current_version = base_version;
+    pthread_mutex_unlock(&catalog_mutex);
+}
+
+long long room_catalog_version(void)
+{
+    pthread_mutex_lock(&catalog_mutex);
+    long long version = current_version;
+    pthread_mutex_unlock(&catalog_mutex);
+    return version;
+}
+
+long long room_catalog_touch(const char *room_id)
+{
+    pthread_mutex_lock(&catalog_mutex);
+    long long version = ++current_version;
+    snprintf(change_log[(version - base_version - 1) % ROOM_CATALOG_LOG_SIZE], MAX_ROOM_ID_LEN, "%s", room_id);
+    pthread_mutex_unlock(&catalog_mutex);
+    return version;
+}
+
+int room_catalog_changes_since(long long since, char room_ids[][MAX_ROOM_ID_LEN], int max, long long *version)
+{
+    pthread_mutex_lock(&catalog_mutex);
+    *version = current_version;
+
+    // Future, previous run, or already overwritten in the ring
+    if (since > current_version || since < base_version || current_version - since > ROOM_CATALOG_LOG_SIZE)
+    {
+        pthread_mutex_unlock(&catalog_mutex);
+        return ROOM_CATALOG_TOO_OLD;
+    }
+
+    int count = 0;
+    for (long long v = since + 1; v <= current_version; v++)
+    {
+        const char *room_id = change_log[(v - base_version - 1) % ROOM_CATALOG_LOG_SIZE];
+        int seen = 0;
+        for (int i = 0; i < count && !seen; i++)
+            seen = strcmp(room_ids[i], room_id) == 0;
+        if (seen)
+            continue;
+        if (count == max)
+        {
+            count = ROOM_CATALOG_TOO_OLD;
+            break;
+        }
+        strcpy(room_ids[count++], room_id);
+    }
+
+    pthread_mutex_unlock(&catalog_mutex);
+    return count;
+}
@@ -0,0 +1,54 @@
+#ifndef ROOM_CATALOG_H
+#define ROOM_CATALOG_H
+
+#include "../protocol/protocol.h"
+
+// ===============================================
+// ROOM CATALOG - version of the room list + recent changes
+// ===============================================
+//
+// Lobby clients poll LIST_ROOMS, and almost every poll returned the same
+// list. Every create/join/leave/start/finish/delete (reported through
+// lobby.h) bumps a catalog version and appends the room id to a ring of
+// the last ROOM_CATALOG_LOG_SIZE changes. A client that sends back the version of its
+// last list gets "not modified", or only the rooms changed since, re-read by
+// id; anything older than the ring gets the full list again.
+//
+// Versions start at (startup time * ROOM_CATALOG_EPOCH_STRIDE) so they keep
+// increasing across restarts (as long as a run makes fewer than
+// ROOM_CATALOG_EPOCH_STRIDE changes per second of uptime); a version from an
+// earlier run is older than the ring and answered with the full list.
+
+#define ROOM_CATALOG_LOG_SIZE 1024
+#define ROOM_CATALOG_EPOCH_STRIDE 1000000LL
+#define ROOM_CATALOG_MAX_DELTA 32 // more changed rooms: send the full list (16KB JSON)
+
+#define ROOM_CATALOG_TOO_OLD -1 // unknown version, outside the ring or too many changes
+
+/**
+ * @brief Start the version sequence from the clock (call once at startup)
+ */
+void room_catalog_init(void);
+
+/**
+ * @brief Current catalog version
+ */
+long long room_catalog_version(void);
+
+/**
+ * @brief A room was created, changed or deleted (lobby_room_* call it after the DB update)
+ * @return The new catalog version
+ */
+long long room_catalog_touch(const char *room_id);
+
+/**
+ * @brief Rooms changed after a version
+ * @param since Version the client already has
+ * @param room_ids Receives the distinct room ids (at most max)
+ * @param version Receives the current version the ids are valid up to
+ * @return Number of ids (0 = not modified), ROOM_CATALOG_TOO_OLD if the
+ *         caller must send the full list
+ */
+int room_catalog_changes_since(long long since, char room_ids[][MAX_ROOM_ID_LEN], int max, long long *version);
+
+#endif // ROOM_CATALOG_H
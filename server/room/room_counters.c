@@ -0,0 +1,131 @@
+#include "room_counters.h"
+#include "../protocol/protocol.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct RoomCounters
+{
+    char room_id[MAX_ROOM_ID_LEN];
+    struct RoomCounters *next; // hash chain
+    atomic_int participants;
+    atomic_int submitted;
+    atomic_int claimed; // 1 once a caller got ROOM_COUNTERS_COMPLETE
+} RoomCounters;
+
+// The table lock is only taken for writing on create/delete: join, leave and
+// submit hold it for reading and update the counters without any other lock.
+static pthread_rwlock_t rooms_lock = PTHREAD_RWLOCK_INITIALIZER;
+static RoomCounters *rooms[ROOM_COUNTERS_BUCKETS];
+
+static unsigned int hash_string(const char *s)
+{
+    unsigned int h = 2166136261u; // FNV-1a
+    while (*s)
+    {
+        h ^= (unsigned char)*s++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// Caller holds rooms_lock
+static RoomCounters **find_slot(const char *room_id)
+{
+    RoomCounters **slot = &rooms[hash_string(room_id) % ROOM_COUNTERS_BUCKETS];
+    while (*slot && strcmp((*slot)->room_id, room_id) != 0)
+        slot = &(*slot)->next;
+    return slot;
+}
+
+// Counters met and nobody claimed the room yet
+static int try_claim(RoomCounters *room)
+{
+    int participants = atomic_load(&room->participants);
+    if (participants <= 0 || atomic_load(&room->submitted) < participants)
+        return ROOM_COUNTERS_PENDING;
+
+    int expected = 0;
+    return atomic_compare_exchange_strong(&room->claimed, &expected, 1) ? ROOM_COUNTERS_COMPLETE : ROOM_COUNTERS_PENDING;
+}
+
+void room_counters_track(const char *room_id, int participants)
+{
+    pthread_rwlock_wrlock(&rooms_lock);
+    RoomCounters **slot = find_slot(room_id);
+    if (!*slot)
+    {
+        RoomCounters *room = calloc(1, sizeof(RoomCounters));
+        if (room)
+        {
+            strncpy(room->room_id, room_id, sizeof(room->room_id) - 1);
+            atomic_init(&room->participants, participants);
+            atomic_init(&room->submitted, 0);
+            atomic_init(&room->claimed, 0);
+            *slot = room;
+        }
+    }
+    pthread_rwlock_unlock(&rooms_lock);
+}
+
+void room_counters_remove(const char *room_id)
+{
+    pthread_rwlock_wrlock(&rooms_lock);
+    RoomCounters **slot = find_slot(room_id);
+    RoomCounters *room = *slot;
+    if (room)
+    {
+        *slot = room->next;
+        free(room);
+    }
+    pthread_rwlock_unlock(&rooms_lock);
+}
+
+void room_counters_join(const char *room_id)
+{
+    pthread_rwlock_rdlock(&rooms_lock);
+    RoomCounters *room = *find_slot(room_id);
+    if (room)
+        atomic_fetch_add(&room->participants, 1);
+    pthread_rwlock_unlock(&rooms_lock);
+}
+
+int room_counters_leave(const char *room_id)
+{
+    int result = ROOM_COUNTERS_UNKNOWN;
+    pthread_rwlock_rdlock(&rooms_lock);
+    RoomCounters *room = *find_slot(room_id);
+    if (room)
+    {
+        atomic_fetch_sub(&room->participants, 1);
+        result = try_claim(room);
+    }
+    pthread_rwlock_unlock(&rooms_lock);
+    return result;
+}
+
+int room_counters_submit(const char *room_id)
+{
+    int result = ROOM_COUNTERS_UNKNOWN;
+    pthread_rwlock_rdlock(&rooms_lock);
+    RoomCounters *room = *find_slot(room_id);
+    if (room)
+    {
+        atomic_fetch_add(&room->submitted, 1);
+        result = try_claim(room);
+    }
+    pthread_rwlock_unlock(&rooms_lock);
+    return result;
+}
+
+int room_counters_participants(const char *room_id)
+{
+    int participants = ROOM_COUNTERS_UNKNOWN;
+    pthread_rwlock_rdlock(&rooms_lock);
+    RoomCounters *room = *find_slot(room_id);
+    if (room)
+        participants = atomic_load(&room->participants);
+    pthread_rwlock_unlock(&rooms_lock);
+    return participants;
+}
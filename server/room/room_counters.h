@@ -0,0 +1,59 @@
+#ifndef ROOM_COUNTERS_H
+#define ROOM_COUNTERS_H
+
+// ===============================================
+// ROOM COUNTERS - participants / submissions kept in memory
+// ===============================================
+//
+// Completion used to be detected with db_check_all_submitted() after every
+// submission: two COUNT(*) queries under the DB lock, 100 queries for a
+// 50-person room. Each room created by this process now has two atomic
+// counters updated on create/join/leave/submit; the submit (or leave) that
+// makes them meet claims the room exactly once and the caller finishes it.
+//
+// Same rule as db_check_all_submitted: complete when participants > 0 and
+// submitted >= participants (the creator counts as a participant, a result
+// stays counted if its author leaves). Rooms created before the server
+// started are not tracked: callers fall back to the database.
+
+#define ROOM_COUNTERS_BUCKETS 1024 // room hash table
+
+#define ROOM_COUNTERS_UNKNOWN -1 // room not tracked
+#define ROOM_COUNTERS_PENDING 0  // still waiting for submissions (or already claimed)
+#define ROOM_COUNTERS_COMPLETE 1 // counters met: the caller finishes the room
+
+/**
+ * @brief Start tracking a newly created room
+ * @param participants Initial participants (the creator)
+ */
+void room_counters_track(const char *room_id, int participants);
+
+/**
+ * @brief Forget a room (deleted)
+ */
+void room_counters_remove(const char *room_id);
+
+/**
+ * @brief A participant joined
+ */
+void room_counters_join(const char *room_id);
+
+/**
+ * @brief A participant left
+ * @return ROOM_COUNTERS_COMPLETE if everyone left behind has submitted
+ */
+int room_counters_leave(const char *room_id);
+
+/**
+ * @brief A result was accepted
+ * @return ROOM_COUNTERS_COMPLETE for exactly one call per room, PENDING or UNKNOWN otherwise
+ */
+int room_counters_submit(const char *room_id);
+
+/**
+ * @brief Current participants (lobby pushes)
+ * @return Count, ROOM_COUNTERS_UNKNOWN if the room is not tracked
+ */
+int room_counters_participants(const char *room_id);
+
+#endif // ROOM_COUNTERS_H
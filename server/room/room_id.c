@@ -0,0 +1,53 @@
+#include "room_id.h"
+#include <stdatomic.h>
+#include <time.h>
+
+#define SEQUENCE_MASK ((1ULL << ROOM_ID_SEQUENCE_BITS) - 1)
+
+static const char DIGITS[] = "0123456789abcdefghjkmnpqrstvwxyz"; // Crockford: no i, l, o, u
+
+static uint64_t node_bits;
+// (ms since the epoch << ROOM_ID_SEQUENCE_BITS) | sequence of the last id
+static _Atomic uint64_t last_tick;
+
+static uint64_t now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    long long ms = (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000 - ROOM_ID_EPOCH_MS;
+    return ms > 0 ? (uint64_t)ms : 0;
+}
+
+int room_id_init(int node_id)
+{
+    if (node_id < 0 || node_id > ROOM_ID_MAX_NODE)
+        return -1;
+    node_bits = (uint64_t)node_id << ROOM_ID_SEQUENCE_BITS;
+    return 0;
+}
+
+uint64_t room_id_next(void)
+{
+    uint64_t fresh = now_ms() << ROOM_ID_SEQUENCE_BITS; // sequence 0 of the current ms
+    uint64_t last = atomic_load(&last_tick);
+    uint64_t next;
+    do
+    {
+        // Same ms (or clock behind the last id): next sequence, which
+        // carries into the following ms once 4096 are used
+        next = fresh > last ? fresh : last + 1;
+    } while (!atomic_compare_exchange_weak(&last_tick, &last, next));
+
+    uint64_t ms = next >> ROOM_ID_SEQUENCE_BITS;
+    return (ms << (ROOM_ID_NODE_BITS + ROOM_ID_SEQUENCE_BITS)) | node_bits | (next & SEQUENCE_MASK);
+}
+
+void room_id_format(uint64_t id, char out[MAX_ROOM_ID_LEN])
+{
+    for (int i = ROOM_ID_TEXT_LEN - 1; i >= 0; i--)
+    {
+        out[i] = DIGITS[id & 31];
+        id >>= 5;
+    }
+    out[ROOM_ID_TEXT_LEN] = '\0';
+}
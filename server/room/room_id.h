@@ -0,0 +1,47 @@
+#ifndef ROOM_ID_H
+#define ROOM_ID_H
+
+#include "../protocol/protocol.h"
+#include <stdint.h>
+
+// ===============================================
+// ROOM ID - Snowflake-style ids for CREATE_ROOM
+// ===============================================
+//
+// Room ids used to be time(NULL): two rooms created in the same second
+// collided on the UNIQUE key and cost a rolled-back transaction. An id is
+// now 64 bits:
+//   41 bits  milliseconds since ROOM_ID_EPOCH_MS (~69 years)
+//   10 bits  node id (--node-id, one per server sharing a database)
+//   12 bits  sequence within the millisecond (4096 ids/ms)
+// Generation is a compare-and-swap on the last (ms, sequence) pair: no lock
+// and no DB round trip. When a millisecond runs out of sequence numbers, or
+// the clock steps back, ids continue from the last one (time borrowed from
+// the next millisecond) instead of waiting.
+//
+// The text form is 13 Crockford base32 digits (lowercase, fixed width), so
+// ids sort like their numbers, i.e. by creation time.
+
+#define ROOM_ID_EPOCH_MS 1704067200000LL // 2024-01-01T00:00:00Z
+#define ROOM_ID_NODE_BITS 10
+#define ROOM_ID_SEQUENCE_BITS 12
+#define ROOM_ID_MAX_NODE ((1 << ROOM_ID_NODE_BITS) - 1)
+#define ROOM_ID_TEXT_LEN 13 // 64 bits / 5 bits per digit, rounded up
+
+/**
+ * @brief Set the node id stamped into every id (call once at startup)
+ * @return 0 on success, -1 if node_id is outside 0..ROOM_ID_MAX_NODE
+ */
+int room_id_init(int node_id);
+
+/**
+ * @brief Next id (thread-safe, lock-free)
+ */
+uint64_t room_id_next(void);
+
+/**
+ * @brief Text form of an id (ROOM_ID_TEXT_LEN digits + NUL)
+ */
+void room_id_format(uint64_t id, char out[MAX_ROOM_ID_LEN]);
+
+#endif // ROOM_ID_H
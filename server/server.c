@@ -1,14 +1,27 @@
 #include "server.h"
 #include "auth/auth.h"
 #include "room/room.h"
+#include "room/room_catalog.h"
+#include "room/lobby.h"
+#include "room/room_id.h"
 // #include "exam/exam.h"
-// #include "practice/practice.h"
+#include "practice/practice.h"
 #include "logger/logger.h"
+#include "metrics/metrics.h"
+#include "stats/stats.h"
+#include "stats/item_stats.h"
+#include "capture/capture.h"
+#include "leaderboard/leaderboard.h"
+#include "exam/exam_timer.h"
+#include "answers/answers.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <time.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
@@ -16,16 +29,32 @@
 // global server instance
 Server *g_server = NULL;
 
+// Every write to a client socket (reply or push) holds the lock of its fd, so
+// a push that stalls halfway cannot have a reply written into the gap. fds
+// are reused lowest first, so below SOCKET_WRITE_LOCKS each socket has its own
+// lock; above it two sockets may share one (a wait, never mixed bytes).
+#define SOCKET_WRITE_LOCKS (MAX_CLIENTS + 64)
+static pthread_mutex_t socket_write_locks[SOCKET_WRITE_LOCKS];
+
+static pthread_mutex_t *socket_write_lock(int socket_fd)
+{
+    return &socket_write_locks[(unsigned int)socket_fd % SOCKET_WRITE_LOCKS];
+}
+
 /**
  * @brief Initialize the server
  */
-int server_init(Server *server, int port)
+int server_init(Server *server, int port, const ServerOptions *options)
 {
     g_server = server;
     memset(server, 0, sizeof(Server));
+    server->options = *options;
 
     // initialize logger
-    if (logger_init("server.log") < 0)
+    int log_status = options->binary_log
+                         ? logger_init_format(SERVER_BINARY_LOG_FILE, LOG_FORMAT_BINARY)
+                         : logger_init(SERVER_LOG_FILE);
+    if (log_status < 0)
     {
         fprintf(stderr, "Failed to initialize logger\n");
         return -1;
@@ -47,7 +76,14 @@ int server_init(Server *server, int port)
     const char *dbname = "exam_system";
     unsigned int port_db = 3306;
 
-    if (db_connect_with_port(server->db, host, user, password, dbname, port_db) < 0)
+    int db_status;
+    if (options->db_backend && strcmp(options->db_backend, DB_BACKEND_MEMORY) == 0)
+        db_status = db_open_memory(server->db, options->db_seed);
+    else if (options->db_backend && strcmp(options->db_backend, DB_BACKEND_SQLITE) == 0)
+        db_status = db_open_sqlite(server->db, options->db_path, options->db_seed);
+    else
+        db_status = db_connect_with_port(server->db, host, user, password, dbname, port_db);
+    if (db_status < 0)
     {
         fprintf(stderr, "Failed to initialize database\n");
         log_event(LOG_ERROR, NULL, "SERVER", "Database initialization failed");
@@ -55,11 +91,108 @@ int server_init(Server *server, int port)
         server->db = NULL;
         return -1;
     }
-    printf("Database connected successfully\n");
-    log_event(LOG_INFO, NULL, "SERVER", "Database connected successfully");
+    if (options->results_journal && db_enable_results_journal(server->db, options->results_journal) < 0)
+    {
+        fprintf(stderr, "Failed to open results journal %s\n", options->results_journal);
+        log_event(LOG_ERROR, NULL, "SERVER", "Results journal %s failed", options->results_journal);
+        db_disconnect(server->db);
+        free(server->db);
+        server->db = NULL;
+        return -1;
+    }
+    printf("Database connected successfully (%s backend)\n", db_backend_name(server->db));
+    log_event(LOG_INFO, NULL, "SERVER", "Database connected successfully (%s backend)", db_backend_name(server->db));
 
     // initialize mutex
     pthread_mutex_init(&server->clients_mutex, NULL);
+    pthread_mutex_init(&server->push_mutex, NULL);
+    for (int i = 0; i < SOCKET_WRITE_LOCKS; i++)
+        pthread_mutex_init(&socket_write_locks[i], NULL);
+
+    // traffic capture (--capture)
+    if (options->capture_file)
+    {
+        if (capture_open(options->capture_file) < 0)
+        {
+            fprintf(stderr, "Failed to open capture file %s\n", options->capture_file);
+            log_event(LOG_ERROR, NULL, "SERVER", "Cannot open capture file %s", options->capture_file);
+            return -1;
+        }
+        printf("Capturing inbound traffic to %s\n", options->capture_file);
+        log_event(LOG_INFO, NULL, "SERVER", "Capturing inbound traffic to %s", options->capture_file);
+    }
+
+    // SAVE_ANSWER sheets of a previous run (--answers-journal)
+    if (options->answers_journal)
+    {
+        if (answers_open_journal(options->answers_journal) < 0)
+        {
+            fprintf(stderr, "Failed to open answers journal %s\n", options->answers_journal);
+            log_event(LOG_ERROR, NULL, "SERVER", "Cannot open answers journal %s", options->answers_journal);
+            return -1;
+        }
+        log_event(LOG_INFO, NULL, "SERVER", "Autosaving answers to %s", options->answers_journal);
+    }
+
+    // practice question bank in memory + score writer
+    if (practice_start(server->db) < 0)
+    {
+        fprintf(stderr, "Failed to start practice score writer\n");
+        log_event(LOG_ERROR, NULL, "SERVER", "Cannot start practice score writer");
+        return -1;
+    }
+
+    // per-question answer counters + their writer
+    if (item_stats_start(server->db) < 0)
+    {
+        fprintf(stderr, "Failed to start question statistics writer\n");
+        log_event(LOG_ERROR, NULL, "SERVER", "Cannot start question statistics writer");
+        return -1;
+    }
+
+    // room list versions (LIST_ROOMS <filter>|<since_version>)
+    room_catalog_init();
+
+    // CREATE_ROOM ids (--node-id)
+    if (room_id_init(options->node_id) < 0)
+    {
+        fprintf(stderr, "Invalid node id %d (0..%d)\n", options->node_id, ROOM_ID_MAX_NODE);
+        log_event(LOG_ERROR, NULL, "SERVER", "Invalid node id %d", options->node_id);
+        return -1;
+    }
+
+    // exam deadlines: START_EXAM cannot be accepted without it
+    if (exam_timer_start(exam_time_expired, server) < 0)
+    {
+        fprintf(stderr, "Failed to start exam timer thread\n");
+        log_event(LOG_ERROR, NULL, "SERVER", "Cannot start exam timer thread");
+        return -1;
+    }
+
+    // live leaderboard pushes (SUBSCRIBE_LEADERBOARD)
+    if (leaderboard_start_push(LEADERBOARD_PUSH_HZ, broadcast_leaderboard_delta, server) < 0)
+    {
+        fprintf(stderr, "Failed to start leaderboard push thread\n");
+        log_event(LOG_WARNING, NULL, "SERVER", "Leaderboard push thread unavailable");
+    }
+
+    // room list changes pushed to the lobby (SUBSCRIBE_LOBBY)
+    if (lobby_start_push(LOBBY_PUSH_HZ, broadcast_lobby, server) < 0)
+    {
+        fprintf(stderr, "Failed to start lobby push thread\n");
+        log_event(LOG_WARNING, NULL, "SERVER", "Lobby push thread unavailable");
+    }
+
+    // metrics scrape endpoint (127.0.0.1 only); the server still runs without it
+    if (metrics_init(options->metrics_port) < 0)
+    {
+        fprintf(stderr, "Failed to start metrics endpoint on port %d\n", options->metrics_port);
+        log_event(LOG_WARNING, NULL, "SERVER", "Metrics endpoint on port %d unavailable", options->metrics_port);
+    }
+    else if (options->metrics_port > 0)
+    {
+        printf("Metrics available at http://127.0.0.1:%d/metrics\n", options->metrics_port);
+    }
 
     // create socket
     server->server_fd = socket(AF_INET, SOCK_STREAM, 0);
@@ -159,6 +292,8 @@ void server_start(Server *server)
         client->state = STATE_CONNECTED;
         client->active = 1;
         client->last_activity = time(NULL);
+        client->conn_id = ++server->next_conn_id;
+        capture_connection(client->conn_id, CAPTURE_OPEN);
 
         // create thread to handle client
         pthread_create(&client->thread_id, NULL, handle_client, client);
@@ -169,6 +304,23 @@ void server_start(Server *server)
     log_event(LOG_INFO, NULL, "SERVER", "Server shutting down main loop");
 }
 
+/**
+ * @brief Handle COMPRESS command: COMPRESS deflate -> 202 COMPRESS_OK deflate
+ * DATA từ COMPRESS_MIN_BYTES trở lên được gửi dạng ZDATA cho đến khi đóng kết nối
+ */
+static void handle_compress(ClientSession *client, Message *msg)
+{
+    if (msg->param_count < 1 || strcmp(msg->params[0], COMPRESS_DEFLATE) != 0)
+    {
+        send_error_or_response(client->socket_fd, CODE_INVALID_PARAMS, "Usage: COMPRESS deflate");
+        return;
+    }
+    pthread_mutex_lock(&g_server->clients_mutex); // broadcasts read it under the lock
+    client->compress = 1;
+    pthread_mutex_unlock(&g_server->clients_mutex);
+    send_error_or_response(client->socket_fd, CODE_COMPRESS_OK, COMPRESS_DEFLATE);
+}
+
 /**
  * @brief Handle client connection
  * nhận và xử lý các command từ client
@@ -192,6 +344,9 @@ void *handle_client(void *arg)
             break;
         }
 
+        if (capture_enabled())
+            capture_data(client->conn_id, buffer, bytes_received);
+
         // parse control message
 
         // ==================================== Control message =====================================
@@ -205,6 +360,7 @@ void *handle_client(void *arg)
         }
 
         printf("[Thread %lu] Received command: %s\n", pthread_self(), msg.command);
+        uint64_t started_ns = metrics_now_ns();
 
         // handle commands
         if (strcmp(msg.command, MSG_REGISTER) == 0)
@@ -223,6 +379,10 @@ void *handle_client(void *arg)
         {
             handle_list_rooms(g_server, client, &msg);
         }
+        else if (strcmp(msg.command, MSG_LIST_ROOMS_PAGE) == 0)
+        {
+            handle_list_rooms_page(g_server, client, &msg);
+        }
         else if (strcmp(msg.command, MSG_CREATE_ROOM) == 0)
         {
             handle_create_room(g_server, client, &msg);
@@ -247,27 +407,84 @@ void *handle_client(void *arg)
         {
             handle_submit_exam(g_server, client, &msg);
         }
+        else if (strcmp(msg.command, MSG_PRACTICE) == 0)
+        {
+            handle_practice(g_server, client, &msg);
+        }
+        else if (strcmp(msg.command, MSG_SUBMIT_PRACTICE) == 0)
+        {
+            handle_submit_practice(g_server, client, &msg);
+        }
+        else if (strcmp(msg.command, MSG_PRACTICE_NEXT) == 0)
+        {
+            handle_practice_next(g_server, client, &msg);
+        }
+        else if (strcmp(msg.command, MSG_PRACTICE_ANSWER) == 0)
+        {
+            handle_practice_answer(g_server, client, &msg);
+        }
+        else if (strcmp(msg.command, MSG_SAVE_ANSWER) == 0)
+        {
+            handle_save_answer(g_server, client, &msg);
+        }
         else if (strcmp(msg.command, MSG_PING) == 0)
         {
             send_error_or_response(client->socket_fd, CODE_PONG, "PONG");
         }
+        else if (strcmp(msg.command, MSG_COMPRESS) == 0)
+        {
+            handle_compress(client, &msg);
+        }
         else if (strcmp(msg.command, MSG_VIEW_RESULT) == 0)
         {
             handle_view_result(g_server, client, &msg);
         }
+        else if (strcmp(msg.command, MSG_STATS) == 0)
+        {
+            handle_stats(g_server, client, &msg);
+        }
+        else if (strcmp(msg.command, MSG_ITEM_STATS) == 0)
+        {
+            handle_item_stats(g_server, client, &msg);
+        }
+        else if (strcmp(msg.command, MSG_SUBSCRIBE_LEADERBOARD) == 0)
+        {
+            handle_subscribe_leaderboard(g_server, client, &msg);
+        }
+        else if (strcmp(msg.command, MSG_UNSUBSCRIBE_LEADERBOARD) == 0)
+        {
+            handle_unsubscribe_leaderboard(g_server, client, &msg);
+        }
+        else if (strcmp(msg.command, MSG_SUBSCRIBE_LOBBY) == 0)
+        {
+            handle_subscribe_lobby(g_server, client, &msg);
+        }
+        else if (strcmp(msg.command, MSG_UNSUBSCRIBE_LOBBY) == 0)
+        {
+            handle_unsubscribe_lobby(g_server, client, &msg);
+        }
         else
         {
             send_error_or_response(client->socket_fd, CODE_BAD_COMMAND, msg.command);
             log_event(LOG_WARNING, client->username[0] ? client->username : "anonymous", "BAD_COMMAND", "Unknown command: %s", msg.command);
         }
 
+        MetricCommand metric = metrics_command_from_name(msg.command);
+        uint64_t elapsed_ns = metrics_now_ns() - started_ns;
+        metrics_record_command(metric, elapsed_ns);
+        stats_record_command(metric, client->username, elapsed_ns);
         free_message(&msg);
     }
 
     // cleanup
+    capture_connection(client->conn_id, CAPTURE_CLOSE);
+    if (client->username[0])
+        practice_discard(client->username);
     remove_client_session(g_server, client->socket_fd);
+    pthread_mutex_lock(&g_server->push_mutex); // no push in flight still holds this fd number
     close(client->socket_fd);
     client->active = 0;
+    pthread_mutex_unlock(&g_server->push_mutex);
 
     printf("[Thread %lu] Cleaning up client socket %d\n", pthread_self(), client->socket_fd);
     return NULL;
@@ -337,6 +554,17 @@ void remove_client_session(Server *server, int socket_fd)
     pthread_mutex_unlock(&server->clients_mutex);
 }
 
+/**
+ * @brief Write a complete reply, never interleaved with a push to the same socket
+ */
+void send_reply(int socket_fd, const char *data, size_t len)
+{
+    pthread_mutex_t *lock = socket_write_lock(socket_fd);
+    pthread_mutex_lock(lock);
+    send_full(socket_fd, data, len);
+    pthread_mutex_unlock(lock);
+}
+
 /**
  * @brief Send error/response to client
  */
@@ -344,5 +572,138 @@ void send_error_or_response(int socket_fd, int code, const char *message)
 {
     char buffer[MAX_MESSAGE_LEN];
     int len = create_simple_response(code, message, buffer, sizeof(buffer));
-    send_full(socket_fd, buffer, len);
+    send_reply(socket_fd, buffer, (size_t)len);
+}
+
+// "CODE DATA <length>\n<data>" (or ZDATA) for this client; malloc'd, NULL on error
+static char *build_data_message(const ClientSession *client, int code, const char *data, size_t data_len, int *len_out)
+{
+    size_t size = data_len + 64;
+    char *buffer = malloc(size);
+    if (!buffer)
+        return NULL;
+
+    int len = 0;
+    if (client->compress && data_len >= COMPRESS_MIN_BYTES)
+        len = create_zdata_message(code, data, data_len, buffer, size);
+    if (len <= 0) // not smaller compressed (or zlib error): plain DATA
+        len = create_data_message(code, data, data_len, buffer, size);
+    if (len <= 0)
+    {
+        free(buffer);
+        return NULL;
+    }
+    *len_out = len;
+    return buffer;
+}
+
+/**
+ * @brief Send "CODE DATA <length>\n<data>", as ZDATA if the client negotiated COMPRESS
+ * @return 0 if sent, -1 on error (nothing sent)
+ */
+int send_data_message(ClientSession *client, int code, const char *data, size_t data_len)
+{
+    int len = 0;
+    char *buffer = build_data_message(client, code, data, data_len, &len);
+    if (!buffer)
+        return -1;
+    send_reply(client->socket_fd, buffer, (size_t)len);
+    free(buffer);
+    return 0;
+}
+
+// Disconnect a session that does not take its push: its thread sees EOF and cleans up
+static void drop_push_target(const PushTarget *target, const char *reason, size_t left)
+{
+    shutdown(target->socket_fd, SHUT_RDWR);
+    printf("[PUSH] Dropped '%s': %s (%zu bytes left)\n", target->username, reason, left);
+    log_event(LOG_WARNING, target->username[0] ? target->username : "anonymous", "PUSH", "Disconnected: %s within %d ms", reason, PUSH_SEND_TIMEOUT_MS);
+}
+
+/**
+ * @brief Write a push without waiting more than PUSH_SEND_TIMEOUT_MS for the client to read
+ * A session that stays full is disconnected: part of the message may already
+ * be written, so its stream cannot be used anymore. The same goes for a session
+ * whose own thread keeps the socket busy with a reply it does not read.
+ * Caller holds push_mutex.
+ * @return 0 if sent, -1 if the session was dropped
+ */
+int send_push(const PushTarget *target, const char *data, size_t len)
+{
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_nsec += (long)PUSH_SEND_TIMEOUT_MS * 1000000L;
+    deadline.tv_sec += deadline.tv_nsec / 1000000000L;
+    deadline.tv_nsec %= 1000000000L;
+    pthread_mutex_t *lock = socket_write_lock(target->socket_fd);
+    if (pthread_mutex_timedlock(lock, &deadline) != 0)
+    {
+        drop_push_target(target, "reply not read", len);
+        return -1;
+    }
+
+    struct timespec start, now;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    while (len > 0)
+    {
+        ssize_t n = send(target->socket_fd, data, len, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (n > 0)
+        {
+            data += n;
+            len -= (size_t)n;
+            continue;
+        }
+        if (n < 0 && errno == EINTR)
+            continue;
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        long waited_ms = (now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) && waited_ms < PUSH_SEND_TIMEOUT_MS)
+        {
+            struct pollfd pfd = {target->socket_fd, POLLOUT, 0};
+            poll(&pfd, 1, (int)(PUSH_SEND_TIMEOUT_MS - waited_ms));
+            continue;
+        }
+
+        drop_push_target(target, "push not read", len);
+        pthread_mutex_unlock(lock);
+        return -1;
+    }
+    pthread_mutex_unlock(lock);
+    return 0;
+}
+
+/**
+ * @brief send_data_message for a reply that must be ordered with pushes (caller holds push_mutex)
+ * @return 0 if sent, -1 on error or if the session was dropped
+ */
+int send_data_push(ClientSession *client, int code, const char *data, size_t data_len)
+{
+    PushTarget target = {client->socket_fd, client->compress, ""};
+    snprintf(target.username, sizeof(target.username), "%s", client->username);
+
+    int len = 0;
+    char *buffer = build_data_message(client, code, data, data_len, &len);
+    if (!buffer)
+        return -1;
+    int rc = send_push(&target, buffer, (size_t)len);
+    free(buffer);
+    return rc;
+}
+
+/**
+ * @brief Write one message to every target, ZDATA to those that negotiated COMPRESS when zmessage is set
+ * Caller holds push_mutex (targets were copied under clients_mutex after taking it)
+ * @return Number of sessions it was delivered to
+ */
+int push_to_targets(const PushTarget *targets, int count, const char *message, size_t len, const char *zmessage, size_t zlen)
+{
+    int sent = 0;
+    for (int i = 0; i < count; i++)
+    {
+        int compressed = targets[i].compress && zmessage;
+        if (send_push(&targets[i], compressed ? zmessage : message, compressed ? zlen : len) == 0)
+            sent++;
+    }
+    return sent;
 }
\ No newline at end of file
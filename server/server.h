@@ -10,6 +10,26 @@
 #define MAX_CLIENTS 100
 #define SERVER_PORT 8888
 #define SESSION_TIMEOUT_MINUTES 30
+#define SERVER_LOG_FILE "server.log"
+#define SERVER_BINARY_LOG_FILE "server.binlog"
+#define PUSH_SEND_TIMEOUT_MS 500 // a session that does not read a push for this long is disconnected
+
+/**
+ * @brief Startup options (parsed from the command line in main.c)
+ */
+typedef struct
+{
+    int binary_log;              // 1 = binary log (decode with bin/log_decoder)
+    int metrics_port;            // Prometheus endpoint on 127.0.0.1 (0 = disabled)
+    const char *capture_file;    // record inbound traffic for bin/replay (NULL = off)
+    const char *db_backend;      // DB_BACKEND_MYSQL (default), DB_BACKEND_MEMORY or DB_BACKEND_SQLITE
+    const char *db_seed;         // schema.sql to seed memory / new sqlite databases (NULL = DB_MEMORY_SEED_FILE)
+    const char *db_path;         // sqlite database file (NULL = DB_SQLITE_FILE)
+    const char *results_journal; // write-behind journal for exam results (NULL = off)
+    int push_exam;               // 1 = send the exam (150 DATA) together with 125 START_OK
+    const char *answers_journal; // SAVE_ANSWER autosave journal (NULL = memory only)
+    int node_id;                 // stamped into room ids (0..ROOM_ID_MAX_NODE, distinct per server on one DB)
+} ServerOptions;
 
 /**
  * @brief Client states
@@ -37,19 +57,36 @@ typedef struct ClientSession
     time_t last_activity;
     pthread_t thread_id;
     int active;
+    uint32_t conn_id; // unique per accepted connection (capture/replay)
+    char subscribed_room[MAX_ROOM_ID_LEN]; // live leaderboard (SUBSCRIBE_LEADERBOARD), "" = none
+    int compress;                          // COMPRESS deflate: large DATA sent as ZDATA
+    int lobby;                             // room list changes pushed (SUBSCRIBE_LOBBY)
 } ClientSession;
 
+/**
+ * @brief A session a push (START_OK, leaderboard, lobby) goes to, copied under clients_mutex
+ */
+typedef struct
+{
+    int socket_fd;
+    int compress;
+    char username[MAX_USERNAME_LEN + 1];
+} PushTarget;
+
 typedef struct Server
 {
     int server_fd;
     Database *db; // Pointer to database (standard design)
     ClientSession clients[MAX_CLIENTS];
     pthread_mutex_t clients_mutex;
+    pthread_mutex_t push_mutex; // held while pushes are written (taken before clients_mutex); closing a socket waits for it
     int running;
+    ServerOptions options;
+    uint32_t next_conn_id; // only touched by the accept loop
 } Server;
 
 // Server lifecycle
-int server_init(Server *server, int port);
+int server_init(Server *server, int port, const ServerOptions *options);
 void server_start(Server *server);
 void server_stop(Server *server);
 void server_cleanup(Server *server);
@@ -61,6 +98,11 @@ ClientSession *find_session_by_username(Server *server, const char *username);
 void remove_client_session(Server *server, int socket_fd);
 
 // Utility functions
+void send_reply(int socket_fd, const char *data, size_t len);
 void send_error_or_response(int socket_fd, int code, const char *message);
+int send_data_message(ClientSession *client, int code, const char *data, size_t data_len);
+int send_push(const PushTarget *target, const char *data, size_t len);
+int send_data_push(ClientSession *client, int code, const char *data, size_t data_len);
+int push_to_targets(const PushTarget *targets, int count, const char *message, size_t len, const char *zmessage, size_t zlen);
 
 #endif // SERVER_H
\ No newline at end of file
@@ -0,0 +1,438 @@
+#include "item_stats.h"
+#include "stats.h"
+#include "../server.h"
+#include "../auth/auth.h"
+#include "../logger/logger.h"
+#include "../metrics/metrics.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define ITEM_CHOICES 5 // A, B, C, D, unanswered
+
+typedef struct
+{
+    atomic_ullong choices[ITEM_CHOICES];
+    atomic_ullong correct;
+    atomic_ullong time_ms;
+    atomic_int dirty; // changed since the last flush
+    char key;         // correct answer in the bank, '\0' if no such question
+} ItemCounters;
+
+typedef struct RoomQuestions
+{
+    char room_id[MAX_ROOM_ID_LEN];
+    struct RoomQuestions *next; // hash chain
+    int count;
+    int ids[ITEM_STATS_MAX_QUESTIONS]; // question_order
+} RoomQuestions;
+
+// Sized once at startup, read-only afterwards (only the counters change)
+static ItemCounters *items;
+static int item_capacity; // items[0 .. item_capacity-1], index = question id
+
+// Written on START_EXAM / room end, read by every graded sheet
+static pthread_rwlock_t rooms_lock = PTHREAD_RWLOCK_INITIALIZER;
+static RoomQuestions *rooms[ITEM_STATS_ROOM_BUCKETS];
+
+static pthread_mutex_t flush_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t flush_cond = PTHREAD_COND_INITIALIZER;
+static int flush_running;
+static pthread_t flush_thread;
+static Database *flush_db;
+
+static unsigned int hash_string(const char *s)
+{
+    unsigned int h = 2166136261u; // FNV-1a
+    while (*s)
+    {
+        h ^= (unsigned char)*s++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// Caller holds rooms_lock
+static RoomQuestions **find_slot(const char *room_id)
+{
+    RoomQuestions **slot = &rooms[hash_string(room_id) % ITEM_STATS_ROOM_BUCKETS];
+    while (*slot && strcmp((*slot)->room_id, room_id) != 0)
+        slot = &(*slot)->next;
+    return slot;
+}
+
+static ItemCounters *item_at(int question_id)
+{
+    return question_id > 0 && question_id < item_capacity && items[question_id].key ? &items[question_id] : NULL;
+}
+
+// ===============================================
+// Startup
+// ===============================================
+
+// Grows items[] as the bank is read (ids come in ascending order)
+static int add_question(void *ctx, const DbQuestion *question)
+{
+    (void)ctx;
+    if (question->id <= 0)
+        return 0;
+    if (question->id >= item_capacity)
+    {
+        int capacity = item_capacity ? item_capacity : 64;
+        while (capacity <= question->id)
+            capacity *= 2;
+        ItemCounters *grown = realloc(items, (size_t)capacity * sizeof(ItemCounters));
+        if (!grown)
+            return -1;
+        memset(grown + item_capacity, 0, (size_t)(capacity - item_capacity) * sizeof(ItemCounters));
+        items = grown;
+        item_capacity = capacity;
+    }
+    items[question->id].key = question->correct_answer;
+    return 0;
+}
+
+static int load_baseline(void *ctx, const DbQuestionStats *row)
+{
+    int *loaded = ctx;
+    ItemCounters *item = item_at(row->question_id);
+    if (!item)
+        return 0; // question deleted since (the row goes with it)
+    for (int c = 0; c < ITEM_CHOICES; c++)
+        atomic_store(&item->choices[c], (unsigned long long)row->choices[c]);
+    atomic_store(&item->correct, (unsigned long long)row->correct);
+    atomic_store(&item->time_ms, (unsigned long long)row->time_ms);
+    (*loaded)++;
+    return 0;
+}
+
+// ===============================================
+// Flush
+// ===============================================
+
+// 0 if written; otherwise the rows are marked to be written again next time
+static int save_rows(Database *db, const DbQuestionStats *rows, int count)
+{
+    if (db_save_question_stats(db, rows, count) == 0)
+        return 0;
+    for (int i = 0; i < count; i++)
+        atomic_store(&items[rows[i].question_id].dirty, 1);
+    return 1;
+}
+
+// Upsert the questions changed since the last call; -1 if a batch failed
+static int flush_items(Database *db)
+{
+    DbQuestionStats rows[ITEM_STATS_WRITE_BATCH];
+    int count = 0, failed = 0;
+    for (int id = 1; id < item_capacity; id++)
+    {
+        ItemCounters *item = &items[id];
+        if (!atomic_exchange(&item->dirty, 0))
+            continue;
+
+        DbQuestionStats *row = &rows[count++];
+        row->question_id = id;
+        row->attempts = 0;
+        for (int c = 0; c < ITEM_CHOICES; c++)
+        {
+            row->choices[c] = (long long)atomic_load_explicit(&item->choices[c], memory_order_relaxed);
+            row->attempts += row->choices[c];
+        }
+        row->correct = (long long)atomic_load_explicit(&item->correct, memory_order_relaxed);
+        row->time_ms = (long long)atomic_load_explicit(&item->time_ms, memory_order_relaxed);
+
+        if (count == ITEM_STATS_WRITE_BATCH)
+        {
+            failed |= save_rows(db, rows, count);
+            count = 0;
+        }
+    }
+    if (count > 0)
+        failed |= save_rows(db, rows, count);
+    return failed ? -1 : 0;
+}
+
+static void *flush_loop(void *arg)
+{
+    (void)arg;
+    int deferred = 0;
+    pthread_mutex_lock(&flush_mutex);
+    while (flush_running)
+    {
+        struct timespec wake;
+        clock_gettime(CLOCK_REALTIME, &wake);
+        wake.tv_sec += ITEM_STATS_FLUSH_INTERVAL_MS / 1000;
+        wake.tv_nsec += (ITEM_STATS_FLUSH_INTERVAL_MS % 1000) * 1000000L;
+        if (wake.tv_nsec >= 1000000000L)
+        {
+            wake.tv_sec++;
+            wake.tv_nsec -= 1000000000L;
+        }
+        pthread_cond_timedwait(&flush_cond, &flush_mutex, &wake);
+        if (!flush_running)
+            break;
+
+        // Exams first: postpone while the database is busy, but not forever
+        if (metrics_db_inflight() > 0 && deferred < ITEM_STATS_MAX_DEFERRED)
+        {
+            deferred++;
+            continue;
+        }
+        deferred = 0;
+        pthread_mutex_unlock(&flush_mutex);
+
+        if (flush_items(flush_db) < 0)
+            log_event(LOG_WARNING, NULL, "ITEM_STATS", "Failed to save question statistics, retrying");
+
+        pthread_mutex_lock(&flush_mutex);
+    }
+    pthread_mutex_unlock(&flush_mutex);
+    return NULL;
+}
+
+// ===============================================
+// API
+// ===============================================
+
+int item_stats_start(Database *db)
+{
+    if (db_load_questions(db, add_question, NULL) < 0)
+        log_event(LOG_WARNING, NULL, "ITEM_STATS", "Question bank unavailable, no question statistics");
+    int loaded = 0;
+    if (item_capacity > 0 && db_load_question_stats(db, load_baseline, &loaded) < 0)
+        log_event(LOG_WARNING, NULL, "ITEM_STATS", "Failed to load question statistics, counting from zero");
+
+    flush_db = db;
+    flush_running = 1;
+    if (pthread_create(&flush_thread, NULL, flush_loop, NULL) != 0)
+    {
+        flush_running = 0;
+        return -1;
+    }
+    printf("Question statistics: %d question(s) with history\n", loaded);
+    return 0;
+}
+
+void item_stats_stop(void)
+{
+    pthread_mutex_lock(&flush_mutex);
+    int running = flush_running;
+    flush_running = 0;
+    pthread_cond_signal(&flush_cond);
+    pthread_mutex_unlock(&flush_mutex);
+    if (!running)
+        return;
+    pthread_join(flush_thread, NULL);
+
+    // Last counts: the database is still connected
+    if (flush_items(flush_db) < 0)
+        log_event(LOG_WARNING, NULL, "ITEM_STATS", "Question statistics since the last flush not saved");
+
+    pthread_rwlock_wrlock(&rooms_lock);
+    for (int b = 0; b < ITEM_STATS_ROOM_BUCKETS; b++)
+    {
+        while (rooms[b])
+        {
+            RoomQuestions *next = rooms[b]->next;
+            free(rooms[b]);
+            rooms[b] = next;
+        }
+    }
+    pthread_rwlock_unlock(&rooms_lock);
+
+    free(items);
+    items = NULL;
+    item_capacity = 0;
+}
+
+int item_stats_track_room(const char *room_id, const int *question_ids, int count)
+{
+    if (count <= 0 || count > ITEM_STATS_MAX_QUESTIONS)
+        return -1;
+
+    int result = 0;
+    pthread_rwlock_wrlock(&rooms_lock);
+    RoomQuestions **slot = find_slot(room_id);
+    if (!*slot)
+    {
+        RoomQuestions *room = calloc(1, sizeof(RoomQuestions));
+        if (room)
+        {
+            strncpy(room->room_id, room_id, sizeof(room->room_id) - 1);
+            room->count = count;
+            memcpy(room->ids, question_ids, (size_t)count * sizeof(int));
+            *slot = room;
+        }
+        else
+            result = -1;
+    }
+    pthread_rwlock_unlock(&rooms_lock);
+    return result;
+}
+
+void item_stats_remove_room(const char *room_id)
+{
+    pthread_rwlock_wrlock(&rooms_lock);
+    RoomQuestions **slot = find_slot(room_id);
+    RoomQuestions *room = *slot;
+    if (room)
+    {
+        *slot = room->next;
+        free(room);
+    }
+    pthread_rwlock_unlock(&rooms_lock);
+}
+
+int item_stats_record(const char *room_id, const char *answers, const char *correct_answers, int time_taken)
+{
+    pthread_rwlock_rdlock(&rooms_lock);
+    RoomQuestions *room = *find_slot(room_id);
+    if (!room)
+    {
+        pthread_rwlock_unlock(&rooms_lock);
+        return ITEM_STATS_UNKNOWN;
+    }
+
+    unsigned long long share_ms = time_taken > 0 ? (unsigned long long)time_taken * 1000 / (unsigned long long)room->count : 0;
+    const char *p = answers;
+    for (int i = 0; i < room->count && correct_answers[i]; i++)
+    {
+        // Same tokens as grade_answers (strtok on ','): empty fields are skipped
+        while (*p == ',')
+            p++;
+        while (*p == ' ')
+            p++;
+        char choice = *p;
+        while (*p && *p != ',')
+            p++;
+
+        ItemCounters *item = item_at(room->ids[i]);
+        if (!item)
+            continue;
+        int slot = choice >= 'A' && choice <= 'D' ? choice - 'A' : ITEM_CHOICES - 1;
+        atomic_fetch_add_explicit(&item->choices[slot], 1, memory_order_relaxed);
+        if (choice == correct_answers[i])
+            atomic_fetch_add_explicit(&item->correct, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&item->time_ms, share_ms, memory_order_relaxed);
+        if (!atomic_load_explicit(&item->dirty, memory_order_relaxed))
+            atomic_store_explicit(&item->dirty, 1, memory_order_relaxed);
+    }
+    pthread_rwlock_unlock(&rooms_lock);
+    return ITEM_STATS_OK;
+}
+
+// ===============================================
+// ITEM_STATS command
+// ===============================================
+
+// "key_suspect": a distractor beats the key; "too_easy": almost everybody is right
+static const char *item_flag(const ItemCounters *item, const unsigned long long *choices,
+                             unsigned long long attempts, unsigned long long correct)
+{
+    if (attempts < ITEM_STATS_MIN_ATTEMPTS)
+        return NULL;
+    int key = item->key - 'A';
+    for (int c = 0; c < 4; c++)
+    {
+        if (c != key && key >= 0 && key < 4 && choices[c] > choices[key])
+            return "key_suspect";
+    }
+    if (correct * 100 >= attempts * ITEM_STATS_TOO_EASY_PERCENT)
+        return "too_easy";
+    return NULL;
+}
+
+// Appends one question; returns the bytes written, 0 if it has no attempts
+static int append_item(char *json, size_t size, int id, int first)
+{
+    ItemCounters *item = &items[id];
+    unsigned long long choices[ITEM_CHOICES];
+    for (int c = 0; c < ITEM_CHOICES; c++)
+        choices[c] = atomic_load_explicit(&item->choices[c], memory_order_relaxed);
+    unsigned long long attempts = choices[0] + choices[1] + choices[2] + choices[3] + choices[4];
+    if (attempts == 0)
+        return 0;
+    unsigned long long correct = atomic_load_explicit(&item->correct, memory_order_relaxed);
+    unsigned long long time_ms = atomic_load_explicit(&item->time_ms, memory_order_relaxed);
+    const char *flag = item_flag(item, choices, attempts, correct);
+
+    int n = snprintf(json, size,
+                     "%s{\"question_id\":%d,\"key\":\"%c\",\"attempts\":%llu,\"correct\":%llu,\"p_correct\":%.4f,"
+                     "\"choices\":{\"A\":%llu,\"B\":%llu,\"C\":%llu,\"D\":%llu,\"none\":%llu},"
+                     "\"mean_time_s\":%.1f,\"flag\":%s%s%s}",
+                     first ? "" : ",", id, item->key, attempts, correct, (double)correct / (double)attempts,
+                     choices[0], choices[1], choices[2], choices[3], choices[4],
+                     (double)time_ms / 1000.0 / (double)attempts,
+                     flag ? "\"" : "", flag ? flag : "null", flag ? "\"" : "");
+    return n > 0 && (size_t)n < size ? n : -1;
+}
+
+/**
+ * @brief Handle ITEM_STATS command
+ */
+void handle_item_stats(Server *server, ClientSession *client, Message *msg)
+{
+    (void)server;
+
+    if (!check_authentication(client))
+    {
+        send_error_or_response(client->socket_fd, CODE_NOT_LOGGED, "Not authenticated");
+        return;
+    }
+    if (strcmp(client->username, STATS_ADMIN_USERNAME) != 0)
+    {
+        send_error_or_response(client->socket_fd, CODE_NOT_ALLOWED, "Admin only");
+        log_event(LOG_WARNING, client->username, "ITEM_STATS", "Denied: not admin");
+        return;
+    }
+
+    int from = 1, to = item_capacity - 1;
+    if (msg->param_count > 0 && msg->params[0][0])
+    {
+        char *end;
+        long id = strtol(msg->params[0], &end, 10);
+        if (*end || !item_at((int)id))
+        {
+            send_error_or_response(client->socket_fd, CODE_INVALID_PARAMS, "Unknown question id");
+            return;
+        }
+        from = to = (int)id;
+    }
+
+    // Bounded by the question bank: one object is well under 320 bytes
+    size_t size = (size_t)(to >= from ? to - from + 1 : 0) * 320 + 128;
+    char *json = malloc(size);
+    if (!json)
+    {
+        send_error_or_response(client->socket_fd, CODE_INTERNAL_ERROR, "Out of memory");
+        return;
+    }
+
+    size_t len = (size_t)snprintf(json, size, "{\"time\":%ld,\"min_attempts\":%d,\"questions\":[",
+                                  (long)time(NULL), ITEM_STATS_MIN_ATTEMPTS);
+    int listed = 0;
+    for (int id = from; id <= to; id++)
+    {
+        if (!items[id].key)
+            continue;
+        int n = append_item(json + len, size - len, id, listed == 0);
+        if (n < 0)
+            break;
+        if (n > 0)
+        {
+            len += (size_t)n;
+            listed++;
+        }
+    }
+    len += (size_t)snprintf(json + len, size - len, "]}");
+
+    if (send_data_message(client, CODE_STATS_DATA, json, len) == 0)
+        log_event(LOG_INFO, client->username, "ITEM_STATS", "%d question(s) sent (%zu bytes)", listed, len);
+    else
+        send_error_or_response(client->socket_fd, CODE_INTERNAL_ERROR, "Failed to build response");
+    free(json);
+}
@@ -0,0 +1,82 @@
+#ifndef ITEM_STATS_H
+#define ITEM_STATS_H
+
+#include "../protocol/protocol.h"
+#include "../database/database.h"
+
+typedef struct ClientSession ClientSession;
+typedef struct Server Server;
+
+// ===============================================
+// ITEM STATS - thống kê từng câu hỏi, cập nhật khi chấm bài
+// ===============================================
+//
+// Counters per question_id (choices A..D / unanswered, correct, time) live
+// in an array indexed by question id, sized from the question bank at
+// startup and seeded from question_stats. Grading a sheet costs one lookup
+// of the room's question ids (read from the DB once per room, at START_EXAM)
+// and a few relaxed atomic adds per question. A thread upserts the
+// cumulative values of the changed questions every few seconds; a crash
+// loses what was counted since the last flush.
+//
+// Time per question is not measured (SUBMIT_EXAM only knows the exam time),
+// so each answer adds its share of the exam time: time_taken / questions.
+
+#define ITEM_STATS_ROOM_BUCKETS 1024
+#define ITEM_STATS_MAX_QUESTIONS 64      // per room (rooms draw at most 50)
+#define ITEM_STATS_WRITE_BATCH 256       // rows per db_save_question_stats
+#define ITEM_STATS_FLUSH_INTERVAL_MS 5000
+#define ITEM_STATS_MAX_DEFERRED 6        // flushes postponed in a row while exams use the DB
+#define ITEM_STATS_MIN_ATTEMPTS 20       // before ITEM_STATS flags a question
+#define ITEM_STATS_TOO_EASY_PERCENT 95
+
+#define ITEM_STATS_OK 0
+#define ITEM_STATS_UNKNOWN -1 // room not tracked
+
+/**
+ * @brief Tạo bảng thống kê từ ngân hàng câu hỏi + question_stats, khởi động flush thread
+ * @return 0 nếu thành công, -1 nếu lỗi (không tạo được thread)
+ */
+int item_stats_start(Database *db);
+
+/**
+ * @brief Dừng flush thread, ghi nốt thống kê (gọi trước db_disconnect)
+ */
+void item_stats_stop(void);
+
+/**
+ * @brief Ghi nhớ question_id của một phòng theo question_order (idempotent)
+ * @return 0 nếu thành công, -1 nếu lỗi
+ */
+int item_stats_track_room(const char *room_id, const int *question_ids, int count);
+
+/**
+ * @brief Quên phòng (phòng kết thúc / bị xóa)
+ */
+void item_stats_remove_room(const char *room_id);
+
+/**
+ * @brief Cộng một bài đã chấm vào thống kê (chỉ các phép cộng atomic)
+ * @param answers Đáp án như grade_answers ("A,B,-,D")
+ * @param correct_answers Đáp án đúng ("ABCD")
+ * @param time_taken Thời gian làm bài (giây)
+ * @return ITEM_STATS_OK, ITEM_STATS_UNKNOWN nếu phòng chưa được track
+ */
+int item_stats_record(const char *room_id, const char *answers, const char *correct_answers, int time_taken);
+
+/**
+ * @brief Xử lý lệnh ITEM_STATS (chỉ admin)
+ * @param server Pointer tới Server instance
+ * @param client Pointer tới ClientSession
+ * @param msg Message đã parse (ITEM_STATS [question_id])
+ *
+ * Flow:
+ * 1. Check authentication (221) và quyền admin (229)
+ * 2. Đọc các bộ đếm trong bộ nhớ (không truy vấn DB)
+ * 3. Response: 160 DATA <length>\n{"questions":[{"question_id":..,"attempts":..,"correct":..,
+ *    "choices":{..},"mean_time_s":..,"flag":..},...]}
+ *    flag: "key_suspect" (một phương án sai được chọn nhiều hơn đáp án), "too_easy", hoặc null
+ */
+void handle_item_stats(Server *server, ClientSession *client, Message *msg);
+
+#endif // ITEM_STATS_H
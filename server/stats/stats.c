@@ -0,0 +1,225 @@
+#include "stats.h"
+#include "../server.h"
+#include "../auth/auth.h"
+#include "../database/db_journal.h"
+#include "../room/lobby.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <time.h>
+
+/**
+ * @brief One slow command remembered for STATS
+ */
+typedef struct
+{
+    MetricCommand command;
+    char username[MAX_USERNAME_LEN + 1];
+    uint64_t elapsed_ns;
+    time_t at;
+} SlowCommand;
+
+// Slow commands are rare: a mutex is fine here and keeps the ring simple
+static pthread_mutex_t slow_mutex = PTHREAD_MUTEX_INITIALIZER;
+static SlowCommand slow_ring[STATS_SLOW_RING_SIZE];
+static unsigned int slow_count = 0; // total recorded, slow_ring[slow_count % SIZE] is next
+
+static pthread_mutex_t cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+static StatsCache caches[STATS_MAX_CACHES];
+static atomic_int cache_count = 0;
+
+StatsCache *stats_register_cache(const char *name)
+{
+    StatsCache *cache = NULL;
+    pthread_mutex_lock(&cache_mutex);
+    int n = atomic_load(&cache_count);
+    if (n < STATS_MAX_CACHES)
+    {
+        cache = &caches[n];
+        cache->name = name;
+        atomic_store(&cache_count, n + 1); // publish after name is set
+    }
+    pthread_mutex_unlock(&cache_mutex);
+    return cache;
+}
+
+void stats_record_command(MetricCommand cmd, const char *username, uint64_t elapsed_ns)
+{
+    if (elapsed_ns < (uint64_t)STATS_SLOW_COMMAND_MS * 1000000ULL)
+        return;
+
+    pthread_mutex_lock(&slow_mutex);
+    SlowCommand *slot = &slow_ring[slow_count % STATS_SLOW_RING_SIZE];
+    slot->command = cmd;
+    snprintf(slot->username, sizeof(slot->username), "%s", username && username[0] ? username : "anonymous");
+    slot->elapsed_ns = elapsed_ns;
+    slot->at = time(NULL);
+    slow_count++;
+    pthread_mutex_unlock(&slow_mutex);
+}
+
+// Append to a fixed JSON buffer; output is truncated (never overflows) if it is too small
+static void json_append(char *buf, size_t size, size_t *len, const char *format, ...)
+{
+    if (*len >= size)
+        return;
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(buf + *len, size - *len, format, args);
+    va_end(args);
+    if (n > 0)
+        *len += (size_t)n;
+}
+
+/**
+ * @brief Handle STATS command
+ */
+void handle_stats(Server *server, ClientSession *client, Message *msg)
+{
+    (void)msg;
+
+    if (!check_authentication(client))
+    {
+        send_error_or_response(client->socket_fd, CODE_NOT_LOGGED, "Not authenticated");
+        return;
+    }
+    if (strcmp(client->username, STATS_ADMIN_USERNAME) != 0)
+    {
+        send_error_or_response(client->socket_fd, CODE_NOT_ALLOWED, "Admin only");
+        log_event(LOG_WARNING, client->username, "STATS", "Denied: not admin");
+        return;
+    }
+
+    // Sessions: copy the states only, count after unlocking
+    ClientState states[MAX_CLIENTS];
+    int active = 0, lobby_subscribers = 0;
+    pthread_mutex_lock(&server->clients_mutex);
+    for (int i = 0; i < MAX_CLIENTS; i++)
+    {
+        if (server->clients[i].active)
+        {
+            states[active++] = server->clients[i].state;
+            lobby_subscribers += server->clients[i].lobby;
+        }
+    }
+    pthread_mutex_unlock(&server->clients_mutex);
+
+    int by_state[STATE_IN_EXAM + 1] = {0};
+    for (int i = 0; i < active; i++)
+    {
+        if (states[i] <= STATE_IN_EXAM)
+            by_state[states[i]]++;
+    }
+
+    // Read before our own DB query so it is not counted
+    int db_inflight = metrics_db_inflight();
+
+    int not_started = 0, in_progress = 0, finished = 0;
+    int rooms_ok = db_count_rooms_by_status(server->db, &not_started, &in_progress, &finished) == 0;
+
+    LoggerStats log_stats;
+    logger_get_stats(&log_stats);
+
+    char json[6144];
+    size_t len = 0;
+    json_append(json, sizeof(json), &len,
+                "{\"time\":%ld,"
+                "\"sessions\":{\"active\":%d,\"CONNECTED\":%d,\"AUTHENTICATED\":%d,\"IN_PRACTICE\":%d,\"IN_ROOM\":%d,\"IN_EXAM\":%d,\"max\":%d},",
+                (long)time(NULL), active, by_state[STATE_CONNECTED], by_state[STATE_AUTHENTICATED],
+                by_state[STATE_IN_PRACTICE], by_state[STATE_IN_ROOM], by_state[STATE_IN_EXAM], MAX_CLIENTS);
+
+    if (rooms_ok)
+        json_append(json, sizeof(json), &len, "\"rooms\":{\"NOT_STARTED\":%d,\"IN_PROGRESS\":%d,\"FINISHED\":%d},",
+                    not_started, in_progress, finished);
+    else
+        json_append(json, sizeof(json), &len, "\"rooms\":null,");
+
+    // Single shared connection: one call runs, the rest wait on db->mutex
+    json_append(json, sizeof(json), &len,
+                "\"db\":{\"pool_size\":1,\"inflight\":%d,\"busy\":%d,\"waiting\":%d},",
+                db_inflight, db_inflight > 0 ? 1 : 0, db_inflight > 1 ? db_inflight - 1 : 0);
+
+    json_append(json, sizeof(json), &len,
+                "\"queues\":{\"log_rings\":%d,\"log_backlog_bytes\":%zu,\"log_dropped\":%llu,\"log_compress_pending\":%d},",
+                log_stats.rings, log_stats.backlog_bytes, log_stats.dropped, log_stats.compress_pending);
+
+    if (server->db->journal)
+    {
+        DbJournalStats journal_stats;
+        db_journal_stats(server->db->journal, &journal_stats);
+        json_append(json, sizeof(json), &len,
+                    "\"results_journal\":{\"pending\":%d,\"appended\":%llu,\"committed\":%llu,\"batches\":%llu,\"fsyncs\":%llu,\"failures\":%llu},",
+                    journal_stats.pending, journal_stats.appended, journal_stats.committed,
+                    journal_stats.batches, journal_stats.fsyncs, journal_stats.failures);
+    }
+    else
+        json_append(json, sizeof(json), &len, "\"results_journal\":null,");
+
+    LobbyStats lobby;
+    lobby_get_stats(&lobby);
+    json_append(json, sizeof(json), &len,
+                "\"lobby\":{\"subscribers\":%d,\"events\":%llu,\"batches\":%llu,\"deliveries\":%llu,\"resyncs\":%llu},",
+                lobby_subscribers, lobby.events, lobby.batches, lobby.deliveries, lobby.resyncs);
+
+    json_append(json, sizeof(json), &len, "\"caches\":[");
+    int caches_n = atomic_load(&cache_count);
+    for (int i = 0; i < caches_n; i++)
+    {
+        unsigned long long hits = atomic_load_explicit(&caches[i].hits, memory_order_relaxed);
+        unsigned long long misses = atomic_load_explicit(&caches[i].misses, memory_order_relaxed);
+        json_append(json, sizeof(json), &len, "%s{\"name\":\"%s\",\"hits\":%llu,\"misses\":%llu,\"hit_rate\":%.4f}",
+                    i ? "," : "", caches[i].name, hits, misses,
+                    hits + misses ? (double)hits / (double)(hits + misses) : 0.0);
+    }
+    json_append(json, sizeof(json), &len, "],");
+
+    // Latency summary from the metrics histograms (only commands seen so far)
+    json_append(json, sizeof(json), &len, "\"commands\":{");
+    int first = 1;
+    for (int i = 0; i < METRIC_CMD_COUNT; i++)
+    {
+        MetricsHistogram h;
+        metrics_snapshot_command((MetricCommand)i, &h);
+        if (h.count == 0)
+            continue;
+        json_append(json, sizeof(json), &len, "%s\"%s\":{\"count\":%llu,\"p50_ms\":%.3f,\"p99_ms\":%.3f}",
+                    first ? "" : ",", metrics_command_name((MetricCommand)i), (unsigned long long)h.count,
+                    metrics_percentile(&h, 50) / 1e6, metrics_percentile(&h, 99) / 1e6);
+        first = 0;
+    }
+    json_append(json, sizeof(json), &len, "},");
+
+    // Recent slow commands, newest first
+    SlowCommand slow[STATS_SLOW_RING_SIZE];
+    unsigned int slow_total;
+    pthread_mutex_lock(&slow_mutex);
+    slow_total = slow_count;
+    memcpy(slow, slow_ring, sizeof(slow));
+    pthread_mutex_unlock(&slow_mutex);
+
+    unsigned int slow_n = slow_total < STATS_SLOW_RING_SIZE ? slow_total : STATS_SLOW_RING_SIZE;
+    json_append(json, sizeof(json), &len, "\"slow_threshold_ms\":%d,\"slow_commands\":[", STATS_SLOW_COMMAND_MS);
+    for (unsigned int i = 0; i < slow_n; i++)
+    {
+        const SlowCommand *s = &slow[(slow_total - 1 - i) % STATS_SLOW_RING_SIZE];
+        json_append(json, sizeof(json), &len, "%s{\"command\":\"%s\",\"user\":\"%s\",\"ms\":%.3f,\"at\":%ld}",
+                    i ? "," : "", metrics_command_name(s->command), s->username, s->elapsed_ns / 1e6, (long)s->at);
+    }
+    json_append(json, sizeof(json), &len, "]}");
+
+    if (len >= sizeof(json))
+    {
+        send_error_or_response(client->socket_fd, CODE_INTERNAL_ERROR, "Response too large");
+        return;
+    }
+
+    if (send_data_message(client, CODE_STATS_DATA, json, len) == 0)
+    {
+        log_event(LOG_INFO, client->username, "STATS", "Snapshot sent (%zu bytes)", len);
+    }
+    else
+    {
+        send_error_or_response(client->socket_fd, CODE_INTERNAL_ERROR, "Response too large");
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include "../protocol/protocol.h"
+#include "../metrics/metrics.h"
+#include <stdatomic.h>
+
+typedef struct ClientSession ClientSession;
+typedef struct Server Server;
+
+#define STATS_ADMIN_USERNAME "admin"  // only this account may run STATS
+#define STATS_SLOW_COMMAND_MS 200     // commands slower than this are kept for STATS
+#define STATS_SLOW_RING_SIZE 16       // recent slow commands kept
+#define STATS_MAX_CACHES 16
+
+/**
+ * @brief Hit/miss counters of one cache, registered once at startup
+ */
+typedef struct
+{
+    const char *name;
+    atomic_ullong hits;
+    atomic_ullong misses;
+} StatsCache;
+
+/**
+ * @brief Register a cache so STATS reports its hit rate
+ * @param name Static string, e.g. "exam_questions"
+ * @return Counter block (NULL if the table is full)
+ */
+StatsCache *stats_register_cache(const char *name);
+
+static inline void stats_cache_hit(StatsCache *cache)
+{
+    if (cache)
+        atomic_fetch_add_explicit(&cache->hits, 1, memory_order_relaxed);
+}
+
+static inline void stats_cache_miss(StatsCache *cache)
+{
+    if (cache)
+        atomic_fetch_add_explicit(&cache->misses, 1, memory_order_relaxed);
+}
+
+/**
+ * @brief Remember a command if it was slow (cheap no-op otherwise)
+ */
+void stats_record_command(MetricCommand cmd, const char *username, uint64_t elapsed_ns);
+
+/**
+ * @brief Xử lý lệnh STATS (chỉ admin)
+ * @param server Pointer tới Server instance
+ * @param client Pointer tới ClientSession
+ * @param msg Message đã parse (STATS)
+ *
+ * Flow:
+ * 1. Check authentication (221) và quyền admin (229)
+ * 2. Copy trạng thái session (giữ clients_mutex rất ngắn)
+ * 3. Đếm phòng theo status, DB / logger queues, lobby push, caches, slow commands
+ * 4. Response: 160 DATA <length>\n<JSON snapshot>
+ */
+void handle_stats(Server *server, ClientSession *client, Message *msg);
+
+#endif // STATS_H
@@ -0,0 +1,155 @@
+#include "../logger/log_format.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <zlib.h>
+
+// Offline decoder for binary server logs (logger_init_format(..., LOG_FORMAT_BINARY))
+// Usage: log_decoder <file.binlog> [more files...]
+// Rotated segments (<file>.<timestamp>.gz) are read directly, no need to gunzip first.
+// Output: [2025-11-30 14:30:00] [INFO] [john123] LOGIN: Successful login
+
+static const char *formats[LOG_MAX_FORMATS + 1];
+
+static const char *level_string(int level)
+{
+    switch (level)
+    {
+    case 0:
+        return "INFO";
+    case 1:
+        return "WARNING";
+    case 2:
+        return "ERROR";
+    default:
+        return "UNKNOWN";
+    }
+}
+
+static int read_exact(gzFile f, void *buf, size_t n)
+{
+    return n == 0 || gzread(f, buf, (unsigned)n) == (int)n;
+}
+
+static int read_str8(gzFile f, char *out, uint8_t *len)
+{
+    if (!read_exact(f, len, 1))
+        return 0;
+    if (!read_exact(f, out, *len))
+        return 0;
+    out[*len] = '\0';
+    return 1;
+}
+
+static void print_line(int level, int64_t timestamp_ns, const char *user, const char *action, const char *msg)
+{
+    time_t sec = (time_t)(timestamp_ns / 1000000000LL);
+    char time_str[32];
+    struct tm tm_buf;
+    localtime_r(&sec, &tm_buf);
+    strftime(time_str, sizeof(time_str), "%Y-%m-%d %H:%M:%S", &tm_buf);
+
+    printf("[%s] [%s] [%s] %s: %s\n", time_str, level_string(level), user[0] ? user : "SYSTEM", action, msg);
+}
+
+static int decode_file(const char *path)
+{
+    gzFile f = gzopen(path, "rb"); // transparent for uncompressed files
+    if (!f)
+    {
+        perror(path);
+        return -1;
+    }
+
+    char magic[LOG_BINARY_MAGIC_LEN];
+    uint32_t version;
+    if (!read_exact(f, magic, sizeof(magic)) || memcmp(magic, LOG_BINARY_MAGIC, LOG_BINARY_MAGIC_LEN) != 0 ||
+        !read_exact(f, &version, sizeof(version)) || version != LOG_BINARY_VERSION)
+    {
+        fprintf(stderr, "%s: not a binary log (version %d expected)\n", path, LOG_BINARY_VERSION);
+        gzclose(f);
+        return -1;
+    }
+
+    int tag;
+    while ((tag = gzgetc(f)) != EOF)
+    {
+        if (tag == LOG_TAG_FORMAT)
+        {
+            uint16_t id, len;
+            if (!read_exact(f, &id, sizeof(id)) || !read_exact(f, &len, sizeof(len)) || id == 0 || id > LOG_MAX_FORMATS)
+                goto truncated;
+            char *format = malloc(len + 1);
+            if (!format || !read_exact(f, format, len))
+            {
+                free(format);
+                goto truncated;
+            }
+            format[len] = '\0';
+            free((char *)formats[id]); // a later process may redefine the id
+            formats[id] = format;
+            continue;
+        }
+
+        if (tag != LOG_TAG_RECORD && tag != LOG_TAG_TEXT)
+        {
+            fprintf(stderr, "%s: unknown entry tag 0x%02x at offset %ld\n", path, tag, (long)gztell(f) - 1);
+            break;
+        }
+
+        uint16_t id = 0, msg_len;
+        uint8_t level, user_len, action_len;
+        int64_t timestamp;
+        char user[256], action[256], payload[65536];
+
+        if (tag == LOG_TAG_RECORD && !read_exact(f, &id, sizeof(id)))
+            goto truncated;
+        if (!read_exact(f, &level, 1) || !read_exact(f, &timestamp, sizeof(timestamp)) ||
+            !read_str8(f, user, &user_len) || !read_str8(f, action, &action_len) ||
+            !read_exact(f, &msg_len, sizeof(msg_len)) || !read_exact(f, payload, msg_len))
+            goto truncated;
+
+        if (tag == LOG_TAG_TEXT)
+        {
+            payload[msg_len] = '\0';
+            print_line(level, timestamp, user, action, payload);
+        }
+        else if (id == 0 || id > LOG_MAX_FORMATS || !formats[id])
+        {
+            fprintf(stderr, "%s: record uses undefined format %u\n", path, id);
+        }
+        else
+        {
+            char msg[4096];
+            log_format_render(formats[id], payload, msg_len, msg, sizeof(msg));
+            print_line(level, timestamp, user, action, msg);
+        }
+    }
+
+    gzclose(f);
+    return 0;
+
+truncated:
+    // The last record may be cut short if the server is still writing
+    fprintf(stderr, "%s: truncated entry at end of file\n", path);
+    gzclose(f);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "Usage: %s <file.binlog> [more files...]\n", argv[0]);
+        return 1;
+    }
+
+    int status = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        if (decode_file(argv[i]) < 0)
+            status = 1;
+    }
+    return status;
+}
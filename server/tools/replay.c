@@ -0,0 +1,760 @@
+#include "../capture/capture.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+// Replay a traffic capture (exam_server --capture FILE) against a server
+// Usage: replay <file.cap> [--host IP] [--port N] [--speed 1|N|max]
+//        replay <file.cap> --dump      (print records as JSON lines)
+//
+// Every captured connection is re-opened and its command lines are sent at
+// their original offsets divided by --speed. "max" sends as fast as possible
+// while keeping the order of records. Responses are read and matched to the
+// oldest outstanding command of the connection to measure latency.
+//
+// Room ids are assigned by the server, so the ids in the capture do not
+// exist on the target. Each 'R' record (room id the captured CREATE_ROOM
+// got) is paired with the id the target returns in 120 ROOM_CREATED on the
+// same connection, and a command whose first parameter is a captured room id
+// is rewritten before sending (waiting up to REPLAY_ROOM_WAIT_MS for that
+// CREATE_ROOM response).
+
+#define REPLAY_MAX_PENDING 64     // outstanding commands tracked per connection
+#define REPLAY_CLOSE_GRACE_MS 2000 // wait for responses before closing a connection
+#define REPLAY_DRAIN_MS 5000       // wait at the end for the last responses
+#define REPLAY_MAX_COMMANDS 64
+#define REPLAY_IN_BUFFER (64 * 1024)
+#define REPLAY_LINE_MAX 8192      // command line assembled from 'D' records
+#define REPLAY_ROOM_ID_MAX 64
+#define REPLAY_ROOM_WAIT_MS 2000
+
+typedef struct
+{
+    char type;
+    uint32_t conn_id;
+    uint64_t t_us; // offset from capture start
+    const char *data;
+    size_t len;
+} ReplayRecord;
+
+typedef struct
+{
+    uint32_t id; // conn_id of the capture
+    int fd;
+    int closing;
+    uint64_t close_deadline_ns;
+    uint64_t pending_ns[REPLAY_MAX_PENDING];
+    int pending_cmd[REPLAY_MAX_PENDING];
+    int pending_head, pending_count;
+    char in[REPLAY_IN_BUFFER];
+    size_t in_len;
+    size_t skip; // payload bytes of a DATA response still to discard
+    char line[REPLAY_LINE_MAX]; // command line not complete yet
+    size_t line_len;
+    char created_room[REPLAY_ROOM_ID_MAX]; // target id of a CREATE_ROOM whose 'R' record is not read yet
+} ReplayConn;
+
+typedef struct
+{
+    char captured[REPLAY_ROOM_ID_MAX];
+    char target[REPLAY_ROOM_ID_MAX]; // "" until the target answers the CREATE_ROOM
+    uint32_t conn_id;
+} RoomMapping;
+
+typedef struct
+{
+    char name[32];
+    uint64_t sent;
+    uint64_t *latencies;
+    size_t count, cap;
+} CommandStats;
+
+static CommandStats commands[REPLAY_MAX_COMMANDS];
+static int command_count = 0;
+static uint64_t code_counts[1000];
+static uint64_t pushes = 0, unmatched = 0, connect_failures = 0;
+static RoomMapping *room_map = NULL;
+static size_t room_map_count = 0, room_map_cap = 0;
+static uint64_t rooms_rewritten = 0, rooms_unresolved = 0;
+static struct sockaddr_in server_addr;
+static int epoll_fd;
+static int open_conns = 0;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// ============================== File parsing ================================
+
+static int get_varint(const unsigned char **p, const unsigned char *end, uint64_t *out)
+{
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64 && *p < end; shift += 7)
+    {
+        unsigned char byte = *(*p)++;
+        value |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+        {
+            *out = value;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static ReplayRecord *load_capture(const char *path, char **file_data, size_t *count, uint32_t *max_conn)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f)
+    {
+        perror(path);
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    char *data = malloc(size > 0 ? size : 1);
+    if (!data || fread(data, 1, size, f) != (size_t)size || size < CAPTURE_MAGIC_LEN + 8 ||
+        memcmp(data, CAPTURE_MAGIC, CAPTURE_MAGIC_LEN) != 0)
+    {
+        fprintf(stderr, "%s: not a capture file\n", path);
+        fclose(f);
+        free(data);
+        return NULL;
+    }
+    fclose(f);
+
+    size_t cap = 1024, n = 0;
+    ReplayRecord *records = malloc(cap * sizeof(ReplayRecord));
+    const unsigned char *p = (const unsigned char *)data + CAPTURE_MAGIC_LEN + 8;
+    const unsigned char *end = (const unsigned char *)data + size;
+    uint64_t t_us = 0;
+    *max_conn = 0;
+
+    while (records && p < end)
+    {
+        ReplayRecord r;
+        uint64_t delta, conn, len = 0;
+        r.type = (char)*p++;
+        if (!get_varint(&p, end, &delta) || !get_varint(&p, end, &conn))
+            break;
+        if ((r.type == CAPTURE_DATA || r.type == CAPTURE_ROOM) && (!get_varint(&p, end, &len) || (uint64_t)(end - p) < len))
+            break;
+        if (r.type != CAPTURE_OPEN && r.type != CAPTURE_DATA && r.type != CAPTURE_CLOSE && r.type != CAPTURE_ROOM)
+        {
+            fprintf(stderr, "%s: unknown record type 0x%02x\n", path, (unsigned char)r.type);
+            break;
+        }
+
+        t_us += delta;
+        r.t_us = t_us;
+        r.conn_id = (uint32_t)conn;
+        r.data = (const char *)p;
+        r.len = len;
+        p += len;
+        if (r.conn_id > *max_conn)
+            *max_conn = r.conn_id;
+
+        if (n == cap)
+        {
+            cap *= 2;
+            ReplayRecord *grown = realloc(records, cap * sizeof(ReplayRecord));
+            if (!grown)
+            {
+                free(records);
+                records = NULL;
+                break;
+            }
+            records = grown;
+        }
+        records[n++] = r;
+    }
+
+    if (p < end)
+        fprintf(stderr, "%s: truncated record at end of file (ignored)\n", path);
+
+    *file_data = data;
+    *count = n;
+    return records;
+}
+
+static void dump_records(const ReplayRecord *records, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        const ReplayRecord *r = &records[i];
+        printf("{\"t_us\":%llu,\"conn\":%u,\"type\":\"%c\"", (unsigned long long)r->t_us, r->conn_id, r->type);
+        if (r->type == CAPTURE_DATA)
+        {
+            printf(",\"line\":\"");
+            for (size_t j = 0; j < r->len; j++)
+            {
+                unsigned char c = (unsigned char)r->data[j];
+                if (c == '"' || c == '\\')
+                    printf("\\%c", c);
+                else if (c == '\n')
+                    printf("\\n");
+                else if (c < 0x20)
+                    printf("\\u%04x", c);
+                else
+                    putchar(c);
+            }
+            putchar('"');
+        }
+        else if (r->type == CAPTURE_ROOM)
+        {
+            printf(",\"room_id\":\"%.*s\"", (int)r->len, r->data); // [0-9a-z] only
+        }
+        printf("}\n");
+    }
+}
+
+// ================================ Replay ====================================
+
+static int command_index(const char *line, size_t len)
+{
+    char name[32];
+    size_t n = 0;
+    while (n < len && n < sizeof(name) - 1 && line[n] != ' ' && line[n] != '\n' && line[n] != '\r')
+    {
+        name[n] = line[n];
+        n++;
+    }
+    name[n] = '\0';
+
+    for (int i = 0; i < command_count; i++)
+    {
+        if (strcmp(commands[i].name, name) == 0)
+            return i;
+    }
+    if (command_count == REPLAY_MAX_COMMANDS)
+        return REPLAY_MAX_COMMANDS - 1;
+    snprintf(commands[command_count].name, sizeof(commands[command_count].name), "%s", name);
+    return command_count++;
+}
+
+static void add_latency(CommandStats *stats, uint64_t ns)
+{
+    if (stats->count == stats->cap)
+    {
+        size_t cap = stats->cap ? stats->cap * 2 : 256;
+        uint64_t *grown = realloc(stats->latencies, cap * sizeof(uint64_t));
+        if (!grown)
+            return;
+        stats->latencies = grown;
+        stats->cap = cap;
+    }
+    stats->latencies[stats->count++] = ns;
+}
+
+// =============================== Room ids ===================================
+
+static RoomMapping *find_room(const char *captured, size_t len)
+{
+    for (size_t i = 0; i < room_map_count; i++)
+    {
+        if (strlen(room_map[i].captured) == len && memcmp(room_map[i].captured, captured, len) == 0)
+            return &room_map[i];
+    }
+    return NULL;
+}
+
+// 'R' record: the captured CREATE_ROOM of this connection got `captured`
+static void add_room(ReplayConn *conn, const char *captured, size_t len)
+{
+    if (len >= REPLAY_ROOM_ID_MAX)
+        return;
+    if (room_map_count == room_map_cap)
+    {
+        size_t cap = room_map_cap ? room_map_cap * 2 : 64;
+        RoomMapping *grown = realloc(room_map, cap * sizeof(RoomMapping));
+        if (!grown)
+            return;
+        room_map = grown;
+        room_map_cap = cap;
+    }
+    RoomMapping *m = &room_map[room_map_count++];
+    memcpy(m->captured, captured, len);
+    m->captured[len] = '\0';
+    m->conn_id = conn->id;
+    strcpy(m->target, conn->created_room); // "" if the target has not answered yet
+    conn->created_room[0] = '\0';
+}
+
+// 120 ROOM_CREATED <room_id> from the target
+static void on_room_created(ReplayConn *conn, const char *line)
+{
+    const char *room_id = strrchr(line, ' ');
+    if (!room_id || strlen(room_id + 1) >= REPLAY_ROOM_ID_MAX)
+        return;
+    for (size_t i = 0; i < room_map_count; i++)
+    {
+        if (room_map[i].conn_id == conn->id && room_map[i].target[0] == '\0')
+        {
+            strcpy(room_map[i].target, room_id + 1);
+            return;
+        }
+    }
+    strcpy(conn->created_room, room_id + 1);
+}
+
+static void close_conn(ReplayConn *conn)
+{
+    if (conn->fd < 0)
+        return;
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, conn->fd, NULL);
+    close(conn->fd);
+    conn->fd = -1;
+    open_conns--;
+}
+
+/**
+ * @brief Unsolicited line: START_OK to members (125), leaderboard stream (128), lobby batches (129)
+ * Each is also the direct reply to one command: 125 to START_EXAM, 128/129 to
+ * (UN)SUBSCRIBE_LEADERBOARD/LOBBY. Only the snapshot of SUBSCRIBE_LEADERBOARD
+ * is a DATA reply; stream updates are always DATA/ZDATA.
+ * @param cmd Pending command at the head of the queue, NULL if none
+ */
+static int is_push(int code, const char *line, const char *cmd)
+{
+    const char *reply_to;
+    if (code == 125)
+        reply_to = "START_EXAM";
+    else if (code == 128)
+        reply_to = "SUBSCRIBE_LEADERBOARD";
+    else if (code == 129)
+        reply_to = "SUBSCRIBE_LOBBY";
+    else
+        return 0;
+    if (!cmd)
+        return 1;
+
+    int is_data = strstr(line, " DATA ") || strstr(line, " ZDATA ");
+    if (code == 125 || strcmp(cmd, "SUBSCRIBE_LEADERBOARD") == 0)
+        return strcmp(cmd, reply_to) != 0;
+    // (UN)SUBSCRIBE_* answers with a status line: a DATA line is a batch sent before it
+    return is_data || strcmp(strncmp(cmd, "UN", 2) == 0 ? cmd + 2 : cmd, reply_to) != 0;
+}
+
+/**
+ * @brief Handle one response line; pushes (see is_push) do not consume a pending command
+ */
+static void on_response_line(ReplayConn *conn, const char *line)
+{
+    int code = atoi(line);
+    if (code >= 0 && code < 1000)
+        code_counts[code]++;
+
+    if (conn->pending_count == 0)
+    {
+        if (is_push(code, line, NULL))
+            pushes++;
+        else
+            unmatched++;
+        return;
+    }
+
+    int cmd = conn->pending_cmd[conn->pending_head];
+    if (is_push(code, line, commands[cmd].name))
+    {
+        pushes++;
+        return;
+    }
+
+    if (code == 120 && strcmp(commands[cmd].name, "CREATE_ROOM") == 0)
+        on_room_created(conn, line);
+    add_latency(&commands[cmd], now_ns() - conn->pending_ns[conn->pending_head]);
+    conn->pending_head = (conn->pending_head + 1) % REPLAY_MAX_PENDING;
+    conn->pending_count--;
+}
+
+static void on_readable(ReplayConn *conn)
+{
+    for (;;)
+    {
+        ssize_t n = recv(conn->fd, conn->in + conn->in_len, sizeof(conn->in) - conn->in_len, MSG_DONTWAIT);
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return;
+        if (n <= 0)
+        {
+            close_conn(conn);
+            return;
+        }
+        conn->in_len += (size_t)n;
+
+        size_t off = 0;
+        while (off < conn->in_len)
+        {
+            if (conn->skip > 0)
+            {
+                size_t take = conn->in_len - off < conn->skip ? conn->in_len - off : conn->skip;
+                off += take;
+                conn->skip -= take;
+                continue;
+            }
+
+            char *nl = memchr(conn->in + off, '\n', conn->in_len - off);
+            if (!nl)
+                break;
+            *nl = '\0';
+            const char *line = conn->in + off;
+            off = (size_t)(nl - conn->in) + 1;
+
+            int code;
+            size_t data_len;
+            if (sscanf(line, "%d DATA %zu", &code, &data_len) == 2 ||
+                sscanf(line, "%d ZDATA %zu", &code, &data_len) == 2) // COMPRESS in the capture
+                conn->skip = data_len;
+            on_response_line(conn, line);
+        }
+
+        if (off == 0 && conn->in_len == sizeof(conn->in))
+            off = conn->in_len; // line longer than the buffer: drop it
+        memmove(conn->in, conn->in + off, conn->in_len - off);
+        conn->in_len -= off;
+
+        if (conn->closing && conn->pending_count == 0)
+        {
+            close_conn(conn);
+            return;
+        }
+    }
+}
+
+static void send_line(ReplayConn *conn, const char *data, size_t len)
+{
+    while (len > 0)
+    {
+        ssize_t n = send(conn->fd, data, len, MSG_NOSIGNAL);
+        if (n <= 0)
+        {
+            close_conn(conn);
+            return;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+}
+
+static void open_conn(ReplayConn *conn, uint32_t id)
+{
+    memset(conn, 0, sizeof(ReplayConn));
+    conn->id = id;
+    conn->fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (conn->fd < 0 || connect(conn->fd, (struct sockaddr *)&server_addr, sizeof(server_addr)) < 0)
+    {
+        if (conn->fd >= 0)
+            close(conn->fd);
+        conn->fd = -1;
+        connect_failures++;
+        return;
+    }
+    int one = 1;
+    setsockopt(conn->fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.ptr = conn;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, conn->fd, &ev);
+    open_conns++;
+}
+
+// Read responses until `until_ns`, closing connections whose grace period ended
+static void pump(ReplayConn *conns, uint32_t conn_count, uint64_t until_ns)
+{
+    struct epoll_event events[256];
+    for (;;)
+    {
+        uint64_t now = now_ns();
+        int timeout_ms = until_ns > now ? (int)((until_ns - now + 999999) / 1000000) : 0;
+        if (timeout_ms > 50)
+            timeout_ms = 50;
+
+        int n = epoll_wait(epoll_fd, events, 256, timeout_ms);
+        for (int i = 0; i < n; i++)
+            on_readable((ReplayConn *)events[i].data.ptr);
+
+        now = now_ns();
+        for (uint32_t c = 0; c < conn_count; c++)
+        {
+            if (conns[c].fd >= 0 && conns[c].closing && now >= conns[c].close_deadline_ns)
+                close_conn(&conns[c]);
+        }
+        if (now >= until_ns || (n == 0 && timeout_ms == 0))
+            return;
+    }
+}
+
+/**
+ * @brief Send one command line, with a captured room id in params[0] replaced
+ *        by the target's (waits for the CREATE_ROOM response if needed)
+ */
+static void replay_line(ReplayConn *conns, uint32_t conn_count, ReplayConn *conn, const char *line, size_t len)
+{
+    char rewritten[REPLAY_LINE_MAX + REPLAY_ROOM_ID_MAX];
+    const char *space = memchr(line, ' ', len);
+    if (space && room_map_count > 0)
+    {
+        const char *param = space + 1, *param_end = param;
+        while (param_end < line + len && *param_end != '|' && *param_end != '\n' && *param_end != '\r')
+            param_end++;
+
+        RoomMapping *m = find_room(param, (size_t)(param_end - param));
+        if (m)
+        {
+            uint64_t deadline = now_ns() + REPLAY_ROOM_WAIT_MS * 1000000ULL;
+            while (m->target[0] == '\0' && now_ns() < deadline)
+                pump(conns, conn_count, now_ns() + 10 * 1000000ULL);
+
+            if (m->target[0] == '\0')
+            {
+                rooms_unresolved++;
+            }
+            else if (conn->fd >= 0)
+            {
+                int n = snprintf(rewritten, sizeof(rewritten), "%.*s%s%.*s", (int)(param - line), line, m->target,
+                                 (int)(line + len - param_end), param_end);
+                line = rewritten;
+                len = (size_t)n;
+                rooms_rewritten++;
+            }
+        }
+    }
+    if (conn->fd < 0)
+        return;
+
+    int cmd = command_index(line, len);
+    commands[cmd].sent++;
+    if (conn->pending_count < REPLAY_MAX_PENDING)
+    {
+        int slot = (conn->pending_head + conn->pending_count) % REPLAY_MAX_PENDING;
+        conn->pending_ns[slot] = now_ns();
+        conn->pending_cmd[slot] = cmd;
+        conn->pending_count++;
+    }
+    send_line(conn, line, len);
+}
+
+// A 'D' record holds what one recv() returned: split it into command lines
+static void replay_data(ReplayConn *conns, uint32_t conn_count, ReplayConn *conn, const char *data, size_t len)
+{
+    while (len > 0 && conn->fd >= 0)
+    {
+        const char *nl = memchr(data, '\n', len);
+        size_t take = nl ? (size_t)(nl - data) + 1 : len;
+        if (conn->line_len + take > sizeof(conn->line))
+        {
+            // Longer than any valid command: pass it through untouched
+            send_line(conn, conn->line, conn->line_len);
+            conn->line_len = 0;
+            if (conn->fd >= 0)
+                send_line(conn, data, take);
+        }
+        else
+        {
+            memcpy(conn->line + conn->line_len, data, take);
+            conn->line_len += take;
+            if (nl)
+            {
+                size_t line_len = conn->line_len;
+                conn->line_len = 0;
+                replay_line(conns, conn_count, conn, conn->line, line_len);
+            }
+        }
+        data += take;
+        len -= take;
+    }
+}
+
+static int compare_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static double pct_ms(const CommandStats *s, double p)
+{
+    if (s->count == 0)
+        return 0;
+    size_t idx = (size_t)(p / 100.0 * (double)(s->count - 1) + 0.5);
+    return s->latencies[idx] / 1e6;
+}
+
+static void print_report(size_t records, double seconds, const char *speed)
+{
+    printf("\n=== REPLAY REPORT ===\n");
+    printf("Records: %zu, speed: %s, duration: %.2f s\n", records, speed, seconds);
+    printf("Connect failures: %llu, pushes: %llu, unmatched responses: %llu\n",
+           (unsigned long long)connect_failures, (unsigned long long)pushes, (unsigned long long)unmatched);
+    printf("Rooms: %zu created, %llu room ids rewritten, %llu unresolved (CREATE_ROOM failed on the target)\n\n",
+           room_map_count, (unsigned long long)rooms_rewritten, (unsigned long long)rooms_unresolved);
+
+    printf("%-16s %8s %8s %9s %9s %9s %9s\n", "command", "sent", "answered", "p50 ms", "p90 ms", "p99 ms", "max ms");
+    for (int i = 0; i < command_count; i++)
+    {
+        CommandStats *s = &commands[i];
+        qsort(s->latencies, s->count, sizeof(uint64_t), compare_u64);
+        printf("%-16s %8llu %8zu %9.2f %9.2f %9.2f %9.2f\n", s->name, (unsigned long long)s->sent, s->count,
+               pct_ms(s, 50), pct_ms(s, 90), pct_ms(s, 99), s->count ? s->latencies[s->count - 1] / 1e6 : 0.0);
+    }
+
+    printf("\nResponse codes:");
+    for (int code = 0; code < 1000; code++)
+    {
+        if (code_counts[code])
+            printf(" %d=%llu", code, (unsigned long long)code_counts[code]);
+    }
+    printf("\n");
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "Usage: %s <file.cap> [--host IP] [--port N] [--speed 1|N|max] [--dump]\n", argv[0]);
+        return 1;
+    }
+
+    const char *host = "127.0.0.1";
+    int port = 8888;
+    const char *speed_arg = "1";
+    int dump = 0;
+    for (int i = 2; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--dump") == 0)
+            dump = 1;
+        else if (strcmp(argv[i], "--host") == 0 && i + 1 < argc)
+            host = argv[++i];
+        else if (strcmp(argv[i], "--port") == 0 && i + 1 < argc)
+            port = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc)
+            speed_arg = argv[++i];
+        else
+        {
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    int max_speed = strcmp(speed_arg, "max") == 0;
+    double speed = max_speed ? 0 : atof(speed_arg);
+    if (!max_speed && speed <= 0)
+    {
+        fprintf(stderr, "Invalid speed: %s\n", speed_arg);
+        return 1;
+    }
+
+    char *file_data;
+    size_t count;
+    uint32_t max_conn;
+    ReplayRecord *records = load_capture(argv[1], &file_data, &count, &max_conn);
+    if (!records)
+        return 1;
+
+    if (dump)
+    {
+        dump_records(records, count);
+        free(records);
+        free(file_data);
+        return 0;
+    }
+
+    memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;
+    server_addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, host, &server_addr.sin_addr) <= 0)
+    {
+        fprintf(stderr, "Invalid address: %s\n", host);
+        return 1;
+    }
+
+    ReplayConn *conns = calloc((size_t)max_conn + 1, sizeof(ReplayConn));
+    if (!conns)
+    {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    for (uint32_t c = 0; c <= max_conn; c++)
+        conns[c].fd = -1;
+    epoll_fd = epoll_create1(0);
+
+    printf("Replaying %zu records (%u connections) against %s:%d at speed %s\n", count, max_conn, host, port, speed_arg);
+    uint64_t start = now_ns();
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const ReplayRecord *r = &records[i];
+        if (!max_speed)
+        {
+            uint64_t target = start + (uint64_t)((double)r->t_us * 1000.0 / speed);
+            pump(conns, max_conn + 1, target);
+        }
+        else if (i % 64 == 0)
+        {
+            pump(conns, max_conn + 1, 0); // keep reading so the server never blocks on send
+        }
+
+        ReplayConn *conn = &conns[r->conn_id];
+        switch (r->type)
+        {
+        case CAPTURE_OPEN:
+            open_conn(conn, r->conn_id);
+            break;
+        case CAPTURE_DATA:
+            replay_data(conns, max_conn + 1, conn, r->data, r->len);
+            break;
+        case CAPTURE_ROOM:
+            add_room(conn, r->data, r->len);
+            break;
+        case CAPTURE_CLOSE:
+            if (conn->fd >= 0 && conn->pending_count == 0)
+            {
+                close_conn(conn);
+            }
+            else if (conn->fd >= 0)
+            {
+                conn->closing = 1;
+                conn->close_deadline_ns = now_ns() + REPLAY_CLOSE_GRACE_MS * 1000000ULL;
+            }
+            break;
+        }
+    }
+
+    // Wait for the last responses
+    uint64_t drain_until = now_ns() + REPLAY_DRAIN_MS * 1000000ULL;
+    while (open_conns > 0 && now_ns() < drain_until)
+    {
+        int outstanding = 0;
+        for (uint32_t c = 0; c <= max_conn; c++)
+            outstanding += conns[c].fd >= 0 ? conns[c].pending_count : 0;
+        if (outstanding == 0)
+            break;
+        pump(conns, max_conn + 1, now_ns() + 50 * 1000000ULL);
+    }
+    double seconds = (now_ns() - start) / 1e9;
+
+    for (uint32_t c = 0; c <= max_conn; c++)
+        close_conn(&conns[c]);
+    print_report(count, seconds, speed_arg);
+
+    for (int i = 0; i < command_count; i++)
+        free(commands[i].latencies);
+    free(room_map);
+    free(conns);
+    free(records);
+    free(file_data);
+    close(epoll_fd);
+    return 0;
+}